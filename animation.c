@@ -1,13 +1,15 @@
 /**
  * @file animation.c
- * @brief Implementao da lgica de animao baseada em fsica.
+ * @brief Implementação da lógica de animação baseada em física.
  *
- * Contm as funes para inicializar, atualizar e gerenciar o estado
- * de animao de cada objeto, incluindo integrao de movimento,
- * deteco de colises e interaes do usurio.
+ * Contém as funções para inicializar, atualizar e gerenciar o estado
+ * de animação de cada objeto, incluindo integração de movimento,
+ * detecção de colisões e interações do usuário.
  */
 
 #include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <GL/glut.h>
 #include "animation.h"
@@ -16,72 +18,192 @@
 #include "utils.h"
 #include "input.h"
 #include "config.h"
+#include "render.h"
+#include "collision.h"
+#include "jobs.h"
+#include "journal.h"
+#include "profiler.h"
 
-// --- SEO DE VARIVEIS GLOBAIS (DEFINIES) ---
+// --- SEÇÃO DE CONSTANTES ---
 
-AnimSlot g_anim[MAX_OBJECTS];
+#define ANIM_GRAVITY 700.0f ///< Aceleração da gravidade (pixels por segundo ao quadrado).
 
-// --- SEO DE VARIVEIS GLOBAIS EXTERNAS ---
+// --- SEÇÃO DE VARIÁVEIS GLOBAIS (DEFINIÇÕES) ---
+
+AnimSlot* g_anim = NULL;
+
+// --- SEÇÃO DE VARIÁVEIS PRIVADAS DO MÓDULO ---
+
+static int s_animCapacity = 0; ///< Tamanho alocado de 'g_anim' (acompanha o de 'g_objects').
+static int s_numActive = 0;    ///< Quantidade de slots com 'active' ligado.
+static int* s_activeList = NULL; ///< Índices dos objetos ativos, sem ordem (os 's_numActive' primeiros).
+static int* s_activePos = NULL;  ///< Posição de cada objeto em 's_activeList' (-1 se inativo).
+static float s_accumulator = 0.0f; ///< Tempo real ainda não simulado (sempre menor que um passo).
+static float s_alpha = 1.0f;       ///< Fração do passo atual já decorrida, para a interpolação.
+
+// --- SEÇÃO DE VARIÁVEIS GLOBAIS EXTERNAS ---
 extern int g_windowWidth;
 extern int g_windowHeight;
 
-// --- SEO DE FUNES AUXILIARES (IMPLEMENTAO PRIVADA) ---
+// --- SEÇÃO DE FUNÇÕES AUXILIARES (IMPLEMENTAÇÃO PRIVADA) ---
 
 /**
- * @brief Calcula a Bounding Box (AABB) de um objeto.
+ * @brief Avança um objeto animado por um passo: forças, movimento e bordas da tela.
  *
- * Uma AABB (Axis-Aligned Bounding Box)  o menor retngulo, alinhado aos eixos,
- * que contm completamente o objeto.  usada para deteco de coliso eficiente.
- * @param i O ndice do objeto.
- * @param minx, maxx, miny, maxy Ponteiros para armazenar as coordenadas da caixa.
+ * Escreve apenas no slot de animação, nos vértices e na caixa em cache do
+ * próprio objeto (a cena é avisada depois, por objectCommitMove()), então
+ * pode rodar em paralelo para objetos diferentes.
  */
-static void object_aabb(int i, float* minx, float* maxx, float* miny, float* maxy) {
-    *minx = *miny = 1e9f;
-    *maxx = *maxy = -1e9f;
-    Object* o = &g_objects[i];
-
-    if (o->type == OBJECT_TYPE_POINT) {
-        Point* p = (Point*)o->data;
-        *minx = *maxx = p->x;
-        *miny = *maxy = p->y;
-    } else if (o->type == OBJECT_TYPE_SEGMENT) {
-        Segment* s = (Segment*)o->data;
-        *minx = (s->p1.x < s->p2.x) ? s->p1.x : s->p2.x;
-        *maxx = (s->p1.x > s->p2.x) ? s->p1.x : s->p2.x;
-        *miny = (s->p1.y < s->p2.y) ? s->p1.y : s->p2.y;
-        *maxy = (s->p1.y > s->p2.y) ? s->p1.y : s->p2.y;
-    } else if (o->type == OBJECT_TYPE_POLYGON) {
-        GfxPolygon* poly = (GfxPolygon*)o->data;
-        for (int v = 0; v < poly->numVertices; v++) {
-            float x = poly->vertices[v].x;
-            float y = poly->vertices[v].y;
-            if (x < *minx) *minx = x;
-            if (x > *maxx) *maxx = x;
-            if (y < *miny) *miny = y;
-            if (y > *maxy) *maxy = y;
-        }
+static void integrateObject(int i, float dtim) {
+    AnimSlot* a = &g_anim[i];
+
+    // 1. Integração de Euler: atualiza a velocidade com base nas forças (gravidade).
+    if (a->gravity) {
+        a->vy -= ANIM_GRAVITY * dtim;
+    }
+
+    // Limita a velocidade máxima.
+    float sp = sqrtf(a->vx * a->vx + a->vy * a->vy);
+    if (sp > a->vmax) {
+        float k = a->vmax / (sp + 1e-6f);
+        a->vx *= k;
+        a->vy *= k;
     }
+
+    // 2. Calcula o deslocamento do passo.
+    float moveX = a->vx * dtim;
+    float moveY = a->vy * dtim;
+
+    // 3. Detecção e resposta de colisão com as bordas da tela, sobre a caixa
+    // em cache já deslocada. As correções entram no mesmo deslocamento, então
+    // os vértices são percorridos uma única vez.
+    BoundingBox box = getObjectBounds(i);
+    float minx = box.minX + moveX, maxx = box.maxX + moveX;
+    float miny = box.minY + moveY, maxy = box.maxY + moveY;
+
+    if (minx < 0.0f && a->vx < 0.0f) {
+        moveX += -minx;
+        a->vx = -a->vx * a->e;
+    }
+    if (maxx > g_windowWidth && a->vx > 0.0f) {
+        moveX += g_windowWidth - maxx;
+        a->vx = -a->vx * a->e;
+    }
+    if (miny < 0.0f && a->vy < 0.0f) {
+        moveY += -miny;
+        a->vy = -a->vy * a->e;
+    }
+    if (maxy > g_windowHeight && a->vy > 0.0f) {
+        moveY += g_windowHeight - maxy;
+        a->vy = -a->vy * a->e;
+    }
+    translateObjectGeometry(i, moveX, moveY);
+    a->stepDx = moveX;
+    a->stepDy = moveY;
+
+    // 4. Atrito (arrasto) para diminuir a velocidade gradualmente.
+    a->vx *= 0.999f;
+    a->vy *= 0.999f;
 }
 
-// --- SEO DE FUNES PBLICAS ---
+/**
+ * @brief Bloco de trabalho do passo: integra os objetos de 's_activeList' em [first, last).
+ * @param ctx Ponteiro para o 'dt' do passo.
+ */
+static void integrateRange(int first, int last, void* ctx) {
+    float dtim = *(const float*)ctx;
+    for (int k = first; k < last; k++) {
+        integrateObject(s_activeList[k], dtim);
+    }
+}
+
+/**
+ * @brief Liga a animação de um objeto e o acrescenta à lista de ativos.
+ * @return int 1 se o objeto estava inativo.
+ */
+static int activate(int idx) {
+    if (g_anim[idx].active) return 0;
+    g_anim[idx].active = 1;
+    s_activePos[idx] = s_numActive;
+    s_activeList[s_numActive++] = idx;
+    collisionTrack(idx);
+    return 1;
+}
+
+/**
+ * @brief Desliga a animação de um objeto e o tira da lista de ativos em O(1).
+ */
+static void deactivate(int idx) {
+    if (!g_anim[idx].active) return;
+    g_anim[idx].active = 0;
+    int pos = s_activePos[idx];
+    int moved = s_activeList[--s_numActive];
+    s_activeList[pos] = moved;
+    s_activePos[moved] = pos;
+    s_activePos[idx] = -1;
+    collisionForget(idx);
+}
+
+// --- SEÇÃO DE FUNÇÕES PÚBLICAS ---
 
 void anim_init_all(void) {
-    memset(g_anim, 0, sizeof(g_anim));
+    if (g_anim != NULL) {
+        memset(g_anim, 0, s_animCapacity * sizeof(AnimSlot));
+    }
+    for (int i = 0; i < s_animCapacity; i++) {
+        s_activePos[i] = -1;
+    }
+    s_numActive = 0;
+    collisionReset();
+    s_accumulator = 0.0f;
+    s_alpha = 1.0f;
+}
+
+int anim_reserve(int capacity) {
+    if (capacity <= s_animCapacity) return 1;
+    AnimSlot* slots = (AnimSlot*)realloc(g_anim, capacity * sizeof(AnimSlot));
+    if (slots) g_anim = slots;
+    int* list = (int*)realloc(s_activeList, capacity * sizeof(int));
+    if (list) s_activeList = list;
+    int* pos = (int*)realloc(s_activePos, capacity * sizeof(int));
+    if (pos) s_activePos = pos;
+    if (!slots || !list || !pos) {
+        fprintf(stderr, "[Anim ERROR] Falha ao alocar estado de animação para %d objetos.\n", capacity);
+        return 0;
+    }
+    // Os novos slots começam inativos.
+    memset(slots + s_animCapacity, 0, (capacity - s_animCapacity) * sizeof(AnimSlot));
+    for (int i = s_animCapacity; i < capacity; i++) {
+        s_activePos[i] = -1;
+    }
+    s_animCapacity = capacity;
+    return 1;
 }
 
 void anim_enable(int idx, float vx, float vy, float e, int gravity) {
     if (idx < 0 || idx >= g_numObjects) return;
-    g_anim[idx].active = 1;
+    if (activate(idx)) {
+        // Acorda o laço de animação, que fica parado sem objetos ativos.
+        renderRequestFrame();
+    }
     g_anim[idx].vx = vx;
     g_anim[idx].vy = vy;
     g_anim[idx].e = e;
     g_anim[idx].gravity = gravity;
     g_anim[idx].vmax = 1200.0f;
+    journalRecordAnim(idx);
 }
 
 void anim_disable(int idx) {
     if (idx < 0 || idx >= g_numObjects) return;
-    g_anim[idx].active = 0;
+    if (g_anim[idx].active) {
+        deactivate(idx);
+        // O objeto volta a ser desenhado na posição real, sem interpolação.
+        g_anim[idx].stepDx = 0.0f;
+        g_anim[idx].stepDy = 0.0f;
+        renderMarkDirty(g_objects[idx].type, g_objects[idx].slot);
+        journalRecordAnim(idx);
+    }
 }
 
 void anim_toggle_selected(void) {
@@ -98,79 +220,123 @@ void anim_kick_towards_mouse(float speed) {
     int i = g_selectedObjectIndex;
     if (i < 0) return;
 
-    // Calcula o vetor direo do centro do objeto para o mouse.
+    // Calcula o vetor direção do centro do objeto para o mouse.
     Point c = getObjectCenter(&g_objects[i]);
     Point m = g_currentMousePos;
     float dx = m.x - c.x;
     float dy = m.y - c.y;
 
-    // Normaliza o vetor para obter apenas a direo.
+    // Normaliza o vetor para obter apenas a direção.
     float L = sqrtf(dx * dx + dy * dy);
-    if (L < 1e-5f) return; // Evita diviso por zero se o mouse estiver no centro.
+    if (L < 1e-5f) return; // Evita divisão por zero se o mouse estiver no centro.
     dx /= L;
     dy /= L;
 
-    // Aplica a velocidade na direo calculada.
+    // Aplica a velocidade na direção calculada.
     g_anim[i].vx = dx * speed;
     g_anim[i].vy = dy * speed;
-    g_anim[i].active = 1;
+    if (activate(i)) {
+        renderRequestFrame();
+    }
+    journalRecordAnim(i);
 }
 
 void anim_step(float dtim) {
-    const float G = 700.0f; // Constante gravitacional.
-    for (int i = 0; i < g_numObjects; i++) {
-        if (!g_anim[i].active) continue;
+    if (s_numActive == 0) return;
+    double profileStart = profileBegin();
 
-        // 1. Integrao de Euler: atualiza a velocidade com base nas foras (gravidade).
-        if (g_anim[i].gravity) {
-            g_anim[i].vy -= G * dtim;
-        }
+    // Passos maiores que o fixo fariam objetos rápidos atravessarem as bordas.
+    if (dtim > ANIM_FIXED_STEP) dtim = ANIM_FIXED_STEP;
 
-        // Limita a velocidade mxima.
-        float sp = sqrtf(g_anim[i].vx * g_anim[i].vx + g_anim[i].vy * g_anim[i].vy);
-        if (sp > g_anim[i].vmax) {
-            float k = g_anim[i].vmax / (sp + 1e-6f);
-            g_anim[i].vx *= k;
-            g_anim[i].vy *= k;
-        }
+    // A integração move os vértices no mundo diretamente e lê as caixas em
+    // cache, então transformações pendentes (ex: um arrasto) são aplicadas antes.
+    objectsFlushTransforms();
 
-        // 2. Atualiza a posio do objeto.
-        translateObject(i, g_anim[i].vx * dtim, g_anim[i].vy * dtim);
+    // 1-4. Integração e bordas: cada objeto só escreve nos próprios dados,
+    // então cenas grandes são divididas entre as threads do sistema de tarefas.
+    // O resultado é o mesmo com qualquer número de threads.
+    // Só os objetos ativos são percorridos, pela lista densa.
+    if (s_numActive >= ANIM_PARALLEL_MIN_OBJECTS) {
+        jobsParallelFor(s_numActive, ANIM_JOB_GRAIN, integrateRange, &dtim);
+    } else {
+        integrateRange(0, s_numActive, &dtim);
+    }
 
-        // 3. Deteco e resposta de coliso com as bordas da tela.
-        float minx, maxx, miny, maxy;
-        object_aabb(i, &minx, &maxx, &miny, &maxy);
+    // O índice espacial e o renderizador são compartilhados: são avisados
+    // aqui, na thread principal, depois da parte paralela.
+    for (int k = 0; k < s_numActive; k++) {
+        objectCommitMove(s_activeList[k]);
+    }
 
-        if (minx < 0.0f && g_anim[i].vx < 0.0f) {
-            translateObject(i, -minx, 0.0f);
-            g_anim[i].vx = -g_anim[i].vx * g_anim[i].e;
-        }
-        if (maxx > g_windowWidth && g_anim[i].vx > 0.0f) {
-            translateObject(i, g_windowWidth - maxx, 0.0f);
-            g_anim[i].vx = -g_anim[i].vx * g_anim[i].e;
-        }
-        if (miny < 0.0f && g_anim[i].vy < 0.0f) {
-            translateObject(i, 0.0f, -miny);
-            g_anim[i].vy = -g_anim[i].vy * g_anim[i].e;
-        }
-        if (maxy > g_windowHeight && g_anim[i].vy > 0.0f) {
-            translateObject(i, 0.0f, g_windowHeight - maxy);
-            g_anim[i].vy = -g_anim[i].vy * g_anim[i].e;
-        }
+    // 5. Colisões entre os objetos animados, já nas posições novas.
+    collisionStep();
+    profileEnd(PROFILE_ANIM_STEP, profileStart);
+}
+
+int anim_advance(float frameDt) {
+    if (frameDt < 0.0f) frameDt = 0.0f;
+    // Limita o tempo de um quadro ao que cabe nos subpassos permitidos; o
+    // restante (ex: após um carregamento demorado) é simplesmente descartado.
+    if (frameDt > ANIM_MAX_SUBSTEPS * ANIM_FIXED_STEP) {
+        frameDt = ANIM_MAX_SUBSTEPS * ANIM_FIXED_STEP;
+    }
+    s_accumulator += frameDt;
+
+    int steps = 0;
+    while (s_accumulator >= ANIM_FIXED_STEP && steps < ANIM_MAX_SUBSTEPS) {
+        anim_step(ANIM_FIXED_STEP);
+        s_accumulator -= ANIM_FIXED_STEP;
+        steps++;
+    }
+    if (s_accumulator >= ANIM_FIXED_STEP) {
+        s_accumulator = 0.0f;
+    }
+    s_alpha = s_accumulator / ANIM_FIXED_STEP;
+
+    // A posição interpolada muda a cada quadro, mesmo sem passo de física.
+    for (int k = 0; k < s_numActive; k++) {
+        int i = s_activeList[k];
+        renderMarkDirty(g_objects[i].type, g_objects[i].slot);
+    }
+    return steps;
+}
 
-        // 4. Atrito (arrasto) para diminuir a velocidade gradualmente.
-        g_anim[i].vx *= 0.999f;
-        g_anim[i].vy *= 0.999f;
+void anim_render_offset(int idx, float* dx, float* dy) {
+    // A cena guarda o estado do último passo; o desenho fica entre ele e o
+    // anterior, 'alpha' do caminho percorrido no passo.
+    if (g_anim[idx].active) {
+        *dx = (s_alpha - 1.0f) * g_anim[idx].stepDx;
+        *dy = (s_alpha - 1.0f) * g_anim[idx].stepDy;
+    } else {
+        *dx = 0.0f;
+        *dy = 0.0f;
     }
 }
 
-void anim_on_remove_compact(int removed_idx) {
-    // Desloca todos os slots de animao para preencher o espao do objeto removido.
-    for (int i = removed_idx; i < g_numObjects; i++) {
-        g_anim[i] = g_anim[i + 1];
+int anim_active_count(void) {
+    return s_numActive;
+}
+
+const int* anim_active_indices(void) {
+    return s_activeList;
+}
+
+void anim_on_remove_swap(int removed_idx, int last_idx) {
+    // Acompanha a remoção em 'objects.c': o slot do último objeto ocupa o lugar do removido.
+    deactivate(removed_idx);
+    if (removed_idx != last_idx) {
+        g_anim[removed_idx] = g_anim[last_idx];
+        if (g_anim[removed_idx].active) {
+            // O objeto movido continua na lista, agora com o índice novo.
+            int pos = s_activePos[last_idx];
+            s_activeList[pos] = removed_idx;
+            s_activePos[removed_idx] = pos;
+            s_activePos[last_idx] = -1;
+            collisionRename(last_idx, removed_idx);
+        }
     }
-    // Zera o ltimo slot que ficou sobrando para evitar dados fantasmas.
-    if (g_numObjects >= 0 && g_numObjects < MAX_OBJECTS) {
-        g_anim[g_numObjects] = (AnimSlot){0};
+    // Zera o último slot que ficou sobrando para evitar dados fantasmas.
+    if (last_idx >= 0 && last_idx < s_animCapacity) {
+        g_anim[last_idx] = (AnimSlot){0};
     }
 }
@@ -1,9 +1,12 @@
 /**
  * @file animation.h
- * @brief Define a interface e as estruturas para o sistema de animao baseado em fsica.
+ * @brief Define a interface e as estruturas para o sistema de animação baseado em física.
  *
- * Este mdulo gerencia o estado da animao de cada objeto, permitindo
- * movimento, colises com as bordas da tela e efeitos como gravidade.
+ * Este módulo gerencia o estado da animação de cada objeto, permitindo
+ * movimento, colisões com as bordas da tela e efeitos como gravidade.
+ *
+ * A simulação avança sempre em passos fixos de ANIM_FIXED_STEP segundos; o
+ * desenho interpola as posições entre os dois últimos passos.
  */
 
 #ifndef ANIMATION_H
@@ -11,39 +14,46 @@
 
 #include "config.h"
 
-// --- SEO DE ESTRUTURAS DE DADOS ---
+// --- SEÇÃO DE ESTRUTURAS DE DADOS ---
 
 /**
- * @brief Armazena o estado de animao de um nico objeto.
+ * @brief Armazena o estado de animação de um único objeto.
  *
  * Cada objeto na cena pode ter um 'AnimSlot' correspondente que dita
- * seu comportamento fsico a cada passo de tempo.
+ * seu comportamento físico a cada passo de tempo.
  */
 typedef struct {
-    int   active;     ///< Flag que indica se a animao est ativa (1) ou inativa (0).
+    int   active;     ///< Flag que indica se a animação está ativa (1) ou inativa (0).
     float vx, vy;     ///< Componentes da velocidade do objeto (pixels por segundo).
-    float e;          ///< Coeficiente de restituio (elasticidade) para colises (0.0 a 1.0).
-    int   gravity;    ///< Flag que indica se a gravidade deve ser aplicada (1) ou no (0).
-    float vmax;       ///< Velocidade mxima permitida para o objeto (pixels por segundo).
+    float e;          ///< Coeficiente de restituição (elasticidade) para colisões (0.0 a 1.0).
+    int   gravity;    ///< Flag que indica se a gravidade deve ser aplicada (1) ou não (0).
+    float vmax;       ///< Velocidade máxima permitida para o objeto (pixels por segundo).
+    float stepDx;     ///< Deslocamento em X no último passo (usado na interpolação do desenho).
+    float stepDy;     ///< Deslocamento em Y no último passo.
 } AnimSlot;
 
-// --- SEO DE VARIVEIS GLOBAIS (DECLARAES) ---
+// --- SEÇÃO DE VARIÁVEIS GLOBAIS (DECLARAÇÕES) ---
 
-extern AnimSlot g_anim[MAX_OBJECTS]; ///< Array que armazena o estado da animao de cada objeto.
+extern AnimSlot* g_anim; ///< Array (paralelo a 'g_objects') com o estado da animação de cada objeto.
 
-// --- SEO DE PROTTIPOS DE FUNES PBLICAS ---
+// --- SEÇÃO DE PROTÓTIPOS DE FUNÇÕES PÚBLICAS ---
 
-// Funes de inicializao e controle de estado
+// Funções de inicialização e controle de estado
 void anim_init_all(void);
+int  anim_reserve(int capacity);
 void anim_enable(int idx, float vx, float vy, float e, int gravity);
 void anim_disable(int idx);
 void anim_toggle_selected(void);
 
-// Funes de interao
+// Funções de interação
 void anim_kick_towards_mouse(float speed);
 
-// Funes do loop principal e de manuteno
+// Funções do loop principal e de manutenção
 void anim_step(float dt);
-void anim_on_remove_compact(int removed_idx);
+int  anim_advance(float frameDt);
+void anim_render_offset(int idx, float* dx, float* dy);
+void anim_on_remove_swap(int removed_idx, int last_idx);
+int  anim_active_count(void);
+const int* anim_active_indices(void); ///< Os índices dos 'anim_active_count()' objetos ativos, sem ordem definida.
 
 #endif // ANIMATION_H
@@ -0,0 +1,647 @@
+/**
+ * @file batch.c
+ * @brief Implementação do modo em lote: leitura do roteiro, lista de cenas e processos trabalhadores.
+ *
+ * O roteiro é lido uma única vez, antes de qualquer cena. Cada cena é
+ * carregada, recebe as operações em ordem e é descartada pela próxima. Com
+ * mais de uma cena e mais de um processador, os trabalhadores são processos
+ * criados com fork(): cada um pega a próxima cena de um contador em memória
+ * compartilhada e anota o resultado dela em um array também compartilhado,
+ * então uma cena que derruba o seu processo aparece como falha no resumo.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "batch.h"
+#include "config.h"
+#include "objects.h"
+#include "polygon.h"
+#include "transformations.h"
+#include "convexhull.h"
+#include "animation.h"
+#include "file_io.h"
+#include "history.h"
+#include "jobs.h"
+#include "rasterizer.h"
+#include "image_io.h"
+
+// --- SEÇÃO DE CONSTANTES PRIVADAS ---
+
+#define BATCH_LINE_SIZE 1024        ///< Tamanho máximo de uma linha do roteiro.
+#define BATCH_MAX_TOKENS 8          ///< Máximo de palavras em uma linha do roteiro.
+#define BATCH_NAME_TOKEN "{name}"   ///< Trocado pelo nome da cena em "save" e "export".
+
+/// O resultado de cada cena, no array compartilhado com os trabalhadores.
+#define BATCH_SCENE_PENDING 0
+#define BATCH_SCENE_OK 1
+#define BATCH_SCENE_FAILED 2
+
+// --- SEÇÃO DE ESTRUTURAS PRIVADAS ---
+
+typedef enum {
+    BATCH_OP_SELECT,
+    BATCH_OP_TRANSLATE,
+    BATCH_OP_ROTATE,
+    BATCH_OP_SCALE,
+    BATCH_OP_REFLECT,
+    BATCH_OP_SHEAR,
+    BATCH_OP_HULL,
+    BATCH_OP_HULL_UNION,
+    BATCH_OP_ANIMATE,
+    BATCH_OP_STEP,
+    BATCH_OP_SAVE,
+    BATCH_OP_EXPORT
+} BatchOpType;
+
+/// Os filtros de "select" (os tipos de objeto usam os valores de ObjectType).
+#define BATCH_SELECT_ALL -1
+#define BATCH_SELECT_NONE -2
+
+/**
+ * @brief Uma operação do roteiro, já convertida.
+ */
+typedef struct {
+    BatchOpType type;
+    int line;               ///< A linha do roteiro, para as mensagens de erro.
+    float x, y, z;          ///< Os argumentos numéricos (deslocamento, ângulo, fatores, velocidade, elasticidade).
+    int n;                  ///< Filtro de "select", eixo de "reflect", passos de "step", gravidade de "animate", preenchimento de "export".
+    int width, height;      ///< O tamanho da imagem de "export".
+    char* path;             ///< O arquivo de "save" e "export" (com BATCH_NAME_TOKEN).
+} BatchOp;
+
+// --- SEÇÃO DE VARIÁVEIS PRIVADAS ---
+
+static BatchOp* s_ops = NULL;
+static int s_numOps = 0;
+static int s_opsCapacity = 0;
+
+static char** s_scenes = NULL;
+static int s_numScenes = 0;
+static int s_scenesCapacity = 0;
+
+// --- SEÇÃO DE LEITURA DO ROTEIRO ---
+
+static int parseFloat(const char* text, float* value) {
+    char* end;
+    *value = strtof(text, &end);
+    return end != text && *end == '\0';
+}
+
+static int parseInt(const char* text, int* value) {
+    char* end;
+    long v = strtol(text, &end, 10);
+    *value = (int)v;
+    return end != text && *end == '\0';
+}
+
+static char* duplicateString(const char* text) {
+    size_t length = strlen(text) + 1;
+    char* copy = (char*)malloc(length);
+    if (copy) memcpy(copy, text, length);
+    return copy;
+}
+
+/**
+ * @brief Converte as palavras de uma linha em uma operação.
+ * @return int 1 em caso de sucesso, 0 se a operação ou os seus argumentos são inválidos.
+ */
+static int parseOperation(char** tokens, int numTokens, BatchOp* op) {
+    const char* name = tokens[0];
+    int numArgs = numTokens - 1;
+    memset(op, 0, sizeof(*op));
+
+    if (strcmp(name, "select") == 0 && numArgs == 1) {
+        op->type = BATCH_OP_SELECT;
+        if (strcmp(tokens[1], "all") == 0) op->n = BATCH_SELECT_ALL;
+        else if (strcmp(tokens[1], "none") == 0) op->n = BATCH_SELECT_NONE;
+        else if (strcmp(tokens[1], "points") == 0) op->n = OBJECT_TYPE_POINT;
+        else if (strcmp(tokens[1], "segments") == 0) op->n = OBJECT_TYPE_SEGMENT;
+        else if (strcmp(tokens[1], "polygons") == 0) op->n = OBJECT_TYPE_POLYGON;
+        else return 0;
+        return 1;
+    }
+    if (strcmp(name, "translate") == 0 && numArgs == 2) {
+        op->type = BATCH_OP_TRANSLATE;
+        return parseFloat(tokens[1], &op->x) && parseFloat(tokens[2], &op->y);
+    }
+    if (strcmp(name, "rotate") == 0 && numArgs == 1) {
+        op->type = BATCH_OP_ROTATE;
+        return parseFloat(tokens[1], &op->x);
+    }
+    if (strcmp(name, "scale") == 0 && (numArgs == 1 || numArgs == 2)) {
+        op->type = BATCH_OP_SCALE;
+        if (!parseFloat(tokens[1], &op->x)) return 0;
+        op->y = op->x;
+        return numArgs == 1 || parseFloat(tokens[2], &op->y);
+    }
+    if (strcmp(name, "reflect") == 0 && numArgs == 1) {
+        op->type = BATCH_OP_REFLECT;
+        if (strcmp(tokens[1], "x") == 0) op->n = 0;
+        else if (strcmp(tokens[1], "y") == 0) op->n = 1;
+        else return 0;
+        return 1;
+    }
+    if (strcmp(name, "shear") == 0 && numArgs == 2) {
+        op->type = BATCH_OP_SHEAR;
+        return parseFloat(tokens[1], &op->x) && parseFloat(tokens[2], &op->y);
+    }
+    if (strcmp(name, "hull") == 0 && numArgs == 0) {
+        op->type = BATCH_OP_HULL;
+        return 1;
+    }
+    if (strcmp(name, "hull-union") == 0 && numArgs == 0) {
+        op->type = BATCH_OP_HULL_UNION;
+        return 1;
+    }
+    if (strcmp(name, "animate") == 0 && numArgs >= 2 && numArgs <= 4) {
+        // Os mesmos padrões da tecla 'b'.
+        op->type = BATCH_OP_ANIMATE;
+        op->z = 0.90f;
+        op->n = 1;
+        return parseFloat(tokens[1], &op->x) && parseFloat(tokens[2], &op->y) &&
+               (numArgs < 3 || parseFloat(tokens[3], &op->z)) &&
+               (numArgs < 4 || (parseInt(tokens[4], &op->n) && (op->n == 0 || op->n == 1)));
+    }
+    if (strcmp(name, "step") == 0 && numArgs == 1) {
+        op->type = BATCH_OP_STEP;
+        return parseInt(tokens[1], &op->n) && op->n >= 0;
+    }
+    if (strcmp(name, "save") == 0 && numArgs == 1) {
+        op->type = BATCH_OP_SAVE;
+        op->path = duplicateString(tokens[1]);
+        return op->path != NULL;
+    }
+    if (strcmp(name, "export") == 0 && numArgs >= 1 && numArgs <= 4) {
+        op->type = BATCH_OP_EXPORT;
+        op->n = strcmp(tokens[numTokens - 1], "fill") == 0;
+        int numSizes = numArgs - 1 - op->n;
+        op->width = WINDOW_WIDTH;
+        op->height = WINDOW_HEIGHT;
+        if (numSizes == 2) {
+            if (!parseInt(tokens[2], &op->width) || !parseInt(tokens[3], &op->height)) return 0;
+            if (op->width <= 0 || op->height <= 0) return 0;
+        } else if (numSizes != 0) {
+            return 0;
+        }
+        op->path = duplicateString(tokens[1]);
+        return op->path != NULL;
+    }
+    return 0;
+}
+
+static void freeScript(void) {
+    for (int k = 0; k < s_numOps; k++) {
+        free(s_ops[k].path);
+    }
+    free(s_ops);
+    s_ops = NULL;
+    s_numOps = s_opsCapacity = 0;
+}
+
+/**
+ * @brief Lê o roteiro inteiro para 's_ops'.
+ * @return int 1 em caso de sucesso, 0 se o arquivo não pode ser lido ou tem uma linha inválida.
+ */
+static int loadScript(const char* filename) {
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        fprintf(stderr, "[Batch ERROR] Nao foi possivel abrir o roteiro '%s'.\n", filename);
+        return 0;
+    }
+
+    char line[BATCH_LINE_SIZE];
+    int lineNumber = 0;
+    int ok = 1;
+    while (ok && fgets(line, sizeof(line), file)) {
+        lineNumber++;
+        char* comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+
+        char* tokens[BATCH_MAX_TOKENS + 1];
+        int numTokens = 0;
+        for (char* token = strtok(line, " \t\r\n"); token; token = strtok(NULL, " \t\r\n")) {
+            if (numTokens == BATCH_MAX_TOKENS + 1) break;
+            tokens[numTokens++] = token;
+        }
+        if (numTokens == 0) continue;
+
+        if (s_numOps == s_opsCapacity) {
+            int newCapacity = s_opsCapacity > 0 ? s_opsCapacity * 2 : 16;
+            BatchOp* ops = (BatchOp*)realloc(s_ops, newCapacity * sizeof(BatchOp));
+            if (!ops) {
+                fprintf(stderr, "[Batch ERROR] Memoria insuficiente para o roteiro.\n");
+                ok = 0;
+                break;
+            }
+            s_ops = ops;
+            s_opsCapacity = newCapacity;
+        }
+        BatchOp* op = &s_ops[s_numOps];
+        if (numTokens > BATCH_MAX_TOKENS || !parseOperation(tokens, numTokens, op)) {
+            fprintf(stderr, "[Batch ERROR] %s:%d: operacao invalida '%s'.\n", filename, lineNumber, tokens[0]);
+            if (numTokens <= BATCH_MAX_TOKENS) free(op->path);
+            ok = 0;
+            break;
+        }
+        op->line = lineNumber;
+        s_numOps++;
+    }
+    fclose(file);
+    return ok;
+}
+
+// --- SEÇÃO DA LISTA DE CENAS ---
+
+static int addScene(const char* filename) {
+    if (s_numScenes == s_scenesCapacity) {
+        int newCapacity = s_scenesCapacity > 0 ? s_scenesCapacity * 2 : 64;
+        char** scenes = (char**)realloc(s_scenes, newCapacity * sizeof(char*));
+        if (!scenes) {
+            fprintf(stderr, "[Batch ERROR] Memoria insuficiente para a lista de cenas.\n");
+            return 0;
+        }
+        s_scenes = scenes;
+        s_scenesCapacity = newCapacity;
+    }
+    s_scenes[s_numScenes] = duplicateString(filename);
+    if (!s_scenes[s_numScenes]) {
+        fprintf(stderr, "[Batch ERROR] Memoria insuficiente para a lista de cenas.\n");
+        return 0;
+    }
+    s_numScenes++;
+    return 1;
+}
+
+static void freeScenes(void) {
+    for (int k = 0; k < s_numScenes; k++) {
+        free(s_scenes[k]);
+    }
+    free(s_scenes);
+    s_scenes = NULL;
+    s_numScenes = s_scenesCapacity = 0;
+}
+
+/**
+ * @brief Indica se um arquivo é uma cena, pela extensão.
+ */
+static int isSceneFile(const char* filename) {
+    const char* dot = strrchr(filename, '.');
+    return dot && (strcmp(dot, ".txt") == 0 || strcmp(dot, SCENE_BINARY_EXTENSION) == 0);
+}
+
+/**
+ * @brief Junta a pasta e o nome de um arquivo e acrescenta o resultado à lista de cenas.
+ */
+static int addSceneInDirectory(const char* directory, const char* name) {
+    size_t dirLength = strlen(directory);
+    size_t nameLength = strlen(name);
+    char* path = (char*)malloc(dirLength + nameLength + 2);
+    if (!path) {
+        fprintf(stderr, "[Batch ERROR] Memoria insuficiente para a lista de cenas.\n");
+        return 0;
+    }
+    memcpy(path, directory, dirLength);
+    if (dirLength > 0 && directory[dirLength - 1] != '/' && directory[dirLength - 1] != '\\') {
+        path[dirLength++] = '/';
+    }
+    memcpy(path + dirLength, name, nameLength + 1);
+    int ok = addScene(path);
+    free(path);
+    return ok;
+}
+
+static int compareSceneNames(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+/**
+ * @brief Acrescenta uma cena, ou todas as cenas de uma pasta em ordem alfabética.
+ * @return int 1 em caso de sucesso, 0 se a pasta não pode ser lida ou faltou memória.
+ */
+static int addInput(const char* input) {
+    int first = s_numScenes;
+    int ok = 1;
+#ifdef _WIN32
+    DWORD attributes = GetFileAttributesA(input);
+    if (attributes == INVALID_FILE_ATTRIBUTES || !(attributes & FILE_ATTRIBUTE_DIRECTORY)) {
+        return addScene(input);
+    }
+    char pattern[MAX_PATH];
+    snprintf(pattern, sizeof(pattern), "%s\\*", input);
+    WIN32_FIND_DATAA entry;
+    HANDLE find = FindFirstFileA(pattern, &entry);
+    if (find == INVALID_HANDLE_VALUE) {
+        fprintf(stderr, "[Batch ERROR] Nao foi possivel ler a pasta '%s'.\n", input);
+        return 0;
+    }
+    do {
+        if (!(entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && isSceneFile(entry.cFileName)) {
+            ok = addSceneInDirectory(input, entry.cFileName);
+        }
+    } while (ok && FindNextFileA(find, &entry));
+    FindClose(find);
+#else
+    struct stat info;
+    if (stat(input, &info) != 0 || !S_ISDIR(info.st_mode)) {
+        return addScene(input);
+    }
+    DIR* dir = opendir(input);
+    if (!dir) {
+        fprintf(stderr, "[Batch ERROR] Nao foi possivel ler a pasta '%s'.\n", input);
+        return 0;
+    }
+    struct dirent* entry;
+    while (ok && (entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] != '.' && isSceneFile(entry->d_name)) {
+            ok = addSceneInDirectory(input, entry->d_name);
+        }
+    }
+    closedir(dir);
+#endif
+    // A ordem do sistema de arquivos não é definida; a ordem alfabética deixa o resumo estável.
+    qsort(s_scenes + first, s_numScenes - first, sizeof(char*), compareSceneNames);
+    return ok;
+}
+
+// --- SEÇÃO DE EXECUÇÃO DAS OPERAÇÕES ---
+
+/**
+ * @brief Copia o nome do arquivo da cena, sem a pasta e sem a extensão.
+ */
+static void sceneBaseName(const char* sceneFile, char* name, size_t size) {
+    const char* start = sceneFile;
+    for (const char* c = sceneFile; *c; c++) {
+        if (*c == '/' || *c == '\\') start = c + 1;
+    }
+    const char* dot = strrchr(start, '.');
+    size_t length = dot && dot != start ? (size_t)(dot - start) : strlen(start);
+    if (length >= size) length = size - 1;
+    memcpy(name, start, length);
+    name[length] = '\0';
+}
+
+/**
+ * @brief Troca cada BATCH_NAME_TOKEN de 'pattern' pelo nome da cena.
+ * @return int 1 em caso de sucesso, 0 se o resultado não cabe em 'out'.
+ */
+static int expandPath(const char* pattern, const char* name, char* out, size_t size) {
+    size_t tokenLength = strlen(BATCH_NAME_TOKEN);
+    size_t nameLength = strlen(name);
+    size_t length = 0;
+    while (*pattern) {
+        const char* piece = pattern;
+        size_t pieceLength = 1;
+        if (strncmp(pattern, BATCH_NAME_TOKEN, tokenLength) == 0) {
+            piece = name;
+            pieceLength = nameLength;
+            pattern += tokenLength;
+        } else {
+            pattern++;
+        }
+        if (length + pieceLength >= size) return 0;
+        memcpy(out + length, piece, pieceLength);
+        length += pieceLength;
+    }
+    out[length] = '\0';
+    return 1;
+}
+
+static void selectByType(int filter) {
+    selectionClear();
+    if (filter == BATCH_SELECT_NONE) return;
+    for (int i = 0; i < g_numObjects; i++) {
+        if (filter == BATCH_SELECT_ALL || (int)g_objects[i].type == filter) {
+            selectionAdd(i);
+        }
+    }
+}
+
+static int saveScene(const char* filename) {
+    SceneSnapshot snap;
+    snapshotInit(&snap);
+    int ok = snapshotCapture(&snap) && writeSceneFile(&snap, filename, NULL);
+    snapshotFree(&snap);
+    if (!ok) {
+        fprintf(stderr, "[Batch ERROR] Falha ao salvar a cena em '%s'.\n", filename);
+    }
+    return ok;
+}
+
+static int exportScene(const char* filename, const BatchOp* op) {
+    RasterImage image;
+    if (!rasterImageInit(&image, op->width, op->height)) return 0;
+    RasterView view = rasterFitView(op->width, op->height);
+    view.fillPolygons = op->n;
+    int ok = rasterRenderScene(&image, &view) &&
+             imageWriteFile(filename, image.pixels, image.width, image.height);
+    rasterImageFree(&image);
+    return ok;
+}
+
+/**
+ * @brief Aplica uma operação à cena atual.
+ * @param name O nome da cena, para BATCH_NAME_TOKEN.
+ * @return int 1 em caso de sucesso, 0 em caso de erro.
+ */
+static int runOperation(const BatchOp* op, const char* name) {
+    char path[BATCH_LINE_SIZE];
+    switch (op->type) {
+        case BATCH_OP_SELECT:    selectByType(op->n); return 1;
+        case BATCH_OP_TRANSLATE: translateSelection(op->x, op->y); return 1;
+        case BATCH_OP_ROTATE:    rotateSelection(op->x); return 1;
+        case BATCH_OP_SCALE:     scaleSelection(op->x, op->y); return 1;
+        case BATCH_OP_REFLECT:   reflectSelection(op->n); return 1;
+        case BATCH_OP_SHEAR:     shearSelection(op->x, op->y); return 1;
+        case BATCH_OP_HULL:
+            // Polígonos colineares e objetos que não são polígonos ficam como estão.
+            for (int k = 0; k < g_numSelected; k++) convexHullReplaceObject(g_selection[k]);
+            return 1;
+
+        case BATCH_OP_HULL_UNION: {
+            if (g_numSelected == 0) return 1;
+            int created = convexHullAddObjectsHull(g_selection, g_numSelected);
+            if (created >= 0) selectSingleObject(created);
+            return 1;
+        }
+
+        case BATCH_OP_ANIMATE:
+            for (int k = 0; k < g_numSelected; k++) {
+                anim_enable(g_selection[k], op->x, op->y, op->z, op->n);
+            }
+            return 1;
+
+        case BATCH_OP_STEP:
+            for (int i = 0; i < op->n; i++) {
+                anim_step(ANIM_FIXED_STEP);
+            }
+            return 1;
+
+        case BATCH_OP_SAVE:
+        case BATCH_OP_EXPORT:
+            if (!expandPath(op->path, name, path, sizeof(path))) {
+                fprintf(stderr, "[Batch ERROR] O nome '%s' ficou longo demais.\n", op->path);
+                return 0;
+            }
+            return op->type == BATCH_OP_SAVE ? saveScene(path) : exportScene(path, op);
+    }
+    return 0;
+}
+
+/**
+ * @brief Carrega uma cena e aplica o roteiro inteiro a ela.
+ * @return int 1 em caso de sucesso, 0 se a cena não pode ser lida ou uma operação falhou.
+ */
+static int processScene(const char* sceneFile) {
+    double start = jobsWallTime();
+    SceneSnapshot snap;
+    snapshotInit(&snap);
+    int ok = readSceneFile(sceneFile, &snap, NULL);
+    if (ok) snapshotInstall(&snap);
+    snapshotFree(&snap);
+    if (!ok) {
+        fprintf(stderr, "[Batch ERROR] A cena '%s' nao pode ser lida.\n", sceneFile);
+        return 0;
+    }
+
+    char name[BATCH_LINE_SIZE];
+    sceneBaseName(sceneFile, name, sizeof(name));
+    selectByType(BATCH_SELECT_ALL);
+    for (int k = 0; k < s_numOps; k++) {
+        if (!runOperation(&s_ops[k], name)) {
+            fprintf(stderr, "[Batch ERROR] '%s': a operacao da linha %d falhou.\n", sceneFile, s_ops[k].line);
+            return 0;
+        }
+    }
+    printf("[BATCH] '%s': %d objetos, %.1f ms\n", sceneFile, g_numObjects, (jobsWallTime() - start) * 1000.0);
+    fflush(stdout);
+    return 1;
+}
+
+/**
+ * @brief Processa cenas até a lista acabar, pegando a próxima de 'next'.
+ */
+static void processScenes(atomic_int* next, unsigned char* results) {
+    for (;;) {
+        int k = atomic_fetch_add(next, 1);
+        if (k >= s_numScenes) break;
+        results[k] = processScene(s_scenes[k]) ? BATCH_SCENE_OK : BATCH_SCENE_FAILED;
+    }
+}
+
+/**
+ * @brief Processa todas as cenas com 'numWorkers' processos.
+ *
+ * Fora do POSIX, ou com um único trabalhador, as cenas são processadas neste
+ * processo, em sequência, com todas as threads.
+ * @param results Recebe o resultado de cada cena (BATCH_SCENE_*).
+ * @return int O número de processos usados.
+ */
+static int runWorkers(int numWorkers, unsigned char* results) {
+#ifndef _WIN32
+    if (numWorkers > 1) {
+        // O contador e os resultados ficam em memória compartilhada com os filhos.
+        size_t sharedSize = sizeof(atomic_int) + (size_t)s_numScenes;
+        void* shared = mmap(NULL, sharedSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (shared != MAP_FAILED) {
+            atomic_int* next = (atomic_int*)shared;
+            unsigned char* sharedResults = (unsigned char*)shared + sizeof(atomic_int);
+            atomic_init(next, 0);
+
+            // As threads do sistema de tarefas não sobrevivem ao fork(): o pai
+            // fica só com a principal e cada filho cria a sua parte das threads.
+            int numThreads = jobsThreadCount();
+            int threadsPerWorker = numThreads / numWorkers > 1 ? numThreads / numWorkers : 1;
+            jobsInit(1);
+            fflush(stdout);
+            fflush(stderr);
+
+            int started = 0;
+            for (int w = 0; w < numWorkers; w++) {
+                pid_t pid = fork();
+                if (pid == 0) {
+                    jobsInit(threadsPerWorker);
+                    processScenes(next, sharedResults);
+                    fflush(stdout);
+                    _exit(0); // Sem os atexit() do pai: a memória volta ao sistema com o processo.
+                }
+                if (pid < 0) {
+                    fprintf(stderr, "[Batch ERROR] Falha ao criar o processo %d; usando %d.\n", w, started);
+                    break;
+                }
+                started++;
+            }
+            while (started > 0 && wait(NULL) > 0) {
+            }
+            // Sem nenhum filho, o próprio pai processa as cenas.
+            if (started == 0) processScenes(next, sharedResults);
+
+            memcpy(results, sharedResults, s_numScenes);
+            munmap(shared, sharedSize);
+            jobsInit(numThreads);
+            return started > 0 ? started : 1;
+        }
+        fprintf(stderr, "[Batch ERROR] Falha ao criar a memoria compartilhada; processando em sequencia.\n");
+    }
+#endif
+    atomic_int next;
+    atomic_init(&next, 0);
+    processScenes(&next, results);
+    return 1;
+}
+
+// --- SEÇÃO DE FUNÇÕES PÚBLICAS ---
+
+int batchRun(const char* scriptFile, char** inputs, int numInputs, int maxWorkers) {
+    int ok = loadScript(scriptFile);
+    for (int k = 0; ok && k < numInputs; k++) {
+        ok = addInput(inputs[k]);
+    }
+    if (ok && s_numScenes == 0) {
+        fprintf(stderr, "[Batch ERROR] Nenhuma cena encontrada.\n");
+        ok = 0;
+    }
+    unsigned char* results = ok ? (unsigned char*)calloc(s_numScenes, 1) : NULL;
+    if (ok && !results) {
+        fprintf(stderr, "[Batch ERROR] Memoria insuficiente para a lista de cenas.\n");
+        ok = 0;
+    }
+
+    if (ok) {
+        // Nada do lote é desfeito; o histórico só gastaria memória.
+        historySetRecording(0);
+
+        int numWorkers = maxWorkers > 0 ? maxWorkers : jobsHardwareThreads();
+        if (numWorkers > s_numScenes) numWorkers = s_numScenes;
+        double start = jobsWallTime();
+        numWorkers = runWorkers(numWorkers, results);
+        double seconds = jobsWallTime() - start;
+
+        int numFailed = 0;
+        for (int k = 0; k < s_numScenes; k++) {
+            if (results[k] == BATCH_SCENE_PENDING) {
+                fprintf(stderr, "[Batch ERROR] A cena '%s' nao terminou (o processo trabalhador foi interrompido).\n", s_scenes[k]);
+            }
+            if (results[k] != BATCH_SCENE_OK) numFailed++;
+        }
+        printf("[BATCH] %d cenas, %d com erro, %.1f s (%d processos)\n", s_numScenes, numFailed, seconds, numWorkers);
+        ok = numFailed == 0;
+        historySetRecording(1);
+    }
+
+    free(results);
+    freeScenes();
+    freeScript();
+    return ok;
+}
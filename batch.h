@@ -0,0 +1,52 @@
+/**
+ * @file batch.h
+ * @brief Define a interface do modo em lote, que processa cenas sem janela a partir de um roteiro.
+ *
+ * Um roteiro é um arquivo de texto com uma operação por linha, aplicada em
+ * ordem a cada cena. Linhas vazias e o que vem depois de '#' são ignorados.
+ * Ao ser carregada, a cena inteira fica selecionada.
+ *
+ *     select all|none|points|segments|polygons   Troca a seleção.
+ *     translate <dx> <dy>                         Translada a seleção.
+ *     rotate <graus>                              Rotaciona a seleção em torno do seu centro.
+ *     scale <sx> [<sy>]                           Aplica uma escala a partir do centro da seleção.
+ *     reflect x|y                                 Reflete a seleção no eixo.
+ *     shear <shx> <shy>                           Cisalha a seleção.
+ *     hull                                        Troca cada polígono selecionado pelo seu fecho convexo.
+ *     hull-union                                  Cria o fecho da união da seleção, que passa a ser a seleção.
+ *     animate <vx> <vy> [<elasticidade> [0|1]]    Anima a seleção (o último valor liga a gravidade).
+ *     step <passos>                               Avança passos fixos de ANIM_FIXED_STEP segundos.
+ *     save <arquivo>                              Salva a cena (o formato segue a extensão).
+ *     export <imagem> [<largura> <altura>] [fill] Desenha a cena com o rasterizador e grava a imagem.
+ *
+ * As transformações seguem as mesmas regras do editor: um ponto selecionado
+ * sozinho gira em torno da origem, e não do próprio centro.
+ *
+ * Em "save" e "export", "{name}" é trocado pelo nome do arquivo da cena sem
+ * a extensão (ex: "saida/{name}.png").
+ *
+ * Como a cena é global, as cenas são distribuídas entre processos
+ * trabalhadores, um por cena de cada vez; cada processo divide as threads
+ * da máquina com os demais.
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+// --- SEÇÃO DE PROTÓTIPOS DE FUNÇÕES PÚBLICAS ---
+
+/**
+ * @brief Aplica um roteiro a uma lista de cenas e de pastas de cenas.
+ *
+ * Uma pasta contribui com todos os arquivos de cena (".txt" e
+ * SCENE_BINARY_EXTENSION) que estão nela, em ordem alfabética. Uma cena que
+ * falha não interrompe as outras.
+ * @param scriptFile O arquivo do roteiro.
+ * @param inputs Os nomes das cenas e das pastas.
+ * @param numInputs A quantidade de nomes.
+ * @param maxWorkers O máximo de processos trabalhadores (0 para um por processador).
+ * @return int 1 se todas as cenas foram processadas, 0 se o roteiro é inválido ou alguma cena falhou.
+ */
+int batchRun(const char* scriptFile, char** inputs, int numInputs, int maxWorkers);
+
+#endif // BATCH_H
@@ -0,0 +1,488 @@
+/**
+ * @file benchmark.c
+ * @brief Implementação da suíte de benchmarks.
+ *
+ * Cada medição roda os mesmos caminhos da janela (as funções de seleção,
+ * de transformação, de fecho, de arquivo e de animação), na mesma ordem e
+ * com os mesmos sorteios em toda execução. O histórico de desfazer fica
+ * desligado durante a suíte, para que as medições não dependam do seu
+ * limite de memória.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "benchmark.h"
+#include "config.h"
+#include "objects.h"
+#include "polygon.h"
+#include "transformations.h"
+#include "convexhull.h"
+#include "animation.h"
+#include "file_io.h"
+#include "history.h"
+#include "input.h"
+#include "jobs.h"
+#include "scenegen.h"
+#include "utils.h"
+
+// --- SEÇÃO DE CONSTANTES PRIVADAS ---
+
+#define BENCH_SUITE_SEED 20240501ULL        ///< Semente das cenas e dos cliques.
+#define BENCH_PICK_CLICKS 10000             ///< Cliques de seleção por escala.
+#define BENCH_TRANSFORM_REPETITIONS 4       ///< Vezes que cada transformação é aplicada à cena inteira.
+#define BENCH_ANIMATED_FRACTION 0.1f        ///< Fração dos objetos animados no passo da animação.
+#define BENCH_ANIM_STEPS 20                 ///< Passos fixos medidos por escala.
+#define BENCH_REMOVE_DIVISOR 10             ///< Remove 1/BENCH_REMOVE_DIVISOR dos objetos.
+#define BENCH_LAYOUT_FRAMES 20              ///< Quadros medidos em cada layout da geometria.
+
+extern int g_windowWidth;
+extern int g_windowHeight;
+
+// --- SEÇÃO DE ESTRUTURAS E TIPOS PRIVADOS ---
+
+/**
+ * @brief Um objeto no layout anterior aos arrays por tipo: a geometria em um
+ * bloco próprio de malloc(), acessada por 'void*'.
+ */
+typedef struct {
+    ObjectType type;
+    void* data;
+} LegacyObject;
+
+// --- SEÇÃO DE FUNÇÕES AUXILIARES ---
+
+/**
+ * @brief Acumula bytes em uma soma de verificação FNV-1a de 64 bits.
+ */
+static unsigned long long hashBytes(unsigned long long hash, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Calcula a soma de verificação da geometria no mundo da cena atual.
+ */
+static unsigned long long geometryHash(void) {
+    objectsFlushTransforms();
+    unsigned long long hash = 1469598103934665603ULL;
+    hash = hashBytes(hash, g_points, g_numPoints * sizeof(Point));
+    hash = hashBytes(hash, g_segments, g_numSegments * sizeof(Segment));
+    for (int k = 0; k < g_numPolygons; k++) {
+        hash = hashBytes(hash, g_polygons[k].vertices, g_polygons[k].numVertices * sizeof(Point));
+    }
+    return hash;
+}
+
+/**
+ * @brief Calcula a soma de verificação da geometria de um snapshot.
+ */
+static unsigned long long snapshotHash(const SceneSnapshot* snap) {
+    unsigned long long hash = 1469598103934665603ULL;
+    hash = hashBytes(hash, snap->points, snap->numPoints * sizeof(Point));
+    hash = hashBytes(hash, snap->segments, snap->numSegments * sizeof(Segment));
+    hash = hashBytes(hash, snap->vertices, snap->numVertices * sizeof(Point));
+    return hash;
+}
+
+static void report(FILE* out, int scale, const char* name, long long operations, double seconds, const char* result) {
+    fprintf(out, "%d,%s,%lld,%.3f,%.1f,%s\n", scale, name, operations, seconds * 1000.0,
+            operations > 0 ? seconds * 1e9 / operations : 0.0, result);
+    fflush(out);
+}
+
+static void reportCount(FILE* out, int scale, const char* name, long long operations, double seconds, long long result) {
+    char text[32];
+    snprintf(text, sizeof(text), "%lld", result);
+    report(out, scale, name, operations, seconds, text);
+}
+
+static void reportHash(FILE* out, int scale, const char* name, long long operations, double seconds, unsigned long long hash) {
+    char text[32];
+    snprintf(text, sizeof(text), "%016llx", hash);
+    report(out, scale, name, operations, seconds, text);
+}
+
+static void selectAll(void) {
+    selectionClear();
+    for (int i = 0; i < g_numObjects; i++) {
+        selectionAdd(i);
+    }
+}
+
+/**
+ * @brief Aplica uma transformação à seleção; as repetições alternam o sentido para a cena não crescer.
+ */
+static void applyBenchTransform(int which, int repetition) {
+    int forward = (repetition & 1) == 0;
+    switch (which) {
+        case 0: translateSelection(forward ? 5.0f : -5.0f, forward ? -3.0f : 3.0f); break;
+        case 1: rotateSelection(forward ? 7.0f : -7.0f); break;
+        case 2: scaleSelection(forward ? 1.1f : 1.0f / 1.1f, forward ? 1.1f : 1.0f / 1.1f); break;
+        case 3: reflectSelection(repetition & 1); break;
+        case 4: shearSelection(forward ? 0.1f : -0.1f, 0.0f); break;
+    }
+}
+
+/**
+ * @brief Salva a cena atual, medindo o tempo.
+ * @return double O tempo em segundos, ou negativo em caso de erro.
+ */
+static double timedSave(const char* filename) {
+    double start = jobsWallTime();
+    SceneSnapshot snap;
+    snapshotInit(&snap);
+    int ok = snapshotCapture(&snap) && writeSceneFile(&snap, filename, NULL);
+    snapshotFree(&snap);
+    double seconds = jobsWallTime() - start;
+    if (!ok) {
+        fprintf(stderr, "[Bench ERROR] Falha ao salvar '%s'.\n", filename);
+        return -1.0;
+    }
+    return seconds;
+}
+
+/**
+ * @brief Substitui a cena atual pela de um arquivo, medindo o tempo.
+ * @return double O tempo em segundos, ou negativo em caso de erro.
+ */
+static double timedLoad(const char* filename) {
+    double start = jobsWallTime();
+    SceneSnapshot snap;
+    snapshotInit(&snap);
+    int ok = readSceneFile(filename, &snap, NULL);
+    if (ok) snapshotInstall(&snap);
+    snapshotFree(&snap);
+    double seconds = jobsWallTime() - start;
+    if (!ok) {
+        fprintf(stderr, "[Bench ERROR] Falha ao carregar '%s'.\n", filename);
+        return -1.0;
+    }
+    return seconds;
+}
+
+/**
+ * @brief Copia a cena atual para o layout antigo, um malloc() por objeto e por lista de vértices.
+ * @return LegacyObject* O array na ordem de 'g_objects', ou NULL se faltou memória.
+ */
+static LegacyObject* legacyCopyScene(void) {
+    LegacyObject* objects = (LegacyObject*)calloc((size_t)g_numObjects + 1, sizeof(LegacyObject));
+    int ok = objects != NULL;
+    for (int i = 0; ok && i < g_numObjects; i++) {
+        const Object* obj = &g_objects[i];
+        objects[i].type = obj->type;
+        if (obj->type == OBJECT_TYPE_POINT) {
+            Point* p = (Point*)malloc(sizeof(Point));
+            if (p) *p = g_points[obj->slot];
+            objects[i].data = p;
+        } else if (obj->type == OBJECT_TYPE_SEGMENT) {
+            Segment* seg = (Segment*)malloc(sizeof(Segment));
+            if (seg) *seg = g_segments[obj->slot];
+            objects[i].data = seg;
+        } else {
+            const GfxPolygon* source = &g_polygons[obj->slot];
+            GfxPolygon* poly = (GfxPolygon*)malloc(sizeof(GfxPolygon));
+            if (poly) {
+                poly->vertices = (Point*)malloc((size_t)source->numVertices * sizeof(Point));
+                poly->numVertices = source->numVertices;
+                poly->capacity = source->numVertices;
+                if (poly->vertices) {
+                    memcpy(poly->vertices, source->vertices, (size_t)source->numVertices * sizeof(Point));
+                } else {
+                    free(poly);
+                    poly = NULL;
+                }
+            }
+            objects[i].data = poly;
+        }
+        ok = objects[i].data != NULL;
+    }
+    if (!ok && objects) {
+        for (int i = 0; i < g_numObjects && objects[i].data; i++) {
+            if (objects[i].type == OBJECT_TYPE_POLYGON) free(((GfxPolygon*)objects[i].data)->vertices);
+            free(objects[i].data);
+        }
+        free(objects);
+        objects = NULL;
+    }
+    return objects;
+}
+
+static void legacyFree(LegacyObject* objects, int count) {
+    for (int i = 0; i < count; i++) {
+        if (objects[i].type == OBJECT_TYPE_POLYGON) free(((GfxPolygon*)objects[i].data)->vertices);
+        free(objects[i].data);
+    }
+    free(objects);
+}
+
+static void frameAddPoint(BoundingBox* box, Point p) {
+    if (p.x < box->minX) box->minX = p.x;
+    if (p.y < box->minY) box->minY = p.y;
+    if (p.x > box->maxX) box->maxX = p.x;
+    if (p.y > box->maxY) box->maxY = p.y;
+}
+
+/**
+ * @brief Um quadro sobre os arrays por tipo: visita cada vértice da cena, em ordem de memória.
+ * @return long long A quantidade de vértices visitados.
+ */
+static long long packedFrame(BoundingBox* box) {
+    long long visited = 0;
+    for (int k = 0; k < g_numPoints; k++) {
+        frameAddPoint(box, g_points[k]);
+    }
+    for (int k = 0; k < g_numSegments; k++) {
+        frameAddPoint(box, g_segments[k].p1);
+        frameAddPoint(box, g_segments[k].p2);
+    }
+    for (int k = 0; k < g_numPolygons; k++) {
+        const GfxPolygon* poly = &g_polygons[k];
+        for (int v = 0; v < poly->numVertices; v++) {
+            frameAddPoint(box, poly->vertices[v]);
+        }
+        visited += poly->numVertices;
+    }
+    return visited + g_numPoints + 2LL * g_numSegments;
+}
+
+/**
+ * @brief O mesmo quadro no layout antigo: um switch no tipo e um 'void*' por objeto.
+ * @return long long A quantidade de vértices visitados.
+ */
+static long long legacyFrame(const LegacyObject* objects, int count, BoundingBox* box) {
+    long long visited = 0;
+    for (int i = 0; i < count; i++) {
+        switch (objects[i].type) {
+            case OBJECT_TYPE_POINT:
+                frameAddPoint(box, *(const Point*)objects[i].data);
+                visited++;
+                break;
+            case OBJECT_TYPE_SEGMENT: {
+                const Segment* seg = (const Segment*)objects[i].data;
+                frameAddPoint(box, seg->p1);
+                frameAddPoint(box, seg->p2);
+                visited += 2;
+                break;
+            }
+            case OBJECT_TYPE_POLYGON: {
+                const GfxPolygon* poly = (const GfxPolygon*)objects[i].data;
+                for (int v = 0; v < poly->numVertices; v++) {
+                    frameAddPoint(box, poly->vertices[v]);
+                }
+                visited += poly->numVertices;
+                break;
+            }
+        }
+    }
+    return visited;
+}
+
+/**
+ * @brief Compara o custo de um quadro nos arrays por tipo e no layout antigo, com 'void*'.
+ *
+ * As duas medições visitam os mesmos vértices e precisam chegar à mesma caixa envolvente.
+ * @return int 1 em caso de sucesso, 0 em caso de erro.
+ */
+static int runLayoutFrames(int scale, FILE* out) {
+    LegacyObject* legacy = legacyCopyScene();
+    if (!legacy) {
+        fprintf(stderr, "[Bench ERROR] Memoria insuficiente para a copia da cena no layout antigo.\n");
+        return 0;
+    }
+    BoundingBox boxes[2];
+    long long visited[2] = {0, 0};
+    double seconds[2];
+    for (int layout = 0; layout < 2; layout++) {
+        double start = jobsWallTime();
+        for (int f = 0; f < BENCH_LAYOUT_FRAMES; f++) {
+            BoundingBox box = {1e30f, 1e30f, -1e30f, -1e30f};
+            visited[layout] = layout == 0 ? packedFrame(&box) : legacyFrame(legacy, g_numObjects, &box);
+            boxes[layout] = box;
+        }
+        seconds[layout] = jobsWallTime() - start;
+    }
+    legacyFree(legacy, g_numObjects);
+
+    if (visited[0] != visited[1] || memcmp(&boxes[0], &boxes[1], sizeof(BoundingBox)) != 0) {
+        fprintf(stderr, "[Bench ERROR] Os dois layouts nao visitaram a mesma geometria.\n");
+        return 0;
+    }
+    long long operations = (long long)scale * BENCH_LAYOUT_FRAMES;
+    reportCount(out, scale, "frame_packed", operations, seconds[0], visited[0]);
+    reportCount(out, scale, "frame_void_ptr", operations, seconds[1], visited[1]);
+    return 1;
+}
+
+/**
+ * @brief Roda todas as medições de uma escala.
+ * @return int 1 em caso de sucesso, 0 em caso de erro.
+ */
+static int runScale(int scale, FILE* out) {
+    static const char* transformNames[5] = {"translate", "rotate", "scale", "reflect", "shear"};
+    static const char* files[2] = {"rabisquim_bench.txt", "rabisquim_bench" SCENE_BINARY_EXTENSION};
+    static const char* saveNames[2] = {"save_text", "save_binary"};
+    static const char* loadNames[2] = {"load_text", "load_binary"};
+
+    SceneGenParams params;
+    sceneGenDefaults(&params, scale);
+    params.animatedFraction = BENCH_ANIMATED_FRACTION;
+    params.seed = BENCH_SUITE_SEED;
+    unsigned long long state = BENCH_SUITE_SEED ^ (unsigned long long)scale;
+
+    // Geração e inserção.
+    SceneSnapshot generated;
+    snapshotInit(&generated);
+    double start = jobsWallTime();
+    int ok = sceneGenerate(&params, &generated);
+    double seconds = jobsWallTime() - start;
+    if (!ok) {
+        snapshotFree(&generated);
+        return 0;
+    }
+    reportHash(out, scale, "generate", scale, seconds, snapshotHash(&generated));
+
+    long long numVertices = (long long)generated.numVertices;
+    start = jobsWallTime();
+    snapshotInstall(&generated);
+    seconds = jobsWallTime() - start;
+    reportCount(out, scale, "add", scale, seconds, g_numObjects);
+    snapshotFree(&generated);
+    if (g_numObjects != scale) {
+        fprintf(stderr, "[Bench ERROR] A cena gerada tem %d objetos em vez de %d.\n", g_numObjects, scale);
+        return 0;
+    }
+    fprintf(out, "# escala %d: %d pontos, %d segmentos, %d poligonos, %lld vertices de poligonos, area %.0fx%.0f\n",
+            scale, params.numPoints, params.numSegments, params.numPolygons, numVertices, params.width, params.height);
+
+    // Um quadro sobre a cena recém-inserida, nos dois layouts da geometria.
+    objectsFlushTransforms();
+    if (!runLayoutFrames(scale, out)) return 0;
+
+    // Clique: metade em pontos sorteados da área, metade no centro de um objeto sorteado.
+    int hits = 0;
+    start = jobsWallTime();
+    for (int c = 0; c < BENCH_PICK_CLICKS; c++) {
+        Point click;
+        if (c & 1) {
+            int index = (int)(sceneGenRandom(&state) % (unsigned long long)g_numObjects);
+            click = getObjectCenter(&g_objects[index]);
+        } else {
+            click.x = params.width * (float)(sceneGenRandom(&state) >> 40) / 16777216.0f;
+            click.y = params.height * (float)(sceneGenRandom(&state) >> 40) / 16777216.0f;
+        }
+        if (selectObjectAtPoint(click) != -1) hits++;
+    }
+    seconds = jobsWallTime() - start;
+    reportCount(out, scale, "pick", BENCH_PICK_CLICKS, seconds, hits);
+
+    // Transformações da cena inteira, incluindo a aplicação adiada aos vértices.
+    // As idas e voltas da translação e do cisalhamento terminam na cena de
+    // partida, então a soma também cobre a cena depois da primeira ida (fora
+    // do tempo medido).
+    selectAll();
+    for (int t = 0; t < 5; t++) {
+        unsigned long long forwardHash = 0;
+        seconds = 0.0;
+        for (int r = 0; r < BENCH_TRANSFORM_REPETITIONS; r++) {
+            start = jobsWallTime();
+            applyBenchTransform(t, r);
+            objectsFlushTransforms();
+            seconds += jobsWallTime() - start;
+            if (r == 0) forwardHash = geometryHash();
+        }
+        unsigned long long finalHash = geometryHash();
+        reportHash(out, scale, transformNames[t], (long long)scale * BENCH_TRANSFORM_REPETITIONS, seconds,
+                   hashBytes(forwardHash, &finalHash, sizeof(finalHash)));
+    }
+
+    // Fecho de cada polígono (sem trocar a geometria) e da união da cena.
+    long long hullVertices = 0;
+    start = jobsWallTime();
+    for (int k = 0; k < g_numPolygons; k++) {
+        GfxPolygon hull = convexHullOfPolygon(&g_polygons[k]);
+        hullVertices += hull.numVertices;
+        freePolygon(&hull);
+    }
+    seconds = jobsWallTime() - start;
+    reportCount(out, scale, "hull_polygons", g_numPolygons, seconds, hullVertices);
+
+    start = jobsWallTime();
+    GfxPolygon unionHull = convexHullOfObjects(g_selection, g_numSelected);
+    seconds = jobsWallTime() - start;
+    reportCount(out, scale, "hull_union", 1, seconds, unionHull.numVertices);
+    freePolygon(&unionHull);
+
+    // Salvamento e carregamento nos dois formatos.
+    for (int f = 0; ok && f < 2; f++) {
+        seconds = timedSave(files[f]);
+        ok = seconds >= 0.0;
+        if (ok) reportCount(out, scale, saveNames[f], scale, seconds, g_numObjects);
+    }
+    for (int f = 0; ok && f < 2; f++) {
+        seconds = timedLoad(files[f]);
+        ok = seconds >= 0.0;
+        if (ok) reportHash(out, scale, loadNames[f], scale, seconds, geometryHash());
+    }
+    remove(files[0]);
+    remove(files[1]);
+    if (!ok) return 0;
+
+    // Remoção de objetos sorteados (a cena é a do arquivo binário, exata).
+    int numRemovals = scale / BENCH_REMOVE_DIVISOR;
+    start = jobsWallTime();
+    for (int k = 0; k < numRemovals && g_numObjects > 0; k++) {
+        removeObject((int)(sceneGenRandom(&state) % (unsigned long long)g_numObjects));
+    }
+    seconds = jobsWallTime() - start;
+    reportHash(out, scale, "remove", numRemovals, seconds, geometryHash());
+
+    // Passo da animação, com as bordas na área da cena. A cena recarregada
+    // mantém os objetos animados pelo gerador; sem eles a medição seria vazia.
+    if (anim_active_count() == 0) {
+        fprintf(stderr, "[Bench ERROR] A cena da escala %d nao tem objetos animados.\n", scale);
+        return 0;
+    }
+    fprintf(out, "# escala %d: %d objetos animados no passo da animacao\n", scale, anim_active_count());
+    int savedWidth = g_windowWidth;
+    int savedHeight = g_windowHeight;
+    g_windowWidth = (int)params.width;
+    g_windowHeight = (int)params.height;
+    start = jobsWallTime();
+    for (int s = 0; s < BENCH_ANIM_STEPS; s++) {
+        anim_step(ANIM_FIXED_STEP);
+    }
+    seconds = jobsWallTime() - start;
+    g_windowWidth = savedWidth;
+    g_windowHeight = savedHeight;
+    reportHash(out, scale, "anim_step", BENCH_ANIM_STEPS, seconds, geometryHash());
+    return 1;
+}
+
+// --- SEÇÃO DE FUNÇÕES PÚBLICAS ---
+
+int benchmarkRunSuite(const int* scales, int numScales, FILE* out) {
+    for (int k = 0; k < numScales; k++) {
+        if (scales[k] < 10) {
+            fprintf(stderr, "[Bench ERROR] Use escalas de pelo menos 10 objetos.\n");
+            return 0;
+        }
+    }
+
+    fprintf(out, "# rabisquim bench-suite: semente %llu, %d threads, kernel de transformacao %s\n",
+            BENCH_SUITE_SEED, jobsThreadCount(), transformKernelName(transformBestKernel()));
+    fprintf(out, "escala,benchmark,operacoes,total_ms,ns_por_operacao,resultado\n");
+
+    historySetRecording(0);
+    int ok = 1;
+    for (int k = 0; ok && k < numScales; k++) {
+        ok = runScale(scales[k], out);
+    }
+    clearAllObjects();
+    historySetRecording(1);
+    return ok;
+}
@@ -0,0 +1,41 @@
+/**
+ * @file benchmark.h
+ * @brief Define a interface da suíte de benchmarks dos caminhos críticos do editor.
+ *
+ * Para cada escala, a suíte gera uma cena sintética (scenegen.h) com semente
+ * fixa e mede: a geração, a inserção dos objetos, um quadro que percorre toda
+ * a geometria (nos arrays por tipo e em uma cópia no layout antigo, um
+ * malloc() por objeto acessado por 'void*'), a remoção, o clique de
+ * seleção, cada transformação aplicada à cena inteira, o fecho convexo, o
+ * salvamento e o carregamento nos dois formatos e o passo da animação.
+ *
+ * O resultado sai em CSV, uma linha por medição, com as colunas
+ *
+ *     escala,benchmark,operacoes,total_ms,ns_por_operacao,resultado
+ *
+ * A coluna "resultado" resume o que a medição produziu (objetos achados,
+ * vértices dos fechos ou uma soma de verificação da geometria). Ela não
+ * depende da máquina: uma mudança nela indica que o comportamento mudou,
+ * não só o tempo. Linhas começadas por '#' são comentários.
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <stdio.h>
+
+// --- SEÇÃO DE PROTÓTIPOS DE FUNÇÕES PÚBLICAS ---
+
+/**
+ * @brief Roda a suíte em cada escala e escreve os resultados em CSV.
+ *
+ * Substitui a cena atual e a deixa vazia no fim. Os arquivos temporários de
+ * salvamento são criados na pasta atual e apagados no fim.
+ * @param scales Os números de objetos de cada escala.
+ * @param numScales A quantidade de escalas.
+ * @param out Onde escrever o CSV (ex: stdout).
+ * @return int 1 se todas as medições rodaram, 0 em caso de erro.
+ */
+int benchmarkRunSuite(const int* scales, int numScales, FILE* out);
+
+#endif // BENCHMARK_H
@@ -0,0 +1,459 @@
+/**
+ * @file collision.c
+ * @brief Implementação da detecção e resposta de colisões entre objetos animados.
+ *
+ * Todos os tipos são tratados como polígonos convexos: um ponto é um
+ * polígono de um vértice e um segmento, de dois. Para que pontos e segmentos
+ * tenham volume, cada objeto ganha uma "pele" de COLLISION_SKIN pixels.
+ * Polígonos côncavos colidem de forma aproximada, como o seu fecho convexo,
+ * calculado quando o polígono chega à fase estreita e guardado até a forma
+ * do objeto mudar (as translações da animação não invalidam o fecho).
+ *
+ * A lista da fase ampla persiste entre os passos: os objetos entram e saem
+ * dela junto com a lista de ativos da animação, e como a ordem muda pouco de
+ * um passo para o outro, a reordenação é feita por inserção.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <float.h>
+
+#include "collision.h"
+#include "objects.h"
+#include "animation.h"
+#include "transformations.h"
+#include "convexhull.h"
+#include "config.h"
+
+// --- SEÇÃO DE ESTRUTURAS E VARIÁVEIS PRIVADAS ---
+
+/**
+ * @brief Uma entrada da lista ordenada da fase ampla.
+ */
+typedef struct {
+    float minX, maxX;   ///< Extensão da caixa envolvente no eixo de varredura.
+    float minY, maxY;   ///< Extensão no outro eixo, copiada para o teste não sair da lista.
+    int index;          ///< Índice do objeto em 'g_objects'.
+    int shapeKnown;     ///< 1 se os campos abaixo valem para 'shapeVersion'.
+    unsigned int shapeVersion; ///< O 'shapeVersion' do objeto quando o fecho foi calculado.
+    Point* hull;        ///< Fecho convexo de um polígono côncavo, relativo ao canto mínimo da caixa.
+    int hullCount;      ///< Vértices do fecho, ou 0 se o objeto é usado como está.
+    int hullCapacity;   ///< Tamanho alocado de 'hull'.
+} SweepEntry;
+
+static SweepEntry* s_sweep = NULL;
+static int s_sweepCount = 0;
+static int s_sweepCapacity = 0;
+static int s_sweepStale = 0;    ///< A lista perdeu algum objeto por falta de memória e precisa ser refeita.
+
+// Cópias dos fechos em coordenadas absolutas para o teste de um par.
+static Point* s_shapeA = NULL;
+static Point* s_shapeB = NULL;
+static int s_shapeCapacity = 0;
+
+// --- SEÇÃO DE FUNÇÕES AUXILIARES (IMPLEMENTAÇÃO PRIVADA) ---
+
+static int compareSweepEntries(const void* a, const void* b) {
+    const SweepEntry* x = (const SweepEntry*)a;
+    const SweepEntry* y = (const SweepEntry*)b;
+    if (x->minX < y->minX) return -1;
+    if (x->minX > y->minX) return 1;
+    // Desempate pelo índice para que a ordem (e a simulação) seja sempre a mesma.
+    return (x->index > y->index) - (x->index < y->index);
+}
+
+static int growArray(void** array, int* capacity, int needed, size_t elementSize) {
+    if (needed <= *capacity) return 1;
+    int newCapacity = *capacity > 0 ? *capacity : 64;
+    while (newCapacity < needed) newCapacity *= 2;
+    void* grown = realloc(*array, (size_t)newCapacity * elementSize);
+    if (!grown) return 0;
+    *array = grown;
+    *capacity = newCapacity;
+    return 1;
+}
+
+/**
+ * @brief Verifica se um polígono é convexo.
+ *
+ * Todas as curvas precisam ir para o mesmo lado e o sentido em X só pode
+ * mudar duas vezes; a segunda condição recusa as estrelas, que viram sempre
+ * para o mesmo lado mas dão mais de uma volta.
+ */
+static int isConvexPolygon(const Point* v, int n) {
+    int turn = 0, flips = 0, firstDir = 0, lastDir = 0;
+    for (int i = 0; i < n; i++) {
+        const Point* a = &v[i];
+        const Point* b = &v[(i + 1) % n];
+        const Point* c = &v[(i + 2) % n];
+        float cross = (b->x - a->x) * (c->y - b->y) - (b->y - a->y) * (c->x - b->x);
+        if (cross != 0.0f) {
+            int sign = cross > 0.0f ? 1 : -1;
+            if (turn == 0) turn = sign;
+            else if (sign != turn) return 0;
+        }
+        int dir = (b->x > a->x) - (b->x < a->x);
+        if (dir != 0) {
+            if (firstDir == 0) firstDir = dir;
+            else if (dir != lastDir) flips++;
+            lastDir = dir;
+        }
+    }
+    if (lastDir != 0 && lastDir != firstDir) flips++;
+    return flips <= 2;
+}
+
+/**
+ * @brief Calcula o fecho convexo de um polígono côncavo da lista, se a forma mudou.
+ *
+ * O fecho fica guardado relativo ao canto mínimo da caixa, então continua
+ * valendo depois das translações (inclusive as da resposta ao contato, no
+ * meio do passo). Polígonos convexos, pontos e segmentos ficam com
+ * 'hullCount' 0 e são usados como estão; se faltar memória, o polígono também.
+ */
+static void prepareHull(SweepEntry* e) {
+    const Object* o = &g_objects[e->index];
+    if (e->shapeKnown && e->shapeVersion == o->shapeVersion) return;
+    e->shapeKnown = 1;
+    e->shapeVersion = o->shapeVersion;
+    e->hullCount = 0;
+    if (o->type != OBJECT_TYPE_POLYGON) return;
+
+    const GfxPolygon* poly = getObjectPolygon(e->index);
+    int n = poly->numVertices;
+    if (n < 4 || isConvexPolygon(poly->vertices, n)) return;
+    if (!growArray((void**)&e->hull, &e->hullCapacity, n, sizeof(Point))) return;
+
+    int count = convexHullPoints(poly->vertices, n, e->hull);
+    if (count <= 0) return;
+    BoundingBox box = getObjectBounds(e->index);
+    for (int k = 0; k < count; k++) {
+        e->hull[k].x -= box.minX;
+        e->hull[k].y -= box.minY;
+    }
+    e->hullCount = count;
+}
+
+/**
+ * @brief Cria a entrada de um objeto; a caixa é preenchida no próximo passo.
+ */
+static SweepEntry newSweepEntry(int index) {
+    return (SweepEntry){ .index = index };
+}
+
+/**
+ * @brief Esvazia a lista, liberando os fechos guardados.
+ */
+static void clearSweep(void) {
+    for (int k = 0; k < s_sweepCount; k++) free(s_sweep[k].hull);
+    s_sweepCount = 0;
+}
+
+/**
+ * @brief Retorna os vértices de um objeto vistos como um polígono convexo.
+ * @param e A entrada do objeto na lista da fase ampla.
+ * @param scratch Onde montar o fecho em coordenadas absolutas, se houver um.
+ * @param count Recebe a quantidade de vértices.
+ */
+static const Point* shapeOf(const SweepEntry* e, Point* scratch, int* count) {
+    int index = e->index;
+    if (e->hullCount > 0) {
+        BoundingBox box = getObjectBounds(index);
+        const Point* hull = e->hull;
+        for (int k = 0; k < e->hullCount; k++) {
+            scratch[k].x = hull[k].x + box.minX;
+            scratch[k].y = hull[k].y + box.minY;
+        }
+        *count = e->hullCount;
+        return scratch;
+    }
+    switch (g_objects[index].type) {
+        case OBJECT_TYPE_POINT:
+            *count = 1;
+            return getObjectPoint(index);
+        case OBJECT_TYPE_SEGMENT:
+            // Os dois extremos do segmento ficam lado a lado na memória.
+            *count = 2;
+            return &getObjectSegment(index)->p1;
+        case OBJECT_TYPE_POLYGON:
+            *count = getObjectPolygon(index)->numVertices;
+            return getObjectPolygon(index)->vertices;
+    }
+    *count = 0;
+    return NULL;
+}
+
+static void projectShape(const Point* v, int n, float ax, float ay, float* outMin, float* outMax) {
+    float lo = v[0].x * ax + v[0].y * ay;
+    float hi = lo;
+    for (int i = 1; i < n; i++) {
+        float d = v[i].x * ax + v[i].y * ay;
+        if (d < lo) lo = d;
+        if (d > hi) hi = d;
+    }
+    *outMin = lo - COLLISION_SKIN;
+    *outMax = hi + COLLISION_SKIN;
+}
+
+/**
+ * @brief Estado da busca pelo eixo de menor sobreposição entre duas formas.
+ */
+typedef struct {
+    const Point* a; int na;
+    const Point* b; int nb;
+    float bestDepth;
+    float bestX, bestY;
+} SatQuery;
+
+/**
+ * @brief Testa um eixo candidato. Retorna 0 se ele separa as formas.
+ */
+static int testAxis(SatQuery* q, float ax, float ay) {
+    float len = sqrtf(ax * ax + ay * ay);
+    if (len < 1e-12f) return 1; // Eixo degenerado: não separa nada.
+    ax /= len;
+    ay /= len;
+
+    float minA, maxA, minB, maxB;
+    projectShape(q->a, q->na, ax, ay, &minA, &maxA);
+    projectShape(q->b, q->nb, ax, ay, &minB, &maxB);
+    float overlap = fminf(maxA, maxB) - fmaxf(minA, minB);
+    if (overlap <= 0.0f) return 0;
+    if (overlap < q->bestDepth) {
+        q->bestDepth = overlap;
+        q->bestX = ax;
+        q->bestY = ay;
+    }
+    return 1;
+}
+
+/**
+ * @brief Testa como eixos as normais das arestas de uma forma (e a direção, se for um segmento).
+ */
+static int testShapeAxes(SatQuery* q, const Point* v, int n) {
+    if (n == 2) {
+        float ex = v[1].x - v[0].x, ey = v[1].y - v[0].y;
+        return testAxis(q, -ey, ex) && testAxis(q, ex, ey);
+    }
+    if (n < 3) return 1;
+    for (int i = 0; i < n; i++) {
+        const Point* p = &v[i];
+        const Point* r = &v[(i + 1) % n];
+        if (!testAxis(q, -(r->y - p->y), r->x - p->x)) return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Fase estreita: verifica se dois objetos se sobrepõem pelo teorema do eixo separador.
+ * @param ea, eb As entradas dos dois objetos na lista da fase ampla.
+ * @param normalX, normalY Recebem a normal do contato, apontando de 'ea' para 'eb'.
+ * @param depth Recebe a profundidade da penetração ao longo da normal.
+ * @return int 1 se há contato, 0 caso contrário.
+ */
+static int narrowPhase(SweepEntry* ea, SweepEntry* eb, float* normalX, float* normalY, float* depth) {
+    prepareHull(ea);
+    prepareHull(eb);
+    int needed = ea->hullCount > eb->hullCount ? ea->hullCount : eb->hullCount;
+    if (needed > s_shapeCapacity) {
+        int capacity = s_shapeCapacity;
+        if (!growArray((void**)&s_shapeA, &capacity, needed, sizeof(Point))) return 0;
+        capacity = s_shapeCapacity;
+        if (!growArray((void**)&s_shapeB, &capacity, needed, sizeof(Point))) return 0;
+        s_shapeCapacity = capacity;
+    }
+
+    int ia = ea->index, ib = eb->index;
+    SatQuery q;
+    q.a = shapeOf(ea, s_shapeA, &q.na);
+    q.b = shapeOf(eb, s_shapeB, &q.nb);
+    if (q.na == 0 || q.nb == 0) return 0;
+    q.bestDepth = FLT_MAX;
+    q.bestX = 1.0f;
+    q.bestY = 0.0f;
+
+    BoundingBox boxA = getObjectBounds(ia);
+    BoundingBox boxB = getObjectBounds(ib);
+    float cx = 0.5f * ((boxB.minX + boxB.maxX) - (boxA.minX + boxA.maxX));
+    float cy = 0.5f * ((boxB.minY + boxB.maxY) - (boxA.minY + boxA.maxY));
+
+    // O eixo entre os centros resolve os casos sem arestas (ponto contra ponto).
+    if (!testShapeAxes(&q, q.a, q.na) || !testShapeAxes(&q, q.b, q.nb) || !testAxis(&q, cx, cy)) {
+        return 0;
+    }
+
+    if (q.bestX * cx + q.bestY * cy < 0.0f) {
+        q.bestX = -q.bestX;
+        q.bestY = -q.bestY;
+    }
+    *normalX = q.bestX;
+    *normalY = q.bestY;
+    *depth = q.bestDepth;
+    return 1;
+}
+
+/**
+ * @brief Aplica o impulso e a separação a um par de objetos em contato.
+ *
+ * Os dois objetos têm a mesma massa, então o impulso e a correção de
+ * posição são divididos igualmente entre eles.
+ */
+static void resolveContact(int ia, int ib, float nx, float ny, float depth) {
+    AnimSlot* a = &g_anim[ia];
+    AnimSlot* b = &g_anim[ib];
+
+    float vn = (b->vx - a->vx) * nx + (b->vy - a->vy) * ny;
+    if (vn < 0.0f) {
+        // Só há impulso se os objetos estiverem se aproximando.
+        float e = fminf(a->e, b->e);
+        float j = -(1.0f + e) * vn * 0.5f;
+        a->vx -= j * nx;
+        a->vy -= j * ny;
+        b->vx += j * nx;
+        b->vy += j * ny;
+    }
+
+    // A separação é imediata: os próximos pares do mesmo passo já leem as posições novas.
+    float push = 0.5f * depth;
+    translateObjectGeometry(ia, -nx * push, -ny * push);
+    translateObjectGeometry(ib, nx * push, ny * push);
+    objectCommitMove(ia);
+    objectCommitMove(ib);
+    a->stepDx -= nx * push;
+    a->stepDy -= ny * push;
+    b->stepDx += nx * push;
+    b->stepDy += ny * push;
+}
+
+/**
+ * @brief Refaz a lista da fase ampla a partir da lista de ativos da animação.
+ * @return int 1 em caso de sucesso, 0 se faltou memória.
+ */
+static int rebuildSweep(void) {
+    int n = anim_active_count();
+    if (!growArray((void**)&s_sweep, &s_sweepCapacity, n, sizeof(SweepEntry))) {
+        fprintf(stderr, "[Collision ERROR] Memória insuficiente para a fase ampla.\n");
+        return 0;
+    }
+    clearSweep();
+    const int* active = anim_active_indices();
+    for (int k = 0; k < n; k++) {
+        s_sweep[k] = newSweepEntry(active[k]);
+    }
+    s_sweepCount = n;
+    s_sweepStale = 0;
+    return 1;
+}
+
+/**
+ * @brief Reordena a lista por inserção, já que a ordem do passo anterior quase não muda.
+ *
+ * Se a lista estiver muito fora de ordem (muitos objetos acabaram de entrar),
+ * a inserção desiste e a ordenação termina pelo qsort. As chaves são únicas,
+ * então os dois caminhos chegam à mesma ordem.
+ */
+static void sortSweep(void) {
+    long budget = 8L * s_sweepCount + 64;
+    for (int i = 1; i < s_sweepCount; i++) {
+        SweepEntry e = s_sweep[i];
+        int j = i;
+        while (j > 0 && compareSweepEntries(&s_sweep[j - 1], &e) > 0) {
+            s_sweep[j] = s_sweep[j - 1];
+            j--;
+            if (--budget < 0) {
+                s_sweep[j] = e;
+                qsort(s_sweep, s_sweepCount, sizeof(SweepEntry), compareSweepEntries);
+                return;
+            }
+        }
+        s_sweep[j] = e;
+    }
+}
+
+// --- SEÇÃO DE FUNÇÕES PÚBLICAS ---
+
+int collisionStep(void) {
+    if (s_sweepStale && !rebuildSweep()) return 0;
+    if (s_sweepCount < 2) return 0;
+
+    // Fase ampla: ordena os objetos animados pelo início da caixa no eixo X e
+    // só compara cada um com os que começam antes de ele terminar.
+    for (int k = 0; k < s_sweepCount; k++) {
+        BoundingBox box = getObjectBounds(s_sweep[k].index);
+        s_sweep[k].minX = box.minX - COLLISION_SKIN;
+        s_sweep[k].maxX = box.maxX + COLLISION_SKIN;
+        s_sweep[k].minY = box.minY - COLLISION_SKIN;
+        s_sweep[k].maxY = box.maxY + COLLISION_SKIN;
+    }
+    sortSweep();
+
+    int count = s_sweepCount;
+    int contacts = 0;
+    for (int i = 0; i < count; i++) {
+        SweepEntry* a = &s_sweep[i];
+        for (int j = i + 1; j < count && s_sweep[j].minX <= a->maxX; j++) {
+            SweepEntry* b = &s_sweep[j];
+            if (a->maxY < b->minY || b->maxY < a->minY) continue;
+
+            float nx, ny, depth;
+            if (narrowPhase(a, b, &nx, &ny, &depth)) {
+                resolveContact(a->index, b->index, nx, ny, depth);
+                contacts++;
+            }
+        }
+    }
+    return contacts;
+}
+
+void collisionTrack(int index) {
+    if (s_sweepStale) return;
+    if (!growArray((void**)&s_sweep, &s_sweepCapacity, s_sweepCount + 1, sizeof(SweepEntry))) {
+        // Sem memória agora: o próximo passo tenta refazer a lista inteira.
+        s_sweepStale = 1;
+        return;
+    }
+    // O próximo passo também põe a entrada no lugar certo da ordem.
+    s_sweep[s_sweepCount++] = newSweepEntry(index);
+}
+
+void collisionForget(int index) {
+    if (s_sweepStale) return;
+    for (int k = 0; k < s_sweepCount; k++) {
+        if (s_sweep[k].index == index) {
+            // Desloca o resto para manter a lista quase ordenada.
+            free(s_sweep[k].hull);
+            s_sweepCount--;
+            for (int m = k; m < s_sweepCount; m++) s_sweep[m] = s_sweep[m + 1];
+            return;
+        }
+    }
+}
+
+void collisionRename(int oldIndex, int newIndex) {
+    if (s_sweepStale) return;
+    for (int k = 0; k < s_sweepCount; k++) {
+        if (s_sweep[k].index == oldIndex) {
+            s_sweep[k].index = newIndex;
+            return;
+        }
+    }
+}
+
+void collisionReset(void) {
+    clearSweep();
+    s_sweepStale = 0;
+}
+
+void collisionShutdown(void) {
+    clearSweep();
+    free(s_sweep);
+    s_sweep = NULL;
+    s_sweepCapacity = 0;
+    s_sweepStale = 0;
+    free(s_shapeA);
+    free(s_shapeB);
+    s_shapeA = NULL;
+    s_shapeB = NULL;
+    s_shapeCapacity = 0;
+}
@@ -0,0 +1,54 @@
+/**
+ * @file collision.h
+ * @brief Define a interface da detecção e resposta de colisões entre objetos animados.
+ *
+ * A detecção tem duas fases: uma fase ampla ("sweep and prune" sobre as
+ * caixas envolventes em cache) descarta os pares distantes, e uma fase
+ * estreita pelo teorema do eixo separador (SAT) confirma o contato e calcula
+ * a direção e a profundidade da penetração.
+ */
+
+#ifndef COLLISION_H
+#define COLLISION_H
+
+// --- SEÇÃO DE PROTÓTIPOS DE FUNÇÕES PÚBLICAS ---
+
+/**
+ * @brief Detecta e resolve as colisões entre os objetos com animação ativa.
+ *
+ * Chamada pelo passo da animação depois da integração das posições. Cada par
+ * em contato recebe um impulso ao longo da normal do contato (usando o menor
+ * coeficiente de restituição 'e' dos dois) e é afastado até deixar de se
+ * sobrepor. Objetos sem animação não participam.
+ * @return int A quantidade de pares em contato neste passo.
+ */
+int collisionStep(void);
+
+/**
+ * @brief Acrescenta um objeto à lista da fase ampla (chamada quando a sua animação é ligada).
+ * @param index O índice do objeto em 'g_objects'.
+ */
+void collisionTrack(int index);
+
+/**
+ * @brief Tira um objeto da lista da fase ampla (animação desligada ou objeto removido).
+ * @param index O índice do objeto em 'g_objects'.
+ */
+void collisionForget(int index);
+
+/**
+ * @brief Acompanha a troca de índice de um objeto na remoção com "swap-remove".
+ */
+void collisionRename(int oldIndex, int newIndex);
+
+/**
+ * @brief Esvazia a lista da fase ampla (todas as animações foram desligadas).
+ */
+void collisionReset(void);
+
+/**
+ * @brief Libera a memória auxiliar do módulo de colisões.
+ */
+void collisionShutdown(void);
+
+#endif // COLLISION_H
@@ -1,42 +1,190 @@
 /**
  * @file config.h
- * @brief Arquivo de configurao central do projeto.
+ * @brief Arquivo de configuração central do projeto.
  *
- * Contm constantes globais para facilitar a manuteno e ajuste do programa.
+ * Contém constantes globais para facilitar a manutenção e ajuste do programa.
  * Mudar um valor aqui afeta o comportamento do programa inteiro.
  */
 
 #ifndef CONFIG_H
 #define CONFIG_H
 
-// --- SEO DE CONFIGURAES DE JANELA ---
+// --- SEÇÃO DE CONFIGURAÇÕES DE JANELA ---
 
 #define WINDOW_WIDTH 800
 #define WINDOW_HEIGHT 600
-#define WINDOW_TITLE "Rabisquim - v1.0" ///< Verso final :)
+#define WINDOW_TITLE "Rabisquim - v1.0" ///< Versão final :)
 
-// --- SEO DE CONSTANTES DE LGICA E INTERAO ---
+// --- SEÇÃO DE CONSTANTES DE LÓGICA E INTERAÇÃO ---
 
 /**
- * @brief Define a "rea de acerto" para cliques do mouse.
+ * @brief Define a "área de acerto" para cliques do mouse.
  *
  * Usado para determinar se um clique foi perto o suficiente de um objeto
- * para selecion-lo.
+ * para selecioná-lo.
  */
 #define CLICK_TOLERANCE 5.0f
 
 /**
- * @brief Define o limite mximo de objetos na cena.
+ * @brief Define a capacidade inicial da lista de objetos da cena.
  *
- * Controla o tamanho do array global 'g_objects'.
+ * O array global 'g_objects' (e o 'g_anim' paralelo a ele) começa com este
+ * tamanho e dobra sempre que fica cheio, então não há limite fixo de objetos.
  */
-#define MAX_OBJECTS 100
+#define INITIAL_OBJECT_CAPACITY 128
 
 /**
- * @brief Define o limite mximo de vrtices de um nico polgono.
+ * @brief Define o tamanho (em pixels) de cada célula da grade espacial.
  *
- * Controla o tamanho do array 'vertices' na struct GfxPolygon.
+ * Usado pelo índice espacial que acelera a seleção de objetos com o mouse.
  */
-#define MAX_POLYGON_VERTICES 100
+#define SPATIAL_CELL_SIZE 64.0f
+
+/**
+ * @brief Define quantas células um objeto pode ocupar na grade espacial.
+ *
+ * Objetos maiores que isso ficam em uma lista à parte, consultada sempre.
+ */
+#define SPATIAL_MAX_CELLS_PER_OBJECT 256
+
+// --- SEÇÃO DE CONSTANTES DA ANIMAÇÃO ---
+
+/**
+ * @brief Define o passo fixo (em segundos) da simulação física.
+ *
+ * A animação sempre avança em passos deste tamanho, independentemente da
+ * taxa de quadros, o que torna a simulação reproduzível.
+ */
+#define ANIM_FIXED_STEP (1.0f / 120.0f)
+
+/**
+ * @brief Define quantos passos de física podem ser executados por quadro.
+ *
+ * Limita o trabalho após um travamento (ou um carregamento demorado): o
+ * tempo excedente é descartado em vez de ser simulado de uma só vez.
+ */
+#define ANIM_MAX_SUBSTEPS 8
+
+/**
+ * @brief Define a espessura (em pixels) somada a cada objeto nas colisões.
+ *
+ * Dá volume a pontos e segmentos, que de outra forma nunca se tocariam.
+ */
+#define COLLISION_SKIN 2.0f
+
+// --- SEÇÃO DE CONSTANTES DO PARALELISMO ---
+
+/**
+ * @brief Define o número máximo de threads do sistema de tarefas (jobs.h).
+ */
+#define JOBS_MAX_THREADS 64
+
+/**
+ * @brief Define quantos objetos cada bloco de trabalho do passo da animação cobre.
+ */
+#define ANIM_JOB_GRAIN 128
+
+/**
+ * @brief Define a partir de quantos objetos animados o passo é dividido entre threads.
+ *
+ * Abaixo disso, acordar as threads custa mais do que o trabalho em si.
+ */
+#define ANIM_PARALLEL_MIN_OBJECTS 512
+
+// --- SEÇÃO DE CONSTANTES DO FECHO CONVEXO ---
+
+/**
+ * @brief Define a partir de quantos pontos o fecho convexo usa o QuickHull em vez da cadeia monótona.
+ *
+ * Abaixo disso, ordenar os poucos pontos custa menos do que as passadas de
+ * partição do QuickHull.
+ */
+#define CONVEX_HULL_QUICKHULL_MIN_POINTS 1024
+
+// --- SEÇÃO DE CONSTANTES DA EXPORTAÇÃO DE IMAGENS ---
+
+/**
+ * @brief Define o lado (em pixels) dos blocos em que o rasterizador em software divide a imagem.
+ *
+ * Cada bloco é desenhado por uma thread, com as suas primitivas em ordem.
+ */
+#define RASTER_TILE_SIZE 64
+
+/**
+ * @brief Define quantas linhas da imagem cada tarefa comprime ao gravar um PNG.
+ */
+#define IMAGE_PNG_BAND_ROWS 64
+
+// --- SEÇÃO DE CONSTANTES DO MEDIDOR DE TEMPO ---
+
+/**
+ * @brief Define quantos eventos o buffer circular de cada thread guarda (potência de 2).
+ *
+ * Com 24 bytes por evento, cada thread medida ocupa 768 KB.
+ */
+#define PROFILER_RING_EVENTS 32768
+
+/**
+ * @brief Define quantas threads podem ser medidas ao longo de uma execução.
+ *
+ * Cada salvamento ou carregamento em segundo plano usa uma thread nova.
+ */
+#define PROFILER_MAX_THREADS 64
+
+/**
+ * @brief Define de quantos quadros recentes saem os percentis do painel.
+ */
+#define PROFILER_FRAME_HISTORY 240
+
+/**
+ * @brief Define o arquivo em que F4 grava o trace das medições.
+ */
+#define PROFILER_TRACE_FILE "rabisquim_trace.json"
+
+// --- SEÇÃO DE CONSTANTES DE ARQUIVOS ---
+
+/**
+ * @brief Define o arquivo de cena usado por F5/F9 quando nenhum é passado na linha de comando.
+ */
+#define SCENE_FILE_NAME "scene.txt"
+
+/**
+ * @brief Define a extensão que faz uma cena ser salva e carregada no formato binário (scenebin.h).
+ */
+#define SCENE_BINARY_EXTENSION ".rbq"
+
+/**
+ * @brief Define o tamanho (em bytes) dos blocos em que as cenas de texto são lidas.
+ */
+#define SCENE_READ_BUFFER_SIZE (1 << 20)
+
+/**
+ * @brief Define o arquivo do diário de operações (journal.h); as cenas base ficam ao lado dele.
+ */
+#define JOURNAL_FILE_NAME "rabisquim.journal"
+
+/**
+ * @brief Define quantos bytes de registros o diário acumula, no mínimo, antes de ser compactado.
+ *
+ * Acima disso, o diário é compactado quando fica maior do que a cena base.
+ */
+#define JOURNAL_COMPACT_MIN_BYTES (4 << 20)
+
+/**
+ * @brief Define de quantos em quantos segundos o diário é compactado enquanto houver objetos animados.
+ *
+ * O movimento da animação não é registrado, então é esta compactação que o preserva.
+ */
+#define JOURNAL_ANIMATED_COMPACT_SECONDS 10.0
+
+// --- SEÇÃO DE CONSTANTES DO HISTÓRICO ---
+
+/**
+ * @brief Define quantos bytes o histórico de desfazer/refazer (history.h) pode ocupar.
+ *
+ * Acima disso, os comandos mais antigos são descartados. Pode ser trocado em
+ * tempo de execução por historySetBudget().
+ */
+#define HISTORY_MEMORY_BUDGET (16 << 20)
 
 #endif // CONFIG_H
@@ -1,101 +1,392 @@
 /**
  * @file convexhull.c
- * @brief Implementao do algoritmo de fecho convexo Marcha de Jarvis.
+ * @brief Implementação dos algoritmos de fecho convexo (cadeia monótona e QuickHull).
+ *
+ * Todas as decisões (orientação e qual ponto está mais longe de uma reta)
+ * usam os predicados exatos de predicates.h, então os dois algoritmos
+ * chegam sempre ao mesmo fecho, mesmo com pontos colineares ou em grade.
  */
 #include <stdio.h>
 #include <stdlib.h>
-#include <float.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
 
 #include "convexhull.h"
+#include "config.h"
+#include "history.h"
+#include "objects.h"
 #include "point.h"
+#include "predicates.h"
+#include "profiler.h"
+
+// Abaixo deste tamanho a ordenação usa qsort(); acima, radix sort.
+#define HULL_RADIX_MIN_POINTS 256
+#define HULL_RADIX_BITS 11
+#define HULL_RADIX_BUCKETS (1 << HULL_RADIX_BITS)
+#define HULL_RADIX_PASSES 6             ///< 6 * 11 bits cobrem a chave de 64 bits.
 
-// --- SEO DE FUNES AUXILIARES (LGICA INTERNA) ---
+// --- SEÇÃO DE FUNÇÕES AUXILIARES (LÓGICA INTERNA) ---
 
 /**
- * @brief Determina a orientao de um trio ordenado de pontos (p, q, r).
- * @return int >0 se for anti-horrio, <0 se for horrio, 0 se for colinear.
+ * @brief Ordem lexicográfica (x, depois y) usada pelos dois algoritmos.
  */
-static int orientation(Point p, Point q, Point r) {
-    float val = (q.y - p.y) * (r.x - q.x) - (q.x - p.x) * (r.y - q.y);
-    if (val > 0) return 1;  // Anti-horrio (curva  esquerda)
-    if (val < 0) return -1; // Horrio (curva  direita)
-    return 0;               // Colinear
+static inline int pointLess(Point a, Point b) {
+    return a.x < b.x || (a.x == b.x && a.y < b.y);
+}
+
+static inline int pointEqual(Point a, Point b) {
+    return a.x == b.x && a.y == b.y;
+}
+
+static int comparePoints(const void* a, const void* b) {
+    Point p = *(const Point*)a;
+    Point q = *(const Point*)b;
+    return pointLess(p, q) ? -1 : (pointLess(q, p) ? 1 : 0);
 }
 
 /**
- * @brief Calcula o quadrado da distncia euclidiana entre dois pontos.
+ * @brief Converte um float em um inteiro sem sinal com a mesma ordem (-0 e +0 viram a mesma chave).
+ */
+static inline uint32_t floatSortBits(float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    if (u == 0x80000000u) u = 0;
+    return (u & 0x80000000u) ? ~u : (u | 0x80000000u);
+}
+
+static inline uint64_t pointSortKey(Point p) {
+    return ((uint64_t)floatSortBits(p.x) << 32) | floatSortBits(p.y);
+}
+
+/**
+ * @brief Ordena os pontos por (x, y) com radix sort LSD, usando 'scratch' como área auxiliar.
+ * @return Point* O array que ficou com o resultado ('points' ou 'scratch').
+ */
+static Point* radixSortPoints(Point* points, Point* scratch, int count) {
+    uint32_t histograms[HULL_RADIX_PASSES][HULL_RADIX_BUCKETS];
+    memset(histograms, 0, sizeof(histograms));
+    for (int i = 0; i < count; i++) {
+        uint64_t key = pointSortKey(points[i]);
+        for (int pass = 0; pass < HULL_RADIX_PASSES; pass++) {
+            histograms[pass][(key >> (pass * HULL_RADIX_BITS)) & (HULL_RADIX_BUCKETS - 1)]++;
+        }
+    }
+
+    Point* src = points;
+    Point* dst = scratch;
+    for (int pass = 0; pass < HULL_RADIX_PASSES; pass++) {
+        uint32_t* histogram = histograms[pass];
+        int shift = pass * HULL_RADIX_BITS;
+        // Um dígito igual em todos os pontos não muda a ordem: a passada é pulada.
+        if (histogram[(pointSortKey(src[0]) >> shift) & (HULL_RADIX_BUCKETS - 1)] == (uint32_t)count) {
+            continue;
+        }
+        uint32_t offset = 0;
+        for (int b = 0; b < HULL_RADIX_BUCKETS; b++) {
+            uint32_t n = histogram[b];
+            histogram[b] = offset;
+            offset += n;
+        }
+        for (int i = 0; i < count; i++) {
+            dst[histogram[(pointSortKey(src[i]) >> shift) & (HULL_RADIX_BUCKETS - 1)]++] = src[i];
+        }
+        Point* swap = src;
+        src = dst;
+        dst = swap;
+    }
+    return src;
+}
+
+/**
+ * @brief Cadeia monótona de Andrew.
+ * @param points Os pontos (serão reordenados).
+ * @param scratch Área auxiliar do mesmo tamanho.
+ * @param count A quantidade de pontos (> 0).
+ * @param hull Recebe o fecho (capacidade 'count').
+ * @return int A quantidade de vértices do fecho.
+ */
+static int monotoneChain(Point* points, Point* scratch, int count, Point* hull) {
+    Point* sorted = points;
+    if (count < HULL_RADIX_MIN_POINTS) {
+        qsort(points, count, sizeof(Point), comparePoints);
+    } else {
+        sorted = radixSortPoints(points, scratch, count);
+    }
+    Point* upper = (sorted == points) ? scratch : points;
+
+    // Cadeia de baixo, da esquerda para a direita, direto no fecho.
+    int k = 0;
+    for (int i = 0; i < count; i++) {
+        if (k > 0 && pointEqual(hull[k - 1], sorted[i])) continue;
+        while (k >= 2 && orient2d(hull[k - 2], hull[k - 1], sorted[i]) <= 0) k--;
+        hull[k++] = sorted[i];
+    }
+    // Cadeia de cima, da direita para a esquerda, no array que não guarda a ordenação.
+    int u = 0;
+    for (int i = count - 1; i >= 0; i--) {
+        if (u > 0 && pointEqual(upper[u - 1], sorted[i])) continue;
+        while (u >= 2 && orient2d(upper[u - 2], upper[u - 1], sorted[i]) <= 0) u--;
+        upper[u++] = sorted[i];
+    }
+    // As duas cadeias compartilham os extremos.
+    for (int j = 1; j < u - 1; j++) {
+        hull[k++] = upper[j];
+    }
+    return k;
+}
+
+/**
+ * @brief Estado de uma execução do QuickHull.
+ */
+typedef struct {
+    Point* hull;
+    int numHull;
+    int maxDepth;       ///< Profundidade a partir da qual o QuickHull desiste.
+    int adaptive;       ///< 1 para desistir também quando a primeira divisão descarta poucos pontos.
+    int failed;         ///< 1 se o QuickHull desistiu.
+} QuickHullState;
+
+/**
+ * @brief Acrescenta ao fecho, de P até Q (exclusive), os vértices entre eles.
  *
- * Usado para encontrar o ponto mais distante em casos de colinearidade,
- * evitando o uso de `sqrt` que  computacionalmente caro.
- * @return float O quadrado da distncia.
+ * 'points' tem apenas pontos estritamente à direita de P->Q. O array é
+ * apenas permutado, então continua contendo os mesmos pontos.
  */
-static float distSq(Point p1, Point p2) {
-    float dx = p1.x - p2.x;
-    float dy = p1.y - p2.y;
-    return (dx * dx) + (dy * dy);
+static void quickHullSide(QuickHullState* state, Point* points, int count, Point p, Point q, int depth) {
+    if (count == 0 || state->failed) return;
+    if (depth > state->maxDepth) {
+        state->failed = 1;
+        return;
+    }
+
+    // O ponto mais distante de P->Q (o mais à direita) é um vértice do fecho.
+    // A comparação das orientações em double só decide quando a diferença
+    // passa da soma dos limites de erro; nos empates aparentes quem decide é
+    // crossDiffSign().
+    double dx = (double)q.x - p.x, dy = (double)q.y - p.y;
+    int far = 0;
+    double farLeft = dx * ((double)points[0].y - p.y), farRight = dy * ((double)points[0].x - p.x);
+    double farOrientation = farLeft - farRight, farMagnitude = fabs(farLeft) + fabs(farRight);
+    for (int i = 1; i < count; i++) {
+        double left = dx * ((double)points[i].y - p.y), right = dy * ((double)points[i].x - p.x);
+        double orientation = left - right, magnitude = fabs(left) + fabs(right);
+        double difference = orientation - farOrientation;
+        double slack = 2.0 * PREDICATES_CROSS_ERROR_BOUND * (magnitude + farMagnitude);
+        if (difference > slack) continue;
+        if (difference >= -slack) {
+            int closer = crossDiffSign(p, q, points[far], points[i]);
+            if (closer > 0 || (closer == 0 && !pointLess(points[i], points[far]))) continue;
+        }
+        far = i;
+        farOrientation = orientation;
+        farMagnitude = magnitude;
+    }
+    Point c = points[far];
+
+    // Particiona: primeiro os pontos à direita de P->C, depois os à direita
+    // de C->Q; os que ficam dentro do triângulo PCQ são descartados.
+    int numLeft = 0;
+    for (int i = 0; i < count; i++) {
+        if (orient2d(p, c, points[i]) < 0) {
+            Point t = points[i]; points[i] = points[numLeft]; points[numLeft] = t;
+            numLeft++;
+        }
+    }
+    int numRight = 0;
+    for (int i = numLeft; i < count; i++) {
+        if (orient2d(c, q, points[i]) < 0) {
+            Point t = points[i]; points[i] = points[numLeft + numRight]; points[numLeft + numRight] = t;
+            numRight++;
+        }
+    }
+
+    // Se quase nada caiu dentro do triângulo, os pontos estão quase todos no
+    // fecho (ex: sobre uma circunferência) e a cadeia monótona é mais rápida.
+    if (depth == 0 && state->adaptive && numLeft + numRight > count / 2) {
+        state->failed = 1;
+        return;
+    }
+
+    quickHullSide(state, points, numLeft, p, c, depth + 1);
+    if (state->failed) return;
+    state->hull[state->numHull++] = c;
+    quickHullSide(state, points + numLeft, numRight, c, q, depth + 1);
 }
 
-// --- SEO DE FUNES PBLICAS ---
+/**
+ * @brief QuickHull.
+ * @param points Os pontos (serão permutados).
+ * @param count A quantidade de pontos (> 0).
+ * @param hull Recebe o fecho (capacidade 'count').
+ * @param adaptive 1 para desistir se a primeira divisão descartar menos da metade dos pontos.
+ * @return int A quantidade de vértices do fecho, ou -1 se o QuickHull desistiu.
+ */
+static int quickHull(Point* points, int count, Point* hull, int adaptive) {
+    Point a = points[0], b = points[0];
+    for (int i = 1; i < count; i++) {
+        if (pointLess(points[i], a)) a = points[i];
+        if (pointLess(b, points[i])) b = points[i];
+    }
+    hull[0] = a;
+    if (pointEqual(a, b)) return 1;
 
-GfxPolygon* jarvisMarch(GfxPolygon* poly) {
-    // 1. Casos base: um fecho convexo requer pelo menos 3 pontos.
-    if (poly->numVertices < 3) {
-        return NULL; // Retorna NULL para indicar que a operao no  aplicvel.
-    }
-
-    // 2. Encontrar o ponto de partida: o ponto mais  esquerda (menor X).
-    // Em caso de empate, o de menor Y  escolhido.
-    int leftMostIndex = 0;
-    for (int i = 1; i < poly->numVertices; i++) {
-        if (poly->vertices[i].x < poly->vertices[leftMostIndex].x) {
-            leftMostIndex = i;
-        } else if (poly->vertices[i].x == poly->vertices[leftMostIndex].x) {
-            if (poly->vertices[i].y < poly->vertices[leftMostIndex].y) {
-                leftMostIndex = i;
-            }
+    // Pontos abaixo de A->B (à direita) e acima (à direita de B->A).
+    int numBelow = 0;
+    for (int i = 0; i < count; i++) {
+        if (orient2d(a, b, points[i]) < 0) {
+            Point t = points[i]; points[i] = points[numBelow]; points[numBelow] = t;
+            numBelow++;
+        }
+    }
+    int numAbove = 0;
+    for (int i = numBelow; i < count; i++) {
+        if (orient2d(b, a, points[i]) < 0) {
+            Point t = points[i]; points[i] = points[numBelow + numAbove]; points[numBelow + numAbove] = t;
+            numAbove++;
         }
     }
 
-    // 3. Aloca memria para o polgono do fecho e inicializa o processo.
-    GfxPolygon* convexHull = (GfxPolygon*)malloc(sizeof(GfxPolygon));
-    if (!convexHull) return NULL; // Checagem de falha de alocao
-    convexHull->numVertices = 0;
+    // Em entradas bem distribuídas a profundidade fica perto de log2(n).
+    int log2n = 0;
+    while ((1 << log2n) < count && log2n < 31) log2n++;
+    QuickHullState state = {hull, 1, 4 * log2n + 32, adaptive, 0};
+    quickHullSide(&state, points, numBelow, a, b, 0);
+    if (!state.failed) {
+        state.hull[state.numHull++] = b;
+        quickHullSide(&state, points + numBelow, numAbove, b, a, 0);
+    }
+    return state.failed ? -1 : state.numHull;
+}
 
-    int p = leftMostIndex;
-    int q;
+// --- SEÇÃO DE FUNÇÕES PÚBLICAS ---
 
-    do {
-        // Adiciona o ponto atual 'p' ao fecho.
-        addVertexToPolygon(convexHull, poly->vertices[p]);
+int convexHullPoints(const Point* points, int count, Point* hull) {
+    double profileStart = profileBegin();
+    int numHull = convexHullPointsWithEngine(HULL_ENGINE_AUTO, points, count, hull);
+    profileEnd(PROFILE_HULL, profileStart);
+    return numHull;
+}
 
-        // 'q' ser o prximo ponto mais anti-horrio.
-        // Inicializa 'q' com um candidato diferente de 'p'.
-        q = (p + 1) % poly->numVertices;
+int convexHullPointsWithEngine(HullEngine engine, const Point* points, int count, Point* hull) {
+    if (count <= 0) return 0;
 
-        // Itera por todos os pontos para encontrar o 'q' definitivo.
-        for (int i = 0; i < poly->numVertices; i++) {
-            // Se o ponto 'i' for mais anti-horrio que 'q', ele se torna o novo 'q'.
-            if (orientation(poly->vertices[p], poly->vertices[i], poly->vertices[q]) > 0) {
-                q = i;
-            }
+    Point* work = (Point*)malloc(2 * (size_t)count * sizeof(Point));
+    if (!work) {
+        fprintf(stderr, "[Hull ERROR] Memória insuficiente para o fecho de %d pontos.\n", count);
+        return -1;
+    }
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        if (isfinite(points[i].x) && isfinite(points[i].y)) work[n++] = points[i];
+    }
+    int k = 0;
+    if (n > 0) {
+        if (engine == HULL_ENGINE_QUICKHULL) {
+            k = quickHull(work, n, hull, 0);
+        } else if (engine == HULL_ENGINE_AUTO && n >= CONVEX_HULL_QUICKHULL_MIN_POINTS) {
+            k = quickHull(work, n, hull, 1);
+        } else {
+            k = -1;
+        }
+        // O QuickHull só permutou os pontos: a cadeia monótona recomeça do mesmo conjunto.
+        if (k < 0) k = monotoneChain(work, work + count, n, hull);
+    }
+    free(work);
+    return k;
+}
+
+const char* hullEngineName(HullEngine engine) {
+    switch (engine) {
+        case HULL_ENGINE_AUTO: return "automatico";
+        case HULL_ENGINE_MONOTONE_CHAIN: return "cadeia monotona";
+        case HULL_ENGINE_QUICKHULL: return "quickhull";
+        default: return "desconhecido";
+    }
+}
+
+/**
+ * @brief Transforma os vértices de um fecho em polígono, se ele tiver área.
+ */
+static GfxPolygon polygonFromHull(const Point* hull, int numHull) {
+    if (numHull < 3) return createPolygon();
+    return createPolygonFromVertices(hull, numHull);
+}
+
+GfxPolygon convexHullOfPolygon(const GfxPolygon* poly) {
+    if (poly->numVertices < 3) {
+        return createPolygon(); // Retorna um polígono vazio para indicar que a operação não é aplicável.
+    }
+    Point* hull = (Point*)malloc((size_t)poly->numVertices * sizeof(Point));
+    if (!hull) return createPolygon();
+    GfxPolygon result = polygonFromHull(hull, convexHullPoints(poly->vertices, poly->numVertices, hull));
+    free(hull);
+    return result;
+}
+
+GfxPolygon convexHullOfObjects(const int* indices, int count) {
+    objectsFlushTransforms();
+    size_t total = 0;
+    for (int k = 0; k < count; k++) {
+        switch (g_objects[indices[k]].type) {
+            case OBJECT_TYPE_POINT: total += 1; break;
+            case OBJECT_TYPE_SEGMENT: total += 2; break;
+            case OBJECT_TYPE_POLYGON: total += (size_t)getObjectPolygon(indices[k])->numVertices; break;
         }
+    }
+    if (total < 3) return createPolygon();
 
-        // Tratamento de pontos colineares.
-        // Se houver pontos colineares, escolhe o que estiver mais distante do piv 'p'.
-        // Isso garante que apenas os vrtices extremos de uma aresta colinear sejam includos.
-        for (int i = 0; i < poly->numVertices; i++) {
-            if (orientation(poly->vertices[p], poly->vertices[i], poly->vertices[q]) == 0) {
-                if (distSq(poly->vertices[p], poly->vertices[i]) > distSq(poly->vertices[p], poly->vertices[q])) {
-                    q = i;
-                }
+    // A nuvem e o fecho dividem o mesmo bloco.
+    Point* cloud = (Point*)malloc(2 * total * sizeof(Point));
+    if (!cloud) {
+        fprintf(stderr, "[Hull ERROR] Memória insuficiente para o fecho de %zu pontos.\n", total);
+        return createPolygon();
+    }
+    Point* hull = cloud + total;
+    size_t n = 0;
+    for (int k = 0; k < count; k++) {
+        int index = indices[k];
+        switch (g_objects[index].type) {
+            case OBJECT_TYPE_POINT:
+                cloud[n++] = *getObjectPoint(index);
+                break;
+            case OBJECT_TYPE_SEGMENT:
+                cloud[n++] = getObjectSegment(index)->p1;
+                cloud[n++] = getObjectSegment(index)->p2;
+                break;
+            case OBJECT_TYPE_POLYGON: {
+                GfxPolygon* poly = getObjectPolygon(index);
+                memcpy(cloud + n, poly->vertices, poly->numVertices * sizeof(Point));
+                n += (size_t)poly->numVertices;
+                break;
             }
         }
+    }
+    GfxPolygon result = polygonFromHull(hull, convexHullPoints(cloud, (int)n, hull));
+    free(cloud);
+    return result;
+}
 
-        // Atualiza o piv 'p' para ser o prximo ponto encontrado.
-        p = q;
+int convexHullReplaceObject(int index) {
+    if (g_objects[index].type != OBJECT_TYPE_POLYGON) return 0;
+    objectFlushTransform(index);
+    GfxPolygon* polygon = getObjectPolygon(index);
 
-    // O "embrulho" termina quando voltamos ao ponto de partida.
-    } while (p != leftMostIndex);
+    // A cadeia monótona ou o QuickHull, conforme o tamanho do polígono.
+    GfxPolygon hull = convexHullOfPolygon(polygon);
+    if (hull.numVertices == 0) return 0;
+
+    historyRecordHull(index, &hull);
+    freePolygon(polygon);           // Devolve os vértices antigos ao pool.
+    *polygon = hull;                // O objeto passa a ser dono do fecho.
+    objectGeometryChanged(index);
+    return 1;
+}
 
-    return convexHull;
+int convexHullAddObjectsHull(const int* indices, int count) {
+    GfxPolygon unionHull = convexHullOfObjects(indices, count);
+    if (unionHull.numVertices == 0) return -1;
+    int created = resolveObjectHandle(addPolygonObject(&unionHull));
+    if (created >= 0) historyRecordAdd(created);
+    return created;
 }
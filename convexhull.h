@@ -1,6 +1,17 @@
 /**
  * @file convexhull.h
- * @brief Define a interface pblica para os algoritros de fecho convexo.
+ * @brief Define a interface pública para os algoritmos de fecho convexo.
+ *
+ * Há dois algoritmos O(n log n): a cadeia monótona de Andrew, que ordena os
+ * pontos e tem custo garantido, e o QuickHull, que descarta cedo os pontos
+ * interiores e é mais rápido em nuvens grandes. A escolha automática usa a
+ * cadeia monótona em entradas pequenas e o QuickHull a partir de
+ * CONVEX_HULL_QUICKHULL_MIN_POINTS pontos; se o QuickHull cair no seu pior
+ * caso (recursão profunda demais), o cálculo termina pela cadeia monótona.
+ *
+ * Todos os caminhos devolvem o mesmo fecho: vértices em sentido anti-horário,
+ * a partir do ponto de menor X (e, no empate, de menor Y), sem pontos
+ * repetidos nem pontos colineares no meio das arestas.
  */
 #ifndef CONVEXHULL_H
 #define CONVEXHULL_H
@@ -8,10 +19,69 @@
 #include "polygon.h"
 
 /**
- * @brief Calcula o fecho convexo de um polgono usando o algoritmo Marcha de Jarvis.
- * @param poly O polgono original cujos vrtices sero analisados.
- * @return GfxPolygon* Um ponteiro para um novo polgono convexo alocado dinamicamente.
+ * @brief Os algoritmos de fecho convexo disponíveis.
  */
-GfxPolygon* jarvisMarch(GfxPolygon* poly);
+typedef enum {
+    HULL_ENGINE_AUTO,               ///< Escolhe pelo tamanho da entrada.
+    HULL_ENGINE_MONOTONE_CHAIN,     ///< Cadeia monótona de Andrew (ordenação + duas varreduras).
+    HULL_ENGINE_QUICKHULL,          ///< QuickHull (divisão pelo ponto mais distante).
+    HULL_ENGINE_COUNT
+} HullEngine;
+
+/**
+ * @brief Calcula o fecho convexo de uma nuvem de pontos com o algoritmo escolhido automaticamente.
+ * @param points Os pontos (não são alterados). Pontos não finitos são ignorados.
+ * @param count A quantidade de pontos.
+ * @param hull Recebe os vértices do fecho; precisa comportar 'count' pontos.
+ * @return int A quantidade de vértices do fecho (1 se todos os pontos são
+ *         iguais, 2 se são colineares), ou -1 se faltou memória.
+ */
+int convexHullPoints(const Point* points, int count, Point* hull);
+
+/**
+ * @brief Versão de convexHullPoints() com o algoritmo escolhido pelo chamador (usada pelo benchmark).
+ */
+int convexHullPointsWithEngine(HullEngine engine, const Point* points, int count, Point* hull);
+
+/**
+ * @brief Retorna o nome de um algoritmo, para mensagens e benchmarks.
+ */
+const char* hullEngineName(HullEngine engine);
+
+/**
+ * @brief Calcula o fecho convexo dos vértices de um polígono.
+ * @param poly O polígono original cujos vértices serão analisados.
+ * @return GfxPolygon Um novo polígono convexo, com vértices alocados no pool
+ *         compartilhado, ou um polígono vazio se o fecho tiver menos de 3 vértices.
+ */
+GfxPolygon convexHullOfPolygon(const GfxPolygon* poly);
+
+/**
+ * @brief Calcula o fecho convexo da união da geometria no mundo de vários objetos.
+ * @param indices Os índices dos objetos em 'g_objects'.
+ * @param count A quantidade de objetos.
+ * @return GfxPolygon Um novo polígono convexo, ou um polígono vazio se o fecho
+ *         tiver menos de 3 vértices ou faltou memória.
+ */
+GfxPolygon convexHullOfObjects(const int* indices, int count);
+
+/**
+ * @brief Troca um polígono da cena pelo seu fecho convexo (tecla 'c' e operação "hull" dos scripts).
+ *
+ * A troca fica registrada no histórico.
+ * @param index O índice do objeto em 'g_objects'.
+ * @return int 1 se o polígono foi trocado, 0 se o objeto não é um polígono ou
+ *         o fecho tem menos de 3 vértices (o objeto fica como estava).
+ */
+int convexHullReplaceObject(int index);
+
+/**
+ * @brief Acrescenta à cena o fecho convexo da união de vários objetos (tecla 'c'
+ *        com vários objetos e operação "hull-union" dos scripts).
+ *
+ * A inclusão fica registrada no histórico.
+ * @return int O índice do polígono novo, ou -1 se o fecho não tem área ou faltou memória.
+ */
+int convexHullAddObjectsHull(const int* indices, int count);
 
 #endif // CONVEXHULL_H
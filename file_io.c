@@ -1,170 +1,688 @@
 /**
  * @file file_io.c
- * @brief Implementa as funes de salvamento e carregamento de arquivos da cena.
+ * @brief Implementa as funções de salvamento e carregamento de arquivos da cena.
  *
- * O mdulo converte a lista de objetos em um formato de texto para salvamento
- * e, de forma inversa, l este formato para reconstruir a cena na memria.
+ * O módulo converte a lista de objetos em um formato de texto para salvamento
+ * e, de forma inversa, lê este formato para reconstruir a cena na memória.
+ * Arquivos com a extensão do formato binário são delegados a scenebin.c.
+ * Leitura e escrita trabalham sobre um snapshot (snapshot.h), o que permite
+ * executá-las em segundo plano.
  */
 
 #include "file_io.h"
 #include "objects.h"
 #include "point.h"
 #include "segment.h"
-#include "polygon.h"
+#include "snapshot.h"
+#include "scenebin.h"
+#include "jobs.h"
+#include "config.h"
+#include "profiler.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <stdatomic.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
 
-// --- SEO DE FUNES PBLICAS ---
+// --- SEÇÃO DE FUNÇÕES DO FORMATO DE TEXTO ---
 
-void saveSceneToFile(const char* filename) {
+/**
+ * @brief Escreve um snapshot no formato de texto. Pode rodar em qualquer thread.
+ * @param status Recebe o andamento (em objetos e vértices) e pode cancelar a escrita (NULL para ignorar).
+ * @return int 1 em caso de sucesso, 0 em caso de erro ou cancelamento.
+ */
+static int writeSceneText(const SceneSnapshot* snap, const char* filename, SceneIoStatus* status) {
     // 1. Abre o arquivo no modo de escrita ("w").
     FILE* f = fopen(filename, "w");
     if (!f) {
         printf("[ERRO] Nao foi possivel abrir '%s' para escrita.\n", filename);
-        return;
+        return 0;
     }
-
-    // 2. Conta os objetos de cada tipo para o cabealho do arquivo.
-    int pointCount = 0, lineCount = 0, polyCount = 0;
-    for (int i = 0; i < g_numObjects; i++) {
-        switch (g_objects[i].type) {
-            case OBJECT_TYPE_POINT:    pointCount++; break;
-            case OBJECT_TYPE_SEGMENT: lineCount++;  break;
-            case OBJECT_TYPE_POLYGON: polyCount++;  break;
-        }
+    if (status) {
+        atomic_store(&status->total, (long long)snapshotObjectCount(snap) + (long long)snap->numVertices);
     }
 
-    // 3. Salva a seo de PONTOS.
+    // 2. Salva a seção de PONTOS. Cada tipo já está agrupado no seu próprio
+    // array, então a contagem do cabeçalho é direta.
     fprintf(f, "[PONTOS]\n");
-    fprintf(f, "Cont: %d\n", pointCount);
-    int pi = 0;
-    for (int i = 0; i < g_numObjects; i++) {
-        if (g_objects[i].type == OBJECT_TYPE_POINT) {
-            Point* p = (Point*)g_objects[i].data;
-            fprintf(f, "P%d: %.2f, %.2f\n", pi++, p->x, p->y);
-        }
+    fprintf(f, "Cont: %d\n", snap->numPoints);
+    for (int i = 0; i < snap->numPoints; i++) {
+        fprintf(f, "P%d: %.2f, %.2f\n", i, snap->points[i].x, snap->points[i].y);
     }
     fprintf(f, "\n");
 
-    // 4. Salva a seo de LINHAS.
+    // 3. Salva a seção de LINHAS.
     fprintf(f, "[LINHAS]\n");
-    fprintf(f, "Cont: %d\n", lineCount);
-    int li = 0;
-    for (int i = 0; i < g_numObjects; i++) {
-        if (g_objects[i].type == OBJECT_TYPE_SEGMENT) {
-            Segment* s = (Segment*)g_objects[i].data;
-            fprintf(f, "L%d: (%.2f, %.2f) -> (%.2f, %.2f)\n",
-                     li++, s->p1.x, s->p1.y, s->p2.x, s->p2.y);
-        }
+    fprintf(f, "Cont: %d\n", snap->numSegments);
+    for (int i = 0; i < snap->numSegments; i++) {
+        const Segment* s = &snap->segments[i];
+        fprintf(f, "L%d: (%.2f, %.2f) -> (%.2f, %.2f)\n",
+                 i, s->p1.x, s->p1.y, s->p2.x, s->p2.y);
     }
     fprintf(f, "\n");
+    if (status) {
+        atomic_store(&status->done, (long long)snap->numPoints + snap->numSegments);
+    }
 
-    // 5. Salva a seo de POLGONOS.
+    // 4. Salva a seção de POLÍGONOS. O andamento é atualizado a cada polígono.
+    int cancelled = 0;
     fprintf(f, "[POLIGONOS]\n");
-    fprintf(f, "Cont: %d\n", polyCount);
-    int poli = 0;
-    for (int i = 0; i < g_numObjects; i++) {
-        if (g_objects[i].type == OBJECT_TYPE_POLYGON) {
-            GfxPolygon* poly = (GfxPolygon*)g_objects[i].data;
-            fprintf(f, "Poligono %d - Pontas: %d\n", poli++, poly->numVertices);
-            for (int v = 0; v < poly->numVertices; v++) {
-                fprintf(f, "  V%d: %.2f, %.2f\n", v, poly->vertices[v].x, poly->vertices[v].y);
-            }
+    fprintf(f, "Cont: %d\n", snap->numPolygons);
+    const Point* vertices = snap->vertices;
+    for (int i = 0; i < snap->numPolygons && !cancelled; i++) {
+        int numVertices = (int)snap->polygonSizes[i];
+        fprintf(f, "Poligono %d - Pontas: %d\n", i, numVertices);
+        for (int v = 0; v < numVertices; v++) {
+            fprintf(f, "  V%d: %.2f, %.2f\n", v, vertices[v].x, vertices[v].y);
+        }
+        vertices += numVertices;
+        if (status) {
+            atomic_fetch_add(&status->done, 1 + (long long)numVertices);
+            cancelled = atomic_load(&status->cancel);
+        }
+    }
+
+    // 5. Salva a seção de ANIMAÇÕES, apenas com os objetos animados. O número
+    // de cada linha é a posição do objeto na ordem em que a cena é carregada
+    // (pontos, depois linhas, depois polígonos). Os valores usam precisão
+    // total para que uma cena recarregada se comporte exatamente igual.
+    if (snap->numAnimated > 0) {
+        fprintf(f, "\n[ANIMACOES]\n");
+        fprintf(f, "Cont: %d\n", snap->numAnimated);
+        for (int k = 0; k < snap->numAnimated; k++) {
+            const SceneAnimRecord* a = &snap->anims[k];
+            fprintf(f, "A%u: %.9g, %.9g, %.9g, %d, %.9g\n", (unsigned)a->objectIndex, a->vx, a->vy,
+                    a->e, (int)a->gravity, a->vmax);
         }
     }
 
     // 6. Fecha o arquivo.
-    fclose(f);
+    int ok = !ferror(f);
+    if (fclose(f) != 0) ok = 0;
+    if (!ok) {
+        printf("[ERRO] Falha ao escrever '%s'.\n", filename);
+    }
+    return ok && !cancelled;
 }
 
-void loadSceneFromFile(const char* filename) {
-    // 1. Abre o arquivo no modo de leitura ("r").
-    FILE* f = fopen(filename, "r");
-    if (!f) {
-        printf("[ERRO] No foi possvel abrir '%s' para leitura.\n", filename);
-        return;
-    }
-
-    // 2. Limpa a cena atual para carregar a nova.
-    clearAllObjects();
-
-    char line[256];
-    int section = 0; // 0=Nenhum, 1=PONTOS, 2=LINHAS, 3=POLIGONOS
-
-    // Variaveis de estado para reconstruir polgonos.
-    int buildingPoly = 0;
-    GfxPolygon tempPoly;
-
-    // 3. L o arquivo linha por linha.
-    while (fgets(line, sizeof(line), f)) {
-        // Normaliza a linha.
-        line[strcspn(line, "\r\n")] = '\0';
-        if (line[0] == '\0') continue; // Pula linhas vazias.
-
-        // Lgica de mquina de estados para mudar a seo de leitura.
-        if (strcmp(line, "[PONTOS]") == 0)      { section = 1; continue; }
-        if (strcmp(line, "[LINHAS]") == 0)      { section = 2; continue; }
-        if (strcmp(line, "[POLIGONOS]") == 0)   { section = 3; continue; }
-        if (strstr(line, "Cont:") != NULL) continue;
-
-        // Finaliza o polgono anterior antes de ler um novo objeto
-        if (section != 3 && buildingPoly && tempPoly.numVertices > 0) {
-            GfxPolygon* poly = (GfxPolygon*)malloc(sizeof(GfxPolygon));
-            *poly = tempPoly;
-            addObject(OBJECT_TYPE_POLYGON, poly);
-            buildingPoly = 0;
+// --- SEÇÃO DO LEITOR DO FORMATO DE TEXTO ---
+// O arquivo é lido em blocos de SCENE_READ_BUFFER_SIZE bytes e percorrido
+// caractere a caractere, sem cópia por linha e sem limite de tamanho de linha.
+// A cena lida vai para um snapshot. Cada linha é lida por inteiro antes de
+// alterá-lo; uma linha malformada é relatada com a sua linha e coluna e
+// ignorada, e a leitura continua.
+
+#define MAX_REPORTED_ERRORS 10      ///< Erros impressos por arquivo; os demais só entram na contagem.
+
+static char s_readBuffer[SCENE_READ_BUFFER_SIZE];   ///< Bloco atual do arquivo sendo lido.
+
+/**
+ * @brief Potências de 10 exatas em float, usadas na conversão rápida de números.
+ */
+static const float s_powersOfTen[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+
+/**
+ * @brief Estado do leitor: a posição no bloco atual e no arquivo (para as mensagens de erro).
+ */
+typedef struct {
+    FILE* file;
+    const char* filename;
+    const char* cur;        ///< Próximo caractere a ser lido em 's_readBuffer'.
+    const char* end;        ///< Fim dos dados válidos em 's_readBuffer'.
+    int line;               ///< Linha do próximo caractere (a partir de 1).
+    int column;             ///< Coluna do próximo caractere (a partir de 1).
+    int numErrors;          ///< Linhas malformadas encontradas até agora.
+    SceneIoStatus* status;  ///< Recebe os bytes lidos e pode pedir o cancelamento (NULL para ignorar).
+    int cancelled;          ///< 1 se a leitura parou por um pedido de cancelamento.
+} SceneReader;
+
+static int peekChar(SceneReader* r) {
+    if (r->cur == r->end) {
+        if (r->cancelled) return EOF;
+        if (r->status && atomic_load(&r->status->cancel)) {
+            r->cancelled = 1;
+            return EOF;
         }
+        size_t n = fread(s_readBuffer, 1, sizeof(s_readBuffer), r->file);
+        if (n == 0) return EOF;
+        if (r->status) atomic_fetch_add(&r->status->done, (long long)n);
+        r->cur = s_readBuffer;
+        r->end = s_readBuffer + n;
+    }
+    return (unsigned char)*r->cur;
+}
 
-        // 4. Interpreta a linha com base na seo atual.
-        if (section == 1) { // Seo de PONTOS
-            float x, y;
-            int idxDummy;
-            if (sscanf(line, "P%d: %f, %f", &idxDummy, &x, &y) == 3) {
-                Point* p = (Point*)malloc(sizeof(Point));
-                *p = createPoint(x, y);
-                addObject(OBJECT_TYPE_POINT, p);
-            }
-        } else if (section == 2) { // Seo de LINHAS
-            float x1, y1, x2, y2;
-            int idxDummy;
-            if (sscanf(line, "L%d: (%f, %f) -> (%f, %f)", &idxDummy, &x1, &y1, &x2, &y2) == 5) {
-                Segment* s = (Segment*)malloc(sizeof(Segment));
-                *s = createSegment((Point){x1, y1}, (Point){x2, y2});
-                addObject(OBJECT_TYPE_SEGMENT, s);
-            }
-        } else if (section == 3) { // Seo de POLGONOS
-            // Lgica para detectar o incio de um polgono ou um novo vrtice.
-            if (strncmp(line, "Poligono", 8) == 0) {
-                if (buildingPoly && tempPoly.numVertices > 0) {
-                    GfxPolygon* poly = (GfxPolygon*)malloc(sizeof(GfxPolygon));
-                    *poly = tempPoly;
-                    addObject(OBJECT_TYPE_POLYGON, poly);
-                }
-                tempPoly = createPolygon();
-                buildingPoly = 1;
-            } else {
-                float vx, vy;
-                int vIdxDummy;
-                if (sscanf(line, "  V%d: %f, %f", &vIdxDummy, &vx, &vy) == 3) {
-                    if (buildingPoly) {
-                        if (tempPoly.numVertices < MAX_POLYGON_VERTICES) {
-                            tempPoly.vertices[tempPoly.numVertices++] = (Point){vx, vy};
-                        } else {
-                            printf("[AVISO] Vrtice ignorado: excedeu MAX_POLYGON_VERTICES.\n");
-                        }
-                    }
-                }
+static void advance(SceneReader* r) {
+    if (*r->cur == '\n') {
+        r->line++;
+        r->column = 1;
+    } else {
+        r->column++;
+    }
+    r->cur++;
+}
+
+static void skipSpaces(SceneReader* r) {
+    int c = peekChar(r);
+    while (c == ' ' || c == '\t') {
+        advance(r);
+        c = peekChar(r);
+    }
+}
+
+/**
+ * @brief Descarta o resto da linha atual, incluindo a quebra de linha.
+ */
+static void skipLine(SceneReader* r) {
+    int c = peekChar(r);
+    while (c != EOF && c != '\n') {
+        advance(r);
+        c = peekChar(r);
+    }
+    if (c == '\n') advance(r);
+}
+
+/**
+ * @brief Relata um erro na posição atual do leitor.
+ * @return int Sempre 0, para que as funções de leitura retornem o resultado direto.
+ */
+static int readError(SceneReader* r, const char* message) {
+    if (++r->numErrors <= MAX_REPORTED_ERRORS) {
+        printf("[ERRO] %s:%d:%d: %s.\n", r->filename, r->line, r->column, message);
+    }
+    return 0;
+}
+
+/**
+ * @brief Consome exatamente o texto 'literal', depois de espaços opcionais.
+ */
+static int expectLiteral(SceneReader* r, const char* literal) {
+    skipSpaces(r);
+    for (const char* p = literal; *p; p++) {
+        if (peekChar(r) != (unsigned char)*p) {
+            char message[48];
+            snprintf(message, sizeof(message), "esperado '%s'", literal);
+            return readError(r, message);
+        }
+        advance(r);
+    }
+    return 1;
+}
+
+/**
+ * @brief Consome espaços e a quebra de linha ("\n" ou "\r\n") que encerram a linha.
+ */
+static int expectEndOfLine(SceneReader* r) {
+    skipSpaces(r);
+    int c = peekChar(r);
+    if (c == '\r') {
+        advance(r);
+        c = peekChar(r);
+    }
+    if (c == '\n') {
+        advance(r);
+        return 1;
+    }
+    return c == EOF ? 1 : readError(r, "texto inesperado no fim da linha");
+}
+
+/**
+ * @brief Lê um inteiro decimal com sinal opcional.
+ */
+static int readInt(SceneReader* r, int* out) {
+    skipSpaces(r);
+    int negative = 0;
+    int c = peekChar(r);
+    if (c == '-' || c == '+') {
+        negative = (c == '-');
+        advance(r);
+        c = peekChar(r);
+    }
+    if (c < '0' || c > '9') return readError(r, "esperado um numero inteiro");
+    long long value = 0;
+    while (c >= '0' && c <= '9') {
+        if (value <= 2147483647LL) value = value * 10 + (c - '0');
+        advance(r);
+        c = peekChar(r);
+    }
+    if (value > 2147483647LL) return readError(r, "numero inteiro grande demais");
+    *out = negative ? -(int)value : (int)value;
+    return 1;
+}
+
+/**
+ * @brief Lê um número real no formato do printf ("-12.50", "3", "1.5e-07").
+ *
+ * Se a mantissa cabe em 24 bits e o expoente decimal está entre -10 e 10
+ * (caso de todos os números gravados com "%.2f"), o valor é obtido com uma
+ * única multiplicação ou divisão exata em float, que dá o mesmo resultado
+ * corretamente arredondado de strtof(). Os demais números são entregues a
+ * strtof(), a partir de uma cópia local do texto.
+ */
+static int readFloat(SceneReader* r, float* out) {
+    char text[64];
+    int length = 0;
+    int negative = 0;
+    int numDigits = 0;
+    int fraction = 0;
+    int scale = 0;
+    unsigned long mantissa = 0;
+
+    skipSpaces(r);
+    int c = peekChar(r);
+    if (c == '-' || c == '+') {
+        negative = (c == '-');
+        text[length++] = (char)c;
+        advance(r);
+        c = peekChar(r);
+    }
+    while ((c >= '0' && c <= '9') || (c == '.' && !fraction)) {
+        if (length >= (int)sizeof(text) - 1) return readError(r, "numero longo demais");
+        text[length++] = (char)c;
+        if (c == '.') {
+            fraction = 1;
+        } else {
+            numDigits++;
+            if (mantissa <= (1ul << 24)) mantissa = mantissa * 10 + (unsigned long)(c - '0');
+            if (fraction) scale--;
+        }
+        advance(r);
+        c = peekChar(r);
+    }
+    if (numDigits == 0) return readError(r, "esperado um numero");
+
+    if (c == 'e' || c == 'E') {
+        int exponent = 0;
+        int expNegative = 0;
+        if (length >= (int)sizeof(text) - 1) return readError(r, "numero longo demais");
+        text[length++] = 'e';
+        advance(r);
+        c = peekChar(r);
+        if (c == '-' || c == '+') {
+            expNegative = (c == '-');
+            if (length >= (int)sizeof(text) - 1) return readError(r, "numero longo demais");
+            text[length++] = (char)c;
+            advance(r);
+            c = peekChar(r);
+        }
+        if (c < '0' || c > '9') return readError(r, "expoente malformado");
+        while (c >= '0' && c <= '9') {
+            if (length >= (int)sizeof(text) - 1) return readError(r, "numero longo demais");
+            text[length++] = (char)c;
+            if (exponent < 10000) exponent = exponent * 10 + (c - '0');
+            advance(r);
+            c = peekChar(r);
+        }
+        scale += expNegative ? -exponent : exponent;
+    }
+
+    if (mantissa <= (1ul << 24) && scale >= -10 && scale <= 10) {
+        float value = (float)mantissa;
+        value = scale < 0 ? value / s_powersOfTen[-scale] : value * s_powersOfTen[scale];
+        *out = negative ? -value : value;
+    } else {
+        text[length] = '\0';
+        *out = strtof(text, NULL);
+    }
+    return 1;
+}
+
+/**
+ * @brief Lê um par "x, y".
+ */
+static int readCoordinates(SceneReader* r, Point* p) {
+    return readFloat(r, &p->x) && expectLiteral(r, ",") && readFloat(r, &p->y);
+}
+
+/**
+ * @brief Lê uma linha não vazia e acrescenta o seu conteúdo ao snapshot.
+ *
+ * O snapshot só é alterado depois que a linha inteira foi lida sem erros.
+ * @return int 1 se a linha era válida, 0 se um erro foi relatado.
+ */
+static int parseSceneLine(SceneReader* r, int* section, SceneSnapshot* snap) {
+    int c = peekChar(r);
+    int idx;
+
+    // Lógica de máquina de estados para mudar a seção de leitura.
+    if (c == '[') {
+        char name[16];
+        int length = 0;
+        advance(r);
+        while ((c = peekChar(r)) != ']' && c != '\n' && c != EOF) {
+            if (length < (int)sizeof(name) - 1) name[length++] = (char)c;
+            advance(r);
+        }
+        name[length] = '\0';
+        if (!expectLiteral(r, "]")) return 0;
+
+        int next = 0; // 0=Nenhum, 1=PONTOS, 2=LINHAS, 3=POLIGONOS, 4=ANIMACOES
+        if (strcmp(name, "PONTOS") == 0)         next = 1;
+        else if (strcmp(name, "LINHAS") == 0)    next = 2;
+        else if (strcmp(name, "POLIGONOS") == 0) next = 3;
+        else if (strcmp(name, "ANIMACOES") == 0) next = 4;
+        else return readError(r, "secao desconhecida");
+        if (!expectEndOfLine(r)) return 0;
+
+        snapshotEndPolygon(snap);
+        *section = next;
+        return 1;
+    }
+
+    // A contagem de cada seção reserva de uma vez o espaço dos objetos.
+    if (c == 'C') {
+        int count;
+        if (!expectLiteral(r, "Cont:") || !readInt(r, &count) || !expectEndOfLine(r)) return 0;
+        if (count > 0 && !snapshotReserve(snap, *section == 1 ? count : 0, *section == 2 ? count : 0,
+                                          *section == 3 ? count : 0)) {
+            return readError(r, "memoria insuficiente");
+        }
+        return 1;
+    }
+
+    switch (*section) {
+        case 1: { // Seção de PONTOS: "P<i>: x, y"
+            Point p;
+            if (!expectLiteral(r, "P") || !readInt(r, &idx) || !expectLiteral(r, ":") ||
+                !readCoordinates(r, &p) || !expectEndOfLine(r)) return 0;
+            return snapshotAddPoint(snap, p) || readError(r, "memoria insuficiente");
+        }
+        case 2: { // Seção de LINHAS: "L<i>: (x1, y1) -> (x2, y2)"
+            Segment s;
+            if (!expectLiteral(r, "L") || !readInt(r, &idx) || !expectLiteral(r, ":") ||
+                !expectLiteral(r, "(") || !readCoordinates(r, &s.p1) || !expectLiteral(r, ")") ||
+                !expectLiteral(r, "->") ||
+                !expectLiteral(r, "(") || !readCoordinates(r, &s.p2) || !expectLiteral(r, ")") ||
+                !expectEndOfLine(r)) return 0;
+            return snapshotAddSegment(snap, s) || readError(r, "memoria insuficiente");
+        }
+        case 3: { // Seção de POLÍGONOS: "Poligono <i> - Pontas: <n>" seguido de "V<i>: x, y"
+            if (c == 'P') {
+                int numVertices;
+                if (!expectLiteral(r, "Poligono") || !readInt(r, &idx) || !expectLiteral(r, "-") ||
+                    !expectLiteral(r, "Pontas:") || !readInt(r, &numVertices) || !expectEndOfLine(r)) return 0;
+                // O espaço dos vértices é reservado com o tamanho anunciado no cabeçalho.
+                return snapshotBeginPolygon(snap, numVertices) || readError(r, "memoria insuficiente");
             }
+            Point v;
+            if (!expectLiteral(r, "V") || !readInt(r, &idx) || !expectLiteral(r, ":") ||
+                !readCoordinates(r, &v) || !expectEndOfLine(r)) return 0;
+            if (!snap->polygonOpen) return readError(r, "vertice fora de um poligono");
+            return snapshotAddVertex(snap, v) || readError(r, "memoria insuficiente");
         }
+        case 4: { // Seção de ANIMAÇÕES: "A<i>: vx, vy, e, gravidade, vmax"
+            // Todos os objetos já foram lidos, na mesma ordem usada ao salvar.
+            SceneAnimRecord a;
+            int gravity;
+            if (!expectLiteral(r, "A") || !readInt(r, &idx) || !expectLiteral(r, ":") ||
+                !readFloat(r, &a.vx) || !expectLiteral(r, ",") || !readFloat(r, &a.vy) || !expectLiteral(r, ",") ||
+                !readFloat(r, &a.e) || !expectLiteral(r, ",") || !readInt(r, &gravity) || !expectLiteral(r, ",") ||
+                !readFloat(r, &a.vmax) || !expectEndOfLine(r)) return 0;
+            if (idx < 0 || idx >= snapshotObjectCount(snap)) return readError(r, "indice de objeto inexistente");
+            a.objectIndex = (uint32_t)idx;
+            a.gravity = gravity;
+            return snapshotAddAnim(snap, &a) || readError(r, "memoria insuficiente");
+        }
+        default:
+            return readError(r, "linha fora de uma secao");
     }
+}
 
-    // 5. Finaliza o ltimo polgono se o arquivo terminou durante sua leitura.
-    if (buildingPoly && tempPoly.numVertices > 0) {
-        GfxPolygon* poly = (GfxPolygon*)malloc(sizeof(GfxPolygon));
-        *poly = tempPoly;
-        addObject(OBJECT_TYPE_POLYGON, poly);
+/**
+ * @brief Lê um arquivo de texto para um snapshot vazio. Pode rodar em qualquer thread.
+ * @param status Recebe o andamento (em bytes) e pode cancelar a leitura (NULL para ignorar).
+ * @return int 1 se o arquivo foi lido até o fim (linhas malformadas são ignoradas),
+ *         0 se não pôde ser aberto, houve erro de leitura ou a leitura foi cancelada.
+ */
+static int readSceneText(const char* filename, SceneSnapshot* snap, SceneIoStatus* status) {
+    // 1. Abre o arquivo no modo binário: as quebras "\r\n" são tratadas pelo leitor.
+    FILE* f = fopen(filename, "rb");
+    if (!f) {
+        printf("[ERRO] Não foi possível abrir '%s' para leitura.\n", filename);
+        return 0;
+    }
+    if (status && fseek(f, 0, SEEK_END) == 0) {
+        atomic_store(&status->total, (long long)ftell(f));
+        rewind(f);
     }
 
-    // 6. Fecha o arquivo.
+    SceneReader reader = {f, filename, s_readBuffer, s_readBuffer, 1, 1, 0, status, 0};
+    int section = 0;
+
+    // 2. Lê o arquivo linha por linha, pulando as linhas vazias.
+    for (;;) {
+        skipSpaces(&reader);
+        int c = peekChar(&reader);
+        if (c == EOF) break;
+        if (c == '\r' || c == '\n' || !parseSceneLine(&reader, &section, snap)) {
+            skipLine(&reader);
+        }
+    }
+
+    // 3. Finaliza o último polígono se o arquivo terminou durante sua leitura.
+    snapshotEndPolygon(snap);
+
+    int ok = !reader.cancelled;
+    if (ferror(f)) {
+        printf("[ERRO] Falha de leitura em '%s'.\n", filename);
+        ok = 0;
+    }
+    if (reader.numErrors > MAX_REPORTED_ERRORS) {
+        printf("[ERRO] %s: %d linhas malformadas ignoradas no total.\n", filename, reader.numErrors);
+    }
+
+    // 4. Fecha o arquivo.
     fclose(f);
+    return ok;
+}
+
+// --- SEÇÃO DE ESCOLHA DO FORMATO ---
+
+int replaceSceneFile(const char* from, const char* to) {
+#ifdef _WIN32
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(from, to) == 0;
+#endif
+}
+
+int writeSceneFile(const SceneSnapshot* snap, const char* filename, SceneIoStatus* status) {
+    size_t length = strlen(filename);
+    char* tempName = (char*)malloc(length + 5);
+    if (!tempName) return 0;
+    double profileStart = profileBegin();
+    memcpy(tempName, filename, length);
+    memcpy(tempName + length, ".tmp", 5);
+
+    int ok = sceneFileIsBinary(filename) ? writeSceneBinary(snap, tempName, status)
+                                         : writeSceneText(snap, tempName, status);
+    if (ok && !replaceSceneFile(tempName, filename)) {
+        printf("[ERRO] Nao foi possivel substituir '%s'.\n", filename);
+        ok = 0;
+    }
+    if (!ok) remove(tempName);
+    free(tempName);
+    profileEnd(PROFILE_SCENE_WRITE, profileStart);
+    return ok;
+}
+
+int readSceneFile(const char* filename, SceneSnapshot* snap, SceneIoStatus* status) {
+    double profileStart = profileBegin();
+    int ok = sceneFileIsBinary(filename) ? readSceneBinary(filename, snap, status)
+                                         : readSceneText(filename, snap, status);
+    profileEnd(PROFILE_SCENE_READ, profileStart);
+    return ok;
+}
+
+// --- SEÇÃO DE OPERAÇÕES EM SEGUNDO PLANO ---
+// Um salvamento copia a cena para um snapshot na thread principal (uma cópia
+// de memória) e o escreve em uma tarefa em segundo plano. Um carregamento lê
+// o arquivo para um snapshot na tarefa, e a cena só é trocada em
+// sceneIoPoll(), chamada pela thread principal entre dois quadros.
+
+typedef enum {
+    SCENE_IO_NONE,
+    SCENE_IO_SAVE,
+    SCENE_IO_LOAD
+} SceneIoKind;
+
+static JobTask* s_task = NULL;                  ///< A tarefa em andamento (NULL se nenhuma).
+static SceneIoKind s_taskKind = SCENE_IO_NONE;
+static char* s_taskFile = NULL;                 ///< Cópia do nome do arquivo da tarefa.
+static SceneSnapshot s_taskSnapshot;            ///< A cena sendo escrita ou lida.
+static SceneIoStatus s_taskStatus;
+static int s_taskOk = 0;                        ///< Resultado da tarefa (válido após 's_taskFinished').
+static _Atomic int s_taskFinished = 0;          ///< Posto em 1 pela tarefa ao terminar.
+
+static void saveTask(void* ctx) {
+    (void)ctx;
+    s_taskOk = writeSceneFile(&s_taskSnapshot, s_taskFile, &s_taskStatus);
+    atomic_store(&s_taskFinished, 1);
+}
+
+static void loadTask(void* ctx) {
+    (void)ctx;
+    s_taskOk = readSceneFile(s_taskFile, &s_taskSnapshot, &s_taskStatus);
+    atomic_store(&s_taskFinished, 1);
+}
+
+/**
+ * @brief Libera os recursos da tarefa que acabou de terminar.
+ */
+static void finishTask(void) {
+    snapshotFree(&s_taskSnapshot);
+    free(s_taskFile);
+    s_taskFile = NULL;
+    s_taskKind = SCENE_IO_NONE;
+}
+
+/**
+ * @brief Inicia a tarefa em segundo plano; 's_taskSnapshot' já deve estar pronto.
+ */
+static int startTask(SceneIoKind kind, const char* filename, JobTaskFunc func) {
+    size_t length = strlen(filename) + 1;
+    s_taskFile = (char*)malloc(length);
+    if (!s_taskFile) {
+        finishTask();
+        return 0;
+    }
+    memcpy(s_taskFile, filename, length);
+    atomic_store(&s_taskStatus.done, 0);
+    atomic_store(&s_taskStatus.total, 0);
+    atomic_store(&s_taskStatus.cancel, 0);
+    atomic_store(&s_taskFinished, 0);
+    s_taskKind = kind;
+
+    s_task = jobsSpawn(func, NULL);
+    if (!s_task) {
+        finishTask();
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Recusa uma nova operação enquanto outra estiver em andamento.
+ */
+static int refuseIfBusy(void) {
+    if (!s_task) return 0;
+    printf("[AVISO] Ja existe um salvamento ou carregamento em andamento.\n");
+    return 1;
+}
+
+// --- SEÇÃO DE FUNÇÕES PÚBLICAS ---
+
+void saveSceneToFile(const char* filename) {
+    SceneSnapshot snap;
+    snapshotInit(&snap);
+    if (snapshotCapture(&snap)) {
+        writeSceneFile(&snap, filename, NULL);
+    }
+    snapshotFree(&snap);
+}
+
+void loadSceneFromFile(const char* filename) {
+    SceneSnapshot snap;
+    snapshotInit(&snap);
+    if (readSceneFile(filename, &snap, NULL)) {
+        snapshotInstall(&snap);
+    }
+    snapshotFree(&snap);
+}
+
+int saveSceneAsync(const char* filename) {
+    if (refuseIfBusy()) return 0;
+    snapshotInit(&s_taskSnapshot);
+    if (!snapshotCapture(&s_taskSnapshot) || !startTask(SCENE_IO_SAVE, filename, saveTask)) {
+        finishTask();
+        printf("[ERRO] Nao foi possivel iniciar o salvamento de '%s'.\n", filename);
+        return 0;
+    }
+    printf("[INFO] Salvando '%s' em segundo plano...\n", filename);
+    return 1;
+}
+
+int loadSceneAsync(const char* filename) {
+    if (refuseIfBusy()) return 0;
+    snapshotInit(&s_taskSnapshot);
+    if (!startTask(SCENE_IO_LOAD, filename, loadTask)) {
+        printf("[ERRO] Nao foi possivel iniciar o carregamento de '%s'.\n", filename);
+        return 0;
+    }
+    printf("[INFO] Carregando '%s' em segundo plano...\n", filename);
+    return 1;
+}
+
+int sceneIoBusy(void) {
+    return s_task != NULL;
+}
+
+float sceneIoProgress(void) {
+    long long total = atomic_load(&s_taskStatus.total);
+    long long done = atomic_load(&s_taskStatus.done);
+    if (!s_task || total <= 0) return 0.0f;
+    return done >= total ? 1.0f : (float)done / (float)total;
+}
+
+void sceneIoCancel(void) {
+    if (s_task) {
+        atomic_store(&s_taskStatus.cancel, 1);
+    }
+}
+
+int sceneIoPoll(void) {
+    if (!s_task || !atomic_load(&s_taskFinished)) return 0;
+    jobsJoin(s_task);
+    s_task = NULL;
+
+    int cancelled = atomic_load(&s_taskStatus.cancel);
+    if (cancelled && s_taskKind == SCENE_IO_SAVE && s_taskOk) {
+        // O pedido chegou depois de o arquivo ter sido escrito e trocado por
+        // inteiro: o salvamento valeu. Um carregamento pronto ainda pode ser
+        // descartado, porque a cena só muda abaixo.
+        cancelled = 0;
+    }
+    if (cancelled) {
+        printf("[INFO] Operacao com '%s' cancelada; a cena nao foi alterada.\n", s_taskFile);
+    } else if (!s_taskOk) {
+        printf("[ERRO] Falha ao %s '%s'.\n", s_taskKind == SCENE_IO_SAVE ? "salvar" : "carregar", s_taskFile);
+    } else if (s_taskKind == SCENE_IO_LOAD) {
+        // A troca acontece inteira aqui, entre dois quadros.
+        snapshotInstall(&s_taskSnapshot);
+        printf("[INFO] Cena '%s' carregada: %d objetos.\n", s_taskFile, g_numObjects);
+    } else {
+        printf("[INFO] Cena salva em '%s'.\n", s_taskFile);
+    }
+    finishTask();
+    return 1;
+}
+
+void sceneIoShutdown(void) {
+    if (!s_task) return;
+    sceneIoCancel();
+    jobsJoin(s_task);
+    s_task = NULL;
+    finishTask();
 }
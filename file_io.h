@@ -1,9 +1,11 @@
 /**
  * @file file_io.h
- * @brief Define a interface para as funes de entrada e sada de arquivos.
+ * @brief Define a interface para as funções de entrada e saída de arquivos.
  *
- * Mdulo responsvel por salvar o estado da cena em um arquivo e carreg-lo,
- * garantindo a persistncia dos dados entre as sesses.
+ * Módulo responsável por salvar o estado da cena em um arquivo e carregá-lo,
+ * garantindo a persistência dos dados entre as sessões. O formato é escolhido
+ * pela extensão: SCENE_BINARY_EXTENSION usa o formato binário (scenebin.h) e
+ * qualquer outra usa o formato de texto.
  */
 
 #ifndef FILE_IO_H
@@ -11,25 +13,114 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include "snapshot.h"
 
-// --- SEO DE PROTTIPOS DE FUNES PBLICAS ---
+// --- SEÇÃO DE PROTÓTIPOS DE FUNÇÕES PÚBLICAS ---
 
 /**
- * @brief Salva todos os objetos da cena atual em um arquivo de texto.
+ * @brief Salva todos os objetos da cena atual em um arquivo, esperando a escrita terminar.
  *
- * O arquivo ser formatado com sees para cada tipo de objeto (pontos,
- * linhas e polgonos), facilitando a leitura.
- * @param filename O nome do arquivo onde a cena ser salva (ex: "meu_desenho.txt").
+ * O arquivo será formatado com seções para cada tipo de objeto (pontos,
+ * linhas e polígonos), facilitando a leitura. O estado dos objetos animados
+ * vai em uma seção adicional, ignorada por versões anteriores do programa.
+ * @param filename O nome do arquivo onde a cena será salva (ex: "meu_desenho.txt").
  */
 void saveSceneToFile(const char* filename);
 
 /**
- * @brief Limpa a cena atual e carrega os objetos de um arquivo de texto.
+ * @brief Substitui a cena atual pelos objetos de um arquivo, esperando a leitura terminar.
  *
- * A funo utiliza uma lgica de mquina de estados para interpretar o arquivo
- * e recriar os objetos na memria.
- * @param filename O nome do arquivo de onde a cena ser carregada.
+ * A função utiliza uma lógica de máquina de estados para interpretar o arquivo
+ * e recriar os objetos na memória. Se o arquivo não puder ser lido, a cena
+ * atual não é alterada.
+ * @param filename O nome do arquivo de onde a cena será carregada.
  */
 void loadSceneFromFile(const char* filename);
 
+// --- SEÇÃO DE LEITURA E ESCRITA DE SNAPSHOTS ---
+// Podem rodar em qualquer thread; não tocam na cena.
+
+/**
+ * @brief Escreve um snapshot no formato indicado pela extensão do arquivo.
+ *
+ * O conteúdo vai primeiro para "<arquivo>.tmp", que só substitui o arquivo
+ * no fim: uma falha ou um cancelamento nunca deixa a cena antiga pela metade.
+ * @param snap O snapshot a ser escrito.
+ * @param filename O nome do arquivo de destino.
+ * @param status Recebe o andamento e pode cancelar a escrita (NULL para ignorar).
+ * @return int 1 em caso de sucesso, 0 em caso de erro ou cancelamento.
+ */
+int writeSceneFile(const SceneSnapshot* snap, const char* filename, SceneIoStatus* status);
+
+/**
+ * @brief Lê um arquivo, no formato indicado pela sua extensão, para um snapshot vazio.
+ * @param filename O nome do arquivo.
+ * @param snap Recebe a cena lida.
+ * @param status Recebe o andamento e pode cancelar a leitura (NULL para ignorar).
+ * @return int 1 em caso de sucesso, 0 se o arquivo não pôde ser lido ou a leitura foi cancelada.
+ */
+int readSceneFile(const char* filename, SceneSnapshot* snap, SceneIoStatus* status);
+
+/**
+ * @brief Troca o arquivo 'to' pelo arquivo 'from' em um único passo, removendo 'from'.
+ * @return int 1 em caso de sucesso, 0 caso contrário.
+ */
+int replaceSceneFile(const char* from, const char* to);
+
+// --- SEÇÃO DE SALVAMENTO E CARREGAMENTO EM SEGUNDO PLANO ---
+// Apenas uma operação roda por vez. Todas as funções abaixo devem ser
+// chamadas na thread principal.
+
+/**
+ * @brief Copia a cena atual e a salva em segundo plano.
+ *
+ * A cópia é só de memória; a formatação e a escrita no disco acontecem em
+ * outra thread, e a cena pode continuar sendo editada enquanto isso.
+ * @param filename O nome do arquivo onde a cena será salva.
+ * @return int 1 se o salvamento começou, 0 se outra operação está em andamento ou houve erro.
+ */
+int saveSceneAsync(const char* filename);
+
+/**
+ * @brief Carrega uma cena em segundo plano.
+ *
+ * O arquivo é lido em outra thread, e a cena atual só é substituída em
+ * sceneIoPoll() depois que a leitura terminar com sucesso.
+ * @param filename O nome do arquivo de onde a cena será carregada.
+ * @return int 1 se o carregamento começou, 0 se outra operação está em andamento ou houve erro.
+ */
+int loadSceneAsync(const char* filename);
+
+/**
+ * @brief Retorna 1 se há um salvamento ou carregamento em andamento.
+ */
+int sceneIoBusy(void);
+
+/**
+ * @brief Retorna o andamento da operação atual, de 0 a 1.
+ */
+float sceneIoProgress(void);
+
+/**
+ * @brief Pede que a operação atual pare; a cena e o arquivo de destino ficam como estavam.
+ *
+ * Um salvamento cujo arquivo já foi escrito por inteiro não é desfeito, e
+ * sceneIoPoll() o informa como concluído.
+ */
+void sceneIoCancel(void);
+
+/**
+ * @brief Conclui a operação em segundo plano se ela terminou.
+ *
+ * Deve ser chamada periodicamente entre dois quadros. Se um carregamento
+ * terminou, é aqui que a cena é trocada pela cena lida.
+ * @return int 1 se uma operação foi concluída nesta chamada, 0 caso contrário.
+ */
+int sceneIoPoll(void);
+
+/**
+ * @brief Cancela e espera a operação em andamento (usada no encerramento do programa).
+ */
+void sceneIoShutdown(void);
+
 #endif // FILE_IO_H
@@ -0,0 +1,694 @@
+/**
+ * @file history.c
+ * @brief Implementação do histórico de edições.
+ *
+ * Os comandos ficam em um array, em ordem, e os dados de cada um em um
+ * trecho contíguo da arena. Os comandos em [s_firstCommand, s_cursor) estão
+ * aplicados e os em [s_cursor, s_numCommands) foram desfeitos. Descartar o
+ * mais antigo só avança o início do array e da arena; o espaço livre no
+ * início é recuperado (com um memmove) quando falta espaço no fim.
+ *
+ * Formato dos dados na arena:
+ *   HISTORY_OP_ADD/DELETE: 'count' HistoryObjectRecord e, em seguida, os vértices de todos eles;
+ *   HISTORY_OP_TRANSFORM:  um HistoryTransformRecord e 'count' referências (int);
+ *   HISTORY_OP_HULL:       um HistoryHullRecord, os vértices antigos e os vértices do fecho.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "history.h"
+#include "config.h"
+#include "objects.h"
+#include "polygon.h"
+#include "animation.h"
+#include "journal.h"
+
+// --- SEÇÃO DE ESTRUTURAS PRIVADAS ---
+
+/**
+ * @brief Os tipos de comando.
+ */
+typedef enum {
+    HISTORY_OP_ADD,             ///< Objetos criados: desfazer os remove, refazer os reinsere.
+    HISTORY_OP_DELETE,          ///< Objetos excluídos: desfazer os reinsere, refazer os remove.
+    HISTORY_OP_TRANSFORM,       ///< Desfazer aplica a inversa, refazer aplica a matriz.
+    HISTORY_OP_HULL             ///< Desfazer volta aos vértices antigos, refazer ao fecho.
+} HistoryOp;
+
+/**
+ * @brief Um comando do histórico. Os dados ficam na arena.
+ */
+typedef struct {
+    HistoryOp op;
+    int count;                  ///< Quantidade de objetos afetados.
+    size_t offset;              ///< Início dos dados na arena.
+    size_t size;                ///< Tamanho dos dados, em bytes.
+} HistoryCommand;
+
+/**
+ * @brief Um objeto guardado por um comando de inserção ou exclusão.
+ */
+typedef struct {
+    int ref;                    ///< Referência do histórico para o objeto.
+    ObjectType type;
+    int numVertices;            ///< 1 para pontos, 2 para segmentos.
+    AnimSlot anim;              ///< O estado da animação quando o objeto saiu (ou entrou) na cena.
+} HistoryObjectRecord;
+
+/**
+ * @brief Os dados de uma transformação, seguidos das referências dos objetos.
+ */
+typedef struct {
+    Matrix3x3 forward;
+    Matrix3x3 inverse;
+} HistoryTransformRecord;
+
+/**
+ * @brief Os dados de uma troca pelo fecho convexo, seguidos dos vértices.
+ */
+typedef struct {
+    int ref;
+    int numOldVertices;
+    int numNewVertices;
+} HistoryHullRecord;
+
+/**
+ * @brief Uma referência do histórico para um objeto.
+ *
+ * Uma entrada ocupada guarda o handle atual do objeto e quantos comandos a
+ * usam; uma entrada livre guarda (em 'next') a próxima entrada livre.
+ */
+typedef struct {
+    ObjectHandle handle;
+    int useCount;               ///< 0 em entradas livres.
+    int next;
+} HistoryRef;
+
+// Os dados de cada comando começam alinhados a este tamanho na arena.
+#define HISTORY_ALIGN 8
+#define HISTORY_ALIGN_UP(n) (((n) + (HISTORY_ALIGN - 1)) & ~(size_t)(HISTORY_ALIGN - 1))
+
+// --- SEÇÃO DE VARIÁVEIS PRIVADAS DO MÓDULO ---
+
+static HistoryCommand* s_commands = NULL;
+static int s_commandCapacity = 0;
+static int s_firstCommand = 0;              ///< O comando mais antigo ainda guardado.
+static int s_numCommands = 0;               ///< Fim dos comandos guardados (aplicados ou desfeitos).
+static int s_cursor = 0;                    ///< O próximo comando a refazer.
+
+static unsigned char* s_arena = NULL;
+static size_t s_arenaCapacity = 0;
+static size_t s_arenaStart = 0;             ///< Início dos dados do comando mais antigo.
+static size_t s_arenaEnd = 0;               ///< Fim dos dados do comando mais recente.
+
+static size_t s_budget = HISTORY_MEMORY_BUDGET;
+static int s_recording = 1;                 ///< 0 enquanto historySetRecording() desligar o registro.
+
+static HistoryRef* s_refs = NULL;
+static int s_refCapacity = 0;
+static int s_freeRefHead = -1;
+
+static int s_merging = 0;                   ///< 1 entre historyBeginMerge() e historyEndMerge().
+static int s_mergeCommand = -1;             ///< O comando que recebe as transformações da sequência atual.
+
+// --- SEÇÃO DE REFERÊNCIAS ---
+
+/**
+ * @brief Retorna a referência de um objeto (criando-a se preciso) e conta mais um uso.
+ * @return int A referência, ou -1 se faltou memória.
+ */
+static int refAcquire(int index) {
+    Object* obj = &g_objects[index];
+    if (obj->historyRef != -1) {
+        s_refs[obj->historyRef].useCount++;
+        return obj->historyRef;
+    }
+    if (s_freeRefHead == -1) {
+        int newCapacity = s_refCapacity > 0 ? s_refCapacity * 2 : INITIAL_OBJECT_CAPACITY;
+        HistoryRef* refs = (HistoryRef*)realloc(s_refs, newCapacity * sizeof(HistoryRef));
+        if (!refs) return -1;
+        for (int i = s_refCapacity; i < newCapacity; i++) {
+            refs[i].useCount = 0;
+            refs[i].next = (i + 1 < newCapacity) ? i + 1 : -1;
+        }
+        s_refs = refs;
+        s_freeRefHead = s_refCapacity;
+        s_refCapacity = newCapacity;
+    }
+    int ref = s_freeRefHead;
+    s_freeRefHead = s_refs[ref].next;
+    s_refs[ref].handle = getObjectHandle(index);
+    s_refs[ref].useCount = 1;
+    obj->historyRef = ref;
+    return ref;
+}
+
+/**
+ * @brief Conta um uso a menos; a referência sem usos é liberada e desligada do objeto.
+ */
+static void refRelease(int ref) {
+    if (--s_refs[ref].useCount > 0) return;
+    int index = resolveObjectHandle(s_refs[ref].handle);
+    if (index != -1) {
+        g_objects[index].historyRef = -1;
+    }
+    s_refs[ref].next = s_freeRefHead;
+    s_freeRefHead = ref;
+}
+
+/**
+ * @brief Retorna o índice atual do objeto de uma referência (-1 se ele não está na cena).
+ */
+static int refResolve(int ref) {
+    return resolveObjectHandle(s_refs[ref].handle);
+}
+
+/**
+ * @brief Liga uma referência ao objeto que acabou de ser reinserido por um desfazer ou refazer.
+ */
+static void refRebind(int ref, int index) {
+    s_refs[ref].handle = getObjectHandle(index);
+    g_objects[index].historyRef = ref;
+}
+
+// --- SEÇÃO DE FUNÇÕES AUXILIARES (IMPLEMENTAÇÃO PRIVADA) ---
+
+static void* commandData(const HistoryCommand* cmd) {
+    return s_arena + cmd->offset;
+}
+
+/**
+ * @brief Libera as referências usadas por um comando.
+ */
+static void releaseCommandRefs(const HistoryCommand* cmd) {
+    switch (cmd->op) {
+        case HISTORY_OP_ADD:
+        case HISTORY_OP_DELETE: {
+            const HistoryObjectRecord* records = (const HistoryObjectRecord*)commandData(cmd);
+            for (int k = 0; k < cmd->count; k++) refRelease(records[k].ref);
+            break;
+        }
+        case HISTORY_OP_TRANSFORM: {
+            const int* refs = (const int*)((const HistoryTransformRecord*)commandData(cmd) + 1);
+            for (int k = 0; k < cmd->count; k++) refRelease(refs[k]);
+            break;
+        }
+        case HISTORY_OP_HULL:
+            refRelease(((const HistoryHullRecord*)commandData(cmd))->ref);
+            break;
+    }
+}
+
+/**
+ * @brief Descarta o comando mais antigo.
+ */
+static void evictOldest(void) {
+    const HistoryCommand* cmd = &s_commands[s_firstCommand];
+    releaseCommandRefs(cmd);
+    s_arenaStart = cmd->offset + cmd->size;
+    s_firstCommand++;
+    if (s_cursor < s_firstCommand) s_cursor = s_firstCommand;
+    if (s_mergeCommand != -1 && s_mergeCommand < s_firstCommand) s_mergeCommand = -1;
+    if (s_firstCommand == s_numCommands) {
+        s_firstCommand = s_numCommands = s_cursor = 0;
+        s_arenaStart = s_arenaEnd = 0;
+    }
+}
+
+/**
+ * @brief Descarta os comandos desfeitos, que não podem mais ser refeitos depois de uma edição nova.
+ */
+static void discardRedo(void) {
+    if (s_cursor == s_numCommands) return;
+    s_arenaEnd = s_commands[s_cursor].offset;
+    for (int i = s_cursor; i < s_numCommands; i++) {
+        releaseCommandRefs(&s_commands[i]);
+    }
+    s_numCommands = s_cursor;
+    if (s_mergeCommand >= s_cursor) s_mergeCommand = -1;
+    if (s_firstCommand == s_numCommands) {
+        s_firstCommand = s_numCommands = s_cursor = 0;
+        s_arenaStart = s_arenaEnd = 0;
+    }
+}
+
+/**
+ * @brief Descarta comandos antigos até o histórico caber no limite.
+ */
+static void enforceBudget(void) {
+    while (s_numCommands > s_firstCommand && historyMemoryUsed() > s_budget) {
+        evictOldest();
+    }
+}
+
+/**
+ * @brief Abre um comando novo no fim do histórico, com 'size' bytes de dados na arena.
+ *
+ * Descarta os comandos desfeitos e, depois, os mais antigos que não cabem
+ * mais no limite. Um comando maior do que o limite inteiro não é guardado:
+ * o histórico é esvaziado, já que os comandos anteriores não poderiam mais
+ * ser desfeitos em ordem.
+ * @return HistoryCommand* O comando (com os dados ainda por preencher), ou NULL.
+ */
+static HistoryCommand* pushCommand(HistoryOp op, int count, size_t size) {
+    discardRedo();
+    size_t aligned = HISTORY_ALIGN_UP(size);
+    if (aligned + sizeof(HistoryCommand) > s_budget) {
+        fprintf(stderr, "[History ERROR] Edição de %zu bytes maior do que o limite do histórico; o histórico foi esvaziado.\n", aligned);
+        historyClear();
+        return NULL;
+    }
+    // Abre espaço no limite antes de crescer os arrays.
+    while (s_numCommands > s_firstCommand &&
+           historyMemoryUsed() + aligned + sizeof(HistoryCommand) > s_budget) {
+        evictOldest();
+    }
+
+    // Recupera o espaço dos comandos descartados antes de realocar.
+    if (s_numCommands == s_commandCapacity && s_firstCommand > 0) {
+        memmove(s_commands, s_commands + s_firstCommand, (s_numCommands - s_firstCommand) * sizeof(HistoryCommand));
+        s_numCommands -= s_firstCommand;
+        s_cursor -= s_firstCommand;
+        if (s_mergeCommand != -1) s_mergeCommand -= s_firstCommand;
+        s_firstCommand = 0;
+    }
+    if (s_numCommands == s_commandCapacity) {
+        int newCapacity = s_commandCapacity > 0 ? s_commandCapacity * 2 : INITIAL_OBJECT_CAPACITY;
+        HistoryCommand* commands = (HistoryCommand*)realloc(s_commands, newCapacity * sizeof(HistoryCommand));
+        if (!commands) {
+            fprintf(stderr, "[History ERROR] Memória insuficiente para o histórico; o histórico foi esvaziado.\n");
+            historyClear();
+            return NULL;
+        }
+        s_commands = commands;
+        s_commandCapacity = newCapacity;
+    }
+
+    if (s_arenaEnd + aligned > s_arenaCapacity && s_arenaStart > 0) {
+        memmove(s_arena, s_arena + s_arenaStart, s_arenaEnd - s_arenaStart);
+        for (int i = s_firstCommand; i < s_numCommands; i++) {
+            s_commands[i].offset -= s_arenaStart;
+        }
+        s_arenaEnd -= s_arenaStart;
+        s_arenaStart = 0;
+    }
+    if (s_arenaEnd + aligned > s_arenaCapacity) {
+        size_t newCapacity = s_arenaCapacity > 0 ? s_arenaCapacity : 4096;
+        while (newCapacity < s_arenaEnd + aligned) newCapacity *= 2;
+        unsigned char* arena = (unsigned char*)realloc(s_arena, newCapacity);
+        if (!arena) {
+            fprintf(stderr, "[History ERROR] Memória insuficiente para o histórico; o histórico foi esvaziado.\n");
+            historyClear();
+            return NULL;
+        }
+        s_arena = arena;
+        s_arenaCapacity = newCapacity;
+    }
+
+    HistoryCommand* cmd = &s_commands[s_numCommands++];
+    cmd->op = op;
+    cmd->count = count;
+    cmd->offset = s_arenaEnd;
+    cmd->size = aligned;
+    s_arenaEnd += aligned;
+    s_cursor = s_numCommands;
+    return cmd;
+}
+
+/**
+ * @brief Desfaz um comando aberto por pushCommand() cujos dados não puderam ser preenchidos.
+ */
+static void popCommand(void) {
+    s_numCommands--;
+    s_cursor = s_numCommands;
+    s_arenaEnd = s_commands[s_numCommands].offset;
+    if (s_firstCommand == s_numCommands) {
+        s_firstCommand = s_numCommands = s_cursor = 0;
+        s_arenaStart = s_arenaEnd = 0;
+    }
+}
+
+/**
+ * @brief Retorna a quantidade de vértices e os vértices no mundo de um objeto.
+ */
+static const Point* objectWorldVertices(int index, int* count) {
+    objectFlushTransform(index);
+    switch (g_objects[index].type) {
+        case OBJECT_TYPE_POINT:
+            *count = 1;
+            return getObjectPoint(index);
+        case OBJECT_TYPE_SEGMENT:
+            *count = 2;
+            return (const Point*)getObjectSegment(index);
+        case OBJECT_TYPE_POLYGON:
+            *count = getObjectPolygon(index)->numVertices;
+            return getObjectPolygon(index)->vertices;
+    }
+    *count = 0;
+    return NULL;
+}
+
+/**
+ * @brief Guarda um grupo de objetos (geometria no mundo e animação) em um comando novo.
+ */
+static void recordGroup(HistoryOp op, const int* indices, int count) {
+    if (count <= 0 || !s_recording) return;
+    size_t numVertices = 0;
+    for (int k = 0; k < count; k++) {
+        int n;
+        objectWorldVertices(indices[k], &n);
+        numVertices += (size_t)n;
+    }
+    HistoryCommand* cmd = pushCommand(op, count, count * sizeof(HistoryObjectRecord) + numVertices * sizeof(Point));
+    if (!cmd) return;
+
+    HistoryObjectRecord* records = (HistoryObjectRecord*)commandData(cmd);
+    Point* vertices = (Point*)(records + count);
+    for (int k = 0; k < count; k++) {
+        int index = indices[k];
+        int ref = refAcquire(index);
+        if (ref == -1) {
+            fprintf(stderr, "[History ERROR] Memória insuficiente para o histórico; o histórico foi esvaziado.\n");
+            while (--k >= 0) refRelease(records[k].ref);
+            popCommand();
+            historyClear();
+            return;
+        }
+        int n;
+        const Point* src = objectWorldVertices(index, &n);
+        memcpy(vertices, src, n * sizeof(Point));
+        vertices += n;
+        records[k].ref = ref;
+        records[k].type = g_objects[index].type;
+        records[k].numVertices = n;
+        records[k].anim = g_anim[index];
+        records[k].anim.stepDx = 0.0f;
+        records[k].anim.stepDy = 0.0f;
+    }
+}
+
+/**
+ * @brief Reinsere na cena os objetos guardados por um comando e os seleciona.
+ */
+static void insertGroup(const HistoryCommand* cmd) {
+    const HistoryObjectRecord* records = (const HistoryObjectRecord*)commandData(cmd);
+    const Point* vertices = (const Point*)(records + cmd->count);
+    selectionClear();
+    reserveObjects(g_numObjects + cmd->count);
+    for (int k = 0; k < cmd->count; k++) {
+        const HistoryObjectRecord* rec = &records[k];
+        ObjectHandle handle = OBJECT_HANDLE_NONE;
+        switch (rec->type) {
+            case OBJECT_TYPE_POINT:
+                handle = addPointObject(vertices[0]);
+                break;
+            case OBJECT_TYPE_SEGMENT: {
+                Segment s = {vertices[0], vertices[1]};
+                handle = addSegmentObject(s);
+                break;
+            }
+            case OBJECT_TYPE_POLYGON: {
+                GfxPolygon poly = createPolygonFromVertices(vertices, rec->numVertices);
+                if (poly.numVertices == 0) {
+                    fprintf(stderr, "[History ERROR] Memória insuficiente para restaurar um polígono.\n");
+                    break;
+                }
+                handle = addPolygonObject(&poly);
+                break;
+            }
+        }
+        vertices += rec->numVertices;
+
+        int index = resolveObjectHandle(handle);
+        if (index == -1) continue;
+        refRebind(rec->ref, index);
+        if (rec->anim.active) {
+            anim_enable(index, rec->anim.vx, rec->anim.vy, rec->anim.e, rec->anim.gravity);
+        } else {
+            g_anim[index].vx = rec->anim.vx;
+            g_anim[index].vy = rec->anim.vy;
+            g_anim[index].e = rec->anim.e;
+            g_anim[index].gravity = rec->anim.gravity;
+        }
+        g_anim[index].vmax = rec->anim.vmax;
+        journalRecordAnim(index);
+        selectionAdd(index);
+    }
+}
+
+/**
+ * @brief Remove da cena os objetos de um comando de inserção ou exclusão.
+ */
+static void removeGroup(const HistoryCommand* cmd) {
+    const HistoryObjectRecord* records = (const HistoryObjectRecord*)commandData(cmd);
+    for (int k = 0; k < cmd->count; k++) {
+        int index = refResolve(records[k].ref);
+        if (index != -1) removeObject(index);
+    }
+}
+
+/**
+ * @brief Aplica a matriz (ou a inversa) de um comando de transformação e seleciona os objetos.
+ */
+static void applyTransformCommand(const HistoryCommand* cmd, int inverse) {
+    const HistoryTransformRecord* rec = (const HistoryTransformRecord*)commandData(cmd);
+    const int* refs = (const int*)(rec + 1);
+    const Matrix3x3* matrix = inverse ? &rec->inverse : &rec->forward;
+    selectionClear();
+    for (int k = 0; k < cmd->count; k++) {
+        int index = refResolve(refs[k]);
+        if (index == -1) continue;
+        objectApplyTransform(index, matrix);
+        selectionAdd(index);
+    }
+}
+
+/**
+ * @brief Troca os vértices do polígono de um comando de fecho convexo pelos antigos ou pelos do fecho.
+ */
+static void applyHullCommand(const HistoryCommand* cmd, int useOld) {
+    const HistoryHullRecord* rec = (const HistoryHullRecord*)commandData(cmd);
+    const Point* vertices = (const Point*)(rec + 1);
+    int count = rec->numOldVertices;
+    if (!useOld) {
+        vertices += rec->numOldVertices;
+        count = rec->numNewVertices;
+    }
+    selectionClear();
+    int index = refResolve(rec->ref);
+    if (index == -1 || g_objects[index].type != OBJECT_TYPE_POLYGON) return;
+
+    GfxPolygon replacement = createPolygonFromVertices(vertices, count);
+    if (replacement.numVertices == 0) {
+        fprintf(stderr, "[History ERROR] Memória insuficiente para restaurar um polígono.\n");
+        return;
+    }
+    objectFlushTransform(index);
+    GfxPolygon* poly = getObjectPolygon(index);
+    freePolygon(poly);
+    *poly = replacement;
+    objectGeometryChanged(index);
+    selectionAdd(index);
+}
+
+/**
+ * @brief Calcula a inversa de uma transformação afim 2D (em double, para perder menos precisão).
+ * @return int 1 em caso de sucesso, 0 se a matriz não é inversível.
+ */
+static int invertAffine(const Matrix3x3* m, Matrix3x3* inv) {
+    double a = m->m[0][0], b = m->m[0][1], c = m->m[0][2];
+    double d = m->m[1][0], e = m->m[1][1], f = m->m[1][2];
+    double det = a * e - b * d;
+    if (fabs(det) < 1e-12) return 0;
+    inv->m[0][0] = (float)(e / det);
+    inv->m[0][1] = (float)(-b / det);
+    inv->m[0][2] = (float)((b * f - c * e) / det);
+    inv->m[1][0] = (float)(-d / det);
+    inv->m[1][1] = (float)(a / det);
+    inv->m[1][2] = (float)((c * d - a * f) / det);
+    inv->m[2][0] = 0.0f;
+    inv->m[2][1] = 0.0f;
+    inv->m[2][2] = 1.0f;
+    return 1;
+}
+
+/**
+ * @brief Compõe 'next' depois de 'first' (next * first), em double.
+ */
+static Matrix3x3 composeAffine(const Matrix3x3* next, const Matrix3x3* first) {
+    Matrix3x3 r;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            double sum = 0.0;
+            for (int k = 0; k < 3; k++) sum += (double)next->m[i][k] * first->m[k][j];
+            r.m[i][j] = (float)sum;
+        }
+    }
+    return r;
+}
+
+// --- SEÇÃO DE FUNÇÕES PÚBLICAS ---
+
+void historyClear(void) {
+    for (int i = 0; i < s_refCapacity; i++) {
+        if (s_refs[i].useCount == 0) continue;
+        int index = resolveObjectHandle(s_refs[i].handle);
+        if (index != -1) g_objects[index].historyRef = -1;
+    }
+    for (int i = 0; i < s_refCapacity; i++) {
+        s_refs[i].useCount = 0;
+        s_refs[i].next = (i + 1 < s_refCapacity) ? i + 1 : -1;
+    }
+    s_freeRefHead = s_refCapacity > 0 ? 0 : -1;
+    s_firstCommand = s_numCommands = s_cursor = 0;
+    s_arenaStart = s_arenaEnd = 0;
+    s_mergeCommand = -1;
+}
+
+void historySetBudget(size_t bytes) {
+    s_budget = bytes;
+    enforceBudget();
+}
+
+void historySetRecording(int enabled) {
+    s_recording = enabled;
+    if (!enabled) historyClear();
+}
+
+size_t historyMemoryUsed(void) {
+    return (s_arenaEnd - s_arenaStart) + (size_t)(s_numCommands - s_firstCommand) * sizeof(HistoryCommand);
+}
+
+int historyUndo(void) {
+    if (s_cursor == s_firstCommand) return 0;
+    const HistoryCommand* cmd = &s_commands[--s_cursor];
+    switch (cmd->op) {
+        case HISTORY_OP_ADD:
+            removeGroup(cmd);
+            selectionClear();
+            break;
+        case HISTORY_OP_DELETE:
+            insertGroup(cmd);
+            break;
+        case HISTORY_OP_TRANSFORM:
+            applyTransformCommand(cmd, 1);
+            break;
+        case HISTORY_OP_HULL:
+            applyHullCommand(cmd, 1);
+            break;
+    }
+    return 1;
+}
+
+int historyRedo(void) {
+    if (s_cursor == s_numCommands) return 0;
+    const HistoryCommand* cmd = &s_commands[s_cursor++];
+    switch (cmd->op) {
+        case HISTORY_OP_ADD:
+            insertGroup(cmd);
+            break;
+        case HISTORY_OP_DELETE:
+            removeGroup(cmd);
+            selectionClear();
+            break;
+        case HISTORY_OP_TRANSFORM:
+            applyTransformCommand(cmd, 0);
+            break;
+        case HISTORY_OP_HULL:
+            applyHullCommand(cmd, 0);
+            break;
+    }
+    return 1;
+}
+
+void historyBeginMerge(void) {
+    s_merging = 1;
+    s_mergeCommand = -1;
+}
+
+void historyEndMerge(void) {
+    s_merging = 0;
+    s_mergeCommand = -1;
+}
+
+void historyRecordAdd(int index) {
+    if (index < 0 || index >= g_numObjects) return;
+    recordGroup(HISTORY_OP_ADD, &index, 1);
+}
+
+void historyRecordDelete(const int* indices, int count) {
+    recordGroup(HISTORY_OP_DELETE, indices, count);
+}
+
+void historyRecordTransform(const int* indices, int count, const Matrix3x3* matrix) {
+    if (count <= 0 || !s_recording) return;
+
+    // Dentro de uma sequência (um arraste), a transformação é composta ao
+    // comando da sequência se ele ainda é o último e afeta os mesmos objetos.
+    if (s_merging && s_mergeCommand != -1 && s_mergeCommand == s_cursor - 1 &&
+        s_mergeCommand == s_numCommands - 1 && s_commands[s_mergeCommand].count == count) {
+        HistoryCommand* cmd = &s_commands[s_mergeCommand];
+        HistoryTransformRecord* rec = (HistoryTransformRecord*)commandData(cmd);
+        const int* refs = (const int*)(rec + 1);
+        int same = 1;
+        for (int k = 0; k < count && same; k++) {
+            same = (g_objects[indices[k]].historyRef == refs[k]);
+        }
+        Matrix3x3 composed = composeAffine(matrix, &rec->forward);
+        Matrix3x3 inverse;
+        if (same && invertAffine(&composed, &inverse)) {
+            rec->forward = composed;
+            rec->inverse = inverse;
+            return;
+        }
+    }
+
+    Matrix3x3 inverse;
+    if (!invertAffine(matrix, &inverse)) {
+        fprintf(stderr, "[History ERROR] Transformação sem inversa; o histórico foi esvaziado.\n");
+        historyClear();
+        return;
+    }
+    HistoryCommand* cmd = pushCommand(HISTORY_OP_TRANSFORM, count, sizeof(HistoryTransformRecord) + count * sizeof(int));
+    if (!cmd) return;
+    HistoryTransformRecord* rec = (HistoryTransformRecord*)commandData(cmd);
+    int* refs = (int*)(rec + 1);
+    rec->forward = *matrix;
+    rec->inverse = inverse;
+    for (int k = 0; k < count; k++) {
+        refs[k] = refAcquire(indices[k]);
+        if (refs[k] == -1) {
+            fprintf(stderr, "[History ERROR] Memória insuficiente para o histórico; o histórico foi esvaziado.\n");
+            while (--k >= 0) refRelease(refs[k]);
+            popCommand();
+            historyClear();
+            return;
+        }
+    }
+    if (s_merging) s_mergeCommand = s_numCommands - 1;
+}
+
+void historyRecordHull(int index, const GfxPolygon* hull) {
+    if (!s_recording || index < 0 || index >= g_numObjects || g_objects[index].type != OBJECT_TYPE_POLYGON) return;
+    int numOld;
+    const Point* oldVertices = objectWorldVertices(index, &numOld);
+    HistoryCommand* cmd = pushCommand(HISTORY_OP_HULL, 1,
+                                      sizeof(HistoryHullRecord) + ((size_t)numOld + hull->numVertices) * sizeof(Point));
+    if (!cmd) return;
+    HistoryHullRecord* rec = (HistoryHullRecord*)commandData(cmd);
+    Point* vertices = (Point*)(rec + 1);
+    rec->ref = refAcquire(index);
+    if (rec->ref == -1) {
+        fprintf(stderr, "[History ERROR] Memória insuficiente para o histórico; o histórico foi esvaziado.\n");
+        popCommand();
+        historyClear();
+        return;
+    }
+    rec->numOldVertices = numOld;
+    rec->numNewVertices = hull->numVertices;
+    memcpy(vertices, oldVertices, numOld * sizeof(Point));
+    memcpy(vertices + numOld, hull->vertices, hull->numVertices * sizeof(Point));
+}
@@ -0,0 +1,115 @@
+/**
+ * @file history.h
+ * @brief Define a interface do histórico de edições (desfazer/refazer).
+ *
+ * Cada edição do usuário vira um comando que sabe se desfazer e se refazer.
+ * Uma transformação guarda apenas a matriz e a sua inversa, sem copiar a
+ * geometria; uma exclusão e uma troca pelo fecho convexo guardam os dados
+ * que saíram da cena em uma arena única de bytes, sem um bloco alocado por
+ * comando. O histórico tem um limite de memória: quando ele é ultrapassado,
+ * os comandos mais antigos são descartados.
+ *
+ * Os comandos não guardam índices de 'g_objects' (que mudam a cada remoção),
+ * e sim referências do próprio histórico, que continuam apontando para o
+ * objeto quando ele é removido e depois reinserido por um desfazer.
+ *
+ * Desfazer e refazer passam pelas mesmas funções da lista de objetos que a
+ * edição original, então também são registrados no diário (journal.h).
+ */
+
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <stddef.h>
+
+#include "objects.h"
+
+// --- SEÇÃO DE PROTÓTIPOS DE FUNÇÕES PÚBLICAS ---
+
+/**
+ * @brief Descarta todos os comandos.
+ *
+ * Chamada pela lista de objetos ao esvaziar a cena (ex: ao carregar outra cena).
+ */
+void historyClear(void);
+
+/**
+ * @brief Define o limite de memória do histórico, descartando os comandos mais antigos se preciso.
+ * @param bytes O limite, em bytes (o padrão é HISTORY_MEMORY_BUDGET).
+ */
+void historySetBudget(size_t bytes);
+
+/**
+ * @brief Retorna quantos bytes o histórico ocupa, na mesma conta usada pelo limite.
+ */
+size_t historyMemoryUsed(void);
+
+/**
+ * @brief Liga ou desliga o registro de comandos (ex: no modo em lote, que não desfaz nada).
+ *
+ * Desligar descarta os comandos guardados; as chamadas de registro passam a
+ * não fazer nada até o registro ser religado.
+ * @param enabled 1 para registrar (o padrão), 0 para não registrar.
+ */
+void historySetRecording(int enabled);
+
+/**
+ * @brief Desfaz o último comando e seleciona os objetos que ele afetou.
+ * @return int 1 se um comando foi desfeito, 0 se não havia nada para desfazer.
+ */
+int historyUndo(void);
+
+/**
+ * @brief Refaz o último comando desfeito e seleciona os objetos que ele afetou.
+ * @return int 1 se um comando foi refeito, 0 se não havia nada para refazer.
+ */
+int historyRedo(void);
+
+/**
+ * @brief Inicia uma sequência de transformações que vira um único comando (ex: um arraste).
+ *
+ * Até historyEndMerge(), cada transformação aplicada aos mesmos objetos da
+ * anterior é composta a ela, em vez de abrir um comando novo.
+ */
+void historyBeginMerge(void);
+
+/**
+ * @brief Encerra a sequência iniciada por historyBeginMerge().
+ */
+void historyEndMerge(void);
+
+// --- SEÇÃO DE REGISTRO DE COMANDOS ---
+// Chamadas pelas edições do usuário. Registrar um comando descarta os
+// comandos que tinham sido desfeitos.
+
+/**
+ * @brief Registra um objeto recém-criado pelo usuário.
+ * @param index O índice do objeto em 'g_objects'.
+ */
+void historyRecordAdd(int index);
+
+/**
+ * @brief Registra a exclusão de um grupo de objetos (antes de eles saírem da lista).
+ * @param indices Os índices dos objetos em 'g_objects'.
+ * @param count A quantidade de objetos.
+ */
+void historyRecordDelete(const int* indices, int count);
+
+/**
+ * @brief Registra uma transformação aplicada a um grupo de objetos.
+ * @param indices Os índices dos objetos em 'g_objects'.
+ * @param count A quantidade de objetos.
+ * @param matrix A transformação aplicada.
+ */
+void historyRecordTransform(const int* indices, int count, const Matrix3x3* matrix);
+
+/**
+ * @brief Registra a troca dos vértices de um polígono pelo seu fecho convexo (antes da troca).
+ *
+ * Os vértices atuais no mundo são guardados para o desfazer.
+ * @param index O índice do polígono em 'g_objects'.
+ * @param hull O fecho convexo que vai substituir o polígono.
+ */
+void historyRecordHull(int index, const GfxPolygon* hull);
+
+#endif // HISTORY_H
@@ -0,0 +1,375 @@
+/**
+ * @file image_io.c
+ * @brief Implementação da gravação de imagens PNG e PPM.
+ *
+ * O fluxo zlib do PNG é montado a partir de faixas comprimidas de forma
+ * independente. Cada faixa termina com um bloco "stored" vazio (o mesmo
+ * "sync flush" do zlib), que deixa o fluxo alinhado em byte, então as
+ * faixas podem ser simplesmente concatenadas; um bloco final vazio fecha o
+ * fluxo. O Adler-32 de cada faixa é calculado junto com ela e combinado no fim.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "image_io.h"
+#include "config.h"
+#include "jobs.h"
+
+// --- SEÇÃO DE CONSTANTES PRIVADAS ---
+
+#define ADLER_MODULUS 65521u
+#define DEFLATE_MAX_MATCH 258
+
+/// Comprimento base e bits extras de cada código de comprimento do deflate (257 a 285).
+static const uint16_t s_lengthBase[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t s_lengthExtra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+// --- SEÇÃO DE ESTRUTURAS PRIVADAS ---
+
+/**
+ * @brief Um buffer de bytes crescente com um acumulador de bits (ordem do deflate: bit menos significativo primeiro).
+ */
+typedef struct {
+    unsigned char* data;
+    size_t size, capacity;
+    uint64_t bits;
+    int numBits;
+    int failed;
+} BitWriter;
+
+/**
+ * @brief Uma faixa de linhas comprimida.
+ */
+typedef struct {
+    BitWriter out;
+    uint32_t adler;             ///< Adler-32 dos bytes filtrados da faixa.
+    size_t rawSize;             ///< Quantidade de bytes filtrados.
+} PngBand;
+
+/**
+ * @brief O estado da compressão paralela.
+ */
+typedef struct {
+    const unsigned char* rgba;
+    int width, height;
+    PngBand* bands;
+} PngJob;
+
+static uint32_t s_crcTable[256];
+static uint16_t s_fixedCode[288];       ///< Códigos de Huffman fixos, já com os bits invertidos.
+static uint8_t s_fixedLength[288];
+static int s_tablesReady = 0;
+
+// --- SEÇÃO DE FUNÇÕES AUXILIARES (IMPLEMENTAÇÃO PRIVADA) ---
+
+static uint16_t reverseBits(uint16_t code, int length) {
+    uint16_t result = 0;
+    for (int i = 0; i < length; i++) {
+        result = (uint16_t)((result << 1) | ((code >> i) & 1));
+    }
+    return result;
+}
+
+/**
+ * @brief Monta as tabelas do CRC-32 e dos códigos de Huffman fixos (chamada na thread principal).
+ */
+static void initTables(void) {
+    if (s_tablesReady) return;
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        s_crcTable[n] = c;
+    }
+    for (int v = 0; v < 288; v++) {
+        uint16_t code;
+        int length;
+        if (v < 144) { code = (uint16_t)(0x30 + v); length = 8; }
+        else if (v < 256) { code = (uint16_t)(0x190 + v - 144); length = 9; }
+        else if (v < 280) { code = (uint16_t)(v - 256); length = 7; }
+        else { code = (uint16_t)(0xC0 + v - 280); length = 8; }
+        s_fixedCode[v] = reverseBits(code, length);
+        s_fixedLength[v] = (uint8_t)length;
+    }
+    s_tablesReady = 1;
+}
+
+static uint32_t crc32Update(uint32_t crc, const unsigned char* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        crc = s_crcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+static uint32_t adler32Update(uint32_t adler, const unsigned char* data, size_t size) {
+    uint32_t a = adler & 0xFFFF, b = adler >> 16;
+    while (size > 0) {
+        // 5552 bytes é o máximo antes de 'b' poder estourar 32 bits.
+        size_t chunk = size < 5552 ? size : 5552;
+        size -= chunk;
+        while (chunk--) {
+            a += *data++;
+            b += a;
+        }
+        a %= ADLER_MODULUS;
+        b %= ADLER_MODULUS;
+    }
+    return (b << 16) | a;
+}
+
+/**
+ * @brief Adler-32 da concatenação de dois trechos, a partir dos valores de cada um (como adler32_combine() do zlib).
+ */
+static uint32_t adler32Combine(uint32_t adler1, uint32_t adler2, size_t size2) {
+    uint32_t remainder = (uint32_t)(size2 % ADLER_MODULUS);
+    uint32_t sum1 = adler1 & 0xFFFF;
+    uint32_t sum2 = (uint32_t)(((uint64_t)remainder * sum1) % ADLER_MODULUS);
+    sum1 += (adler2 & 0xFFFF) + ADLER_MODULUS - 1;
+    sum2 += (adler1 >> 16) + (adler2 >> 16) + ADLER_MODULUS - remainder;
+    if (sum1 >= ADLER_MODULUS) sum1 -= ADLER_MODULUS;
+    if (sum1 >= ADLER_MODULUS) sum1 -= ADLER_MODULUS;
+    if (sum2 >= 2 * ADLER_MODULUS) sum2 -= 2 * ADLER_MODULUS;
+    if (sum2 >= ADLER_MODULUS) sum2 -= ADLER_MODULUS;
+    return sum1 | (sum2 << 16);
+}
+
+static int reserveBytes(BitWriter* w, size_t extra) {
+    if (w->size + extra <= w->capacity) return 1;
+    size_t capacity = w->capacity > 0 ? w->capacity : 65536;
+    while (capacity < w->size + extra) capacity *= 2;
+    unsigned char* data = (unsigned char*)realloc(w->data, capacity);
+    if (!data) {
+        w->failed = 1;
+        return 0;
+    }
+    w->data = data;
+    w->capacity = capacity;
+    return 1;
+}
+
+static inline void putBits(BitWriter* w, uint32_t value, int count) {
+    w->bits |= (uint64_t)value << w->numBits;
+    w->numBits += count;
+    if (w->numBits >= 32) {
+        if (!reserveBytes(w, 4)) return;
+        for (int i = 0; i < 4; i++) {
+            w->data[w->size++] = (unsigned char)(w->bits & 0xFF);
+            w->bits >>= 8;
+        }
+        w->numBits -= 32;
+    }
+}
+
+/**
+ * @brief Completa o último byte com zeros.
+ */
+static void alignToByte(BitWriter* w) {
+    while (w->numBits > 0) {
+        if (!reserveBytes(w, 1)) return;
+        w->data[w->size++] = (unsigned char)(w->bits & 0xFF);
+        w->bits >>= 8;
+        w->numBits = w->numBits > 8 ? w->numBits - 8 : 0;
+    }
+    w->bits = 0;
+}
+
+static inline void putSymbol(BitWriter* w, int symbol) {
+    putBits(w, s_fixedCode[symbol], s_fixedLength[symbol]);
+}
+
+/**
+ * @brief Codifica 'length' repetições do byte anterior (distância 1).
+ */
+static void putRepeat(BitWriter* w, int length) {
+    int code = 28;
+    while (s_lengthBase[code] > length) code--;
+    putSymbol(w, 257 + code);
+    if (s_lengthExtra[code] > 0) putBits(w, (uint32_t)(length - s_lengthBase[code]), s_lengthExtra[code]);
+    putBits(w, 0, 5); // Código de distância 0 (distância 1), sem bits extras.
+}
+
+/**
+ * @brief Comprime 'size' bytes em um bloco deflate de Huffman fixo, terminado por um "sync flush".
+ */
+static void deflateBand(BitWriter* w, const unsigned char* data, size_t size) {
+    putBits(w, 1 << 1, 3);  // BFINAL = 0, BTYPE = 01 (Huffman fixo).
+    size_t i = 0;
+    while (i < size) {
+        if (i > 0 && data[i] == data[i - 1]) {
+            size_t run = 1;
+            while (i + run < size && run < DEFLATE_MAX_MATCH && data[i + run] == data[i - 1]) run++;
+            if (run >= 3) {
+                putRepeat(w, (int)run);
+                i += run;
+                continue;
+            }
+        }
+        putSymbol(w, data[i]);
+        i++;
+    }
+    putSymbol(w, 256);      // Fim do bloco.
+    putBits(w, 0, 3);       // Bloco "stored" vazio: BFINAL = 0, BTYPE = 00...
+    alignToByte(w);
+    if (reserveBytes(w, 4)) {
+        static const unsigned char emptyStored[4] = {0x00, 0x00, 0xFF, 0xFF}; // ...LEN = 0, NLEN = ~0.
+        memcpy(w->data + w->size, emptyStored, 4);
+        w->size += 4;
+    }
+}
+
+/**
+ * @brief Tarefa paralela: filtra e comprime as faixas [first, last).
+ */
+static void compressBands(int first, int last, void* ctx) {
+    PngJob* job = (PngJob*)ctx;
+    size_t rowBytes = 1 + (size_t)job->width * 3;
+    unsigned char* raw = (unsigned char*)malloc(rowBytes * IMAGE_PNG_BAND_ROWS);
+
+    for (int b = first; b < last; b++) {
+        PngBand* band = &job->bands[b];
+        if (!raw) {
+            band->out.failed = 1;
+            continue;
+        }
+        int y0 = b * IMAGE_PNG_BAND_ROWS;
+        int y1 = y0 + IMAGE_PNG_BAND_ROWS < job->height ? y0 + IMAGE_PNG_BAND_ROWS : job->height;
+        unsigned char* dst = raw;
+        for (int y = y0; y < y1; y++) {
+            // Filtro "Sub": cada byte menos o byte correspondente do pixel à esquerda.
+            const unsigned char* src = job->rgba + (size_t)y * job->width * 4;
+            *dst++ = 1;
+            unsigned char left[3] = {0, 0, 0};
+            for (int x = 0; x < job->width; x++, src += 4) {
+                for (int c = 0; c < 3; c++) {
+                    *dst++ = (unsigned char)(src[c] - left[c]);
+                    left[c] = src[c];
+                }
+            }
+        }
+        band->rawSize = (size_t)(dst - raw);
+        band->adler = adler32Update(1, raw, band->rawSize);
+        deflateBand(&band->out, raw, band->rawSize);
+    }
+    free(raw);
+}
+
+static void putUint32(unsigned char* dst, uint32_t value) {
+    dst[0] = (unsigned char)(value >> 24);
+    dst[1] = (unsigned char)(value >> 16);
+    dst[2] = (unsigned char)(value >> 8);
+    dst[3] = (unsigned char)value;
+}
+
+/**
+ * @brief Grava um chunk PNG cujo conteúdo é a concatenação de 'prefix' e 'data'.
+ */
+static int writeChunk(FILE* file, const char* type, const unsigned char* prefix, size_t prefixSize,
+                      const unsigned char* data, size_t size) {
+    unsigned char header[8];
+    putUint32(header, (uint32_t)(prefixSize + size));
+    memcpy(header + 4, type, 4);
+    uint32_t crc = crc32Update(0xFFFFFFFFu, header + 4, 4);
+    crc = crc32Update(crc, prefix, prefixSize);
+    crc = crc32Update(crc, data, size);
+    unsigned char trailer[4];
+    putUint32(trailer, crc ^ 0xFFFFFFFFu);
+    return fwrite(header, 1, 8, file) == 8 &&
+           (prefixSize == 0 || fwrite(prefix, 1, prefixSize, file) == prefixSize) &&
+           (size == 0 || fwrite(data, 1, size, file) == size) &&
+           fwrite(trailer, 1, 4, file) == 4;
+}
+
+// --- SEÇÃO DE FUNÇÕES PÚBLICAS ---
+
+int imageWritePng(const char* filename, const unsigned char* rgba, int width, int height) {
+    initTables();
+    int numBands = (height + IMAGE_PNG_BAND_ROWS - 1) / IMAGE_PNG_BAND_ROWS;
+    PngJob job = {rgba, width, height, (PngBand*)calloc((size_t)numBands, sizeof(PngBand))};
+    if (!job.bands) {
+        fprintf(stderr, "[Image ERROR] Memoria insuficiente para gravar '%s'.\n", filename);
+        return 0;
+    }
+    jobsParallelFor(numBands, 1, compressBands, &job);
+
+    int ok = 1;
+    uint32_t adler = 1;
+    for (int b = 0; b < numBands; b++) {
+        if (job.bands[b].out.failed) ok = 0;
+        adler = adler32Combine(adler, job.bands[b].adler, job.bands[b].rawSize);
+    }
+
+    FILE* file = ok ? fopen(filename, "wb") : NULL;
+    if (file) {
+        static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        unsigned char ihdr[13];
+        putUint32(ihdr, (uint32_t)width);
+        putUint32(ihdr + 4, (uint32_t)height);
+        ihdr[8] = 8;    // Bits por componente.
+        ihdr[9] = 2;    // RGB.
+        ihdr[10] = 0;   // Deflate.
+        ihdr[11] = 0;   // Filtros adaptativos (por linha).
+        ihdr[12] = 0;   // Sem entrelaçamento.
+        static const unsigned char zlibHeader[2] = {0x78, 0x01};
+        // Bloco final vazio de Huffman fixo (BFINAL = 1, BTYPE = 01, fim de bloco) e o Adler-32.
+        unsigned char zlibTrailer[6] = {0x03, 0x00};
+        putUint32(zlibTrailer + 2, adler);
+
+        ok = fwrite(signature, 1, 8, file) == 8 && writeChunk(file, "IHDR", ihdr, 13, NULL, 0);
+        for (int b = 0; b < numBands && ok; b++) {
+            ok = writeChunk(file, "IDAT", zlibHeader, b == 0 ? 2 : 0, job.bands[b].out.data, job.bands[b].out.size);
+        }
+        ok = ok && writeChunk(file, "IDAT", zlibTrailer, 6, NULL, 0) && writeChunk(file, "IEND", NULL, 0, NULL, 0);
+        if (fclose(file) != 0) ok = 0;
+        if (!ok) fprintf(stderr, "[Image ERROR] Falha ao gravar '%s'.\n", filename);
+    } else if (ok) {
+        fprintf(stderr, "[Image ERROR] Nao foi possivel criar o arquivo '%s'.\n", filename);
+        ok = 0;
+    } else {
+        fprintf(stderr, "[Image ERROR] Memoria insuficiente para comprimir '%s'.\n", filename);
+    }
+
+    for (int b = 0; b < numBands; b++) {
+        free(job.bands[b].out.data);
+    }
+    free(job.bands);
+    return ok;
+}
+
+int imageWritePpm(const char* filename, const unsigned char* rgba, int width, int height) {
+    FILE* file = fopen(filename, "wb");
+    if (!file) {
+        fprintf(stderr, "[Image ERROR] Nao foi possivel criar o arquivo '%s'.\n", filename);
+        return 0;
+    }
+    unsigned char* row = (unsigned char*)malloc((size_t)width * 3);
+    int ok = row != NULL && fprintf(file, "P6\n%d %d\n255\n", width, height) > 0;
+    for (int y = 0; y < height && ok; y++) {
+        const unsigned char* src = rgba + (size_t)y * width * 4;
+        for (int x = 0; x < width; x++) {
+            memcpy(row + (size_t)x * 3, src + (size_t)x * 4, 3);
+        }
+        ok = fwrite(row, 3, (size_t)width, file) == (size_t)width;
+    }
+    free(row);
+    if (fclose(file) != 0) ok = 0;
+    if (!ok) fprintf(stderr, "[Image ERROR] Falha ao gravar '%s'.\n", filename);
+    return ok;
+}
+
+int imageWriteFile(const char* filename, const unsigned char* rgba, int width, int height) {
+    size_t length = strlen(filename);
+    if (length >= 4 && strcmp(filename + length - 4, ".ppm") == 0) {
+        return imageWritePpm(filename, rgba, width, height);
+    }
+    return imageWritePng(filename, rgba, width, height);
+}
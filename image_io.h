@@ -0,0 +1,40 @@
+/**
+ * @file image_io.h
+ * @brief Define a interface para gravar imagens RGBA em arquivos PNG e PPM.
+ *
+ * O PNG é gravado sem bibliotecas externas: cada faixa de IMAGE_PNG_BAND_ROWS
+ * linhas é filtrada ("Sub") e comprimida em paralelo pelo sistema de tarefas
+ * (jobs.h), com um compressor deflate simples que só codifica repetições do
+ * byte anterior. As áreas de cor lisa, que dominam os desenhos, ficam
+ * pequenas; o resto é gravado quase sem compressão. O canal alfa não é
+ * gravado (as imagens do rasterizador são opacas).
+ */
+
+#ifndef IMAGE_IO_H
+#define IMAGE_IO_H
+
+// --- SEÇÃO DE PROTÓTIPOS DE FUNÇÕES PÚBLICAS ---
+
+/**
+ * @brief Grava uma imagem no formato indicado pela extensão: ".ppm" para PPM, PNG para as demais.
+ * @param filename O nome do arquivo.
+ * @param rgba Os pixels, 4 bytes por pixel, com a linha de cima primeiro.
+ * @param width A largura da imagem.
+ * @param height A altura da imagem.
+ * @return int 1 em caso de sucesso, 0 em caso de erro.
+ */
+int imageWriteFile(const char* filename, const unsigned char* rgba, int width, int height);
+
+/**
+ * @brief Grava uma imagem em PNG (RGB de 8 bits).
+ * @return int 1 em caso de sucesso, 0 em caso de erro.
+ */
+int imageWritePng(const char* filename, const unsigned char* rgba, int width, int height);
+
+/**
+ * @brief Grava uma imagem em PPM binário (P6).
+ * @return int 1 em caso de sucesso, 0 em caso de erro.
+ */
+int imageWritePpm(const char* filename, const unsigned char* rgba, int width, int height);
+
+#endif // IMAGE_IO_H
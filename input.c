@@ -21,6 +21,12 @@
 #include "file_io.h"
 #include "animation.h"
 #include "convexhull.h"
+#include "spatial.h"
+#include "utils.h"
+#include "journal.h"
+#include "history.h"
+#include "predicates.h"
+#include "profiler.h"
 
 // --- SEÇÃO DE VARIÁVEIS GLOBAIS DE ESTADO ---
 
@@ -28,10 +34,14 @@ ProgramMode g_currentMode = MODE_SELECT;
 int g_isDragging = 0;
 int g_segmentClickCount = 0;
 Point g_segmentP1;
-Point g_polygonVertices[MAX_POLYGON_VERTICES];
+Point* g_polygonVertices = NULL;
 int g_polygonVertexCount = 0;
+static int s_polygonVertexCapacity = 0;
 Point g_lastMousePos = {0.0f, 0.0f};
 Point g_currentMousePos = {0.0f, 0.0f};
+int g_isRubberBanding = 0;
+Point g_rubberBandStart = {0.0f, 0.0f};
+const char* g_sceneFileName = SCENE_FILE_NAME;
 
 // --- SEÇÃO DE VARIÁVEIS GLOBAIS EXTERNAS ---
 extern int g_windowWidth;
@@ -63,27 +73,15 @@ static const char* getModeString(ProgramMode mode) {
 
 /**
  * @brief Verifica se um ponto está dentro de um polígono usando o algoritmo de ray casting (tiro).
+ *
+ * O teste é o predicado exato de predicates.h: cliques sobre a borda contam
+ * como dentro, e vértices na altura do clique não são perdidos.
  * @param poly O polígono a ser testado.
  * @param p O ponto de teste.
- * @return 1 se o ponto está dentro, 0 caso contrário.
+ * @return 1 se o ponto está dentro ou sobre a borda, 0 caso contrário.
  */
 static int selectPolygon(GfxPolygon* poly, Point p) {
-    int crossings = 0;
-    for (int i = 0; i < poly->numVertices; i++) {
-        Point p1 = poly->vertices[i];
-        Point p2 = poly->vertices[(i + 1) % poly->numVertices];
-
-        if(((p1.y > p.y) && (p2.y > p.y)) || ((p1.y < p.y) && (p2.y < p.y)) || ((p1.x < p.x) && (p2.x < p.x))){
-            continue;
-        }
-        if((p1.y > p.y && p2.y < p.y) || (p1.y < p.y && p2.y > p.y)){
-            float xi = p1.x + (p.y - p1.y)*(p2.x - p1.x) / (p2.y - p1.y);
-            if(xi> p.x){
-                crossings++;
-            }
-        }
-    }
-    return crossings % 2; // Ímpar = dentro, Par = fora.
+    return pointInPolygon(p, poly->vertices, poly->numVertices) != POINT_OUTSIDE;
 }
 
 /**
@@ -193,19 +191,32 @@ static int segmentIntersectsRect(Segment s, float xmin, float xmax, float ymin,
 }
 
 /**
- * @brief Seleciona o objeto mais próximo em um ponto de clique, priorizando Pontos > Segmentos > Polígonos.
+ * @brief Encontra o objeto mais próximo de um ponto de clique, priorizando Pontos > Segmentos > Polígonos.
  * @param click_point O ponto de clique na tela.
- * @return O índice do objeto selecionado ou -1 se nenhum objeto for encontrado.
+ * @return O índice do objeto encontrado ou -1 se nenhum objeto estiver perto do clique.
  */
-static int selectObjectAtPoint(Point click_point) {
-    int found_index = -1;
+static int findObjectAtPoint(Point click_point) {
+    float xmin = click_point.x - CLICK_TOLERANCE;
+    float xmax = click_point.x + CLICK_TOLERANCE;
+    float ymin = click_point.y - CLICK_TOLERANCE;
+    float ymax = click_point.y + CLICK_TOLERANCE;
+
+    // O índice espacial e os testes exatos precisam da geometria atualizada.
+    objectsFlushTransforms();
+
+    // Consulta o índice espacial: só os objetos das células próximas ao clique
+    // são candidatos. Os três níveis de prioridade percorrem apenas essa lista.
+    BoundingBox query = {xmin, ymin, xmax, ymax};
+    const int* candidates;
+    int numCandidates = spatialQuery(query, &candidates);
 
     // Prioridade 1: Pontos
     int closest_point_index = -1;
     float min_sq_dist_point = -1.0f;
-    for (int i = 0; i < g_numObjects; i++) {
+    for (int c = 0; c < numCandidates; c++) {
+        int i = candidates[c];
         if (g_objects[i].type == OBJECT_TYPE_POINT) {
-            Point* p_obj = (Point*)g_objects[i].data;
+            Point* p_obj = getObjectPoint(i);
             if (fabs(p_obj->x - click_point.x) <= CLICK_TOLERANCE &&
                 fabs(p_obj->y - click_point.y) <= CLICK_TOLERANCE)
             {
@@ -226,13 +237,10 @@ static int selectObjectAtPoint(Point click_point) {
     // Prioridade 2: Segmentos
     int closest_segment_index = -1;
     float min_dist_segment = CLICK_TOLERANCE;
-    float xmin = click_point.x - CLICK_TOLERANCE;
-    float xmax = click_point.x + CLICK_TOLERANCE;
-    float ymin = click_point.y - CLICK_TOLERANCE;
-    float ymax = click_point.y + CLICK_TOLERANCE;
-    for (int i = 0; i < g_numObjects; i++) {
+    for (int c = 0; c < numCandidates; c++) {
+        int i = candidates[c];
         if (g_objects[i].type == OBJECT_TYPE_SEGMENT) {
-            Segment* s_obj = (Segment*)g_objects[i].data;
+            Segment* s_obj = getObjectSegment(i);
             if (segmentIntersectsRect(*s_obj, xmin, xmax, ymin, ymax)) {
                 float dist = distPointSegment(click_point, *s_obj);
                 if (dist < min_dist_segment) {
@@ -249,9 +257,16 @@ static int selectObjectAtPoint(Point click_point) {
     // Prioridade 3: Polígonos
     int closest_poly_index = -1;
     float min_poly_dist = -1.0f;
-    for (int i = 0; i < g_numObjects; i++) {
+    for (int c = 0; c < numCandidates; c++) {
+        int i = candidates[c];
         if (g_objects[i].type == OBJECT_TYPE_POLYGON) {
-            GfxPolygon* poly_obj = (GfxPolygon*)g_objects[i].data;
+            // Rejeição barata pela caixa envolvente antes do teste de ponto-em-polígono.
+            BoundingBox box = getObjectBounds(i);
+            if (click_point.x < box.minX || click_point.x > box.maxX ||
+                click_point.y < box.minY || click_point.y > box.maxY) {
+                continue;
+            }
+            GfxPolygon* poly_obj = getObjectPolygon(i);
             if (selectPolygon(poly_obj, click_point)) {
                 float dist_to_edge = distPointToPolygonEdges(poly_obj, click_point);
                 if (closest_poly_index == -1 || dist_to_edge < min_poly_dist) {
@@ -264,6 +279,59 @@ static int selectObjectAtPoint(Point click_point) {
     return closest_poly_index;
 }
 
+int selectObjectAtPoint(Point click_point) {
+    double profileStart = profileBegin();
+    int found = findObjectAtPoint(click_point);
+    profileEnd(PROFILE_SELECT, profileStart);
+    return found;
+}
+
+/**
+ * @brief Acrescenta à seleção todos os objetos que tocam um retângulo (seleção por área).
+ *
+ * Usa os mesmos testes do clique: pontos dentro do retângulo, segmentos pelo
+ * Cohen-Sutherland e, para polígonos, uma aresta que cruze o retângulo ou o
+ * retângulo inteiro dentro do polígono.
+ * @param xmin, xmax, ymin, ymax As coordenadas do retângulo.
+ */
+static void selectObjectsInRect(float xmin, float xmax, float ymin, float ymax) {
+    double profileStart = profileBegin();
+    objectsFlushTransforms();
+
+    BoundingBox query = {xmin, ymin, xmax, ymax};
+    const int* candidates;
+    int numCandidates = spatialQuery(query, &candidates);
+
+    for (int c = 0; c < numCandidates; c++) {
+        int i = candidates[c];
+        int hit = 0;
+        switch (g_objects[i].type) {
+            case OBJECT_TYPE_POINT:
+                hit = (computeOutCode(*getObjectPoint(i), xmin, xmax, ymin, ymax) == INSIDE);
+                break;
+            case OBJECT_TYPE_SEGMENT:
+                hit = segmentIntersectsRect(*getObjectSegment(i), xmin, xmax, ymin, ymax);
+                break;
+            case OBJECT_TYPE_POLYGON: {
+                GfxPolygon* poly = getObjectPolygon(i);
+                for (int v = 0; v < poly->numVertices && !hit; v++) {
+                    Segment edge = {poly->vertices[v], poly->vertices[(v + 1) % poly->numVertices]};
+                    hit = segmentIntersectsRect(edge, xmin, xmax, ymin, ymax);
+                }
+                if (!hit) {
+                    Point corner = {xmin, ymin};
+                    hit = selectPolygon(poly, corner);
+                }
+                break;
+            }
+        }
+        if (hit) {
+            selectionAdd(i);
+        }
+    }
+    profileEnd(PROFILE_SELECT, profileStart);
+}
+
 // --- SEÇÃO DE FUNÇÕES DE CALLBACK GLUT ---
 
 /**
@@ -273,7 +341,7 @@ static int selectObjectAtPoint(Point click_point) {
  * @param y Coordenada Y do mouse no momento do evento.
  */
 void keyboardCallback(unsigned char key, int x, int y) {
-    int objectIsSelected = (g_selectedObjectIndex != -1);
+    int objectIsSelected = (g_numSelected > 0);
     ProgramMode oldMode = g_currentMode;
 
     switch (key) {
@@ -305,25 +373,19 @@ void keyboardCallback(unsigned char key, int x, int y) {
 
         // --- LÓGICA PARA O FECHO CONVEXO ---
         case 'c': case 'C':
-            if (objectIsSelected) {
-                Object* selectedObject = &g_objects[g_selectedObjectIndex];
-                if (selectedObject->type == OBJECT_TYPE_POLYGON) {
-                    // printf("[INFO] Acionando calculo de fecho convexo...\n");
-                    GfxPolygon* originalPolygon = (GfxPolygon*)selectedObject->data;
-
-                    // Chama o algoritmo da Marcha de Jarvis.
-                    GfxPolygon* newConvexHull = jarvisMarch(originalPolygon);
-
-                    // Se o algoritmo foi bem-sucedido, substitui o polígono.
-                    if (newConvexHull != NULL) {
-                        free(originalPolygon); // Libera a memória do polígono antigo.
-                        selectedObject->data = newConvexHull; // Atualiza o ponteiro para o novo.
-                        // printf("[INFO] Poligono transformado em seu fecho convexo.\n");
-                    } else {
-                        printf("[AVISO] Nao foi possivel calcular o fecho convexo (poligono pode ter menos de 3 vertices).\n");
-                    }
+            if (g_numSelected > 1) {
+                // Vários objetos: o fecho da união de todos eles vira um polígono novo.
+                int created = convexHullAddObjectsHull(g_selection, g_numSelected);
+                if (created >= 0) {
+                    selectSingleObject(created);
                 } else {
+                    printf("[AVISO] Nao foi possivel calcular o fecho convexo (os objetos selecionados sao colineares).\n");
+                }
+            } else if (objectIsSelected) {
+                if (g_objects[g_selectedObjectIndex].type != OBJECT_TYPE_POLYGON) {
                     printf("[AVISO] O objeto selecionado nao eh um poligono. Selecione um poligono para usar esta funcao.\n");
+                } else if (!convexHullReplaceObject(g_selectedObjectIndex)) {
+                    printf("[AVISO] Nao foi possivel calcular o fecho convexo (poligono com menos de 3 vertices ou colinear).\n");
                 }
             } else {
                 printf("[AVISO] Nenhum objeto selecionado. Selecione um poligono para calcular o fecho convexo.\n");
@@ -333,31 +395,42 @@ void keyboardCallback(unsigned char key, int x, int y) {
         // Ações específicas de transformação
         case 'x': case 'X':
             if (objectIsSelected && g_currentMode == MODE_REFLECT) {
-                reflectObject(g_selectedObjectIndex, 0); // Eixo X
+                reflectSelection(0); // Eixo X
             }
             break;
         case 'y': case 'Y':
             if (objectIsSelected && g_currentMode == MODE_REFLECT) {
-                reflectObject(g_selectedObjectIndex, 1); // Eixo Y
+                reflectSelection(1); // Eixo Y
             }
             break;
         case '=':
             if (objectIsSelected && g_currentMode == MODE_SCALE) {
-                scaleObject(g_selectedObjectIndex, 1.1f, 1.1f);
+                scaleSelection(1.1f, 1.1f);
             }
             break;
         case '-':
             if (objectIsSelected && g_currentMode == MODE_SCALE) {
-                scaleObject(g_selectedObjectIndex, 0.9f, 0.9f);
+                scaleSelection(0.9f, 0.9f);
             }
             break;
 
         // Ações de gerenciamento de objetos
         case 127: // Tecla DELETE
-            if (objectIsSelected) removeObject(g_selectedObjectIndex);
+            historyRecordDelete(g_selection, g_numSelected);
+            // removeObject() retira o objeto da seleção, então o laço sempre termina.
+            while (g_numSelected > 0) {
+                removeObject(g_selection[g_numSelected - 1]);
+            }
+            break;
+        case 26: // Ctrl+Z
+            if (!historyUndo()) printf("[AVISO] Nada para desfazer.\n");
+            break;
+        case 25: // Ctrl+Y
+            if (!historyRedo()) printf("[AVISO] Nada para refazer.\n");
             break;
         case 27: // Tecla ESC
-            clearAllObjects(); exit(0);
+            // A limpeza (e o fechamento do diário, antes dela) fica em cleanup_on_exit().
+            exit(0);
             break;
 
         // Ações de animação
@@ -366,18 +439,21 @@ void keyboardCallback(unsigned char key, int x, int y) {
         case 'g': case 'G':
             if (objectIsSelected) {
                 g_anim[g_selectedObjectIndex].gravity = !g_anim[g_selectedObjectIndex].gravity;
+                journalRecordAnim(g_selectedObjectIndex);
             }
             break;
         case '[':
             if (objectIsSelected) {
                 g_anim[g_selectedObjectIndex].vx *= 0.9f;
                 g_anim[g_selectedObjectIndex].vy *= 0.9f;
+                journalRecordAnim(g_selectedObjectIndex);
             }
             break;
         case ']':
             if (objectIsSelected) {
                 g_anim[g_selectedObjectIndex].vx *= 1.1f;
                 g_anim[g_selectedObjectIndex].vy *= 1.1f;
+                journalRecordAnim(g_selectedObjectIndex);
             }
             break;
     }
@@ -388,7 +464,7 @@ void keyboardCallback(unsigned char key, int x, int y) {
         g_polygonVertexCount = 0;
         if (g_currentMode == MODE_SELECT || g_currentMode == MODE_CREATE_POINT ||
             g_currentMode == MODE_CREATE_SEGMENT || g_currentMode == MODE_CREATE_POLYGON) {
-            g_selectedObjectIndex = -1;
+            selectionClear();
             g_isDragging = 0;
         }
     }
@@ -402,32 +478,48 @@ void keyboardCallback(unsigned char key, int x, int y) {
  * @param y Coordenada Y do mouse.
  */
 void specialKeysCallback(int key, int x, int y) {
-    // Ações de Arquivo
+    // Ações de Arquivo: rodam em segundo plano, com o andamento desenhado na janela.
     if (key == GLUT_KEY_F5) {
-        saveSceneToFile("scene.txt");
+        saveSceneAsync(g_sceneFileName);
+        glutPostRedisplay();
         return;
     }
     if (key == GLUT_KEY_F9) {
-        loadSceneFromFile("scene.txt");
+        loadSceneAsync(g_sceneFileName);
         glutPostRedisplay();
         return;
     }
+    if (key == GLUT_KEY_F8) {
+        sceneIoCancel();
+        return;
+    }
+
+    // Medidor de tempo: F3 liga/desliga as medições e o painel; F4 grava o trace.
+    if (key == GLUT_KEY_F3) {
+        profilerSetEnabled(!atomic_load(&g_profilerEnabled));
+        glutPostRedisplay();
+        return;
+    }
+    if (key == GLUT_KEY_F4) {
+        profilerExportTrace(PROFILER_TRACE_FILE);
+        return;
+    }
 
     // Ações condicionadas ao modo de operação
-    if (g_selectedObjectIndex != -1 && g_currentMode == MODE_ROTATE) {
+    if (g_numSelected > 0 && g_currentMode == MODE_ROTATE) {
         switch (key) {
-            case GLUT_KEY_LEFT: rotateObject(g_selectedObjectIndex, 5); break;
-            case GLUT_KEY_RIGHT: rotateObject(g_selectedObjectIndex, -5); break;
+            case GLUT_KEY_LEFT: rotateSelection(5); break;
+            case GLUT_KEY_RIGHT: rotateSelection(-5); break;
         }
         glutPostRedisplay();
     }
-    if (g_selectedObjectIndex != -1 && g_currentMode == MODE_SHEAR) {
+    if (g_numSelected > 0 && g_currentMode == MODE_SHEAR) {
         float shearFactor = 0.1f;
         switch (key) {
-            case GLUT_KEY_RIGHT: shearObject(g_selectedObjectIndex, shearFactor, 0.0f); break;
-            case GLUT_KEY_LEFT: shearObject(g_selectedObjectIndex, -shearFactor, 0.0f); break;
-            case GLUT_KEY_UP: shearObject(g_selectedObjectIndex, 0.0f, shearFactor); break;
-            case GLUT_KEY_DOWN: shearObject(g_selectedObjectIndex, 0.0f, -shearFactor); break;
+            case GLUT_KEY_RIGHT: shearSelection(shearFactor, 0.0f); break;
+            case GLUT_KEY_LEFT: shearSelection(-shearFactor, 0.0f); break;
+            case GLUT_KEY_UP: shearSelection(0.0f, shearFactor); break;
+            case GLUT_KEY_DOWN: shearSelection(0.0f, -shearFactor); break;
         }
         glutPostRedisplay();
     }
@@ -446,53 +538,79 @@ void mouseCallback(int button, int state, int x, int y) {
 
     if (state == GLUT_DOWN) {
         if (g_currentMode == MODE_CREATE_POINT && button == GLUT_LEFT_BUTTON) {
-            Point* newPoint = (Point*)malloc(sizeof(Point));
-            *newPoint = createPoint(click_point.x, click_point.y);
-            addObject(OBJECT_TYPE_POINT, newPoint);
-            g_selectedObjectIndex = g_numObjects - 1;
+            int created = resolveObjectHandle(addPointObject(createPoint(click_point.x, click_point.y)));
+            selectSingleObject(created);
+            historyRecordAdd(created);
         }
         else if (g_currentMode == MODE_CREATE_SEGMENT && button == GLUT_LEFT_BUTTON) {
             g_segmentClickCount++;
             if (g_segmentClickCount == 1) {
                 g_segmentP1 = click_point;
             } else if (g_segmentClickCount == 2) {
-                Segment* newSegment = (Segment*)malloc(sizeof(Segment));
-                *newSegment = createSegment(g_segmentP1, click_point);
-                addObject(OBJECT_TYPE_SEGMENT, newSegment);
-                g_selectedObjectIndex = g_numObjects - 1;
+                int created = resolveObjectHandle(addSegmentObject(createSegment(g_segmentP1, click_point)));
+                selectSingleObject(created);
+                historyRecordAdd(created);
                 g_segmentClickCount = 0;
             }
         }
         else if (g_currentMode == MODE_CREATE_POLYGON) {
-            if (button == GLUT_LEFT_BUTTON && g_polygonVertexCount < MAX_POLYGON_VERTICES) {
+            if (button == GLUT_LEFT_BUTTON) {
+                if (g_polygonVertexCount == s_polygonVertexCapacity) {
+                    int newCapacity = s_polygonVertexCapacity > 0 ? s_polygonVertexCapacity * 2 : 16;
+                    Point* grown = (Point*)realloc(g_polygonVertices, newCapacity * sizeof(Point));
+                    if (grown == NULL) {
+                        printf("[AVISO] Memória insuficiente para adicionar mais vértices.\n");
+                        return;
+                    }
+                    g_polygonVertices = grown;
+                    s_polygonVertexCapacity = newCapacity;
+                }
                 g_polygonVertices[g_polygonVertexCount++] = click_point;
             } else if (button == GLUT_RIGHT_BUTTON && g_polygonVertexCount >= 3) {
-                GfxPolygon* newPolygon = (GfxPolygon*)malloc(sizeof(GfxPolygon));
-                *newPolygon = createPolygon();
-                for (int i = 0; i < g_polygonVertexCount; i++) {
-                    addVertexToPolygon(newPolygon, g_polygonVertices[i]);
-                }
-                addObject(OBJECT_TYPE_POLYGON, newPolygon);
-                g_selectedObjectIndex = g_numObjects - 1;
+                GfxPolygon newPolygon = createPolygonFromVertices(g_polygonVertices, g_polygonVertexCount);
+                int created = resolveObjectHandle(addPolygonObject(&newPolygon));
+                selectSingleObject(created);
+                historyRecordAdd(created);
                 g_polygonVertexCount = 0;
             }
         }
         else if (g_currentMode == MODE_SELECT || g_currentMode == MODE_TRANSLATE) {
             if (button == GLUT_LEFT_BUTTON) {
+                int additive = (glutGetModifiers() & GLUT_ACTIVE_SHIFT) != 0;
                 int found_index = selectObjectAtPoint(click_point);
                 if (found_index != -1) {
-                    g_selectedObjectIndex = found_index;
-                    g_isDragging = 1;
+                    // Shift+clique alterna o objeto na seleção; um clique simples
+                    // em um objeto já selecionado mantém o grupo para arrastá-lo.
+                    if (additive) {
+                        selectionToggle(found_index);
+                    } else if (!isObjectSelected(found_index)) {
+                        selectSingleObject(found_index);
+                    }
+                    g_isDragging = (g_numSelected > 0);
                     g_lastMousePos = click_point;
+                    // Todos os movimentos do arraste viram um único comando no histórico.
+                    if (g_isDragging) historyBeginMerge();
                 } else {
-                    g_selectedObjectIndex = -1;
+                    if (!additive) selectionClear();
                     g_isDragging = 0;
+                    // No modo de seleção, arrastar a partir do vazio desenha o retângulo de seleção.
+                    if (g_currentMode == MODE_SELECT) {
+                        g_isRubberBanding = 1;
+                        g_rubberBandStart = click_point;
+                        g_currentMousePos = click_point;
+                    }
                 }
             }
         }
     }
     else if (state == GLUT_UP && button == GLUT_LEFT_BUTTON) {
+        if (g_isDragging) historyEndMerge();
         g_isDragging = 0;
+        if (g_isRubberBanding) {
+            g_isRubberBanding = 0;
+            selectObjectsInRect(fminf(g_rubberBandStart.x, click_point.x), fmaxf(g_rubberBandStart.x, click_point.x),
+                                fminf(g_rubberBandStart.y, click_point.y), fmaxf(g_rubberBandStart.y, click_point.y));
+        }
     }
     glutPostRedisplay();
 }
@@ -503,12 +621,18 @@ void mouseCallback(int button, int state, int x, int y) {
  * @param y Coordenada Y do mouse.
  */
 void motionCallback(int x, int y) {
-    if (g_isDragging && g_currentMode == MODE_TRANSLATE && g_selectedObjectIndex != -1) {
+    if (g_isRubberBanding) {
+        g_currentMousePos.x = (float)x;
+        g_currentMousePos.y = g_windowHeight - (float)y;
+        glutPostRedisplay();
+        return;
+    }
+    if (g_isDragging && g_currentMode == MODE_TRANSLATE && g_numSelected > 0) {
         float gl_y = g_windowHeight - (float)y;
         Point currentMousePos = {(float)x, gl_y};
         float dx = currentMousePos.x - g_lastMousePos.x;
         float dy = currentMousePos.y - g_lastMousePos.y;
-        translateObject(g_selectedObjectIndex, dx, dy);
+        translateSelection(dx, dy);
         g_lastMousePos = currentMousePos;
         glutPostRedisplay();
     }
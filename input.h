@@ -1,9 +1,9 @@
 /**
  * @file input.h
- * @brief Define a interface pblica e as variveis de estado do mdulo de entrada.
+ * @brief Define a interface pública e as variáveis de estado do módulo de entrada.
  *
- * Este arquivo declara as funes de callback do GLUT e as variveis globais
- * que controlam a mquina de estados do programa de acordo com as aes do usurio.
+ * Este arquivo declara as funções de callback do GLUT e as variáveis globais
+ * que controlam a máquina de estados do programa de acordo com as ações do usuário.
  */
 
 #ifndef INPUT_H
@@ -13,10 +13,10 @@
 #include "config.h"
 #include "polygon.h"
 
-// --- SEO DE ENUMS E DEFINIES ---
+// --- SEÇÃO DE ENUMS E DEFINIÇÕES ---
 
 /**
- * @brief Enumerao dos modos de operao do programa.
+ * @brief Enumeração dos modos de operação do programa.
  */
 typedef enum {
     MODE_SELECT,
@@ -30,18 +30,21 @@ typedef enum {
     MODE_REFLECT
 } ProgramMode;
 
-// --- SEO DE VARIVEIS GLOBAIS DE ESTADO (DECLARAES) ---
+// --- SEÇÃO DE VARIÁVEIS GLOBAIS DE ESTADO (DECLARAÇÕES) ---
 
-extern ProgramMode g_currentMode;               ///< O modo de operao atual do programa.
-extern int g_isDragging;                        ///< Sinaliza se o usurio est arrastando o mouse.
-extern int g_segmentClickCount;                 ///< Contador de cliques para a criao de segmentos.
-extern Point g_segmentP1;                       ///< O primeiro ponto clicado na criao de um segmento.
-extern Point g_polygonVertices[MAX_POLYGON_VERTICES]; ///< Vetor temporrio para os vrtices do polgono.
-extern int g_polygonVertexCount;                ///< Contador de vrtices na criao de um polgono.
-extern Point g_lastMousePos;                    ///< Posio anterior do mouse durante um movimento.
-extern Point g_currentMousePos;                 ///< Posio atual do mouse para pr-visualizaes.
+extern ProgramMode g_currentMode;               ///< O modo de operação atual do programa.
+extern int g_isDragging;                        ///< Sinaliza se o usuário está arrastando o mouse.
+extern int g_segmentClickCount;                 ///< Contador de cliques para a criação de segmentos.
+extern Point g_segmentP1;                       ///< O primeiro ponto clicado na criação de um segmento.
+extern Point* g_polygonVertices;                ///< Vetor temporário (redimensionável) para os vértices do polígono.
+extern int g_polygonVertexCount;                ///< Contador de vértices na criação de um polígono.
+extern Point g_lastMousePos;                    ///< Posição anterior do mouse durante um movimento.
+extern Point g_currentMousePos;                 ///< Posição atual do mouse para pré-visualizações.
+extern int g_isRubberBanding;                   ///< Sinaliza se o usuário está desenhando o retângulo de seleção.
+extern Point g_rubberBandStart;                 ///< O canto onde o retângulo de seleção começou.
+extern const char* g_sceneFileName;             ///< O arquivo de cena salvo com F5 e carregado com F9.
 
-// --- SEO DE PROTTIPOS DAS FUNES DE CALLBACK ---
+// --- SEÇÃO DE PROTÓTIPOS DAS FUNÇÕES DE CALLBACK ---
 
 void keyboardCallback(unsigned char key, int x, int y);
 void specialKeysCallback(int key, int x, int y);
@@ -49,4 +52,15 @@ void mouseCallback(int button, int state, int x, int y);
 void motionCallback(int x, int y);
 void passiveMotionCallback(int x, int y);
 
+// --- SEÇÃO DE CONSULTAS ---
+
+/**
+ * @brief Encontra o objeto de um clique, priorizando Pontos > Segmentos > Polígonos.
+ *
+ * Usada pelo clique no modo de seleção; não altera a seleção.
+ * @param click_point O ponto do clique, em coordenadas do mundo.
+ * @return O índice do objeto em 'g_objects' ou -1 se nenhum objeto estiver perto do clique.
+ */
+int selectObjectAtPoint(Point click_point);
+
 #endif // INPUT_H
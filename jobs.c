@@ -0,0 +1,318 @@
+/**
+ * @file jobs.c
+ * @brief Implementação do sistema de tarefas paralelas.
+ *
+ * A fila de cada participante é apenas um intervalo de blocos [frente, fim)
+ * guardado em um único inteiro atômico de 64 bits. O dono consome blocos
+ * pela frente e os ladrões pelo fim, ambos com compare-and-swap, então
+ * nenhum bloco é executado duas vezes e não há travas no caminho quente.
+ * A trava e as variáveis de condição só acordam e esperam as threads.
+ *
+ * Usa a API do Windows no Windows e pthreads nos demais sistemas.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#endif
+
+#include "jobs.h"
+#include "config.h"
+#include "profiler.h"
+
+// --- SEÇÃO DE ABSTRAÇÃO DE THREADS ---
+
+#ifdef _WIN32
+typedef HANDLE JobThread;
+typedef CRITICAL_SECTION JobMutex;
+typedef CONDITION_VARIABLE JobCond;
+#define THREAD_RESULT DWORD WINAPI
+static void mutexInit(JobMutex* m) { InitializeCriticalSection(m); }
+static void mutexDestroy(JobMutex* m) { DeleteCriticalSection(m); }
+static void mutexLock(JobMutex* m) { EnterCriticalSection(m); }
+static void mutexUnlock(JobMutex* m) { LeaveCriticalSection(m); }
+static void condInit(JobCond* c) { InitializeConditionVariable(c); }
+static void condDestroy(JobCond* c) { (void)c; }
+static void condWait(JobCond* c, JobMutex* m) { SleepConditionVariableCS(c, m, INFINITE); }
+static void condBroadcast(JobCond* c) { WakeAllConditionVariable(c); }
+static int threadStart(JobThread* t, DWORD (WINAPI *fn)(void*), void* arg) {
+    *t = CreateThread(NULL, 0, fn, arg, 0, NULL);
+    return *t != NULL;
+}
+static void threadJoin(JobThread t) {
+    WaitForSingleObject(t, INFINITE);
+    CloseHandle(t);
+}
+#else
+typedef pthread_t JobThread;
+typedef pthread_mutex_t JobMutex;
+typedef pthread_cond_t JobCond;
+#define THREAD_RESULT void*
+static void mutexInit(JobMutex* m) { pthread_mutex_init(m, NULL); }
+static void mutexDestroy(JobMutex* m) { pthread_mutex_destroy(m); }
+static void mutexLock(JobMutex* m) { pthread_mutex_lock(m); }
+static void mutexUnlock(JobMutex* m) { pthread_mutex_unlock(m); }
+static void condInit(JobCond* c) { pthread_cond_init(c, NULL); }
+static void condDestroy(JobCond* c) { pthread_cond_destroy(c); }
+static void condWait(JobCond* c, JobMutex* m) { pthread_cond_wait(c, m); }
+static void condBroadcast(JobCond* c) { pthread_cond_broadcast(c); }
+static int threadStart(JobThread* t, void* (*fn)(void*), void* arg) {
+    return pthread_create(t, NULL, fn, arg) == 0;
+}
+static void threadJoin(JobThread t) {
+    pthread_join(t, NULL);
+}
+#endif
+
+// --- SEÇÃO DE ESTRUTURAS E VARIÁVEIS PRIVADAS ---
+
+/**
+ * @brief Fila de blocos de um participante, isolada em sua própria linha de cache.
+ *
+ * Os 32 bits baixos guardam a frente e os 32 altos o fim do intervalo.
+ */
+typedef union {
+    _Atomic uint64_t range;
+    char padding[64];
+} WorkQueue;
+
+static int s_numThreads = 1;                    ///< Participantes, incluindo a thread principal.
+static int s_started = 0;                       ///< 1 se as threads trabalhadoras estão rodando.
+static JobThread s_threads[JOBS_MAX_THREADS];
+static WorkQueue s_queues[JOBS_MAX_THREADS];
+
+static JobMutex s_mutex;
+static JobCond s_wakeCond;                      ///< Sinalizada quando há um novo laço ou no encerramento.
+static JobCond s_doneCond;                      ///< Sinalizada quando o último trabalhador termina.
+static unsigned int s_generation = 0;           ///< Incrementada a cada novo laço publicado.
+static int s_pending = 0;                       ///< Trabalhadores que ainda não terminaram o laço atual.
+static int s_quit = 0;
+
+// O laço atual (válido enquanto 's_pending' > 0).
+static JobRangeFunc s_func = NULL;
+static void* s_ctx = NULL;
+static int s_count = 0;
+static int s_grain = 1;
+
+/**
+ * @brief Uma tarefa em segundo plano e a sua thread dedicada.
+ */
+struct JobTask {
+    JobThread thread;
+    JobTaskFunc func;
+    void* ctx;
+};
+
+// --- SEÇÃO DE FUNÇÕES AUXILIARES (IMPLEMENTAÇÃO PRIVADA) ---
+
+static uint64_t packRange(uint32_t front, uint32_t back) {
+    return ((uint64_t)back << 32) | front;
+}
+
+/**
+ * @brief Retira um bloco da frente (dono) ou do fim (ladrão) de uma fila.
+ * @return int 1 se um bloco foi obtido em 'chunk', 0 se a fila está vazia.
+ */
+static int takeChunk(WorkQueue* q, int fromBack, int* chunk) {
+    uint64_t r = atomic_load(&q->range);
+    for (;;) {
+        uint32_t front = (uint32_t)r;
+        uint32_t back = (uint32_t)(r >> 32);
+        if (front >= back) return 0;
+        uint64_t next = fromBack ? packRange(front, back - 1) : packRange(front + 1, back);
+        if (atomic_compare_exchange_weak(&q->range, &r, next)) {
+            *chunk = fromBack ? (int)(back - 1) : (int)front;
+            return 1;
+        }
+    }
+}
+
+static void runChunk(int chunk) {
+    int first = chunk * s_grain;
+    int last = first + s_grain;
+    if (last > s_count) last = s_count;
+    s_func(first, last, s_ctx);
+}
+
+/**
+ * @brief Consome a fila própria e, depois, rouba das filas dos outros até todas esvaziarem.
+ */
+static void participate(int self) {
+    int chunk;
+    while (takeChunk(&s_queues[self], 0, &chunk)) {
+        runChunk(chunk);
+    }
+    for (int k = 1; k < s_numThreads; k++) {
+        WorkQueue* victim = &s_queues[(self + k) % s_numThreads];
+        while (takeChunk(victim, 1, &chunk)) {
+            runChunk(chunk);
+        }
+    }
+}
+
+static THREAD_RESULT workerMain(void* arg) {
+    int self = (int)(intptr_t)arg;
+    unsigned int seen = 0;
+
+    mutexLock(&s_mutex);
+    for (;;) {
+        while (!s_quit && s_generation == seen) {
+            condWait(&s_wakeCond, &s_mutex);
+        }
+        if (s_quit) break;
+        seen = s_generation;
+        mutexUnlock(&s_mutex);
+
+        participate(self);
+
+        mutexLock(&s_mutex);
+        if (--s_pending == 0) {
+            condBroadcast(&s_doneCond);
+        }
+    }
+    mutexUnlock(&s_mutex);
+    profilerThreadExit();
+    return 0;
+}
+
+static THREAD_RESULT taskMain(void* arg) {
+    JobTask* task = (JobTask*)arg;
+    task->func(task->ctx);
+    profilerThreadExit();
+    return 0;
+}
+
+// --- SEÇÃO DE FUNÇÕES PÚBLICAS ---
+
+void jobsInit(int numThreads) {
+    jobsShutdown();
+
+    if (numThreads <= 0) numThreads = jobsHardwareThreads();
+    if (numThreads > JOBS_MAX_THREADS) numThreads = JOBS_MAX_THREADS;
+    s_numThreads = 1;
+    if (numThreads == 1) return;
+
+    mutexInit(&s_mutex);
+    condInit(&s_wakeCond);
+    condInit(&s_doneCond);
+    s_quit = 0;
+    s_generation = 0;
+    s_started = 1;
+
+    // A thread principal é o participante 0; as trabalhadoras são 1..n-1.
+    for (int i = 1; i < numThreads; i++) {
+        if (!threadStart(&s_threads[i], workerMain, (void*)(intptr_t)i)) {
+            fprintf(stderr, "[Jobs ERROR] Falha ao criar a thread %d; usando %d.\n", i, s_numThreads);
+            break;
+        }
+        s_numThreads++;
+    }
+}
+
+int jobsThreadCount(void) {
+    return s_numThreads;
+}
+
+int jobsHardwareThreads(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int n = (int)info.dwNumberOfProcessors;
+#else
+    int n = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return n > 0 ? n : 1;
+}
+
+void jobsParallelFor(int count, int grain, JobRangeFunc func, void* ctx) {
+    if (count <= 0) return;
+    if (grain < 1) grain = 1;
+    int numChunks = (count + grain - 1) / grain;
+    if (s_numThreads <= 1 || numChunks < 2) {
+        func(0, count, ctx);
+        return;
+    }
+
+    // Cada participante começa com uma fatia contígua dos blocos.
+    for (int w = 0; w < s_numThreads; w++) {
+        uint32_t front = (uint32_t)((long long)numChunks * w / s_numThreads);
+        uint32_t back = (uint32_t)((long long)numChunks * (w + 1) / s_numThreads);
+        atomic_store(&s_queues[w].range, packRange(front, back));
+    }
+
+    mutexLock(&s_mutex);
+    s_func = func;
+    s_ctx = ctx;
+    s_count = count;
+    s_grain = grain;
+    s_pending = s_numThreads - 1;
+    s_generation++;
+    condBroadcast(&s_wakeCond);
+    mutexUnlock(&s_mutex);
+
+    participate(0);
+
+    mutexLock(&s_mutex);
+    while (s_pending > 0) {
+        condWait(&s_doneCond, &s_mutex);
+    }
+    mutexUnlock(&s_mutex);
+}
+
+JobTask* jobsSpawn(JobTaskFunc func, void* ctx) {
+    JobTask* task = (JobTask*)malloc(sizeof(JobTask));
+    if (!task) return NULL;
+    task->func = func;
+    task->ctx = ctx;
+    if (!threadStart(&task->thread, taskMain, task)) {
+        fprintf(stderr, "[Jobs ERROR] Falha ao criar a thread da tarefa em segundo plano.\n");
+        free(task);
+        return NULL;
+    }
+    return task;
+}
+
+void jobsJoin(JobTask* task) {
+    if (!task) return;
+    threadJoin(task->thread);
+    free(task);
+}
+
+double jobsWallTime(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq, now;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+void jobsShutdown(void) {
+    if (!s_started) return;
+
+    mutexLock(&s_mutex);
+    s_quit = 1;
+    condBroadcast(&s_wakeCond);
+    mutexUnlock(&s_mutex);
+    for (int i = 1; i < s_numThreads; i++) {
+        threadJoin(s_threads[i]);
+    }
+
+    condDestroy(&s_wakeCond);
+    condDestroy(&s_doneCond);
+    mutexDestroy(&s_mutex);
+    s_started = 0;
+    s_numThreads = 1;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file jobs.h
+ * @brief Define a interface do sistema de tarefas paralelas (job system).
+ *
+ * Um conjunto fixo de threads trabalhadoras executa laços "parallel for":
+ * o intervalo de índices é dividido em blocos, cada participante recebe uma
+ * fila com a sua parte dos blocos e, ao esvaziá-la, rouba blocos do fim das
+ * filas dos outros ("work stealing"). Cada bloco é executado por exatamente
+ * um participante. A thread que chama jobsParallelFor() também trabalha.
+ *
+ * Trabalhos longos e isolados (como ler ou gravar um arquivo) rodam em uma
+ * thread dedicada criada por jobsSpawn(), sem ocupar as trabalhadoras.
+ */
+
+#ifndef JOBS_H
+#define JOBS_H
+
+// --- SEÇÃO DE ESTRUTURAS E TIPOS ---
+
+/**
+ * @brief Função que processa os índices [first, last) de um laço paralelo.
+ * @param first O primeiro índice do bloco.
+ * @param last O índice seguinte ao último do bloco.
+ * @param ctx O ponteiro de contexto passado a jobsParallelFor().
+ */
+typedef void (*JobRangeFunc)(int first, int last, void* ctx);
+
+/**
+ * @brief Função executada por uma tarefa em segundo plano.
+ * @param ctx O ponteiro de contexto passado a jobsSpawn().
+ */
+typedef void (*JobTaskFunc)(void* ctx);
+
+/**
+ * @brief Uma tarefa em segundo plano (tipo opaco).
+ */
+typedef struct JobTask JobTask;
+
+// --- SEÇÃO DE PROTÓTIPOS DE FUNÇÕES PÚBLICAS ---
+
+/**
+ * @brief Inicia (ou reinicia) as threads trabalhadoras.
+ *
+ * Se as threads já existem, elas são encerradas e recriadas com o novo total.
+ * @param numThreads O total de participantes, contando a thread principal
+ *        (0 usa a quantidade de processadores da máquina; 1 desliga o paralelismo).
+ */
+void jobsInit(int numThreads);
+
+/**
+ * @brief Retorna o total de participantes dos laços paralelos (incluindo a thread principal).
+ */
+int jobsThreadCount(void);
+
+/**
+ * @brief Retorna a quantidade de processadores disponíveis na máquina.
+ */
+int jobsHardwareThreads(void);
+
+/**
+ * @brief Executa 'func' sobre os índices [0, count) dividido em blocos de 'grain' índices.
+ *
+ * Só retorna quando todos os blocos terminaram. Sem threads trabalhadoras
+ * (ou com um único bloco), chama 'func' uma vez com o intervalo inteiro.
+ * Não pode ser chamada de dentro de um laço paralelo.
+ * @param count A quantidade de índices.
+ * @param grain A quantidade de índices por bloco.
+ * @param func A função chamada para cada bloco.
+ * @param ctx Um ponteiro repassado a 'func'.
+ */
+void jobsParallelFor(int count, int grain, JobRangeFunc func, void* ctx);
+
+/**
+ * @brief Executa 'func' em uma nova thread dedicada, em segundo plano.
+ * @param func A função a ser executada.
+ * @param ctx Um ponteiro repassado a 'func'.
+ * @return JobTask* A tarefa, que deve ser encerrada com jobsJoin(), ou NULL se a thread não pôde ser criada.
+ */
+JobTask* jobsSpawn(JobTaskFunc func, void* ctx);
+
+/**
+ * @brief Espera a tarefa terminar e libera os seus recursos.
+ * @param task A tarefa obtida em jobsSpawn() (NULL é ignorado).
+ */
+void jobsJoin(JobTask* task);
+
+/**
+ * @brief Retorna o tempo de um relógio de parede de alta resolução, em segundos.
+ *
+ * Ao contrário de clock(), não soma o tempo de processador de todas as
+ * threads, então serve para medir laços paralelos.
+ */
+double jobsWallTime(void);
+
+/**
+ * @brief Encerra as threads trabalhadoras.
+ */
+void jobsShutdown(void);
+
+#endif // JOBS_H
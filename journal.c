@@ -0,0 +1,752 @@
+/**
+ * @file journal.c
+ * @brief Implementação do diário de operações.
+ *
+ * Arquivos usados por um diário "<diario>":
+ *   "<diario>"              cabeçalho, identificadores e transformações dos objetos da base e registros;
+ *   "<diario>.0.rbq"/".1.rbq" a base das épocas pares e das épocas ímpares;
+ *   "<diario>.next"         o próximo diário, durante uma compactação.
+ *
+ * A base guarda a geometria base de cada objeto, e o diário a transformação
+ * acumulada de cada um; a recuperação recompõe as mesmas matrizes e refaz os
+ * mesmos vértices no mundo, em vez de partir de vértices já transformados.
+ *
+ * Uma compactação copia a cena na thread principal, escreve a base da época
+ * seguinte em segundo plano e, enquanto isso, grava cada registro novo nos
+ * dois diários. Só depois que a base nova está completa no disco o próximo
+ * diário substitui o atual, com um rename; até lá, o diário e a base antigos
+ * continuam completos. Assim, uma queda em qualquer ponto deixa um par
+ * (diário, base) consistente.
+ *
+ * Cada registro leva uma soma de verificação, e a recuperação para no
+ * primeiro registro incompleto ou corrompido.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include "journal.h"
+#include "config.h"
+#include "objects.h"
+#include "polygon.h"
+#include "snapshot.h"
+#include "file_io.h"
+#include "jobs.h"
+#include "animation.h"
+
+// --- SEÇÃO DE ESTRUTURAS DO ARQUIVO ---
+
+#define JOURNAL_MAGIC "RBQJ"
+#define JOURNAL_VERSION 2u                ///< A versão 2 acrescentou JOURNAL_OP_PLACE; diários da versão 1 continuam legíveis.
+#define JOURNAL_BYTE_ORDER 0x01020304u      ///< Lido ao contrário em uma máquina big-endian.
+
+/**
+ * @brief Cabeçalho do diário.
+ */
+typedef struct {
+    char magic[4];                  ///< Sempre "RBQJ".
+    uint32_t version;               ///< Versão do formato que gravou o arquivo.
+    uint32_t byteOrder;             ///< JOURNAL_BYTE_ORDER na ordem de bytes de quem gravou.
+    uint32_t headerSize;            ///< sizeof(JournalHeader) de quem gravou.
+    uint64_t epoch;                 ///< Escolhe a base: "<diario>.<epoch % 2>.rbq".
+    uint32_t numBaseObjects;        ///< Seguido de numBaseObjects identificadores uint32_t e numBaseObjects Matrix3x3, na ordem de carga da base.
+    uint32_t nextId;                ///< O próximo identificador livre quando a base foi copiada.
+} JournalHeader;
+
+/**
+ * @brief As operações registradas.
+ */
+typedef enum {
+    JOURNAL_OP_ADD_POINT = 1,       ///< 2 floats: o ponto.
+    JOURNAL_OP_ADD_SEGMENT,         ///< 4 floats: os extremos.
+    JOURNAL_OP_ADD_POLYGON,         ///< 2 floats por vértice.
+    JOURNAL_OP_REMOVE,              ///< Sem dados.
+    JOURNAL_OP_TRANSFORM,           ///< 9 floats: a matriz, linha a linha.
+    JOURNAL_OP_GEOMETRY,            ///< A nova geometria no mundo, no mesmo formato da inserção.
+    JOURNAL_OP_CLEAR,               ///< Sem dados.
+    JOURNAL_OP_ANIM,                ///< 6 floats: ativo, vx, vy, e, gravidade, vmax.
+    JOURNAL_OP_PLACE                ///< 9 floats: a transformação acumulada, que substitui a atual.
+} JournalOp;
+
+/**
+ * @brief Cabeçalho de um registro, seguido de 'numFloats' floats.
+ */
+typedef struct {
+    uint32_t op;                    ///< Um JournalOp.
+    uint32_t id;                    ///< O objeto afetado (o objeto novo, nas inserções).
+    uint32_t numFloats;             ///< Tamanho dos dados do registro.
+    uint32_t checksum;              ///< Soma dos três campos acima e dos dados.
+} JournalRecord;
+
+_Static_assert(sizeof(JournalHeader) == 32, "O cabeçalho do diário mudou de tamanho");
+_Static_assert(sizeof(JournalRecord) == 16, "O registro do diário mudou de tamanho");
+_Static_assert(sizeof(Point) == 2 * sizeof(float), "Point precisa ser dois floats sem preenchimento");
+_Static_assert(sizeof(Matrix3x3) == 9 * sizeof(float), "Matrix3x3 precisa ser nove floats sem preenchimento");
+
+// --- SEÇÃO DE VARIÁVEIS PRIVADAS DO MÓDULO ---
+
+static char* s_fileName = NULL;             ///< O nome do diário (NULL com o diário fechado).
+static FILE* s_file = NULL;                 ///< O diário atual, aberto para acréscimo (NULL se não registra).
+static uint64_t s_epoch = 0;                ///< A época da base do diário atual.
+static unsigned int s_nextId = 0;           ///< O próximo identificador de objeto.
+static long long s_logBytes = 0;            ///< Bytes de registros no diário atual.
+static long long s_baseBytes = 0;           ///< Tamanho aproximado da base atual.
+static double s_lastCompactionTime = 0.0;
+
+// Compactação em andamento.
+static JobTask* s_compactTask = NULL;
+static FILE* s_nextFile = NULL;             ///< O próximo diário, que também recebe os registros.
+static long long s_nextLogBytes = 0;
+static long long s_nextBaseBytes = 0;
+static char* s_compactBaseName = NULL;
+static SceneSnapshot s_compactSnapshot;
+static SceneIoStatus s_compactStatus;
+static int s_compactOk = 0;
+static _Atomic int s_compactFinished = 0;
+
+// Tabela (identificador -> handle) usada apenas durante a recuperação.
+typedef struct {
+    uint32_t id;
+    ObjectHandle handle;                    ///< OBJECT_HANDLE_NONE marca uma posição livre.
+} JournalIdEntry;
+
+static JournalIdEntry* s_idMap = NULL;
+static size_t s_idMapCapacity = 0;
+static size_t s_idMapCount = 0;
+
+// --- SEÇÃO DE FUNÇÕES AUXILIARES (IMPLEMENTAÇÃO PRIVADA) ---
+
+/**
+ * @brief Retorna um novo nome "<diario><sufixo>", que deve ser liberado com free().
+ */
+static char* journalFileName(const char* suffix) {
+    size_t length = strlen(s_fileName);
+    size_t suffixLength = strlen(suffix);
+    char* name = (char*)malloc(length + suffixLength + 1);
+    if (name) {
+        memcpy(name, s_fileName, length);
+        memcpy(name + length, suffix, suffixLength + 1);
+    }
+    return name;
+}
+
+/**
+ * @brief Retorna o nome da base de uma época, que deve ser liberado com free().
+ */
+static char* baseFileName(uint64_t epoch) {
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), ".%d%s", (int)(epoch % 2), SCENE_BINARY_EXTENSION);
+    return journalFileName(suffix);
+}
+
+/**
+ * @brief Soma FNV-1a, palavra a palavra, do registro (sem o campo da soma) e dos seus dados.
+ */
+static uint32_t recordChecksum(const JournalRecord* rec, const float* data) {
+    uint32_t hash = 2166136261u;
+    hash = (hash ^ rec->op) * 16777619u;
+    hash = (hash ^ rec->id) * 16777619u;
+    hash = (hash ^ rec->numFloats) * 16777619u;
+    for (uint32_t k = 0; k < rec->numFloats; k++) {
+        uint32_t word;
+        memcpy(&word, &data[k], sizeof(word));
+        hash = (hash ^ word) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Retorna a geometria no mundo de um objeto como uma lista de floats.
+ */
+static const float* objectGeometry(int index, uint32_t* numFloats) {
+    const Object* o = &g_objects[index];
+    switch (o->type) {
+        case OBJECT_TYPE_POINT:
+            *numFloats = 2;
+            return &g_points[o->slot].x;
+        case OBJECT_TYPE_SEGMENT:
+            // Os dois extremos do segmento ficam lado a lado na memória.
+            *numFloats = 4;
+            return &g_segments[o->slot].p1.x;
+        case OBJECT_TYPE_POLYGON:
+            *numFloats = 2u * (uint32_t)g_polygons[o->slot].numVertices;
+            return (const float*)g_polygons[o->slot].vertices;
+    }
+    *numFloats = 0;
+    return NULL;
+}
+
+/**
+ * @brief Para de registrar depois de um erro de escrita (a cena continua funcionando).
+ */
+static void stopRecording(void) {
+    fprintf(stderr, "[Journal ERROR] Falha ao escrever o diário '%s'; as operações deixaram de ser registradas.\n", s_fileName);
+    fclose(s_file);
+    s_file = NULL;
+}
+
+/**
+ * @brief Acrescenta um registro ao diário atual e, durante uma compactação, ao próximo.
+ *
+ * Os registros ficam no buffer do arquivo até o próximo journalPoll().
+ */
+static void writeRecord(JournalOp op, unsigned int id, const float* data, uint32_t numFloats) {
+    if (!s_file) return;
+    JournalRecord rec = {(uint32_t)op, id, numFloats, 0};
+    rec.checksum = recordChecksum(&rec, data);
+
+    FILE* files[2] = {s_file, s_nextFile};
+    for (int f = 0; f < 2 && files[f]; f++) {
+        fwrite(&rec, sizeof(rec), 1, files[f]);
+        if (numFloats > 0) fwrite(data, sizeof(float), numFloats, files[f]);
+    }
+    long long bytes = (long long)sizeof(rec) + (long long)numFloats * (long long)sizeof(float);
+    s_logBytes += bytes;
+    if (s_nextFile) s_nextLogBytes += bytes;
+}
+
+/**
+ * @brief Registra a transformação acumulada de um objeto, que inclui o deslocamento da animação.
+ */
+static void recordPlacement(int index) {
+    writeRecord(JOURNAL_OP_PLACE, g_objects[index].journalId, &g_objects[index].transform.m[0][0], 9);
+}
+
+// --- SEÇÃO DE COMPACTAÇÃO ---
+
+static void compactTask(void* ctx) {
+    (void)ctx;
+    s_compactOk = writeSceneFile(&s_compactSnapshot, s_compactBaseName, &s_compactStatus);
+    atomic_store(&s_compactFinished, 1);
+}
+
+/**
+ * @brief Copia a cena e cria o próximo diário, que passa a receber os registros.
+ * @return int 1 se a compactação pode começar, 0 em caso de erro.
+ */
+static int beginCompaction(void) {
+    snapshotInit(&s_compactSnapshot);
+    char* nextName = journalFileName(".next");
+    s_compactBaseName = baseFileName(s_epoch + 1);
+    if (!nextName || !s_compactBaseName || !snapshotCaptureBase(&s_compactSnapshot)) {
+        free(nextName);
+        return 0;
+    }
+
+    // Identificadores e transformações vão na ordem de carga da base: pontos, segmentos, polígonos.
+    uint32_t numObjects = (uint32_t)snapshotObjectCount(&s_compactSnapshot);
+    size_t arraySize = numObjects > 0 ? numObjects : 1;
+    uint32_t* ids = (uint32_t*)malloc(arraySize * sizeof(uint32_t));
+    Matrix3x3* transforms = (Matrix3x3*)malloc(arraySize * sizeof(Matrix3x3));
+    FILE* next = ids && transforms ? fopen(nextName, "wb") : NULL;
+    int ok = next != NULL;
+    if (ok) {
+        const int* owners[3] = {g_pointOwners, g_segmentOwners, g_polygonOwners};
+        const int counts[3] = {g_numPoints, g_numSegments, g_numPolygons};
+        uint32_t k = 0;
+        for (int t = 0; t < 3; t++) {
+            for (int i = 0; i < counts[t]; i++, k++) {
+                ids[k] = g_objects[owners[t][i]].journalId;
+                transforms[k] = g_objects[owners[t][i]].transform;
+            }
+        }
+
+        JournalHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, JOURNAL_MAGIC, 4);
+        header.version = JOURNAL_VERSION;
+        header.byteOrder = JOURNAL_BYTE_ORDER;
+        header.headerSize = sizeof(JournalHeader);
+        header.epoch = s_epoch + 1;
+        header.numBaseObjects = numObjects;
+        header.nextId = s_nextId;
+        ok = fwrite(&header, sizeof(header), 1, next) == 1 &&
+             fwrite(ids, sizeof(uint32_t), numObjects, next) == numObjects &&
+             fwrite(transforms, sizeof(Matrix3x3), numObjects, next) == numObjects;
+    }
+    free(ids);
+    free(transforms);
+    if (!ok) {
+        fprintf(stderr, "[Journal ERROR] Não foi possível criar '%s'.\n", nextName);
+        if (next) fclose(next);
+        remove(nextName);
+        free(nextName);
+        return 0;
+    }
+    free(nextName);
+
+    const SceneSnapshot* snap = &s_compactSnapshot;
+    s_nextFile = next;
+    s_nextLogBytes = 0;
+    s_nextBaseBytes = (long long)snap->numPoints * sizeof(Point) + (long long)snap->numSegments * sizeof(Segment) +
+                      (long long)snap->numPolygons * sizeof(uint32_t) + (long long)snap->numVertices * sizeof(Point) +
+                      (long long)numObjects * (sizeof(uint32_t) + sizeof(Matrix3x3));
+    s_compactOk = 0;
+    atomic_store(&s_compactStatus.done, 0);
+    atomic_store(&s_compactStatus.total, 0);
+    atomic_store(&s_compactStatus.cancel, 0);
+    atomic_store(&s_compactFinished, 0);
+    return 1;
+}
+
+/**
+ * @brief Conclui a compactação: o próximo diário substitui o atual se a base nova foi gravada.
+ *
+ * Caso contrário, o próximo diário é descartado e o atual continua valendo.
+ */
+static void finishCompaction(void) {
+    char* nextName = journalFileName(".next");
+    int wasRecording = s_file != NULL;
+    int ok = s_compactOk && !atomic_load(&s_compactStatus.cancel) && !ferror(s_nextFile);
+    if (fclose(s_nextFile) != 0) ok = 0;
+    s_nextFile = NULL;
+
+    if (ok && nextName) {
+        if (s_file) fclose(s_file);
+        s_file = NULL;
+        if (replaceSceneFile(nextName, s_fileName)) {
+            char* oldBase = baseFileName(s_epoch);
+            if (oldBase) remove(oldBase);
+            free(oldBase);
+            s_epoch++;
+            s_logBytes = s_nextLogBytes;
+            s_baseBytes = s_nextBaseBytes;
+            wasRecording = 1;
+        } else {
+            fprintf(stderr, "[Journal ERROR] Não foi possível substituir '%s'.\n", s_fileName);
+            remove(nextName);
+        }
+        // O diário atual (novo ou antigo) recebeu todos os registros até aqui.
+        if (wasRecording) {
+            s_file = fopen(s_fileName, "ab");
+            if (!s_file) {
+                fprintf(stderr, "[Journal ERROR] Não foi possível reabrir '%s'; as operações deixaram de ser registradas.\n", s_fileName);
+            }
+        }
+    } else {
+        if (nextName) remove(nextName);
+        if (!atomic_load(&s_compactStatus.cancel)) {
+            fprintf(stderr, "[Journal ERROR] Falha ao compactar o diário '%s'.\n", s_fileName);
+        }
+    }
+    free(nextName);
+    free(s_compactBaseName);
+    s_compactBaseName = NULL;
+    snapshotFree(&s_compactSnapshot);
+    s_lastCompactionTime = jobsWallTime();
+}
+
+/**
+ * @brief Inicia uma compactação em segundo plano.
+ */
+static void startCompaction(void) {
+    if (!beginCompaction()) {
+        free(s_compactBaseName);
+        s_compactBaseName = NULL;
+        snapshotFree(&s_compactSnapshot);
+        s_lastCompactionTime = jobsWallTime(); // Não tenta de novo a cada quadro.
+        return;
+    }
+    s_compactTask = jobsSpawn(compactTask, NULL);
+    if (!s_compactTask) {
+        // Sem thread: a compactação falha e o próximo diário é descartado.
+        finishCompaction();
+    }
+}
+
+/**
+ * @brief Decide se o diário deve ser compactado agora.
+ *
+ * O diário só é compactado depois de ficar maior do que a base, então o
+ * custo de cada compactação (proporcional à cena) se divide entre pelo menos
+ * o mesmo volume de edições.
+ */
+static int compactionDue(void) {
+    if (s_logBytes >= JOURNAL_COMPACT_MIN_BYTES && s_logBytes >= s_baseBytes) return 1;
+    return s_logBytes > 0 && anim_active_count() > 0 &&
+           jobsWallTime() - s_lastCompactionTime >= JOURNAL_ANIMATED_COMPACT_SECONDS;
+}
+
+// --- SEÇÃO DE RECUPERAÇÃO ---
+
+static int idMapPut(uint32_t id, ObjectHandle handle);
+
+/**
+ * @brief Dobra a tabela de identificadores e reinsere as entradas.
+ */
+static int idMapGrow(void) {
+    size_t oldCapacity = s_idMapCapacity;
+    JournalIdEntry* old = s_idMap;
+    size_t newCapacity = oldCapacity > 0 ? oldCapacity * 2 : INITIAL_OBJECT_CAPACITY;
+    JournalIdEntry* entries = (JournalIdEntry*)malloc(newCapacity * sizeof(JournalIdEntry));
+    if (!entries) return 0;
+    for (size_t k = 0; k < newCapacity; k++) entries[k].handle = OBJECT_HANDLE_NONE;
+    s_idMap = entries;
+    s_idMapCapacity = newCapacity;
+    s_idMapCount = 0;
+    for (size_t k = 0; k < oldCapacity; k++) {
+        if (old[k].handle.id != -1) idMapPut(old[k].id, old[k].handle);
+    }
+    free(old);
+    return 1;
+}
+
+/**
+ * @brief Associa um identificador de diário a um objeto (endereçamento aberto).
+ */
+static int idMapPut(uint32_t id, ObjectHandle handle) {
+    if ((s_idMapCount + 1) * 2 > s_idMapCapacity && !idMapGrow()) return 0;
+    size_t mask = s_idMapCapacity - 1;
+    size_t k = (id * 2654435761u) & mask;
+    while (s_idMap[k].handle.id != -1 && s_idMap[k].id != id) k = (k + 1) & mask;
+    if (s_idMap[k].handle.id == -1) s_idMapCount++;
+    s_idMap[k].id = id;
+    s_idMap[k].handle = handle;
+    return 1;
+}
+
+/**
+ * @brief Retorna o índice atual do objeto com o identificador dado, ou -1 se ele não existe mais.
+ */
+static int idMapFind(uint32_t id) {
+    if (s_idMapCapacity == 0) return -1;
+    size_t mask = s_idMapCapacity - 1;
+    size_t k = (id * 2654435761u) & mask;
+    while (s_idMap[k].handle.id != -1) {
+        if (s_idMap[k].id == id) return resolveObjectHandle(s_idMap[k].handle);
+        k = (k + 1) & mask;
+    }
+    return -1;
+}
+
+/**
+ * @brief Verifica se o tamanho dos dados de um registro combina com a operação.
+ */
+static int recordIsValid(const JournalRecord* rec) {
+    switch ((JournalOp)rec->op) {
+        case JOURNAL_OP_ADD_POINT: return rec->numFloats == 2;
+        case JOURNAL_OP_ADD_SEGMENT: return rec->numFloats == 4;
+        case JOURNAL_OP_ADD_POLYGON:
+        case JOURNAL_OP_GEOMETRY: return rec->numFloats % 2 == 0 && rec->numFloats / 2 <= (uint32_t)INT32_MAX;
+        case JOURNAL_OP_TRANSFORM:
+        case JOURNAL_OP_PLACE: return rec->numFloats == 9;
+        case JOURNAL_OP_ANIM: return rec->numFloats == 6;
+        case JOURNAL_OP_REMOVE:
+        case JOURNAL_OP_CLEAR: return rec->numFloats == 0;
+    }
+    return 0;
+}
+
+/**
+ * @brief Substitui a geometria de um objeto, como o fecho convexo faz.
+ */
+static void replaceGeometry(int index, const float* data, uint32_t numFloats) {
+    objectFlushTransform(index);
+    switch (g_objects[index].type) {
+        case OBJECT_TYPE_POINT:
+            if (numFloats != 2) return;
+            memcpy(getObjectPoint(index), data, sizeof(Point));
+            break;
+        case OBJECT_TYPE_SEGMENT:
+            if (numFloats != 4) return;
+            memcpy(getObjectSegment(index), data, sizeof(Segment));
+            break;
+        case OBJECT_TYPE_POLYGON: {
+            GfxPolygon poly = createPolygonFromVertices((const Point*)data, (int)(numFloats / 2));
+            if (poly.numVertices == 0 && numFloats > 0) return;
+            GfxPolygon* world = getObjectPolygon(index);
+            freePolygon(world);
+            *world = poly;
+            break;
+        }
+    }
+    objectGeometryChanged(index);
+}
+
+/**
+ * @brief Refaz uma operação do diário sobre a cena.
+ */
+static void applyRecord(const JournalRecord* rec, const float* data) {
+    ObjectHandle handle = OBJECT_HANDLE_NONE;
+    int index = -1;
+    switch ((JournalOp)rec->op) {
+        case JOURNAL_OP_ADD_POINT: {
+            Point p;
+            memcpy(&p, data, sizeof(p));
+            s_nextId = rec->id;
+            handle = addPointObject(p);
+            break;
+        }
+        case JOURNAL_OP_ADD_SEGMENT: {
+            Segment s;
+            memcpy(&s, data, sizeof(s));
+            s_nextId = rec->id;
+            handle = addSegmentObject(s);
+            break;
+        }
+        case JOURNAL_OP_ADD_POLYGON: {
+            GfxPolygon poly = createPolygonFromVertices((const Point*)data, (int)(rec->numFloats / 2));
+            s_nextId = rec->id;
+            handle = addPolygonObject(&poly);
+            break;
+        }
+        case JOURNAL_OP_REMOVE:
+            index = idMapFind(rec->id);
+            if (index != -1) removeObject(index);
+            break;
+        case JOURNAL_OP_TRANSFORM: {
+            index = idMapFind(rec->id);
+            if (index != -1) {
+                Matrix3x3 matrix;
+                memcpy(&matrix, data, sizeof(matrix));
+                objectApplyTransform(index, &matrix);
+            }
+            break;
+        }
+        case JOURNAL_OP_GEOMETRY:
+            index = idMapFind(rec->id);
+            if (index != -1) replaceGeometry(index, data, rec->numFloats);
+            break;
+        case JOURNAL_OP_CLEAR:
+            clearAllObjects();
+            break;
+        case JOURNAL_OP_ANIM:
+            index = idMapFind(rec->id);
+            if (index == -1) break;
+            if (data[0] != 0.0f) {
+                anim_enable(index, data[1], data[2], data[3], data[4] != 0.0f);
+            } else {
+                anim_disable(index);
+                g_anim[index].vx = data[1];
+                g_anim[index].vy = data[2];
+                g_anim[index].e = data[3];
+                g_anim[index].gravity = data[4] != 0.0f;
+            }
+            g_anim[index].vmax = data[5];
+            break;
+        case JOURNAL_OP_PLACE: {
+            index = idMapFind(rec->id);
+            if (index != -1) {
+                Matrix3x3 matrix;
+                memcpy(&matrix, data, sizeof(matrix));
+                objectSetTransform(index, &matrix);
+            }
+            break;
+        }
+    }
+    if (handle.id != -1) {
+        idMapPut(rec->id, handle);
+    }
+}
+
+/**
+ * @brief Carrega a base do diário e refaz as operações registradas.
+ *
+ * Em caso de erro no cabeçalho ou na base, a cena fica vazia. Um registro
+ * incompleto ou corrompido encerra a recuperação sem desfazer as operações
+ * anteriores a ele.
+ */
+static void recoverScene(FILE* f) {
+    JournalHeader header;
+    if (fread(&header, sizeof(header), 1, f) != 1 || memcmp(header.magic, JOURNAL_MAGIC, 4) != 0 ||
+        header.version == 0 || header.version > JOURNAL_VERSION || header.byteOrder != JOURNAL_BYTE_ORDER ||
+        header.headerSize != sizeof(JournalHeader)) {
+        fprintf(stderr, "[Journal ERROR] '%s' não é um diário válido; a cena começa vazia.\n", s_fileName);
+        return;
+    }
+    s_epoch = header.epoch;
+
+    // 1. A base: os objetos entram na ordem de carga, a mesma dos identificadores
+    // e das transformações, que são compostas à identidade de cada objeto.
+    uint32_t numBase = header.numBaseObjects;
+    size_t arraySize = numBase > 0 ? numBase : 1;
+    uint32_t* ids = (uint32_t*)malloc(arraySize * sizeof(uint32_t));
+    Matrix3x3* transforms = (Matrix3x3*)malloc(arraySize * sizeof(Matrix3x3));
+    char* baseName = baseFileName(header.epoch);
+    SceneSnapshot base;
+    snapshotInit(&base);
+    int ok = ids && transforms && baseName &&
+             fread(ids, sizeof(uint32_t), numBase, f) == numBase &&
+             fread(transforms, sizeof(Matrix3x3), numBase, f) == numBase &&
+             readSceneFile(baseName, &base, NULL) && (uint32_t)snapshotObjectCount(&base) == numBase;
+    if (ok) {
+        snapshotInstall(&base);
+        ok = (uint32_t)g_numObjects == numBase;
+    }
+    if (ok) {
+        for (int i = 0; i < g_numObjects; i++) {
+            g_objects[i].journalId = ids[i];
+            objectApplyTransform(i, &transforms[i]);
+            if (!idMapPut(ids[i], getObjectHandle(i))) ok = 0;
+        }
+        s_nextId = header.nextId;
+    }
+    snapshotFree(&base);
+    free(ids);
+    free(transforms);
+    if (!ok) {
+        fprintf(stderr, "[Journal ERROR] A base '%s' do diário está ausente ou não confere; a cena começa vazia.\n",
+                baseName ? baseName : s_fileName);
+        free(baseName);
+        clearAllObjects();
+        return;
+    }
+    free(baseName);
+
+    // 2. As operações, na ordem em que aconteceram.
+    float* data = NULL;
+    size_t dataCapacity = 0;
+    long long numOps = 0;
+    int intact = 0;
+    for (;;) {
+        JournalRecord rec;
+        size_t got = fread(&rec, 1, sizeof(rec), f);
+        if (got == 0 && feof(f)) {
+            intact = 1;
+            break;
+        }
+        if (got != sizeof(rec) || !recordIsValid(&rec)) break;
+        if (rec.numFloats > dataCapacity) {
+            float* grown = (float*)realloc(data, rec.numFloats * sizeof(float));
+            if (!grown) break;
+            data = grown;
+            dataCapacity = rec.numFloats;
+        }
+        if (fread(data, sizeof(float), rec.numFloats, f) != rec.numFloats) break;
+        if (recordChecksum(&rec, data) != rec.checksum) break;
+        applyRecord(&rec, data);
+        numOps++;
+    }
+    free(data);
+    objectsFlushTransforms();
+
+    if (!intact) {
+        fprintf(stderr, "[Journal ERROR] O registro %lld do diário '%s' está incompleto ou corrompido; ele e os seguintes foram descartados.\n",
+                numOps + 1, s_fileName);
+    }
+    printf("[INFO] Cena recuperada do diario '%s': %u objetos da base e %lld operacoes refeitas.\n",
+           s_fileName, numBase, numOps);
+}
+
+// --- SEÇÃO DE FUNÇÕES PÚBLICAS ---
+
+void journalOpen(const char* filename) {
+    if (s_fileName) return;
+    size_t length = strlen(filename) + 1;
+    s_fileName = (char*)malloc(length);
+    if (!s_fileName) return;
+    memcpy(s_fileName, filename, length);
+
+    // Um próximo diário que sobrou é de uma compactação interrompida e nunca substituiu o atual.
+    char* nextName = journalFileName(".next");
+    if (nextName) remove(nextName);
+    free(nextName);
+
+    FILE* f = fopen(s_fileName, "rb");
+    if (f) {
+        recoverScene(f);
+        fclose(f);
+        free(s_idMap);
+        s_idMap = NULL;
+        s_idMapCapacity = 0;
+        s_idMapCount = 0;
+    }
+
+    // A cena recuperada vira a base de uma nova época (aqui mesmo, antes do primeiro quadro).
+    if (beginCompaction()) {
+        compactTask(NULL);
+        finishCompaction();
+    } else {
+        free(s_compactBaseName);
+        s_compactBaseName = NULL;
+        snapshotFree(&s_compactSnapshot);
+    }
+    if (!s_file) {
+        fprintf(stderr, "[Journal ERROR] Não foi possível iniciar o diário '%s'; as operações não serão registradas.\n", s_fileName);
+    }
+}
+
+void journalClose(void) {
+    if (s_compactTask) {
+        atomic_store(&s_compactStatus.cancel, 1);
+        jobsJoin(s_compactTask);
+        s_compactTask = NULL;
+        finishCompaction();
+    }
+    if (s_file) {
+        fclose(s_file);
+        s_file = NULL;
+    }
+    free(s_fileName);
+    s_fileName = NULL;
+}
+
+void journalPoll(void) {
+    if (s_compactTask && atomic_load(&s_compactFinished)) {
+        jobsJoin(s_compactTask);
+        s_compactTask = NULL;
+        finishCompaction();
+    }
+    if (!s_file) return;
+
+    // Uma queda do programa perde no máximo os registros do quadro atual.
+    if (fflush(s_file) != 0 || (s_nextFile && fflush(s_nextFile) != 0)) {
+        stopRecording();
+        return;
+    }
+    if (!s_compactTask && compactionDue()) {
+        startCompaction();
+    }
+}
+
+int journalBusy(void) {
+    return s_compactTask != NULL;
+}
+
+unsigned int journalAssignId(void) {
+    return s_nextId++;
+}
+
+void journalRecordAdd(int index) {
+    if (!s_file) return;
+    uint32_t numFloats;
+    const float* data = objectGeometry(index, &numFloats);
+    writeRecord((JournalOp)(JOURNAL_OP_ADD_POINT + g_objects[index].type), g_objects[index].journalId, data, numFloats);
+}
+
+void journalRecordRemove(int index) {
+    if (!s_file) return;
+    writeRecord(JOURNAL_OP_REMOVE, g_objects[index].journalId, NULL, 0);
+}
+
+void journalRecordTransform(int index, const Matrix3x3* matrix) {
+    if (!s_file) return;
+    // A matriz foi calculada sobre a posição atual; um objeto animado pode
+    // estar longe da posição que o diário conhece.
+    if (g_anim[index].active) recordPlacement(index);
+    writeRecord(JOURNAL_OP_TRANSFORM, g_objects[index].journalId, &matrix->m[0][0], 9);
+}
+
+void journalRecordGeometry(int index) {
+    if (!s_file) return;
+    uint32_t numFloats;
+    const float* data = objectGeometry(index, &numFloats);
+    writeRecord(JOURNAL_OP_GEOMETRY, g_objects[index].journalId, data, numFloats);
+}
+
+void journalRecordClear(void) {
+    if (!s_file) return;
+    writeRecord(JOURNAL_OP_CLEAR, 0, NULL, 0);
+}
+
+void journalRecordAnim(int index) {
+    if (!s_file) return;
+    // A animação parte (ou para) da posição atual do objeto.
+    recordPlacement(index);
+    const AnimSlot* a = &g_anim[index];
+    float data[6] = {(float)a->active, a->vx, a->vy, a->e, (float)a->gravity, a->vmax};
+    writeRecord(JOURNAL_OP_ANIM, g_objects[index].journalId, data, 6);
+}
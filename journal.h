@@ -0,0 +1,113 @@
+/**
+ * @file journal.h
+ * @brief Define a interface do diário de operações (salvamento automático incremental).
+ *
+ * Cada operação sobre os objetos (inserção, remoção, transformação, troca de
+ * geometria e limpeza da cena) é acrescentada ao fim de um arquivo de diário,
+ * a um custo proporcional ao tamanho da operação e não ao da cena. O diário
+ * parte de uma cena base (um arquivo SCENE_BINARY_EXTENSION ao lado dele);
+ * de tempos em tempos a cena atual vira a nova base e o diário recomeça
+ * vazio (compactação), em segundo plano. Ao abrir o programa, a base é
+ * carregada e as operações são refeitas, o que recupera o trabalho depois
+ * de uma queda.
+ *
+ * No diário, os objetos são identificados por 'Object.journalId', que não
+ * muda quando outros objetos são removidos nem de uma sessão para outra.
+ * O estado da animação é registrado quando o usuário o altera, mas o
+ * movimento causado por ela não é registrado a cada passo. A posição de um
+ * objeto animado (a sua transformação acumulada) entra no diário antes de
+ * cada operação que depende dela, como uma transformação ou uma mudança na
+ * animação, e assim essas operações são refeitas exatamente como na cena
+ * viva. Entre uma operação e outra, um objeto em movimento volta na posição
+ * do último desses registros ou da última compactação, que acontece com
+ * mais frequência enquanto houver animações ativas.
+ */
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "objects.h"
+
+// --- SEÇÃO DE PROTÓTIPOS DE FUNÇÕES PÚBLICAS ---
+
+/**
+ * @brief Recupera a cena do diário (se existir) e passa a registrar as operações.
+ *
+ * A cena atual é substituída pela cena recuperada. Em seguida a cena é
+ * compactada, então um diário danificado no fim (por uma queda no meio de
+ * uma escrita) é descartado a partir do último registro íntegro.
+ * @param filename O nome do arquivo de diário.
+ */
+void journalOpen(const char* filename);
+
+/**
+ * @brief Grava os registros pendentes e para de registrar.
+ *
+ * Uma compactação em andamento é cancelada; o diário continua válido para a
+ * próxima sessão.
+ */
+void journalClose(void);
+
+/**
+ * @brief Manutenção periódica do diário, chamada pela thread principal a cada quadro.
+ *
+ * Envia ao sistema operacional os registros acumulados desde a última
+ * chamada, inicia uma compactação quando o diário ficou grande (ou antiga,
+ * com objetos animados) e conclui a compactação que terminou.
+ */
+void journalPoll(void);
+
+/**
+ * @brief Retorna 1 se uma compactação está rodando em segundo plano.
+ */
+int journalBusy(void);
+
+/**
+ * @brief Reserva o identificador de diário de um objeto novo.
+ *
+ * Chamada pela lista de objetos ao registrar cada objeto, mesmo com o
+ * diário fechado, para que a recuperação atribua os mesmos identificadores.
+ */
+unsigned int journalAssignId(void);
+
+// --- SEÇÃO DE REGISTRO DE OPERAÇÕES ---
+// Chamadas pela lista de objetos (objects.c) e pela animação. Não fazem nada
+// com o diário fechado.
+
+/**
+ * @brief Registra um objeto recém-adicionado, com a sua geometria no mundo.
+ * @param index O índice do objeto em 'g_objects'.
+ */
+void journalRecordAdd(int index);
+
+/**
+ * @brief Registra a remoção de um objeto (antes de ele sair da lista).
+ * @param index O índice do objeto em 'g_objects'.
+ */
+void journalRecordRemove(int index);
+
+/**
+ * @brief Registra uma transformação composta à transformação acumulada de um objeto.
+ * @param index O índice do objeto em 'g_objects'.
+ * @param matrix A transformação aplicada.
+ */
+void journalRecordTransform(int index, const Matrix3x3* matrix);
+
+/**
+ * @brief Registra a substituição da geometria de um objeto pela sua geometria atual no mundo.
+ * @param index O índice do objeto em 'g_objects'.
+ */
+void journalRecordGeometry(int index);
+
+/**
+ * @brief Registra a remoção de todos os objetos.
+ */
+void journalRecordClear(void);
+
+/**
+ * @brief Registra o estado atual da animação de um objeto ('g_anim').
+ * @param index O índice do objeto em 'g_objects'.
+ */
+void journalRecordAnim(int index);
+
+#endif // JOURNAL_H
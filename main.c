@@ -6,10 +6,12 @@
  * grafico e registrar as funcoes de callback para gerenciar eventos do usuario.
  */
 
-// --- SEO DE CABEALHOS ---
+// --- SEÇÃO DE CABEÇALHOS ---
 #include <GL/glut.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
 
 #include "config.h"
 #include "render.h"
@@ -21,47 +23,246 @@
 #include "transformations.h"
 #include "animation.h"
 #include "file_io.h"
+#include "vertexpool.h"
+#include "collision.h"
+#include "jobs.h"
+#include "journal.h"
+#include "convexhull.h"
+#include "predicates.h"
+#include "rasterizer.h"
+#include "image_io.h"
+#include "batch.h"
+#include "profiler.h"
+#include "scenegen.h"
+#include "benchmark.h"
 
 
-// --- SEO DE VARIVEIS GLOBAIS DA JANELA ---
+// --- SEÇÃO DE VARIÁVEIS GLOBAIS DA JANELA ---
 int g_windowWidth = WINDOW_WIDTH;
 int g_windowHeight = WINDOW_HEIGHT;
 
-// --- SEO DE FUNES AUXILIARES ---
+// --- SEÇÃO DE VARIÁVEIS PRIVADAS ---
+static int s_timerRunning = 0;  ///< 1 enquanto o temporizador da animacao estiver agendado.
+static int s_lastTick = 0;      ///< Instante (ms) do ultimo passo de animacao.
+static int s_ioTimerRunning = 0; ///< 1 enquanto o temporizador do salvamento/carregamento estiver agendado.
+static int s_journalTimerRunning = 0; ///< 1 enquanto o temporizador da compactacao do diario estiver agendado.
+static const char* s_traceFileName = NULL; ///< O trace gravado ao sair, com --trace (NULL sem a opcao).
+
+// --- SEÇÃO DE FUNÇÕES AUXILIARES ---
 
 /**
- * @brief Callback para quando a janela  redimensionada.
- * * Responsvel por atualizar o viewport e a projeo ortogrfica do OpenGL
- * para corresponderem s novas dimenses da janela.
+ * @brief Callback para quando a janela é redimensionada.
+ * * Responsável por atualizar o viewport e a projeção ortográfica do OpenGL
+ * para corresponderem às novas dimensões da janela.
  * @param w A nova largura da janela.
  * @param h A nova altura da janela.
  */
 void reshapeCallback(int w, int h) {
-    // Atualiza as variveis globais com as novas dimenses.
+    // Atualiza as variáveis globais com as novas dimensões.
     g_windowWidth = w;
-    g_windowHeight = h > 0 ? h : 1; // Evita diviso por zero se a altura for 0.
+    g_windowHeight = h > 0 ? h : 1; // Evita divisão por zero se a altura for 0.
 
-    // Define a rea de desenho do OpenGL para ocupar a janela inteira.
+    // Define a área de desenho do OpenGL para ocupar a janela inteira.
     glViewport(0, 0, g_windowWidth, g_windowHeight);
 
-    // Atualiza o sistema de coordenadas (projeo) para corresponder ao novo tamanho.
+    // Atualiza o sistema de coordenadas (projeção) para corresponder ao novo tamanho.
     glMatrixMode(GL_PROJECTION);
     glLoadIdentity();
     gluOrtho2D(0, g_windowWidth, 0, g_windowHeight);
 
-    // Volta para a matriz de modelo-vista para as operaes de desenho.
+    // O renderizador descarta o que fica fora desta regiao.
+    RenderView view = {0.0f, 0.0f, (float)g_windowWidth, (float)g_windowHeight, 1.0f};
+    renderSetView(&view);
+
+    // Volta para a matriz de modelo-vista para as operações de desenho.
     glMatrixMode(GL_MODELVIEW);
 }
 
+/**
+ * @brief Callback do temporizador para controlar a animacao.
+ *
+ * Chamado em intervalos fixos enquanto houver objetos animados. O redesenho
+ * nao e pedido aqui: os objetos movidos marcam a cena como modificada. Sem
+ * animacoes ativas o temporizador nao e reagendado e o programa fica ocioso
+ * ate o proximo evento.
+ */
+static void timerCallback(int value) {
+    if (anim_active_count() == 0) {
+        s_timerRunning = 0;
+        return;
+    }
+    int now = glutGet(GLUT_ELAPSED_TIME);
+    if (s_lastTick == 0) s_lastTick = now;
+    float dt = (now - s_lastTick) / 1000.0f;
+    s_lastTick = now;
+
+    // O tempo real é convertido em passos fixos; travamentos longos são limitados.
+    anim_advance(dt);
+    glutTimerFunc(16, timerCallback, 0);
+}
+
+/**
+ * @brief Reinicia o temporizador da animacao se ele estiver parado e houver objetos animados.
+ */
+static void scheduleAnimationTimer(void) {
+    if (!s_timerRunning && anim_active_count() > 0) {
+        s_timerRunning = 1;
+        s_lastTick = 0; // O tempo parado nao conta como passo de animacao.
+        glutTimerFunc(16, timerCallback, 0);
+    }
+}
+
+/**
+ * @brief Callback do temporizador que acompanha o salvamento/carregamento em segundo plano.
+ *
+ * Entre dois quadros, conclui a operacao que terminou (trocando a cena, no
+ * caso de um carregamento) e pede um quadro para atualizar a barra de
+ * andamento. Deixa de ser reagendado quando nao ha operacao em andamento.
+ */
+static void sceneIoTimerCallback(int value) {
+    sceneIoPoll();
+    glutPostRedisplay();
+    if (sceneIoBusy()) {
+        glutTimerFunc(50, sceneIoTimerCallback, 0);
+    } else {
+        s_ioTimerRunning = 0;
+    }
+}
+
+/**
+ * @brief Inicia o temporizador do salvamento/carregamento se houver uma operacao em andamento.
+ */
+static void scheduleSceneIoTimer(void) {
+    if (!s_ioTimerRunning && sceneIoBusy()) {
+        s_ioTimerRunning = 1;
+        glutTimerFunc(50, sceneIoTimerCallback, 0);
+    }
+}
+
+/**
+ * @brief Callback do temporizador que conclui a compactacao do diario em segundo plano.
+ *
+ * Sem ele, uma compactacao que termina com a janela ociosa so seria
+ * concluida no proximo quadro.
+ */
+static void journalTimerCallback(int value) {
+    journalPoll();
+    if (journalBusy()) {
+        glutTimerFunc(100, journalTimerCallback, 0);
+    } else {
+        s_journalTimerRunning = 0;
+    }
+}
+
+/**
+ * @brief Inicia o temporizador do diario se houver uma compactacao em andamento.
+ */
+static void scheduleJournalTimer(void) {
+    if (!s_journalTimerRunning && journalBusy()) {
+        s_journalTimerRunning = 1;
+        glutTimerFunc(100, journalTimerCallback, 0);
+    }
+}
+
+/**
+ * @brief Desenha uma barra de andamento no rodape da janela durante um salvamento/carregamento.
+ */
+static void drawSceneIoProgress(void) {
+    if (!sceneIoBusy()) return;
+    float width = g_windowWidth * sceneIoProgress();
+    glColor3f(0.8f, 0.8f, 0.8f);
+    glRectf(0.0f, 0.0f, (float)g_windowWidth, 6.0f);
+    glColor3f(0.2f, 0.5f, 0.9f);
+    glRectf(0.0f, 0.0f, width, 6.0f);
+}
+
+/**
+ * @brief Escreve uma linha de texto na janela, com a base da linha em (x, y).
+ */
+static void drawText(float x, float y, const char* text) {
+    glRasterPos2f(x, y);
+    for (const char* c = text; *c; c++) {
+        glutBitmapCharacter(GLUT_BITMAP_8_BY_13, *c);
+    }
+}
+
+/**
+ * @brief Desenha o painel do medidor de tempo (F3) no canto superior esquerdo da janela.
+ *
+ * Mostra a duracao do ultimo quadro e os seus percentis, o tamanho da cena,
+ * o que o ultimo desenho emitiu e o tempo medio por quadro de cada trecho medido.
+ */
+static void drawProfilerHud(void) {
+    if (!atomic_load(&g_profilerEnabled)) return;
+    ProfileStats stats;
+    profilerGetStats(&stats);
+    long long numVertices = g_numPoints + 2LL * g_numSegments;
+    for (int k = 0; k < g_numPolygons; k++) {
+        numVertices += g_polygons[k].numVertices;
+    }
+
+    RenderStats drawn;
+    renderGetStats(&drawn);
+
+    const float lineHeight = 15.0f;
+    int numLines = 4 + (PROFILE_NUM_ZONES - 1);
+    float top = (float)g_windowHeight - 8.0f;
+    float bottom = top - numLines * lineHeight - 8.0f;
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glColor4f(0.0f, 0.0f, 0.0f, 0.65f);
+    glRectf(8.0f, bottom, 330.0f, top);
+    glDisable(GL_BLEND);
+
+    char line[96];
+    float y = top - lineHeight;
+    glColor3f(1.0f, 1.0f, 1.0f);
+    snprintf(line, sizeof(line), "Quadro %.2f ms (%d quadros)", stats.frameMs, stats.numFrames);
+    drawText(14.0f, y, line);
+    y -= lineHeight;
+    snprintf(line, sizeof(line), "p50 %.2f ms  p99 %.2f ms", stats.frameP50Ms, stats.frameP99Ms);
+    drawText(14.0f, y, line);
+    y -= lineHeight;
+    snprintf(line, sizeof(line), "%d objetos, %lld vertices", g_numObjects, numVertices);
+    drawText(14.0f, y, line);
+    y -= lineHeight;
+    snprintf(line, sizeof(line), "%d visiveis (%d simplif., %d pontos)",
+             drawn.drawnObjects, drawn.simplifiedPolygons, drawn.collapsedPolygons);
+    drawText(14.0f, y, line);
+    glColor3f(0.7f, 0.9f, 1.0f);
+    for (int z = PROFILE_FRAME + 1; z < PROFILE_NUM_ZONES; z++) {
+        y -= lineHeight;
+        snprintf(line, sizeof(line), "%-12s %8.3f ms/quadro", profileZoneName((ProfileZone)z), stats.zoneMs[z]);
+        drawText(14.0f, y, line);
+    }
+}
+
 /**
  * @brief Funcao de callback para redesenhar a tela.
  *
- * Limpa o buffer de cor e chama a funcao de renderizacao da cena.
+ * Limpa o buffer de cor e chama a funcao de renderizacao da cena. Com o
+ * medidor de tempo ligado, a duracao do quadro nao inclui a espera da
+ * troca de buffers.
  */
 void displayCallback() {
+    double frameStart = profileBegin();
     glClear(GL_COLOR_BUFFER_BIT);
     renderAllObjects();
+    drawSceneIoProgress();
+    drawProfilerHud();
+    profilerFrameEnd(frameStart);
     glutSwapBuffers();
+
+    // Qualquer evento que ligue uma animacao (ou inicie um salvamento ou
+    // carregamento) tambem pede um quadro, entao este e o ponto em que os
+    // temporizadores parados voltam a rodar.
+    scheduleAnimationTimer();
+    scheduleSceneIoTimer();
+
+    // Toda edicao pede um quadro, entao os registros do diario sao gravados
+    // aqui, uma vez por quadro.
+    journalPoll();
+    scheduleJournalTimer();
 }
 
 
@@ -78,20 +279,623 @@ void initOpenGL() {
 }
 
 /**
- * @brief Callback do temporizador para controlar a animacao e redesenhar a tela.
+ * @brief Acumula bytes em uma soma de verificacao FNV-1a de 64 bits.
+ */
+static unsigned long long hashBytes(unsigned long long hash, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Calcula a soma de verificacao FNV-1a dos bytes da geometria e das velocidades da cena.
+ */
+static unsigned long long sceneChecksum(void) {
+    unsigned long long hash = 1469598103934665603ULL;
+    hash = hashBytes(hash, g_points, g_numPoints * sizeof(Point));
+    hash = hashBytes(hash, g_segments, g_numSegments * sizeof(Segment));
+    for (int k = 0; k < g_numPolygons; k++) {
+        hash = hashBytes(hash, g_polygons[k].vertices, g_polygons[k].numVertices * sizeof(Point));
+    }
+    for (int i = 0; i < g_numObjects; i++) {
+        hash = hashBytes(hash, &g_anim[i].vx, sizeof(float));
+        hash = hashBytes(hash, &g_anim[i].vy, sizeof(float));
+    }
+    return hash;
+}
+
+/**
+ * @brief Carrega uma cena e avanca 'steps' passos fixos de animacao.
+ * @return double O tempo de parede gasto nos passos, em segundos (negativo se a cena nao pode ser lida).
+ */
+static double simulateScene(const char* sceneFile, int steps) {
+    anim_init_all();
+    loadSceneFromFile(sceneFile);
+    if (g_numObjects == 0) {
+        fprintf(stderr, "[Replay ERROR] A cena '%s' esta vazia ou nao pode ser lida.\n", sceneFile);
+        return -1.0;
+    }
+
+    double start = jobsWallTime();
+    for (int i = 0; i < steps; i++) {
+        anim_step(ANIM_FIXED_STEP);
+    }
+    return jobsWallTime() - start;
+}
+
+/**
+ * @brief Executa a simulacao de uma cena sem janela, para testes de regressao.
  *
- * Chamado repetidamente em intervalos fixos para criar um loop de animacao.
+ * Carrega a cena, avanca 'steps' passos fixos de animacao (com a area da
+ * janela padrao como limite) e imprime uma soma de verificacao dos bytes da
+ * geometria e do estado da animacao. Duas execucoes com a mesma cena devem
+ * imprimir exatamente a mesma soma.
+ * @param sceneFile A cena a ser simulada.
+ * @param steps O numero de passos de ANIM_FIXED_STEP segundos.
+ * @param outFile Arquivo onde a cena final e salva (NULL para nao salvar).
+ * @return int O codigo de saida do programa.
  */
-static void timerCallback(int value) {
-    static int last = 0;
-    int now = glutGet(GLUT_ELAPSED_TIME);
-    if (last == 0) last = now;
-    float dt = (now - last) / 1000.0f;
-    last = now;
+static int runReplay(const char* sceneFile, int steps, const char* outFile) {
+    initObjectList();
+    double seconds = simulateScene(sceneFile, steps);
+    if (seconds < 0.0) return 1;
 
-    anim_step(dt);
-    glutPostRedisplay();
-    glutTimerFunc(16, timerCallback, 0);
+    printf("[REPLAY] %d objetos, %d passos, checksum %016llx\n", g_numObjects, steps, sceneChecksum());
+    printf("[REPLAY] Tempo de simulacao: %.1f ms (%.3f ms por passo, %d threads)\n",
+           seconds * 1000.0, steps > 0 ? seconds * 1000.0 / steps : 0.0, jobsThreadCount());
+    if (outFile) {
+        saveSceneToFile(outFile);
+    }
+    return 0;
+}
+
+/**
+ * @brief Mede o passo da animacao com 1, 2, 4, ... threads ate 'maxThreads'.
+ *
+ * Cada rodada recarrega a cena do zero. Todas devem terminar com a mesma
+ * soma de verificacao da rodada com uma thread; se alguma divergir, o
+ * programa termina com erro. Uma cena sem objetos animados e recusada.
+ * @return int O codigo de saida do programa.
+ */
+static int runThreadBenchmark(const char* sceneFile, int steps, int maxThreads) {
+    if (maxThreads <= 0) maxThreads = jobsHardwareThreads();
+    if (maxThreads > JOBS_MAX_THREADS) maxThreads = JOBS_MAX_THREADS;
+    initObjectList();
+
+    // Sem objetos animados o passo nao faz nada, e os speedups seriam ruido.
+    anim_init_all();
+    loadSceneFromFile(sceneFile);
+    if (g_numObjects == 0) {
+        fprintf(stderr, "[Bench ERROR] A cena '%s' esta vazia ou nao pode ser lida.\n", sceneFile);
+        return 1;
+    }
+    if (anim_active_count() == 0) {
+        fprintf(stderr, "[Bench ERROR] A cena '%s' nao tem objetos animados; nada a medir.\n"
+                        "              Gere uma com: --generate <cena> <objetos> --animated 0.1\n", sceneFile);
+        return 1;
+    }
+
+    double baseline = 0.0;
+    unsigned long long expected = 0;
+    int diverged = 0;
+    int threads = 1;
+    for (;;) {
+        jobsInit(threads);
+        double seconds = simulateScene(sceneFile, steps);
+        if (seconds < 0.0) return 1;
+
+        unsigned long long hash = sceneChecksum();
+        if (threads == 1) {
+            baseline = seconds;
+            expected = hash;
+        }
+        printf("[BENCH] %2d threads: %8.3f ms por passo, speedup %.2fx, checksum %016llx%s\n",
+               jobsThreadCount(), steps > 0 ? seconds * 1000.0 / steps : 0.0,
+               seconds > 0.0 ? baseline / seconds : 0.0, hash, hash == expected ? "" : " DIVERGENTE");
+        if (hash != expected) diverged = 1;
+
+        if (threads == maxThreads) break;
+        threads = threads * 2 < maxThreads ? threads * 2 : maxThreads;
+    }
+    return diverged;
+}
+
+/**
+ * @brief Mede quantos vertices por segundo cada caminho de transformacao processa.
+ *
+ * Compara o caminho antigo (tres matrizes, duas multiplicacoes e um
+ * multiplyMatrixByPoint() por vertice) com transformPoints() em cada kernel
+ * disponivel. Os kernels precisam terminar com exatamente os mesmos bytes.
+ * @param numVertices O tamanho da lista de vertices.
+ * @param repetitions Quantas vezes a lista inteira e transformada.
+ * @return int O codigo de saida do programa.
+ */
+static int runTransformBenchmark(int numVertices, int repetitions) {
+    if (numVertices <= 0 || repetitions <= 0) {
+        fprintf(stderr, "[Bench ERROR] Use um numero positivo de vertices e de repeticoes.\n");
+        return 1;
+    }
+    size_t bytes = (size_t)numVertices * sizeof(Point);
+    Point* base = (Point*)malloc(bytes);
+    Point* work = (Point*)malloc(bytes);
+    Point* reference = (Point*)malloc(bytes);
+    if (!base || !work || !reference) {
+        fprintf(stderr, "[Bench ERROR] Memoria insuficiente para %d vertices.\n", numVertices);
+        free(base); free(work); free(reference);
+        return 1;
+    }
+    for (int i = 0; i < numVertices; i++) {
+        base[i].x = (float)(i % 800);
+        base[i].y = (float)((i / 800) % 600);
+    }
+    Point center = {400.0f, 300.0f};
+    double total = (double)numVertices * repetitions;
+
+    // Caminho antigo: composicao completa e um vertice por chamada.
+    memcpy(work, base, bytes);
+    double start = jobsWallTime();
+    for (int r = 0; r < repetitions; r++) {
+        Matrix3x3 toOrigin = createTranslationMatrix(-center.x, -center.y);
+        Matrix3x3 rotation = createRotationMatrix((r & 1) ? -1.0f : 1.0f);
+        Matrix3x3 fromOrigin = createTranslationMatrix(center.x, center.y);
+        Matrix3x3 composite = multiplyMatrices(fromOrigin, multiplyMatrices(rotation, toOrigin));
+        for (int i = 0; i < numVertices; i++) {
+            work[i] = multiplyMatrixByPoint(composite, work[i]);
+        }
+    }
+    double seconds = jobsWallTime() - start;
+    printf("[BENCH] %-22s %8.1f Mvertices/s\n", "matriz por vertice", total / seconds / 1e6);
+
+    int mismatch = 0;
+    for (int k = 0; k < TRANSFORM_KERNEL_COUNT; k++) {
+        memcpy(work, base, bytes);
+        start = jobsWallTime();
+        int supported = 1;
+        for (int r = 0; r < repetitions && supported; r++) {
+            Matrix3x3 composite = composeAboutPoint(createRotationMatrix((r & 1) ? -1.0f : 1.0f), center);
+            supported = transformPointsWithKernel((TransformKernel)k, work, numVertices, &composite);
+        }
+        seconds = jobsWallTime() - start;
+        if (!supported) {
+            printf("[BENCH] kernel %-15s indisponivel neste processador\n", transformKernelName((TransformKernel)k));
+            continue;
+        }
+        if (k == TRANSFORM_KERNEL_SCALAR) {
+            memcpy(reference, work, bytes);
+        }
+        int same = memcmp(reference, work, bytes) == 0;
+        if (!same) mismatch = 1;
+        printf("[BENCH] kernel %-15s %8.1f Mvertices/s%s\n", transformKernelName((TransformKernel)k),
+               total / seconds / 1e6, same ? "" : " DIVERGENTE");
+    }
+    printf("[BENCH] Kernel em uso: %s\n", transformKernelName(transformBestKernel()));
+
+    free(base);
+    free(work);
+    free(reference);
+    return mismatch;
+}
+
+/**
+ * @brief Gera 'count' pontos em um disco (uniforme na area) ou sobre a circunferencia.
+ *
+ * Usa um gerador xorshift com semente fixa, entao toda execucao gera os mesmos pontos.
+ */
+static void generateHullPoints(Point* points, int count, int onCircle) {
+    unsigned int state = 2463534242u;
+    for (int i = 0; i < count; i++) {
+        state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+        float angle = 6.2831853f * (state >> 8) / 16777216.0f;
+        float radius = 1000.0f;
+        if (!onCircle) {
+            state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+            radius *= sqrtf((state >> 8) / 16777216.0f);
+        }
+        points[i].x = 400.0f + radius * cosf(angle);
+        points[i].y = 300.0f + radius * sinf(angle);
+    }
+}
+
+/**
+ * @brief Mede cada algoritmo de fecho convexo em nuvens de 1000 a 'maxPoints' pontos.
+ *
+ * As nuvens sao um disco uniforme (poucos vertices no fecho) e pontos sobre
+ * uma circunferencia (quase todos no fecho, o pior caso de algoritmos
+ * O(n*h) como a Marcha de Jarvis). Todos os algoritmos precisam devolver
+ * exatamente o mesmo fecho.
+ * @return int O codigo de saida do programa.
+ */
+static int runHullBenchmark(int maxPoints) {
+    if (maxPoints < 1000) {
+        fprintf(stderr, "[Bench ERROR] Use pelo menos 1000 pontos.\n");
+        return 1;
+    }
+    Point* points = (Point*)malloc((size_t)maxPoints * sizeof(Point));
+    Point* hull = (Point*)malloc((size_t)maxPoints * sizeof(Point));
+    Point* reference = (Point*)malloc((size_t)maxPoints * sizeof(Point));
+    if (!points || !hull || !reference) {
+        fprintf(stderr, "[Bench ERROR] Memoria insuficiente para %d pontos.\n", maxPoints);
+        free(points); free(hull); free(reference);
+        return 1;
+    }
+
+    int mismatch = 0;
+    for (int onCircle = 0; onCircle < 2; onCircle++) {
+        for (long long n = 1000; n <= maxPoints; n *= 10) {
+            int count = (int)n;
+            generateHullPoints(points, count, onCircle);
+            int numReference = -1;
+            // O automatico fica por ultimo, comparado com a cadeia monotona.
+            for (int step = 1; step <= HULL_ENGINE_COUNT; step++) {
+                int e = step % HULL_ENGINE_COUNT;
+                double start = jobsWallTime();
+                int numHull = convexHullPointsWithEngine((HullEngine)e, points, count, hull);
+                double seconds = jobsWallTime() - start;
+                if (e == HULL_ENGINE_MONOTONE_CHAIN) {
+                    numReference = numHull;
+                    if (numHull > 0) memcpy(reference, hull, numHull * sizeof(Point));
+                }
+                int same = numHull == numReference &&
+                           (numHull <= 0 || memcmp(reference, hull, numHull * sizeof(Point)) == 0);
+                if (!same) mismatch = 1;
+                printf("[BENCH] %-14s %9d pontos, %-16s %9.2f ms, %8.1f Mpontos/s, %7d vertices%s\n",
+                       onCircle ? "circunferencia" : "disco", count, hullEngineName((HullEngine)e),
+                       seconds * 1000.0, count / seconds / 1e6, numHull, same ? "" : " DIVERGENTE");
+            }
+        }
+    }
+    printf("[BENCH] Automatico: cadeia monotona abaixo de %d pontos, quickhull a partir dai.\n",
+           CONVEX_HULL_QUICKHULL_MIN_POINTS);
+
+    free(points);
+    free(hull);
+    free(reference);
+    return mismatch;
+}
+
+/**
+ * @brief Sinal da orientacao calculada direto em float, como o codigo fazia antes dos predicados exatos.
+ */
+static int naiveOrientation(Point a, Point b, Point c) {
+    float value = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    return (value > 0.0f) - (value < 0.0f);
+}
+
+/**
+ * @brief Mede o custo dos predicados exatos contra o calculo direto em float.
+ *
+ * Sao tres conjuntos de 'count' trios de pontos: aleatorios (o caso comum,
+ * resolvido pelo filtro), colineares em uma grade inteira (cuja orientacao
+ * exata e conhecida) e quase colineares sobre uma reta inclinada (onde o
+ * float erra o sinal e o caminho exato e acionado). Tambem mede o
+ * ponto-em-poligono em um poligono de 64 vertices.
+ * @return int O codigo de saida do programa (1 se um predicado errar a grade).
+ */
+static int runPredicateBenchmark(int count) {
+    if (count <= 0) {
+        fprintf(stderr, "[Bench ERROR] Use um numero positivo de testes.\n");
+        return 1;
+    }
+    Point* points = (Point*)malloc((size_t)count * 3 * sizeof(Point));
+    if (!points) {
+        fprintf(stderr, "[Bench ERROR] Memoria insuficiente para %d testes.\n", count);
+        return 1;
+    }
+    static const char* names[3] = {"aleatorios", "grade colinear", "quase colineares"};
+
+    int mismatch = 0;
+    for (int set = 0; set < 3; set++) {
+        unsigned int state = 2463534242u;
+        for (int i = 0; i < count * 3; i++) {
+            state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+            float t = (state >> 8) / 16777216.0f;
+            if (set == 0) {
+                points[i].x = 1000.0f * t;
+                state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+                points[i].y = 1000.0f * (state >> 8) / 16777216.0f;
+            } else if (set == 1) {
+                // Pontos inteiros sobre retas de inclinacao 3/7 (sem arredondamento).
+                int k = (int)(t * 100.0f);
+                points[i].x = (float)(7 * k + (i / 3) % 50);
+                points[i].y = (float)(3 * k);
+            } else {
+                // Pontos sobre uma reta inclinada, arredondados para float.
+                points[i].x = 100.0f + 800.0f * t;
+                points[i].y = 0.1f + 0.7f * points[i].x;
+            }
+        }
+
+        long long naiveSum = 0, exactSum = 0;
+        int disagreements = 0;
+        double start = jobsWallTime();
+        for (int i = 0; i < count; i++) {
+            naiveSum += naiveOrientation(points[3 * i], points[3 * i + 1], points[3 * i + 2]);
+        }
+        double naiveSeconds = jobsWallTime() - start;
+
+        unsigned long long exactBefore = predicatesExactCount();
+        start = jobsWallTime();
+        for (int i = 0; i < count; i++) {
+            exactSum += orient2d(points[3 * i], points[3 * i + 1], points[3 * i + 2]);
+        }
+        double exactSeconds = jobsWallTime() - start;
+        unsigned long long exactCalls = predicatesExactCount() - exactBefore;
+
+        // Conferencia (fora da medicao): quantos sinais o float errou e, na
+        // grade, se o predicado acertou todos.
+        for (int i = 0; i < count; i++) {
+            Point a = points[3 * i], b = points[3 * i + 1], c = points[3 * i + 2];
+            int exact = orient2d(a, b, c);
+            if (naiveOrientation(a, b, c) != exact) disagreements++;
+            if (set == 1) {
+                long long value = (long long)(b.x - a.x) * (long long)(c.y - a.y) -
+                                  (long long)(b.y - a.y) * (long long)(c.x - a.x);
+                if (exact != (value > 0) - (value < 0)) mismatch = 1;
+            }
+        }
+        printf("[BENCH] orientacao %-17s float %6.2f ns, exato %6.2f ns (%+6.1f%%), "
+               "caminho exato em %5.1f%%, float errou %d sinais (%lld/%lld)\n",
+               names[set], naiveSeconds * 1e9 / count, exactSeconds * 1e9 / count,
+               (exactSeconds / naiveSeconds - 1.0) * 100.0, 100.0 * exactCalls / count,
+               disagreements, naiveSum, exactSum);
+    }
+
+    Point polygon[64];
+    for (int i = 0; i < 64; i++) {
+        float angle = 6.2831853f * i / 64.0f;
+        float radius = (i & 1) ? 250.0f : 400.0f;
+        polygon[i].x = 500.0f + radius * cosf(angle);
+        polygon[i].y = 500.0f + radius * sinf(angle);
+    }
+    int locations[3] = {0, 0, 0};
+    double start = jobsWallTime();
+    for (int i = 0; i < count; i++) {
+        locations[pointInPolygon(points[i], polygon, 64)]++;
+    }
+    double seconds = jobsWallTime() - start;
+    printf("[BENCH] ponto-em-poligono (64 vertices) %8.1f ns por teste: %d dentro, %d fora, %d na borda\n",
+           seconds * 1e9 / count, locations[POINT_INSIDE], locations[POINT_OUTSIDE],
+           locations[POINT_ON_BOUNDARY]);
+
+    free(points);
+    return mismatch;
+}
+
+/**
+ * @brief Converte uma cena entre os formatos de texto e binario.
+ *
+ * O formato de cada arquivo e escolhido pela extensao, como em F5/F9.
+ * @return int O codigo de saida do programa.
+ */
+static int runConvert(const char* inFile, const char* outFile) {
+    initObjectList();
+    anim_init_all();
+    loadSceneFromFile(inFile);
+    if (g_numObjects == 0) {
+        fprintf(stderr, "[Convert ERROR] A cena '%s' esta vazia ou nao pode ser lida.\n", inFile);
+        return 1;
+    }
+    saveSceneToFile(outFile);
+    printf("[CONVERT] %d objetos: '%s' -> '%s'\n", g_numObjects, inFile, outFile);
+    return 0;
+}
+
+#define BENCH_POLYGON_SIDES 64   ///< Vertices de cada poligono da cena gerada por runSceneIoBenchmark().
+
+/**
+ * @brief Mede o tempo de salvar e carregar a mesma cena nos dois formatos.
+ *
+ * Gera poligonos de BENCH_POLYGON_SIDES vertices ate somar 'numVertices',
+ * salva a cena em texto e em binario, recarrega cada arquivo e confere a
+ * soma de verificacao da geometria recarregada com a original.
+ * @return int O codigo de saida do programa.
+ */
+static int runSceneIoBenchmark(int numVertices) {
+    static const char* files[2] = {"rabisquim_bench.txt", "rabisquim_bench" SCENE_BINARY_EXTENSION};
+    if (numVertices < BENCH_POLYGON_SIDES) {
+        fprintf(stderr, "[Bench ERROR] Use pelo menos %d vertices.\n", BENCH_POLYGON_SIDES);
+        return 1;
+    }
+    initObjectList();
+    anim_init_all();
+
+    int numPolygons = numVertices / BENCH_POLYGON_SIDES;
+    reserveObjects(numPolygons);
+    Point ring[BENCH_POLYGON_SIDES];
+    for (int k = 0; k < numPolygons; k++) {
+        // Centros e raios fracionarios, como os de uma cena transformada.
+        float cx = (float)(k % 97) * 8.123f + 3.3f;
+        float cy = (float)((k / 97) % 71) * 8.456f + 2.7f;
+        for (int v = 0; v < BENCH_POLYGON_SIDES; v++) {
+            float angle = 6.2831853f * v / BENCH_POLYGON_SIDES;
+            ring[v].x = cx + 3.71f * cosf(angle);
+            ring[v].y = cy + 3.71f * sinf(angle);
+        }
+        GfxPolygon poly = createPolygonFromVertices(ring, BENCH_POLYGON_SIDES);
+        addPolygonObject(&poly);
+    }
+    unsigned long long expected = sceneChecksum();
+    printf("[BENCH] %d poligonos, %d vertices\n", numPolygons, numPolygons * BENCH_POLYGON_SIDES);
+
+    double saveSeconds[2];
+    for (int f = 0; f < 2; f++) {
+        double start = jobsWallTime();
+        saveSceneToFile(files[f]);
+        saveSeconds[f] = jobsWallTime() - start;
+    }
+    for (int f = 0; f < 2; f++) {
+        double start = jobsWallTime();
+        loadSceneFromFile(files[f]);
+        double loadSeconds = jobsWallTime() - start;
+        int same = g_numObjects == numPolygons && sceneChecksum() == expected;
+        printf("[BENCH] %-24s salvar %8.1f ms, carregar %8.1f ms, geometria %s\n", files[f],
+               saveSeconds[f] * 1000.0, loadSeconds * 1000.0, same ? "identica" : "com perda de precisao");
+        remove(files[f]);
+    }
+    return 0;
+}
+
+/**
+ * @brief Desenha uma cena sem janela, com o rasterizador em software, e grava a imagem.
+ *
+ * A regiao desenhada e a caixa de todos os objetos (rasterFitView()). O
+ * formato da imagem e escolhido pela extensao: ".ppm" grava PPM e as demais, PNG.
+ * @param fillPolygons 1 para preencher o interior dos poligonos.
+ * @return int O codigo de saida do programa.
+ */
+static int runExport(const char* sceneFile, const char* imageFile, int width, int height, int fillPolygons) {
+    initObjectList();
+    anim_init_all();
+    loadSceneFromFile(sceneFile);
+    if (g_numObjects == 0) {
+        fprintf(stderr, "[Export ERROR] A cena '%s' esta vazia ou nao pode ser lida.\n", sceneFile);
+        return 1;
+    }
+    RasterImage image;
+    if (!rasterImageInit(&image, width, height)) return 1;
+
+    RasterView view = rasterFitView(width, height);
+    view.fillPolygons = fillPolygons;
+    double start = jobsWallTime();
+    int ok = rasterRenderScene(&image, &view);
+    double renderSeconds = jobsWallTime() - start;
+    start = jobsWallTime();
+    ok = ok && imageWriteFile(imageFile, image.pixels, image.width, image.height);
+    double writeSeconds = jobsWallTime() - start;
+    rasterImageFree(&image);
+    if (!ok) return 1;
+
+    printf("[EXPORT] %d objetos: '%s' -> '%s' (%dx%d)\n", g_numObjects, sceneFile, imageFile, width, height);
+    printf("[EXPORT] Desenho %.1f ms, gravacao %.1f ms (%d threads)\n",
+           renderSeconds * 1000.0, writeSeconds * 1000.0, jobsThreadCount());
+    return 0;
+}
+
+/**
+ * @brief Aplica um roteiro de operacoes a cenas e pastas de cenas, sem janela.
+ *
+ * O formato do roteiro esta descrito em batch.h.
+ * @param maxWorkers O maximo de processos trabalhadores (0 para um por processador).
+ * @return int O codigo de saida do programa.
+ */
+static int runBatch(const char* scriptFile, char** inputs, int numInputs, int maxWorkers) {
+    initObjectList();
+    anim_init_all();
+    return batchRun(scriptFile, inputs, numInputs, maxWorkers) ? 0 : 1;
+}
+
+/**
+ * @brief Roda a suite de benchmarks em cenas geradas e escreve o CSV na saida padrao.
+ *
+ * As colunas estao descritas em benchmark.h.
+ * @return int O codigo de saida do programa.
+ */
+static int runBenchSuite(int* scales, int numScales) {
+    static int defaultScales[3] = {1000, 10000, 100000};
+    if (numScales == 0) {
+        scales = defaultScales;
+        numScales = 3;
+    }
+    initObjectList();
+    anim_init_all();
+    return benchmarkRunSuite(scales, numScales, stdout) ? 0 : 1;
+}
+
+/**
+ * @brief Gera uma cena sintetica com os parametros de scenegen.h e a grava.
+ *
+ * O formato do arquivo e escolhido pela extensao, como em F5/F9. As opcoes
+ * trocam os parametros padrao de sceneGenDefaults():
+ *   <semente>                       A semente (0 para a semente padrao).
+ *   --animated <fracao>             A fracao (0 a 1) de objetos com a animacao ligada.
+ *   --concave <fracao>              A fracao (0 a 1) de poligonos concavos.
+ *   --vertices <min> <max>          A faixa de vertices por poligono.
+ *   --distribution uniform|power    Como os vertices de cada poligono sao sorteados.
+ * @return int O codigo de saida do programa.
+ */
+static int runGenerate(const char* sceneFile, int numObjects, char** options, int numOptions) {
+    if (numObjects < 1) {
+        fprintf(stderr, "[Generate ERROR] Use pelo menos 1 objeto.\n");
+        return 1;
+    }
+    SceneGenParams params;
+    sceneGenDefaults(&params, numObjects);
+
+    int k = 0;
+    if (k < numOptions && strncmp(options[k], "--", 2) != 0) {
+        unsigned long long seed = strtoull(options[k++], NULL, 10);
+        if (seed != 0) params.seed = seed;
+    }
+    for (; k < numOptions; k++) {
+        int remaining = numOptions - k - 1;
+        if (strcmp(options[k], "--animated") == 0 && remaining >= 1) {
+            params.animatedFraction = (float)atof(options[++k]);
+        } else if (strcmp(options[k], "--concave") == 0 && remaining >= 1) {
+            params.concaveFraction = (float)atof(options[++k]);
+        } else if (strcmp(options[k], "--vertices") == 0 && remaining >= 2) {
+            params.minVertices = atoi(options[++k]);
+            params.maxVertices = atoi(options[++k]);
+        } else if (strcmp(options[k], "--distribution") == 0 && remaining >= 1 &&
+                   (strcmp(options[k + 1], "uniform") == 0 || strcmp(options[k + 1], "power") == 0)) {
+            params.distribution = strcmp(options[++k], "uniform") == 0 ? SCENEGEN_VERTICES_UNIFORM
+                                                                      : SCENEGEN_VERTICES_POWER;
+        } else {
+            fprintf(stderr, "[Generate ERROR] Opcao invalida: '%s'.\n", options[k]);
+            return 1;
+        }
+    }
+    if (!(params.animatedFraction >= 0.0f && params.animatedFraction <= 1.0f)) {
+        fprintf(stderr, "[Generate ERROR] A fracao de objetos animados deve estar entre 0 e 1.\n");
+        return 1;
+    }
+    if (!(params.concaveFraction >= 0.0f && params.concaveFraction <= 1.0f)) {
+        fprintf(stderr, "[Generate ERROR] A fracao de poligonos concavos deve estar entre 0 e 1.\n");
+        return 1;
+    }
+    if (params.minVertices < 3 || params.maxVertices < params.minVertices) {
+        fprintf(stderr, "[Generate ERROR] A faixa de vertices deve comecar em 3 ou mais e ter <min> <= <max>.\n");
+        return 1;
+    }
+
+    SceneSnapshot snap;
+    snapshotInit(&snap);
+    int ok = sceneGenerate(&params, &snap) && writeSceneFile(&snap, sceneFile, NULL);
+    if (ok) {
+        printf("[GENERATE] '%s': %d pontos, %d segmentos, %d poligonos (%zu vertices), %d animados, semente %llu\n",
+               sceneFile, snap.numPoints, snap.numSegments, snap.numPolygons, snap.numVertices,
+               snap.numAnimated, params.seed);
+    }
+    snapshotFree(&snap);
+    return ok ? 0 : 1;
+}
+
+/**
+ * @brief Imprime os modos de linha de comando.
+ */
+static void printUsage(const char* program) {
+    printf("Uso: %s [<cena>]                        (editor interativo)\n"
+           "     %s [--trace <arquivo>] <modo> ...  (grava um trace da execucao)\n"
+           "\n"
+           "Modos sem janela:\n"
+           "  --replay <cena> <passos> [<cena_final>]\n"
+           "  --bench-threads <cena> <passos> [<max_threads>]\n"
+           "  --bench-transform <vertices> <repeticoes>\n"
+           "  --bench-hull <max_pontos>\n"
+           "  --bench-predicates <testes>\n"
+           "  --bench-io <vertices>\n"
+           "  --bench-suite [<objetos>...]\n"
+           "  --convert <cena_origem> <cena_destino>\n"
+           "  --export <cena> <imagem> [<largura> <altura>] [--fill]\n"
+           "  --batch <roteiro> [--workers <n>] <cena_ou_pasta>...\n"
+           "  --generate <cena> <objetos> [<semente>] [--animated <fracao>] [--concave <fracao>]\n"
+           "             [--vertices <min> <max>] [--distribution uniform|power]\n"
+           "\n"
+           "--replay e --bench-threads medem o passo da animacao, que so trabalha com\n"
+           "objetos animados. Para gerar uma cena com 10%% deles em movimento:\n"
+           "  %s --generate cena.txt 100000 --animated 0.1\n",
+           program, program, program);
 }
 
 /**
@@ -100,14 +904,122 @@ static void timerCallback(int value) {
  * Registrada com atexit() para garantir a liberacao de recursos.
  */
 static void cleanup_on_exit(void) {
+    sceneIoShutdown();
+    journalClose(); // Antes da limpeza, que nao deve entrar no diario.
     clearAllObjects();
+    renderShutdown();
+    collisionShutdown();
+    jobsShutdown();
+    vertexPoolShutdown();
+    // Com --trace, os buffers ainda serao gravados por exportTraceOnExit().
+    if (!s_traceFileName) profilerShutdown();
     printf("[INFO] Recursos alocados liberados.\n");
 }
 
+/**
+ * @brief Grava o trace pedido com --trace ao sair do programa.
+ *
+ * Registrada antes de cleanup_on_exit(), roda depois dela, quando as
+ * threads de trabalho ja terminaram.
+ */
+static void exportTraceOnExit(void) {
+    profilerExportTrace(s_traceFileName);
+    profilerShutdown();
+}
+
 
-// --- SEO DE FUNO PRINCIPAL ---
+// --- SEÇÃO DE FUNÇÃO PRINCIPAL ---
 
 int main(int argc, char **argv) {
+    // O passo da animacao usa todos os processadores da maquina.
+    jobsInit(0);
+
+    // Opcao de qualquer modo: rabisquim --trace <arquivo> ... mede a execucao
+    // inteira e grava o trace ao sair.
+    if (argc >= 3 && strcmp(argv[1], "--trace") == 0) {
+        s_traceFileName = argv[2];
+        profilerSetEnabled(1);
+        atexit(exportTraceOnExit);
+        argv[2] = argv[0];
+        argv += 2;
+        argc -= 2;
+    }
+
+    // rabisquim --help lista os modos.
+    if (argc >= 2 && (strcmp(argv[1], "--help") == 0 || strcmp(argv[1], "-h") == 0)) {
+        printUsage(argv[0]);
+        return 0;
+    }
+    // Modo sem janela: rabisquim --replay <cena> <passos> [<cena_final>]
+    if (argc >= 4 && strcmp(argv[1], "--replay") == 0) {
+        atexit(cleanup_on_exit);
+        return runReplay(argv[2], atoi(argv[3]), argc >= 5 ? argv[4] : NULL);
+    }
+    // Modo sem janela: rabisquim --bench-threads <cena> <passos> [<max_threads>]
+    if (argc >= 4 && strcmp(argv[1], "--bench-threads") == 0) {
+        atexit(cleanup_on_exit);
+        return runThreadBenchmark(argv[2], atoi(argv[3]), argc >= 5 ? atoi(argv[4]) : 0);
+    }
+    // Modo sem janela: rabisquim --bench-transform <vertices> <repeticoes>
+    if (argc >= 4 && strcmp(argv[1], "--bench-transform") == 0) {
+        return runTransformBenchmark(atoi(argv[2]), atoi(argv[3]));
+    }
+    // Modo sem janela: rabisquim --convert <cena_origem> <cena_destino>
+    if (argc >= 4 && strcmp(argv[1], "--convert") == 0) {
+        atexit(cleanup_on_exit);
+        return runConvert(argv[2], argv[3]);
+    }
+    // Modo sem janela: rabisquim --bench-hull <max_pontos>
+    if (argc >= 3 && strcmp(argv[1], "--bench-hull") == 0) {
+        return runHullBenchmark(atoi(argv[2]));
+    }
+    // Modo sem janela: rabisquim --bench-predicates <testes>
+    if (argc >= 3 && strcmp(argv[1], "--bench-predicates") == 0) {
+        return runPredicateBenchmark(atoi(argv[2]));
+    }
+    // Modo sem janela: rabisquim --export <cena> <imagem> [<largura> <altura>] [--fill]
+    if (argc >= 4 && strcmp(argv[1], "--export") == 0) {
+        int fill = strcmp(argv[argc - 1], "--fill") == 0;
+        int numSizes = argc - 4 - fill;
+        atexit(cleanup_on_exit);
+        return runExport(argv[2], argv[3], numSizes >= 2 ? atoi(argv[4]) : WINDOW_WIDTH,
+                         numSizes >= 2 ? atoi(argv[5]) : WINDOW_HEIGHT, fill);
+    }
+    // Modo sem janela: rabisquim --batch <roteiro> [--workers <n>] <cena_ou_pasta>...
+    if (argc >= 4 && strcmp(argv[1], "--batch") == 0) {
+        int first = 3;
+        int workers = 0;
+        if (argc >= 6 && strcmp(argv[3], "--workers") == 0) {
+            workers = atoi(argv[4]);
+            first = 5;
+        }
+        atexit(cleanup_on_exit);
+        return runBatch(argv[2], argv + first, argc - first, workers);
+    }
+    // Modo sem janela: rabisquim --bench-io <vertices>
+    if (argc >= 3 && strcmp(argv[1], "--bench-io") == 0) {
+        atexit(cleanup_on_exit);
+        return runSceneIoBenchmark(atoi(argv[2]));
+    }
+    // Modo sem janela: rabisquim --bench-suite [<objetos>...]
+    if (argc >= 2 && strcmp(argv[1], "--bench-suite") == 0) {
+        int scales[16];
+        int numScales = 0;
+        for (int k = 2; k < argc && numScales < 16; k++) {
+            scales[numScales++] = atoi(argv[k]);
+        }
+        // Sem cleanup_on_exit(), cuja mensagem final sairia no meio do CSV.
+        return runBenchSuite(scales, numScales);
+    }
+    // Modo sem janela: rabisquim --generate <cena> <objetos> [<semente>] [<opcoes>...]
+    if (argc >= 4 && strcmp(argv[1], "--generate") == 0) {
+        return runGenerate(argv[2], atoi(argv[3]), argv + 4, argc - 4);
+    }
+    // Modo interativo: rabisquim [<cena>] escolhe o arquivo usado por F5/F9.
+    if (argc >= 2 && strncmp(argv[1], "--", 2) != 0) {
+        g_sceneFileName = argv[1];
+    }
+
     // 1. Inicializa o GLUT e a janela
     glutInit(&argc, argv);
     glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB);
@@ -120,6 +1032,9 @@ int main(int argc, char **argv) {
     anim_init_all();
     atexit(cleanup_on_exit); // Registra a funcao de limpeza
 
+    // Recupera o trabalho da sessao anterior e passa a registrar as operacoes.
+    journalOpen(JOURNAL_FILE_NAME);
+
     // 3. Registra as funcoes de callback para gerenciar eventos
     glutDisplayFunc(displayCallback);
     glutKeyboardFunc(keyboardCallback);
@@ -127,8 +1042,8 @@ int main(int argc, char **argv) {
     glutMotionFunc(motionCallback);
     glutPassiveMotionFunc(passiveMotionCallback);
     glutSpecialFunc(specialKeysCallback);
-    glutTimerFunc(16, timerCallback, 0);
     glutReshapeFunc(reshapeCallback);
+    renderSetFrameRequestHook(glutPostRedisplay);
 
     // 4. Bloco de instrucoes para o console (crucial para o usuario)
     printf("\n======================= Rabisquim - Instrucoes =======================\n\n");
@@ -138,23 +1053,32 @@ int main(int argc, char **argv) {
     printf("  'o' -> Modo Criar Poligono: Clique para adicionar vertices. Botao direito para finalizar.\n\n");
     printf("--- Selecao e Edicao Basica ---\n");
     printf("  's' -> Modo de Selecao: Clique em um objeto para seleciona-lo.\n");
-    printf("  'DEL' -> Excluir: Apaga o objeto que estiver selecionado.\n\n");
-    printf("--- Transformacoes (com um objeto selecionado) ---\n");
-    printf("  't' -> Transladar (Mover): Arraste o objeto selecionado com o mouse.\n");
+    printf("         Shift+Clique adiciona/remove objetos; arraste no vazio para selecionar por area.\n");
+    printf("  'DEL' -> Excluir: Apaga os objetos que estiverem selecionados.\n");
+    printf("  'Ctrl+Z' / 'Ctrl+Y' -> Desfaz / refaz a ultima criacao, exclusao, transformacao ou fecho convexo.\n\n");
+    printf("--- Transformacoes (aplicadas a toda a selecao, em torno do seu centro) ---\n");
+    printf("  't' -> Transladar (Mover): Arraste os objetos selecionados com o mouse.\n");
     printf("  'r' -> Rotacao: Use as SETAS ESQUERDA/DIREITA para girar.\n");
     printf("  'e' -> Escala: Use as teclas '+' e '-' para aumentar ou diminuir.\n");
     printf("  'm' -> Reflexao (Espelho): Pressione 'x' ou 'y' para refletir no eixo.\n");
     printf("  'h' -> Cisalhamento (Shear): Use as SETAS do teclado para deformar.\n\n");
     printf("--- Algoritmos Geometricos ---\n");
-    printf("  'c' -> Fecho Convexo: Com um poligono selecionado, transforma-o em seu fecho convexo.\n\n");
+    printf("  'c' -> Fecho Convexo: Com um poligono selecionado, transforma-o em seu fecho convexo.\n");
+    printf("         Com varios objetos selecionados, cria um poligono com o fecho da uniao deles.\n\n");
     printf("--- Animacoes (com um objeto selecionado) ---\n");
     printf("  'b' -> Alterna o modo de 'pular' (bounce).\n");
     printf("  'v' -> Aplica uma velocidade inicial na direcao do mouse.\n");
     printf("  'g' -> Alterna a gravidade.\n");
     printf("  '[' e ']' -> Diminui ou aumenta a velocidade.\n\n");
     printf("--- Controles de Arquivo ---\n");
-    printf("  'F5' -> Salva a cena atual no arquivo 'scene.txt'.\n");
-    printf("  'F9' -> Carrega a cena do arquivo 'scene.txt'.\n\n");
+    printf("  'F5' -> Salva a cena atual no arquivo '%s' (em segundo plano).\n", g_sceneFileName);
+    printf("  'F9' -> Carrega a cena do arquivo '%s' (em segundo plano).\n", g_sceneFileName);
+    printf("  'F8' -> Cancela o salvamento ou carregamento em andamento.\n");
+    printf("         Arquivos '%s' usam o formato binario; os demais, o formato de texto.\n", SCENE_BINARY_EXTENSION);
+    printf("  Cada edicao e gravada no diario '%s' e recuperada ao abrir o programa.\n\n", JOURNAL_FILE_NAME);
+    printf("--- Medidor de Tempo ---\n");
+    printf("  'F3' -> Liga/desliga as medicoes e o painel com o tempo do quadro e de cada etapa.\n");
+    printf("  'F4' -> Grava as ultimas medicoes em '%s' (abra em chrome://tracing ou no Perfetto).\n\n", PROFILER_TRACE_FILE);
     printf("--- Controles Gerais ---\n");
     printf("  'ESC' -> Sair do programa.\n\n");
     printf("======================================================================\n");
@@ -1,14 +1,16 @@
 /**
  * @file objects.c
- * @brief Implementa a lgica de gerenciamento da lista global de objetos grficos.
+ * @brief Implementa a lógica de gerenciamento da lista global de objetos gráficos.
  *
- * Responsvel por adicionar, remover, desenhar e limpar todos os objetos da
- * cena de forma genrica, utilizando um array e a tcnica de "polimorfismo"
- * com `void*` e um `enum`.
+ * Responsável por adicionar, remover, desenhar e limpar todos os objetos da
+ * cena de forma genérica. Cada objeto é um "tag" de tipo mais a posição dos
+ * seus dados no array compacto do tipo correspondente, sem nenhuma alocação
+ * individual por objeto.
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <GL/glut.h>
 
 #include "objects.h"
@@ -18,112 +20,682 @@
 #include "config.h"
 #include "input.h"
 #include "animation.h"
+#include "spatial.h"
+#include "utils.h"
+#include "render.h"
+#include "transformations.h"
+#include "journal.h"
+#include "history.h"
+#include "profiler.h"
 
-// --- SEO DE VARIVEIS GLOBAIS DE ESTADO (DEFINIES) ---
+// --- SEÇÃO DE VARIÁVEIS GLOBAIS DE ESTADO (DEFINIÇÕES) ---
 
-Object g_objects[MAX_OBJECTS];
+Object* g_objects = NULL;
 int g_numObjects = 0;
 int g_selectedObjectIndex = -1;
+int* g_selection = NULL;
+int g_numSelected = 0;
 
-// --- SEO DE FUNES AUXILIARES (IMPLEMENTAO PRIVADA) ---
-// Essas funes no so expostas no arquivo de cabealho.
+Point* g_points = NULL;
+int* g_pointOwners = NULL;
+int g_numPoints = 0;
+
+Segment* g_segments = NULL;
+int* g_segmentOwners = NULL;
+int g_numSegments = 0;
+
+GfxPolygon* g_polygons = NULL;
+int* g_polygonOwners = NULL;
+int g_numPolygons = 0;
+
+// --- SEÇÃO DE VARIÁVEIS PRIVADAS DO MÓDULO ---
+
+static int s_objectCapacity = 0;            ///< Tamanho alocado de 'g_objects'.
+static int s_pointCapacity = 0;             ///< Tamanho alocado de 'g_points'.
+static int s_segmentCapacity = 0;           ///< Tamanho alocado de 'g_segments'.
+static int s_polygonCapacity = 0;           ///< Tamanho alocado de 'g_polygons'.
+
+// Geometria base de cada objeto, paralela aos arrays de geometria no mundo.
+// Cada polígono base tem o seu próprio bloco no pool de vértices.
+static Point* s_pointBases = NULL;
+static Segment* s_segmentBases = NULL;
+static GfxPolygon* s_polygonBases = NULL;
+
+// Fila de objetos com transformação pendente. Guarda handles para que
+// objetos removidos antes do flush sejam simplesmente ignorados.
+static ObjectHandle* s_pendingTransforms = NULL;
+static int s_numPendingTransforms = 0;
+static int s_pendingCapacity = 0;
+
+static int s_selectionCapacity = 0;         ///< Tamanho alocado de 'g_selection'.
+
+// Tabela de handles ("slot map"). Cada entrada ocupada guarda o índice atual
+// do objeto em 'g_objects'; cada entrada livre guarda a próxima entrada livre.
+static int* s_handleSlots = NULL;
+static unsigned int* s_handleGenerations = NULL;
+static int s_handleCapacity = 0;
+static int s_freeHandleHead = -1;
+
+// --- SEÇÃO DE FUNÇÕES AUXILIARES (IMPLEMENTAÇÃO PRIVADA) ---
+// Essas funções não são expostas no arquivo de cabeçalho.
+
+/**
+ * @brief Reserva uma entrada na tabela de handles para o objeto no índice dado.
+ * @param index O índice do objeto em 'g_objects'.
+ * @return int A entrada reservada, ou -1 em caso de falha de alocação.
+ */
+static int acquireHandle(int index) {
+    if (s_freeHandleHead == -1) {
+        int newCapacity = s_handleCapacity > 0 ? s_handleCapacity * 2 : INITIAL_OBJECT_CAPACITY;
+        int* slots = (int*)realloc(s_handleSlots, newCapacity * sizeof(int));
+        if (!slots) return -1;
+        s_handleSlots = slots;
+        unsigned int* gens = (unsigned int*)realloc(s_handleGenerations, newCapacity * sizeof(unsigned int));
+        if (!gens) return -1;
+        s_handleGenerations = gens;
+
+        // Encadeia as novas entradas na lista livre, preservando a ordem crescente.
+        for (int i = s_handleCapacity; i < newCapacity; i++) {
+            s_handleSlots[i] = (i + 1 < newCapacity) ? i + 1 : -1;
+            s_handleGenerations[i] = 0;
+        }
+        s_freeHandleHead = s_handleCapacity;
+        s_handleCapacity = newCapacity;
+    }
+    int id = s_freeHandleHead;
+    s_freeHandleHead = s_handleSlots[id];
+    s_handleSlots[id] = index;
+    return id;
+}
+
+/**
+ * @brief Devolve uma entrada à lista livre, invalidando os handles emitidos para ela.
+ * @param id A entrada a ser liberada.
+ */
+static void releaseHandle(int id) {
+    s_handleGenerations[id]++;
+    s_handleSlots[id] = s_freeHandleHead;
+    s_freeHandleHead = id;
+}
+
+/**
+ * @brief Garante que um array de geometria (e os seus arrays de base e de donos) comporte mais um elemento.
+ * @param items Endereço do ponteiro para o array de geometria.
+ * @param bases Endereço do ponteiro para o array de geometria base (mesmo tipo de 'items').
+ * @param owners Endereço do ponteiro para o array de donos.
+ * @param capacity Endereço da capacidade atual, atualizada em caso de crescimento.
+ * @param count A quantidade atual de elementos.
+ * @param itemSize O tamanho de um elemento de geometria, em bytes.
+ * @return int 1 se há espaço para mais um elemento, 0 em caso de falha de alocação.
+ */
+static int growTypeStore(void** items, void** bases, int** owners, int* capacity, int count, size_t itemSize) {
+    if (count < *capacity) return 1;
+
+    // Os três arrays são realocados antes de a capacidade mudar: se algum
+    // falhar, os que cresceram só ficam com folga e a capacidade continua a
+    // mesma para os três.
+    int newCapacity = *capacity > 0 ? *capacity * 2 : INITIAL_OBJECT_CAPACITY;
+    void* newItems = realloc(*items, newCapacity * itemSize);
+    if (newItems) *items = newItems;
+    void* newBases = realloc(*bases, newCapacity * itemSize);
+    if (newBases) *bases = newBases;
+    int* newOwners = (int*)realloc(*owners, newCapacity * sizeof(int));
+    if (newOwners) *owners = newOwners;
+    if (!newItems || !newBases || !newOwners) return 0;
+    *capacity = newCapacity;
+    return 1;
+}
+
+/**
+ * @brief Registra um novo objeto em 'g_objects' cujos dados já estão no array do seu tipo.
+ * @param type O tipo do objeto.
+ * @param slot A posição dos dados do objeto no array do seu tipo.
+ * @return ObjectHandle O handle do novo objeto, ou OBJECT_HANDLE_NONE em caso de falha.
+ */
+static ObjectHandle registerObject(ObjectType type, int slot) {
+    if (g_numObjects == s_objectCapacity && !reserveObjects(g_numObjects + 1)) {
+        return OBJECT_HANDLE_NONE;
+    }
+    int id = acquireHandle(g_numObjects);
+    if (id == -1) {
+        return OBJECT_HANDLE_NONE;
+    }
+
+    g_objects[g_numObjects].type = type;
+    g_objects[g_numObjects].slot = slot;
+    g_objects[g_numObjects].handleId = id;
+    g_objects[g_numObjects].selectionSlot = -1;
+    g_objects[g_numObjects].journalId = journalAssignId();
+    g_objects[g_numObjects].historyRef = -1;
+    g_objects[g_numObjects].shapeVersion = 0;
+    g_numObjects++;
+
+    ObjectHandle handle = {id, s_handleGenerations[id]};
+    return handle;
+}
+
+/**
+ * @brief Retorna o array de donos correspondente a um tipo de objeto.
+ */
+static int* ownersOfType(ObjectType type) {
+    switch (type) {
+        case OBJECT_TYPE_POINT: return g_pointOwners;
+        case OBJECT_TYPE_SEGMENT: return g_segmentOwners;
+        case OBJECT_TYPE_POLYGON: return g_polygonOwners;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Libera os dados de um objeto no array do seu tipo.
+ *
+ * Assim como em 'g_objects', a remoção é feita em O(1): o último elemento do
+ * array ocupa a posição liberada e o objeto dono dele é atualizado.
+ * @param obj O objeto cujos dados serão removidos.
+ */
+static void clearObject(const Object* obj) {
+    int slot = obj->slot;
+    int last;
+    switch (obj->type) {
+        case OBJECT_TYPE_POINT:
+            freePoint(&g_points[slot]);
+            last = --g_numPoints;
+            if (slot != last) {
+                g_points[slot] = g_points[last];
+                s_pointBases[slot] = s_pointBases[last];
+                g_pointOwners[slot] = g_pointOwners[last];
+                g_objects[g_pointOwners[slot]].slot = slot;
+            }
+            break;
+        case OBJECT_TYPE_SEGMENT:
+            freeSegment(&g_segments[slot]);
+            last = --g_numSegments;
+            if (slot != last) {
+                g_segments[slot] = g_segments[last];
+                s_segmentBases[slot] = s_segmentBases[last];
+                g_segmentOwners[slot] = g_segmentOwners[last];
+                g_objects[g_segmentOwners[slot]].slot = slot;
+            }
+            break;
+        case OBJECT_TYPE_POLYGON:
+            freePolygon(&g_polygons[slot]);
+            freePolygon(&s_polygonBases[slot]);
+            last = --g_numPolygons;
+            if (slot != last) {
+                g_polygons[slot] = g_polygons[last];
+                s_polygonBases[slot] = s_polygonBases[last];
+                g_polygonOwners[slot] = g_polygonOwners[last];
+                g_objects[g_polygonOwners[slot]].slot = slot;
+            }
+            break;
+    }
+    renderMarkRemoved(obj->type, slot);
+}
 
 /**
- * @brief Libera a memria alocada para um nico objeto grfico.
- * @param obj O ponteiro para o objeto a ser limpo.
+ * @brief Torna a geometria atual no mundo a geometria base do objeto.
+ *
+ * A transformação acumulada volta a ser a identidade e o centro da base é
+ * recalculado. Se faltar memória para a cópia de um polígono, a base fica
+ * vazia e o objeto passa a ser transformado diretamente no mundo.
+ * @param index O índice do objeto em 'g_objects'.
  */
-static void clearObject(Object* obj) {
-    if (obj != NULL && obj->data != NULL) {
-        switch (obj->type) {
-            case OBJECT_TYPE_POINT: freePoint((Point*)obj->data); break;
-            case OBJECT_TYPE_SEGMENT: freeSegment((Segment*)obj->data); break;
-            case OBJECT_TYPE_POLYGON: freePolygon((GfxPolygon*)obj->data); break;
+static void adoptWorldAsBase(int index) {
+    Object* o = &g_objects[index];
+    switch (o->type) {
+        case OBJECT_TYPE_POINT:
+            s_pointBases[o->slot] = g_points[o->slot];
+            break;
+        case OBJECT_TYPE_SEGMENT:
+            s_segmentBases[o->slot] = g_segments[o->slot];
+            break;
+        case OBJECT_TYPE_POLYGON: {
+            const GfxPolygon* world = &g_polygons[o->slot];
+            GfxPolygon* base = &s_polygonBases[o->slot];
+            if (base->capacity < world->numVertices) {
+                freePolygon(base);
+                *base = createPolygonFromVertices(world->vertices, world->numVertices);
+            } else {
+                if (world->numVertices > 0) {
+                    memcpy(base->vertices, world->vertices, world->numVertices * sizeof(Point));
+                }
+                base->numVertices = world->numVertices;
+            }
+            break;
         }
-        free(obj->data);
-        obj->data = NULL;
     }
+    o->transform = createIdentityMatrix();
+    o->baseCenter = computeObjectCenter(index);
+    o->transformPending = 0;
+}
+
+/**
+ * @brief Refaz os vértices no mundo de um objeto a partir da base e da transformação acumulada.
+ */
+static void rebuildWorldGeometry(int index) {
+    Object* o = &g_objects[index];
+    switch (o->type) {
+        case OBJECT_TYPE_POINT:
+            transformPointsTo(&s_pointBases[o->slot], &g_points[o->slot], 1, &o->transform);
+            break;
+        case OBJECT_TYPE_SEGMENT:
+            // Os dois extremos do segmento ficam lado a lado na memória.
+            transformPointsTo(&s_segmentBases[o->slot].p1, &g_segments[o->slot].p1, 2, &o->transform);
+            break;
+        case OBJECT_TYPE_POLYGON:
+            transformPointsTo(s_polygonBases[o->slot].vertices, g_polygons[o->slot].vertices,
+                              g_polygons[o->slot].numVertices, &o->transform);
+            break;
+    }
+    o->transformPending = 0;
+    o->bounds = computeObjectBounds(index);
+    spatialUpdate(o->handleId, o->bounds);
+    renderMarkDirty(o->type, o->slot);
 }
 
 /**
- * @brief Desenha um nico objeto da lista na tela.
- * @param index O ndice do objeto a ser desenhado.
- * @param is_selected Um flag que indica se o objeto deve ser desenhado em modo de seleo.
+ * @brief Registra a geometria base e a caixa envolvente de um objeto recém-adicionado.
+ */
+static void finishAddedObject(int index) {
+    adoptWorldAsBase(index);
+    g_objects[index].bounds = computeObjectBounds(index);
+    spatialInsert(g_objects[index].handleId, g_objects[index].bounds);
+    renderMarkDirty(g_objects[index].type, g_objects[index].slot);
+    journalRecordAdd(index);
+}
+
+/**
+ * @brief Desenha um único objeto da lista na tela.
+ * @param index O índice do objeto a ser desenhado.
+ * @param is_selected Um flag que indica se o objeto deve ser desenhado em modo de seleção.
  */
 static void drawObject(int index, int is_selected) {
-    if (index >= 0 && index < g_numObjects && g_objects[index].data != NULL) {
+    if (index >= 0 && index < g_numObjects) {
         switch (g_objects[index].type) {
             case OBJECT_TYPE_POINT:
-                drawPoint((Point*)g_objects[index].data, is_selected);
+                drawPoint(getObjectPoint(index), is_selected);
                 break;
             case OBJECT_TYPE_SEGMENT:
-                drawSegment((Segment*)g_objects[index].data, is_selected);
+                drawSegment(getObjectSegment(index), is_selected);
                 break;
             case OBJECT_TYPE_POLYGON:
-                drawPolygon((GfxPolygon*)g_objects[index].data, is_selected);
+                drawPolygon(getObjectPolygon(index), is_selected);
                 break;
         }
     }
 }
 
-// --- SEO DE FUNES PBLICAS ---
+/**
+ * @brief Põe um objeto na fila de transformações pendentes, se ele ainda não estiver nela.
+ */
+static void queueTransform(int index) {
+    Object* o = &g_objects[index];
+    if (o->transformPending) return;
+
+    if (s_numPendingTransforms == s_pendingCapacity) {
+        int newCapacity = s_pendingCapacity > 0 ? s_pendingCapacity * 2 : INITIAL_OBJECT_CAPACITY;
+        ObjectHandle* pending = (ObjectHandle*)realloc(s_pendingTransforms, newCapacity * sizeof(ObjectHandle));
+        if (!pending) {
+            // Sem espaço na fila: refaz o cache agora mesmo.
+            rebuildWorldGeometry(index);
+            return;
+        }
+        s_pendingTransforms = pending;
+        s_pendingCapacity = newCapacity;
+    }
+    o->transformPending = 1;
+    s_pendingTransforms[s_numPendingTransforms++] = getObjectHandle(index);
+    renderRequestFrame();
+}
+
+// --- SEÇÃO DE FUNÇÕES PÚBLICAS ---
 
 void initObjectList() {
     g_numObjects = 0;
     g_selectedObjectIndex = -1;
+    reserveObjects(INITIAL_OBJECT_CAPACITY);
 }
 
-void addObject(ObjectType type, void* data) {
-    if (g_numObjects < MAX_OBJECTS) {
-        g_objects[g_numObjects].type = type;
-        g_objects[g_numObjects].data = data;
-        g_numObjects++;
-    } else {
-        fprintf(stderr, "[Objects ERROR] Limite mximo de objetos (%d) atingido.\n", MAX_OBJECTS);
+int reserveObjects(int capacity) {
+    if (capacity <= s_objectCapacity) return 1;
+
+    int newCapacity = s_objectCapacity > 0 ? s_objectCapacity : INITIAL_OBJECT_CAPACITY;
+    while (newCapacity < capacity) newCapacity *= 2;
+
+    // O estado de animação é um array paralelo e cresce antes: 'g_anim' nunca
+    // pode ser menor que 's_objectCapacity'.
+    if (!anim_reserve(newCapacity)) return 0;
+
+    Object* objects = (Object*)realloc(g_objects, newCapacity * sizeof(Object));
+    if (!objects) {
+        fprintf(stderr, "[Objects ERROR] Falha ao alocar memória para %d objetos.\n", newCapacity);
+        return 0;
+    }
+    g_objects = objects;
+    s_objectCapacity = newCapacity;
+    return 1;
+}
+
+ObjectHandle addPointObject(Point p) {
+    if (!growTypeStore((void**)&g_points, (void**)&s_pointBases, &g_pointOwners, &s_pointCapacity, g_numPoints, sizeof(Point))) {
+        fprintf(stderr, "[Objects ERROR] Não foi possível adicionar o ponto: memória insuficiente.\n");
+        return OBJECT_HANDLE_NONE;
+    }
+    ObjectHandle handle = registerObject(OBJECT_TYPE_POINT, g_numPoints);
+    if (handle.id == -1) {
+        fprintf(stderr, "[Objects ERROR] Não foi possível adicionar o ponto: memória insuficiente.\n");
+        return handle;
+    }
+    g_points[g_numPoints] = p;
+    g_pointOwners[g_numPoints] = g_numObjects - 1;
+    g_numPoints++;
+    finishAddedObject(g_numObjects - 1);
+    return handle;
+}
+
+ObjectHandle addSegmentObject(Segment s) {
+    if (!growTypeStore((void**)&g_segments, (void**)&s_segmentBases, &g_segmentOwners, &s_segmentCapacity, g_numSegments, sizeof(Segment))) {
+        fprintf(stderr, "[Objects ERROR] Não foi possível adicionar o segmento: memória insuficiente.\n");
+        return OBJECT_HANDLE_NONE;
+    }
+    ObjectHandle handle = registerObject(OBJECT_TYPE_SEGMENT, g_numSegments);
+    if (handle.id == -1) {
+        fprintf(stderr, "[Objects ERROR] Não foi possível adicionar o segmento: memória insuficiente.\n");
+        return handle;
+    }
+    g_segments[g_numSegments] = s;
+    g_segmentOwners[g_numSegments] = g_numObjects - 1;
+    g_numSegments++;
+    finishAddedObject(g_numObjects - 1);
+    return handle;
+}
+
+ObjectHandle addPolygonObject(const GfxPolygon* poly) {
+    ObjectHandle handle = OBJECT_HANDLE_NONE;
+    if (growTypeStore((void**)&g_polygons, (void**)&s_polygonBases, &g_polygonOwners, &s_polygonCapacity, g_numPolygons, sizeof(GfxPolygon))) {
+        handle = registerObject(OBJECT_TYPE_POLYGON, g_numPolygons);
     }
+    if (handle.id == -1) {
+        fprintf(stderr, "[Objects ERROR] Não foi possível adicionar o polígono: memória insuficiente.\n");
+        GfxPolygon orphan = *poly;
+        freePolygon(&orphan);
+        return handle;
+    }
+    g_polygons[g_numPolygons] = *poly;
+    s_polygonBases[g_numPolygons] = createPolygon();
+    g_polygonOwners[g_numPolygons] = g_numObjects - 1;
+    g_numPolygons++;
+    finishAddedObject(g_numObjects - 1);
+    return handle;
 }
 
 void removeObject(int index) {
     if (index >= 0 && index < g_numObjects) {
+        int last = g_numObjects - 1;
+        journalRecordRemove(index);
+        selectionRemove(index);
+        spatialRemove(g_objects[index].handleId);
         clearObject(&g_objects[index]);
-        for (int i = index; i < g_numObjects - 1; i++) {
-            g_objects[i] = g_objects[i + 1];
+        releaseHandle(g_objects[index].handleId);
+
+        // Remoção em O(1): o último objeto ocupa a posição liberada e apenas
+        // a sua entrada na tabela de handles e o seu dono no array do tipo
+        // precisam ser atualizados.
+        if (index != last) {
+            g_objects[index] = g_objects[last];
+            s_handleSlots[g_objects[index].handleId] = index;
+            ownersOfType(g_objects[index].type)[g_objects[index].slot] = index;
+            if (g_objects[index].selectionSlot != -1) {
+                g_selection[g_objects[index].selectionSlot] = index;
+            }
         }
         g_numObjects--;
-        anim_on_remove_compact(index);
-        if (g_selectedObjectIndex == index) {
-            g_selectedObjectIndex = -1;
-        } else if (g_selectedObjectIndex > index) {
-            g_selectedObjectIndex--;
+        anim_on_remove_swap(index, last);
+
+        if (g_selectedObjectIndex == last) {
+            g_selectedObjectIndex = index;
         }
     } else {
-        fprintf(stderr, "[Objects ERROR] ndice de remoo de objeto invlido: %d.\n", index);
+        fprintf(stderr, "[Objects ERROR] Índice de remoção de objeto inválido: %d.\n", index);
     }
 }
 
 void clearAllObjects() {
+    journalRecordClear();
+    historyClear();
+    for (int i = 0; i < g_numPolygons; i++) {
+        freePolygon(&g_polygons[i]);
+        freePolygon(&s_polygonBases[i]);
+    }
     for (int i = 0; i < g_numObjects; i++) {
-        clearObject(&g_objects[i]);
+        releaseHandle(g_objects[i].handleId);
     }
     g_numObjects = 0;
+    g_numPoints = 0;
+    g_numSegments = 0;
+    g_numPolygons = 0;
     g_selectedObjectIndex = -1;
+    g_numSelected = 0;
+    s_numPendingTransforms = 0;
+    spatialClear();
+    renderInvalidateAll();
+    anim_init_all();
 }
 
-void drawAllObjects() {
-    // 1 Passada: Desenha todos os objetos que NO esto selecionados.
-    for (int i = 0; i < g_numObjects; i++) {
-        if (i != g_selectedObjectIndex) {
-            drawObject(i, 0);
+ObjectHandle getObjectHandle(int index) {
+    if (index < 0 || index >= g_numObjects) {
+        return OBJECT_HANDLE_NONE;
+    }
+    int id = g_objects[index].handleId;
+    ObjectHandle handle = {id, s_handleGenerations[id]};
+    return handle;
+}
+
+int resolveObjectHandle(ObjectHandle handle) {
+    if (handle.id < 0 || handle.id >= s_handleCapacity) return -1;
+    if (s_handleGenerations[handle.id] != handle.generation) return -1;
+    return s_handleSlots[handle.id];
+}
+
+int resolveHandleId(int handleId) {
+    return s_handleSlots[handleId];
+}
+
+void objectGeometryChanged(int index) {
+    if (index < 0 || index >= g_numObjects) return;
+    g_objects[index].shapeVersion++;
+    adoptWorldAsBase(index);
+    g_objects[index].bounds = computeObjectBounds(index);
+    spatialUpdate(g_objects[index].handleId, g_objects[index].bounds);
+    renderMarkDirty(g_objects[index].type, g_objects[index].slot);
+    journalRecordGeometry(index);
+}
+
+void selectionClear(void) {
+    for (int k = 0; k < g_numSelected; k++) {
+        g_objects[g_selection[k]].selectionSlot = -1;
+    }
+    g_numSelected = 0;
+    g_selectedObjectIndex = -1;
+    renderRequestFrame();
+}
+
+void selectionAdd(int index) {
+    if (index < 0 || index >= g_numObjects) return;
+    if (!isObjectSelected(index)) {
+        if (g_numSelected == s_selectionCapacity) {
+            int newCapacity = s_selectionCapacity > 0 ? s_selectionCapacity * 2 : INITIAL_OBJECT_CAPACITY;
+            int* selection = (int*)realloc(g_selection, newCapacity * sizeof(int));
+            if (!selection) {
+                fprintf(stderr, "[Objects ERROR] Memória insuficiente para selecionar mais objetos.\n");
+                return;
+            }
+            g_selection = selection;
+            s_selectionCapacity = newCapacity;
+        }
+        g_objects[index].selectionSlot = g_numSelected;
+        g_selection[g_numSelected++] = index;
+    }
+    g_selectedObjectIndex = index;
+    renderRequestFrame();
+}
+
+void selectionRemove(int index) {
+    if (index < 0 || index >= g_numObjects || !isObjectSelected(index)) return;
+
+    // Remoção em O(1): o último membro ocupa a posição liberada.
+    int slot = g_objects[index].selectionSlot;
+    int moved = g_selection[--g_numSelected];
+    g_selection[slot] = moved;
+    g_objects[moved].selectionSlot = slot;
+    g_objects[index].selectionSlot = -1;
+
+    if (g_selectedObjectIndex == index) {
+        g_selectedObjectIndex = g_numSelected > 0 ? g_selection[g_numSelected - 1] : -1;
+    }
+    renderRequestFrame();
+}
+
+void selectionToggle(int index) {
+    if (index < 0 || index >= g_numObjects) return;
+    if (isObjectSelected(index)) {
+        selectionRemove(index);
+    } else {
+        selectionAdd(index);
+    }
+}
+
+void selectSingleObject(int index) {
+    selectionClear();
+    if (index != -1) {
+        selectionAdd(index);
+    }
+}
+
+void objectApplyTransform(int index, const Matrix3x3* matrix) {
+    if (index < 0 || index >= g_numObjects) return;
+    Object* o = &g_objects[index];
+    o->shapeVersion++;
+
+    if (o->type == OBJECT_TYPE_POLYGON &&
+        s_polygonBases[o->slot].numVertices != g_polygons[o->slot].numVertices) {
+        // Sem cópia base (faltou memória): transforma diretamente no mundo.
+        // O diário registra a geometria resultante, em objectGeometryChanged().
+        transformPoints(g_polygons[o->slot].vertices, g_polygons[o->slot].numVertices, matrix);
+        objectGeometryChanged(index);
+        return;
+    }
+    journalRecordTransform(index, matrix);
+
+    o->transform = multiplyMatrices(*matrix, o->transform);
+    queueTransform(index);
+}
+
+void objectSetTransform(int index, const Matrix3x3* matrix) {
+    if (index < 0 || index >= g_numObjects) return;
+    Object* o = &g_objects[index];
+    if (o->type == OBJECT_TYPE_POLYGON &&
+        s_polygonBases[o->slot].numVertices != g_polygons[o->slot].numVertices) {
+        // Sem cópia base, a geometria no mundo é a única referência.
+        return;
+    }
+    o->shapeVersion++;
+    o->transform = *matrix;
+    queueTransform(index);
+}
+
+const Point* getObjectBaseVertices(int index, int* count) {
+    const Object* o = &g_objects[index];
+    switch (o->type) {
+        case OBJECT_TYPE_POINT:
+            *count = 1;
+            return &s_pointBases[o->slot];
+        case OBJECT_TYPE_SEGMENT:
+            *count = 2;
+            return &s_segmentBases[o->slot].p1;
+        case OBJECT_TYPE_POLYGON:
+            *count = g_polygons[o->slot].numVertices;
+            if (s_polygonBases[o->slot].numVertices != *count) {
+                return g_polygons[o->slot].vertices;
+            }
+            return s_polygonBases[o->slot].vertices;
+    }
+    *count = 0;
+    return NULL;
+}
+
+void objectsFlushTransforms(void) {
+    if (s_numPendingTransforms == 0) return;
+    double profileStart = profileBegin();
+    for (int k = 0; k < s_numPendingTransforms; k++) {
+        // Objetos removidos (ou já refeitos individualmente) são ignorados.
+        int index = resolveObjectHandle(s_pendingTransforms[k]);
+        if (index != -1 && g_objects[index].transformPending) {
+            rebuildWorldGeometry(index);
         }
     }
-    // 2 Passada: Desenha o objeto selecionado por ltimo para destac-lo (z-order).
-    if (g_selectedObjectIndex != -1) {
-        drawObject(g_selectedObjectIndex, 1);
+    s_numPendingTransforms = 0;
+    profileEnd(PROFILE_FLUSH, profileStart);
+}
+
+void objectFlushTransform(int index) {
+    if (index < 0 || index >= g_numObjects) return;
+    if (g_objects[index].transformPending) {
+        rebuildWorldGeometry(index);
+    }
+}
+
+void objectTranslated(int index, float dx, float dy) {
+    if (index < 0 || index >= g_numObjects) return;
+    objectShiftBounds(index, dx, dy);
+    objectCommitMove(index);
+}
+
+void objectShiftBounds(int index, float dx, float dy) {
+    BoundingBox* box = &g_objects[index].bounds;
+    box->minX += dx;
+    box->maxX += dx;
+    box->minY += dy;
+    box->maxY += dy;
+}
+
+void objectCommitMove(int index) {
+    if (index < 0 || index >= g_numObjects) return;
+    spatialUpdate(g_objects[index].handleId, g_objects[index].bounds);
+    renderMarkDirty(g_objects[index].type, g_objects[index].slot);
+}
+
+void drawObjectOverlays() {
+    // Os objetos em si são desenhados em lote pelo renderizador (render.c).
+    // 1ª Passada: Redesenha os objetos selecionados por cima do lote para destacá-los (z-order).
+    for (int k = 0; k < g_numSelected; k++) {
+        // Acompanha a posição interpolada com que o lote desenha objetos animados.
+        float dx, dy;
+        anim_render_offset(g_selection[k], &dx, &dy);
+        glPushMatrix();
+        glTranslatef(dx, dy, 0.0f);
+        drawObject(g_selection[k], 1);
+        glPopMatrix();
+    }
+
+    // Retângulo da seleção por área, enquanto o usuário arrasta.
+    if (g_isRubberBanding) {
+        glColor3f(0.3f, 0.3f, 0.3f);
+        glEnable(GL_LINE_STIPPLE);
+        glLineStipple(1, 0x00FF);
+        glBegin(GL_LINE_LOOP);
+        glVertex2f(g_rubberBandStart.x, g_rubberBandStart.y);
+        glVertex2f(g_currentMousePos.x, g_rubberBandStart.y);
+        glVertex2f(g_currentMousePos.x, g_currentMousePos.y);
+        glVertex2f(g_rubberBandStart.x, g_currentMousePos.y);
+        glEnd();
+        glDisable(GL_LINE_STIPPLE);
     }
 
-    // 3 Passada: Desenha a pr-visualizao (feedback visual) de objetos em criao.
-    // Esta lgica  necessria aqui para interagir com o estado do mdulo de input.
+    // 2ª Passada: Desenha a pré-visualização (feedback visual) de objetos em criação.
+    // Esta lógica é necessária aqui para interagir com o estado do módulo de input.
     if (g_currentMode == MODE_CREATE_POLYGON && g_polygonVertexCount > 0) {
-        // Desenha os vrtices j clicados.
+        // Desenha os vértices já clicados.
         glColor3f(0.5f, 0.5f, 0.5f);
         glPointSize(CLICK_TOLERANCE / 2.0f);
         glBegin(GL_POINTS);
@@ -133,7 +705,7 @@ void drawAllObjects() {
         glEnd();
         glPointSize(1.0f);
 
-        // Desenha a linha entre os vrtices para visualizao.
+        // Desenha a linha entre os vértices para visualização.
         if (g_polygonVertexCount > 1) {
             glColor3f(0.0f, 0.0f, 1.0f);
             glBegin(GL_LINE_STRIP);
@@ -143,7 +715,7 @@ void drawAllObjects() {
             glEnd();
         }
 
-        // Desenha o "rubber band" do ltimo vrtice at a posio atual do mouse.
+        // Desenha o "rubber band" do último vértice até a posição atual do mouse.
         if (g_polygonVertexCount > 0) {
             glColor3f(0.0f, 1.0f, 0.0f);
             glBegin(GL_LINES);
@@ -160,7 +732,7 @@ void drawAllObjects() {
         glEnd();
         glPointSize(1.0f);
 
-        // Desenha a linha "rubber band" do primeiro ponto at a posio atual do mouse.
+        // Desenha a linha "rubber band" do primeiro ponto até a posição atual do mouse.
         glColor3f(0.0f, 1.0f, 0.0f);
         glBegin(GL_LINES);
         glVertex2f(g_segmentP1.x, g_segmentP1.y);
@@ -1,9 +1,15 @@
 /**
  * @file objects.h
- * @brief Define a interface e as estruturas para o gerenciamento de objetos grficos.
+ * @brief Define a interface e as estruturas para o gerenciamento de objetos gráficos.
  *
- * Este mdulo  o corao do sistema de dados do projeto, responsvel por
- * armazenar e manipular uma lista genrica de objetos grficos.
+ * Este módulo é o coração do sistema de dados do projeto, responsável por
+ * armazenar e manipular uma lista genérica de objetos gráficos.
+ *
+ * A geometria fica em arrays compactos, um por tipo (todos os pontos juntos,
+ * todos os segmentos juntos, todos os polígonos juntos). A lista 'g_objects'
+ * guarda apenas o tipo e a posição de cada objeto no array do seu tipo, então
+ * passadas em massa podem percorrer a memória de forma linear. Os vértices
+ * dos polígonos ficam no pool compartilhado de 'vertexpool.h'.
  */
 
 #ifndef OBJECTS_H
@@ -14,42 +20,317 @@
 #include "polygon.h"
 #include "config.h"
 
-// --- SEO DE ESTRUTURAS E TIPOS ---
+// --- SEÇÃO DE ESTRUTURAS E TIPOS ---
 
 /**
- * @brief Enumerao para os diferentes tipos de objetos grficos.
+ * @brief Enumeração para os diferentes tipos de objetos gráficos.
  *
- * Utilizado para identificar o tipo de dado para o ponteiro 'void*' na struct Object.
+ * Identifica em qual array de geometria ('g_points', 'g_segments' ou
+ * 'g_polygons') os dados do objeto estão armazenados.
  */
 typedef enum {
     OBJECT_TYPE_POINT,      ///< Objeto do tipo Ponto.
     OBJECT_TYPE_SEGMENT,    ///< Objeto do tipo Segmento de Reta.
-    OBJECT_TYPE_POLYGON     ///< Objeto do tipo Polgono.
+    OBJECT_TYPE_POLYGON     ///< Objeto do tipo Polígono.
 } ObjectType;
 
 /**
- * @brief Estrutura genrica para armazenar qualquer tipo de objeto.
+ * @brief Caixa envolvente alinhada aos eixos (AABB) de um objeto.
+ */
+typedef struct {
+    float minX, minY;       ///< Canto inferior esquerdo.
+    float maxX, maxY;       ///< Canto superior direito.
+} BoundingBox;
+
+/**
+ * @brief Estrutura para uma Matriz 3x3.
+ *
+ * Usada para representar transformações 2D em coordenadas homogêneas,
+ * permitindo a composição de múltiplas transformações.
+ */
+typedef struct {
+    float m[3][3];
+} Matrix3x3;
+
+/**
+ * @brief Estrutura genérica para referenciar qualquer tipo de objeto.
+ *
+ * Esta abordagem simula polimorfismo em C: o 'type' indica o array de
+ * geometria e o 'slot' a posição dentro dele.
  *
- * Esta abordagem simula polimorfismo em C, permitindo que diferentes
- * tipos de structs coexistam em um mesmo array.
+ * A geometria nos arrays de cada tipo é um cache, em coordenadas do mundo, de
+ * 'transform' aplicada à geometria base do objeto (guardada em 'objects.c').
+ * As transformações do usuário só compõem 'transform'; o cache é refeito sob
+ * demanda por objectsFlushTransforms().
  */
 typedef struct {
-    void* data;             ///< Ponteiro genrico para a struct especfica do objeto.
-    ObjectType type;        ///< "Tag" que identifica o tipo de dado apontado por 'data'.
+    ObjectType type;        ///< "Tag" que identifica o array de geometria do objeto.
+    int slot;               ///< Posição do objeto no array do seu tipo.
+    int handleId;           ///< Entrada da tabela de handles que aponta para este objeto.
+    BoundingBox bounds;     ///< Caixa envolvente em cache, mantida a cada mudança de geometria.
+    Matrix3x3 transform;    ///< Transformação acumulada desde a geometria base.
+    Point baseCenter;       ///< Centro da geometria base (o centro no mundo é 'transform' * 'baseCenter').
+    int transformPending;   ///< 1 se 'transform' mudou e o cache no mundo ainda não foi refeito.
+    int selectionSlot;      ///< Posição do objeto em 'g_selection' (-1 se não está selecionado).
+    unsigned int journalId; ///< Identificador permanente do objeto no diário de operações (journal.h).
+    int historyRef;         ///< Referência do objeto no histórico de edições (history.h), ou -1.
+    unsigned int shapeVersion; ///< Muda a cada troca de geometria ou de transformação (não nas translações da animação).
 } Object;
 
-// --- SEO DE VARIVEIS GLOBAIS DE ESTADO (DECLARAES) ---
+/**
+ * @brief Referência estável para um objeto da cena.
+ *
+ * O índice em 'g_objects' muda quando outro objeto é removido (o último
+ * objeto ocupa a posição liberada). O handle, ao contrário, continua válido
+ * até a remoção do próprio objeto; a geração detecta handles antigos cuja
+ * entrada já foi reutilizada por outro objeto.
+ */
+typedef struct {
+    int id;                 ///< Entrada na tabela de handles (-1 para handle nulo).
+    unsigned int generation;///< Geração da entrada no momento em que o handle foi emitido.
+} ObjectHandle;
+
+#define OBJECT_HANDLE_NONE ((ObjectHandle){-1, 0}) ///< Handle que não referencia nenhum objeto.
+
+// --- SEÇÃO DE VARIÁVEIS GLOBAIS DE ESTADO (DECLARAÇÕES) ---
+
+extern Object* g_objects;                   ///< O array contíguo (e redimensionável) com todos os objetos da cena.
+extern int g_numObjects;                    ///< O número atual de objetos no array.
+extern int g_selectedObjectIndex;           ///< O objeto principal da seleção: o último selecionado (-1 se nenhum).
+extern int* g_selection;                    ///< Índices em 'g_objects' de todos os objetos selecionados.
+extern int g_numSelected;                   ///< Quantidade de objetos em 'g_selection'.
 
-extern Object g_objects[MAX_OBJECTS];       ///< O array principal que armazena todos os objetos da cena.
-extern int g_numObjects;                    ///< O nmero atual de objetos no array.
-extern int g_selectedObjectIndex;           ///< O ndice do objeto selecionado na lista (-1 se nenhum).
+// Arrays de geometria, um por tipo. O array '...Owners' correspondente guarda,
+// para cada elemento, o índice do objeto dono em 'g_objects'.
+extern Point* g_points;                     ///< Todos os pontos da cena, contíguos.
+extern int* g_pointOwners;                  ///< Índice em 'g_objects' do dono de cada ponto.
+extern int g_numPoints;                     ///< Quantidade de pontos em 'g_points'.
 
-// --- SEO DE PROTTIPOS DE FUNES PBLICAS ---
+extern Segment* g_segments;                 ///< Todos os segmentos da cena, contíguos.
+extern int* g_segmentOwners;                ///< Índice em 'g_objects' do dono de cada segmento.
+extern int g_numSegments;                   ///< Quantidade de segmentos em 'g_segments'.
+
+extern GfxPolygon* g_polygons;              ///< Todos os polígonos da cena, contíguos.
+extern int* g_polygonOwners;                ///< Índice em 'g_objects' do dono de cada polígono.
+extern int g_numPolygons;                   ///< Quantidade de polígonos em 'g_polygons'.
+
+// --- SEÇÃO DE PROTÓTIPOS DE FUNÇÕES PÚBLICAS ---
 
 void initObjectList();
-void addObject(ObjectType type, void* data);
 void removeObject(int index);
 void clearAllObjects();
-void drawAllObjects();
+
+/**
+ * @brief Desenha o destaque do objeto selecionado e a pré-visualização dos objetos em criação.
+ *
+ * Chamada pelo renderizador depois do desenho em lote da cena.
+ */
+void drawObjectOverlays();
+
+/**
+ * @brief Adiciona um ponto à cena, copiando-o para o array de pontos.
+ * @param p O ponto a ser adicionado.
+ * @return ObjectHandle O handle do novo objeto, ou OBJECT_HANDLE_NONE em caso de falha.
+ */
+ObjectHandle addPointObject(Point p);
+
+/**
+ * @brief Adiciona um segmento à cena, copiando-o para o array de segmentos.
+ * @param s O segmento a ser adicionado.
+ * @return ObjectHandle O handle do novo objeto, ou OBJECT_HANDLE_NONE em caso de falha.
+ */
+ObjectHandle addSegmentObject(Segment s);
+
+/**
+ * @brief Adiciona um polígono à cena, copiando-o para o array de polígonos.
+ *
+ * A cena passa a ser dona do bloco de vértices do polígono, que não deve mais
+ * ser liberado pelo chamador (mesmo em caso de falha).
+ * @param poly Ponteiro para o polígono a ser copiado.
+ * @return ObjectHandle O handle do novo objeto, ou OBJECT_HANDLE_NONE em caso de falha.
+ */
+ObjectHandle addPolygonObject(const GfxPolygon* poly);
+
+/**
+ * @brief Garante espaço para pelo menos 'capacity' objetos sem novas realocações.
+ *
+ * Útil antes de inserções em massa (ex: carregamento de cenas grandes). O
+ * estado de animação (g_anim) cresce junto.
+ * @param capacity O número mínimo de objetos que a lista deve comportar.
+ * @return int 1 em caso de sucesso, 0 se faltou memória (a capacidade não muda).
+ */
+int reserveObjects(int capacity);
+
+/**
+ * @brief Retorna o handle estável do objeto que está no índice informado.
+ * @param index O índice do objeto em 'g_objects'.
+ * @return ObjectHandle O handle do objeto, ou OBJECT_HANDLE_NONE se o índice for inválido.
+ */
+ObjectHandle getObjectHandle(int index);
+
+/**
+ * @brief Converte um handle no índice atual do objeto em 'g_objects'.
+ * @param handle O handle obtido na criação do objeto ou em getObjectHandle().
+ * @return int O índice atual do objeto, ou -1 se ele já foi removido.
+ */
+int resolveObjectHandle(ObjectHandle handle);
+
+/**
+ * @brief Retorna o índice atual do objeto dono de uma entrada da tabela de handles.
+ *
+ * Versão sem checagem de geração, para módulos (como o índice espacial) que
+ * só guardam entradas de objetos vivos.
+ * @param handleId A entrada (Object.handleId) de um objeto existente.
+ * @return int O índice do objeto em 'g_objects'.
+ */
+int resolveHandleId(int handleId);
+
+/**
+ * @brief Avisa a cena de que a geometria de um objeto foi substituída.
+ *
+ * A geometria atual no mundo passa a ser a nova geometria base (com a
+ * transformação identidade), a caixa envolvente é recalculada e as
+ * estruturas derivadas (como o índice espacial) são sincronizadas. Deve ser
+ * chamada após qualquer escrita direta nos vértices (ex: o fecho convexo).
+ * @param index O índice do objeto em 'g_objects'.
+ */
+void objectGeometryChanged(int index);
+
+/**
+ * @brief Compõe uma transformação à transformação acumulada do objeto, em O(1).
+ *
+ * Os vértices no mundo não são tocados: o objeto entra na fila de pendentes e
+ * o cache é refeito, a partir da geometria base, no próximo flush. Até lá, a
+ * geometria e a caixa envolvente do objeto estão desatualizadas.
+ * @param index O índice do objeto em 'g_objects'.
+ * @param matrix A transformação, aplicada depois das já acumuladas.
+ */
+void objectApplyTransform(int index, const Matrix3x3* matrix);
+
+/**
+ * @brief Substitui a transformação acumulada de um objeto, sem registrá-la no diário.
+ *
+ * Usada pela recuperação do diário para devolver um objeto animado à posição
+ * registrada. Como em objectApplyTransform(), o cache no mundo é refeito no
+ * próximo flush. Um polígono sem cópia base não é alterado.
+ * @param index O índice do objeto em 'g_objects'.
+ * @param matrix A nova transformação acumulada.
+ */
+void objectSetTransform(int index, const Matrix3x3* matrix);
+
+/**
+ * @brief Retorna os vértices da geometria base de um objeto, antes da transformação acumulada.
+ *
+ * Um polígono sem cópia base (por falta de memória) tem sempre a transformação
+ * identidade; nesse caso, os vértices retornados são os do mundo.
+ * @param index O índice do objeto em 'g_objects'.
+ * @param count Recebe a quantidade de vértices (1 para pontos e 2 para segmentos).
+ * @return const Point* Os vértices, válidos até a próxima mudança na cena.
+ */
+const Point* getObjectBaseVertices(int index, int* count);
+
+/**
+ * @brief Refaz o cache no mundo de todos os objetos com transformação pendente.
+ *
+ * Deve ser chamada antes de ler vértices ou caixas envolventes da cena
+ * (desenho, seleção, fecho convexo, salvamento, passo da animação).
+ */
+void objectsFlushTransforms(void);
+
+/**
+ * @brief Refaz o cache no mundo de um único objeto, se a sua transformação estiver pendente.
+ * @param index O índice do objeto em 'g_objects'.
+ */
+void objectFlushTransform(int index);
+
+/**
+ * @brief Versão de objectGeometryChanged() para translações puras.
+ *
+ * A caixa envolvente em cache é apenas deslocada, em O(1), sem percorrer os vértices.
+ * @param index O índice do objeto em 'g_objects'.
+ * @param dx O deslocamento aplicado no eixo X.
+ * @param dy O deslocamento aplicado no eixo Y.
+ */
+void objectTranslated(int index, float dx, float dy);
+
+/**
+ * @brief Desloca apenas a caixa envolvente em cache, sem avisar as estruturas derivadas.
+ *
+ * Não toca em nada compartilhado entre objetos, então pode ser chamada em
+ * paralelo para objetos diferentes. O chamador deve chamar objectCommitMove()
+ * depois, fora da região paralela.
+ * @param index O índice do objeto em 'g_objects'.
+ * @param dx O deslocamento aplicado no eixo X.
+ * @param dy O deslocamento aplicado no eixo Y.
+ */
+void objectShiftBounds(int index, float dx, float dy);
+
+/**
+ * @brief Sincroniza o índice espacial e o renderizador com a caixa em cache de um objeto.
+ *
+ * Completa um ou mais objectShiftBounds() feitos sobre o mesmo objeto.
+ * @param index O índice do objeto em 'g_objects'.
+ */
+void objectCommitMove(int index);
+
+// --- SEÇÃO DE SELEÇÃO ---
+// A seleção é um conjunto de objetos. 'g_selectedObjectIndex' é sempre um
+// membro do conjunto (ou -1 com o conjunto vazio) e é o alvo das operações
+// que atuam sobre um único objeto, como o fecho convexo e a animação.
+
+/**
+ * @brief Esvazia a seleção.
+ */
+void selectionClear(void);
+
+/**
+ * @brief Acrescenta um objeto à seleção e o torna o objeto principal.
+ * @param index O índice do objeto em 'g_objects'.
+ */
+void selectionAdd(int index);
+
+/**
+ * @brief Retira um objeto da seleção, se ele estiver nela.
+ *
+ * Se ele era o objeto principal, o último objeto que restou na seleção assume o seu lugar.
+ * @param index O índice do objeto em 'g_objects'.
+ */
+void selectionRemove(int index);
+
+/**
+ * @brief Acrescenta o objeto à seleção se ele não estiver nela; caso contrário, o retira.
+ * @param index O índice do objeto em 'g_objects'.
+ */
+void selectionToggle(int index);
+
+/**
+ * @brief Substitui a seleção por um único objeto.
+ * @param index O índice do objeto em 'g_objects' (-1 apenas esvazia a seleção).
+ */
+void selectSingleObject(int index);
+
+static inline int isObjectSelected(int index) {
+    return g_objects[index].selectionSlot != -1;
+}
+
+// --- SEÇÃO DE ACESSO À GEOMETRIA ---
+// O chamador deve conferir o tipo do objeto antes de usar o acessor correspondente.
+// Os ponteiros retornados deixam de ser válidos após qualquer inserção ou remoção.
+
+static inline Point* getObjectPoint(int index) {
+    return &g_points[g_objects[index].slot];
+}
+
+static inline Segment* getObjectSegment(int index) {
+    return &g_segments[g_objects[index].slot];
+}
+
+static inline GfxPolygon* getObjectPolygon(int index) {
+    return &g_polygons[g_objects[index].slot];
+}
+
+static inline BoundingBox getObjectBounds(int index) {
+    return g_objects[index].bounds;
+}
 
 #endif // OBJECTS_H
@@ -1,9 +1,9 @@
 /**
  * @file point.c
- * @brief Implementao das funes para criar, desenhar e liberar objetos do tipo Ponto.
+ * @brief Implementação das funções para criar, desenhar e liberar objetos do tipo Ponto.
  *
- * Este mdulo gerencia todas as operaes de baixo nvel para a primitiva
- * geomtrica "Ponto".
+ * Este módulo gerencia todas as operações de baixo nível para a primitiva
+ * geométrica "Ponto".
  */
 
 #include <GL/glut.h>
@@ -11,7 +11,7 @@
 #include "point.h"
 #include "config.h"
 
-// --- SEO DE FUNES PBLICAS ---
+// --- SEÇÃO DE FUNÇÕES PÚBLICAS ---
 
 Point createPoint(float x, float y) {
     Point p = {x, y};
@@ -19,26 +19,26 @@ Point createPoint(float x, float y) {
 }
 
 void drawPoint(Point* p, int is_selected) {
-    // Define a cor do ponto com base no estado de seleo.
+    // Define a cor do ponto com base no estado de seleção.
     if (is_selected) {
         glColor3f(1.0f, 0.0f, 0.0f); // Vermelho se selecionado.
     } else {
-        glColor3f(0.0f, 0.0f, 1.0f); // Azul se no selecionado.
+        glColor3f(0.0f, 0.0f, 1.0f); // Azul se não selecionado.
     }
 
-    // Aumenta o tamanho do ponto para torn-lo mais visvel e fcil de selecionar.
+    // Aumenta o tamanho do ponto para torná-lo mais visível e fácil de selecionar.
     glPointSize(CLICK_TOLERANCE / 1.3f);
 
     glBegin(GL_POINTS);
         glVertex2f(p->x, p->y);
     glEnd();
 
-    // Reseta o tamanho do ponto para o padro.
+    // Reseta o tamanho do ponto para o padrão.
     glPointSize(1.0f);
 }
 
 void freePoint(Point* p) {
-    // A estrutura 'Point' no possui alocao de memria dinmica interna.
-    // Esta funo existe para manter uma API consistente com o mdulo 'objects',
-    // que chama uma funo de liberao para cada tipo de objeto.
+    // A estrutura 'Point' não possui alocação de memória dinâmica interna.
+    // Esta função existe para manter uma API consistente com o módulo 'objects',
+    // que chama uma função de liberação para cada tipo de objeto.
 }
@@ -2,14 +2,14 @@
  * @file point.h
  * @brief Define a estrutura de dados e a interface para o objeto Ponto.
  *
- * O Ponto  a primitiva geomtrica mais fundamental do projeto e serve como
- * base para a criao de outros objetos, como segmentos e polgonos.
+ * O Ponto é a primitiva geométrica mais fundamental do projeto e serve como
+ * base para a criação de outros objetos, como segmentos e polígonos.
  */
 
 #ifndef POINT_H
 #define POINT_H
 
-// --- SEO DE ESTRUTURAS E TIPOS ---
+// --- SEÇÃO DE ESTRUTURAS E TIPOS ---
 
 /**
  * @brief Estrutura para representar um ponto 2D.
@@ -20,7 +20,7 @@ typedef struct {
 } Point;
 
 
-// --- SEO DE PROTTIPOS DE FUNES PBLICAS ---
+// --- SEÇÃO DE PROTÓTIPOS DE FUNÇÕES PÚBLICAS ---
 
 /**
  * @brief Cria e inicializa uma estrutura Point com as coordenadas fornecidas.
@@ -33,17 +33,17 @@ Point createPoint(float x, float y);
 /**
  * @brief Desenha um ponto na tela usando as primitivas do OpenGL.
  *
- * A cor do ponto muda dependendo de seu estado de seleo.
+ * A cor do ponto muda dependendo de seu estado de seleção.
  * @param p Ponteiro para a estrutura Point a ser desenhada.
- * @param is_selected Flag (1 ou 0) que indica se o ponto est selecionado.
+ * @param is_selected Flag (1 ou 0) que indica se o ponto está selecionado.
  */
 void drawPoint(Point* p, int is_selected);
 
 /**
- * @brief Libera a memria interna de um Ponto, se houver.
+ * @brief Libera a memória interna de um Ponto, se houver.
  *
- * Esta funo  mantida para consistncia com a API de gerenciamento de objetos,
- * mesmo que a estrutura Point no exija liberao de memria interna.
+ * Esta função é mantida para consistência com a API de gerenciamento de objetos,
+ * mesmo que a estrutura Point não exija liberação de memória interna.
  * @param p Ponteiro para a estrutura Point.
  */
 void freePoint(Point* p);
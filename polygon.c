@@ -1,10 +1,10 @@
 /**
  * @file polygon.c
- * @brief Implementao das funes para criar, adicionar vrtices, desenhar e
- * liberar objetos do tipo Polgono.
+ * @brief Implementação das funções para criar, adicionar vértices, desenhar e
+ * liberar objetos do tipo Polígono.
  *
- * Este mdulo gerencia as operaes de baixo nvel para a primitiva
- * geomtrica "Polgono".
+ * Este módulo gerencia as operações de baixo nível para a primitiva
+ * geométrica "Polígono".
  */
 
 #include <GL/glut.h>
@@ -14,35 +14,60 @@
 #include "point.h"
 #include "config.h"
 #include "utils.h"
-#include "objects.h" // Necessrio para OBJECT_TYPE_POLYGON
+#include "objects.h" // Necessário para OBJECT_TYPE_POLYGON
+#include "vertexpool.h"
+#include <string.h>
 
-// --- SEO DE FUNES PBLICAS ---
+// --- SEÇÃO DE FUNÇÕES PÚBLICAS ---
 
 GfxPolygon createPolygon() {
     GfxPolygon poly;
+    poly.vertices = NULL;
     poly.numVertices = 0;
+    poly.capacity = 0;
+    return poly;
+}
+
+GfxPolygon createPolygonFromVertices(const Point* vertices, int count) {
+    GfxPolygon poly = createPolygon();
+    poly.vertices = vertexPoolAlloc(count, &poly.capacity);
+    if (poly.vertices != NULL) {
+        memcpy(poly.vertices, vertices, count * sizeof(Point));
+        poly.numVertices = count;
+    }
     return poly;
 }
 
 void addVertexToPolygon(GfxPolygon* poly, Point p) {
-    if (poly->numVertices < MAX_POLYGON_VERTICES) {
-        poly->vertices[poly->numVertices] = p;
-        poly->numVertices++;
-    } else {
-        fprintf(stderr, "[GfxPolygon ERROR] Limite mximo de vrtices (%d) atingido.\n", MAX_POLYGON_VERTICES);
+    if (poly->numVertices == poly->capacity) {
+        // Bloco cheio: move os vértices para um bloco da próxima classe de tamanho.
+        int newCapacity;
+        Point* block = vertexPoolAlloc(poly->numVertices + 1, &newCapacity);
+        if (block == NULL) {
+            fprintf(stderr, "[GfxPolygon ERROR] Sem memória para adicionar o vértice %d.\n", poly->numVertices);
+            return;
+        }
+        if (poly->numVertices > 0) {
+            memcpy(block, poly->vertices, poly->numVertices * sizeof(Point));
+        }
+        vertexPoolFree(poly->vertices, poly->capacity);
+        poly->vertices = block;
+        poly->capacity = newCapacity;
     }
+    poly->vertices[poly->numVertices] = p;
+    poly->numVertices++;
 }
 
 void drawPolygon(GfxPolygon* poly, int is_selected) {
     // --- Desenho do Contorno ---
-    // A cor do contorno  definida pelo estado de seleo.
+    // A cor do contorno é definida pelo estado de seleção.
     if (is_selected) {
         glColor3f(1.0f, 0.0f, 0.0f); // Vermelho se selecionado.
     } else {
-        glColor3f(0.0f, 0.0f, 1.0f); // Azul se no selecionado.
+        glColor3f(0.0f, 0.0f, 1.0f); // Azul se não selecionado.
     }
 
-    // A espessura da linha  aumentada para melhor visualizao.
+    // A espessura da linha é aumentada para melhor visualização.
     glLineWidth(2.0f);
 
     if (poly->numVertices >= 2) {
@@ -53,17 +78,17 @@ void drawPolygon(GfxPolygon* poly, int is_selected) {
         }
         glEnd();
     } else if (poly->numVertices == 1) {
-        // Se houver apenas um vrtice, desenha apenas um ponto.
+        // Se houver apenas um vértice, desenha apenas um ponto.
         glBegin(GL_POINTS);
             glVertex2f(poly->vertices[0].x, poly->vertices[0].y);
         glEnd();
     }
 
-    // Reseta a espessura da linha para o padro.
+    // Reseta a espessura da linha para o padrão.
     glLineWidth(1.0f);
 
-    // --- Desenho dos Vrtices ---
-    // Desenha os vrtices do polgono para indicar os pontos de controle.
+    // --- Desenho dos Vértices ---
+    // Desenha os vértices do polígono para indicar os pontos de controle.
     glColor3f(0.5f, 0.5f, 0.5f);
     glPointSize(CLICK_TOLERANCE / 2.0f);
     glBegin(GL_POINTS);
@@ -74,9 +99,9 @@ void drawPolygon(GfxPolygon* poly, int is_selected) {
     glPointSize(1.0f);
 
 //    // --- Desenho do Centroide (Ponto Central) ---
-//    // Desenha um ponto para indicar o centro de rotao/escala do polgono.
+//    // Desenha um ponto para indicar o centro de rotação/escala do polígono.
 //    if (poly->numVertices > 0) {
-//        // Cria um objeto temporrio para chamar a funo genrica getObjectCenter.
+//        // Cria um objeto temporário para chamar a função genérica getObjectCenter.
 //        Object tempObj;
 //        tempObj.type = OBJECT_TYPE_POLYGON;
 //        tempObj.data = poly;
@@ -95,8 +120,8 @@ void drawPolygon(GfxPolygon* poly, int is_selected) {
 }
 
 void freePolygon(GfxPolygon* poly) {
-    // A struct 'GfxPolygon' usa um array de tamanho fixo para os vrtices.
-    // Portanto, no h memria alocada dinamicamente para ser liberada aqui.
-    // A funo existe para manter a consistncia com a API do 'objects' e garantir
-    // que a chamada 'free(obj->data)' em objects.c seja segura.
+    // Os vértices pertencem ao pool compartilhado; o bloco volta para a lista
+    // livre da sua classe de tamanho para ser reaproveitado por outro polígono.
+    vertexPoolFree(poly->vertices, poly->capacity);
+    *poly = createPolygon();
 }
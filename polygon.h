@@ -1,9 +1,9 @@
 /**
  * @file polygon.h
- * @brief Define a estrutura de dados e a interface para o objeto Polgono.
+ * @brief Define a estrutura de dados e a interface para o objeto Polígono.
  *
- * Um polgono  um objeto interativo, construdo por uma sequncia de
- * vrtices e renderizado como uma forma fechada.
+ * Um polígono é um objeto interativo, construído por uma sequência de
+ * vértices e renderizado como uma forma fechada.
  */
 
 #ifndef POLYGON_H
@@ -12,47 +12,61 @@
 #include "point.h"
 #include "config.h"
 
-// --- SEO DE ESTRUTURAS E TIPOS ---
+// --- SEÇÃO DE ESTRUTURAS E TIPOS ---
 
 /**
- * @brief Estrutura para representar um polgono 2D.
+ * @brief Estrutura para representar um polígono 2D.
  *
- * Utiliza um array de tamanho fixo para armazenar os vrtices.
+ * Os vértices ficam em um bloco do pool compartilhado (vertexpool.h) do
+ * tamanho do polígono, que cresce conforme necessário. A struct é dona do
+ * bloco: copiá-la transfere a posse, e freePolygon() o devolve ao pool.
  */
 typedef struct {
-    Point vertices[MAX_POLYGON_VERTICES];   ///< Array que armazena os vrtices do polgono.
-    int numVertices;                        ///< Contador do nmero atual de vrtices.
+    Point* vertices;                        ///< Bloco do pool que armazena os vértices do polígono.
+    int numVertices;                        ///< Contador do número atual de vértices.
+    int capacity;                           ///< Quantidade de vértices que cabem no bloco atual.
 } GfxPolygon;
 
-// --- SEO DE PROTTIPOS DE FUNES PBLICAS ---
+// --- SEÇÃO DE PROTÓTIPOS DE FUNÇÕES PÚBLICAS ---
 
 /**
- * @brief Cria e inicializa uma estrutura de polgono vazia.
+ * @brief Cria e inicializa uma estrutura de polígono vazia.
  * @return GfxPolygon Uma nova estrutura GfxPolygon com numVertices = 0.
  */
 GfxPolygon createPolygon();
 
 /**
- * @brief Adiciona um novo vrtice a um polgono existente.
- * @param poly Ponteiro para o polgono que ser modificado.
- * @param p O Ponto (vrtice) a ser adicionado.
+ * @brief Cria um polígono com uma cópia dos vértices fornecidos.
+ *
+ * Aloca de uma só vez um bloco do tamanho exato necessário no pool.
+ * @param vertices O array de vértices a ser copiado.
+ * @param count A quantidade de vértices no array.
+ * @return GfxPolygon O novo polígono (vazio em caso de falha de alocação).
+ */
+GfxPolygon createPolygonFromVertices(const Point* vertices, int count);
+
+/**
+ * @brief Adiciona um novo vértice a um polígono existente.
+ *
+ * Quando o bloco atual está cheio, os vértices são movidos para um bloco
+ * maior do pool.
+ * @param poly Ponteiro para o polígono que será modificado.
+ * @param p O Ponto (vértice) a ser adicionado.
  */
 void addVertexToPolygon(GfxPolygon* poly, Point p);
 
 /**
- * @brief Desenha um polgono na tela como uma forma fechada.
+ * @brief Desenha um polígono na tela como uma forma fechada.
  *
- * A funo desenha o contorno do polgono e, opcionalmente, os vrtices e
- * o centroide, dependendo da configurao.
- * @param poly Ponteiro para o polgono a ser desenhado.
- * @param is_selected Flag (1 ou 0) que indica se o polgono est selecionado.
+ * A função desenha o contorno do polígono e, opcionalmente, os vértices e
+ * o centroide, dependendo da configuração.
+ * @param poly Ponteiro para o polígono a ser desenhado.
+ * @param is_selected Flag (1 ou 0) que indica se o polígono está selecionado.
  */
 void drawPolygon(GfxPolygon* poly, int is_selected);
 
 /**
- * @brief Libera a memria interna de um Polgono, se houver.
- *
- * Esta funo  mantida para consistncia com a API de gerenciamento de objetos.
+ * @brief Devolve o bloco de vértices do polígono ao pool e o deixa vazio.
  * @param poly Ponteiro para a estrutura GfxPolygon.
  */
 void freePolygon(GfxPolygon* poly);
@@ -0,0 +1,146 @@
+/**
+ * @file predicates.c
+ * @brief Implementação dos predicados geométricos exatos.
+ *
+ * As coordenadas são float, então o produto de duas coordenadas cabe sem
+ * arredondamento em um double (24 + 24 bits de mantissa). O sinal de
+ * (b - a) x (d - c), expandido em oito desses produtos, é calculado
+ * exatamente somando-os em uma expansão (uma soma de doubles que não se
+ * sobrepõem, no estilo de Shewchuk); o sinal da expansão é o do seu
+ * componente de maior magnitude.
+ *
+ * O filtro rápido fica em predicates.h, para ser expandido em linha nos
+ * laços do fecho convexo e da seleção; aqui fica só o caminho exato.
+ */
+
+#include <float.h>
+
+#include "predicates.h"
+
+// --- SEÇÃO DE VARIÁVEIS PRIVADAS ---
+
+// Por thread: um contador atômico custaria mais que o próprio caminho exato.
+static _Thread_local unsigned long long s_exactCount = 0;
+
+// As somas exatas dependem de cada operação ser arredondada para double. Em
+// x87 (ex: MinGW de 32 bits) os intermediários têm mais precisão e precisam
+// passar pela memória.
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD != 0
+#define PREDICATES_ROUNDED volatile
+#else
+#define PREDICATES_ROUNDED
+#endif
+
+// --- SEÇÃO DE FUNÇÕES AUXILIARES (IMPLEMENTAÇÃO PRIVADA) ---
+
+/**
+ * @brief Soma exata de dois doubles: a + b == sum + error, sem arredondamento.
+ */
+static inline void twoSum(double a, double b, double* sum, double* error) {
+    PREDICATES_ROUNDED double s = a + b;
+    PREDICATES_ROUNDED double bVirtual = s - a;
+    PREDICATES_ROUNDED double aVirtual = s - bVirtual;
+    *sum = s;
+    *error = (a - aVirtual) + (b - bVirtual);
+}
+
+/**
+ * @brief Produto exato de dois doubles: a * b == product + error (Dekker, com a divisão de Veltkamp).
+ */
+static inline void twoProduct(double a, double b, double* product, double* error) {
+    PREDICATES_ROUNDED double p = a * b;
+    PREDICATES_ROUNDED double c = 134217729.0 * a; // 2^27 + 1
+    PREDICATES_ROUNDED double aHigh = c - (c - a);
+    double aLow = a - aHigh;
+    c = 134217729.0 * b;
+    PREDICATES_ROUNDED double bHigh = c - (c - b);
+    double bLow = b - bHigh;
+    *product = p;
+    *error = ((aHigh * bHigh - p) + aHigh * bLow + aLow * bHigh) + aLow * bLow;
+}
+
+/**
+ * @brief Indica se a diferença a - b de dois floats é exata em double.
+ */
+static inline int exactDifference(float a, float b, double difference) {
+    return difference + b == (double)a && (double)a - difference == (double)b;
+}
+
+/**
+ * @brief Sinal exato de uma soma de doubles.
+ *
+ * Cada termo é acrescentado a uma expansão (Shewchuk, "Grow-Expansion");
+ * os componentes ficam em ordem crescente de magnitude, sem se sobrepor.
+ */
+static int exactSumSign(const double* terms, int count) {
+    double expansion[8];
+    int length = 0;
+    for (int t = 0; t < count; t++) {
+        double q = terms[t];
+        for (int i = 0; i < length; i++) {
+            double sum, error;
+            twoSum(q, expansion[i], &sum, &error);
+            expansion[i] = error;
+            q = sum;
+        }
+        expansion[length++] = q;
+    }
+    for (int i = length - 1; i >= 0; i--) {
+        if (expansion[i] > 0.0) return 1;
+        if (expansion[i] < 0.0) return -1;
+    }
+    return 0;
+}
+
+// --- SEÇÃO DE FUNÇÕES PÚBLICAS ---
+
+int crossDiffSignExact(Point a, Point b, Point c, Point d) {
+    s_exactCount++;
+
+    // Caso comum (coordenadas próximas, ex: uma grade): as quatro diferenças
+    // são exatas e basta somar os dois produtos, cada um dividido em duas partes.
+    double abx = (double)b.x - a.x, aby = (double)b.y - a.y;
+    double cdx = (double)d.x - c.x, cdy = (double)d.y - c.y;
+    if (exactDifference(b.x, a.x, abx) && exactDifference(b.y, a.y, aby) &&
+        exactDifference(d.x, c.x, cdx) && exactDifference(d.y, c.y, cdy)) {
+        double parts[4];
+        twoProduct(abx, cdy, &parts[1], &parts[0]);
+        twoProduct(-aby, cdx, &parts[3], &parts[2]);
+        return exactSumSign(parts, 4);
+    }
+
+    // Caso geral: os oito produtos de coordenadas, todos exatos em double.
+    double terms[8] = {
+        (double)b.x * d.y, -(double)b.x * c.y, -(double)a.x * d.y, (double)a.x * c.y,
+        -(double)b.y * d.x, (double)b.y * c.x, (double)a.y * d.x, -(double)a.y * c.x
+    };
+    return exactSumSign(terms, 8);
+}
+
+PointLocation pointInPolygon(Point p, const Point* vertices, int count) {
+    int inside = 0;
+    for (int i = 0, j = count - 1; i < count; j = i++) {
+        Point a = vertices[j];
+        Point b = vertices[i];
+        // Arestas que não alcançam a altura do ponto não cruzam o raio nem contêm o ponto.
+        if ((p.y < a.y && p.y < b.y) || (p.y > a.y && p.y > b.y)) continue;
+        // Arestas inteiramente à esquerda do ponto não cruzam o raio (que vai para a direita).
+        if (p.x > a.x && p.x > b.x) continue;
+
+        int o = orient2d(a, b, p);
+        if (o == 0 && (p.x >= a.x || p.x >= b.x)) {
+            return POINT_ON_BOUNDARY; // Colinear e dentro da caixa da aresta.
+        }
+        // Regra semiaberta: um vértice na altura do ponto conta como abaixo
+        // dele, então cada cruzamento é contado exatamente uma vez.
+        if ((a.y > p.y) != (b.y > p.y)) {
+            // O cruzamento está à direita se o ponto fica à esquerda da aresta orientada para cima.
+            if ((o > 0) == (b.y > a.y)) inside = !inside;
+        }
+    }
+    return inside ? POINT_INSIDE : POINT_OUTSIDE;
+}
+
+unsigned long long predicatesExactCount(void) {
+    return s_exactCount;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file predicates.h
+ * @brief Define a interface dos predicados geométricos exatos (orientação e ponto-em-polígono).
+ *
+ * Os predicados respondem a perguntas de sinal ("o ponto está à esquerda da
+ * reta?") sempre corretamente, mesmo com pontos quase colineares ou
+ * alinhados em grade. Cada um calcula primeiro uma aproximação em ponto
+ * flutuante junto com um limite para o seu erro; só quando o resultado fica
+ * dentro desse limite (o sinal pode estar errado) o cálculo é refeito em
+ * aritmética exata, o que é raro em cenas comuns.
+ *
+ * Devem ser usados por qualquer código que decida topologia (fecho convexo,
+ * seleção, operações futuras com polígonos) em vez de comparar com zero o
+ * resultado de um cálculo em float.
+ */
+
+#ifndef PREDICATES_H
+#define PREDICATES_H
+
+#include <math.h>
+
+#include "point.h"
+
+/// Limite relativo do erro do determinante calculado em double (Shewchuk,
+/// "ccwerrboundA"): (3 + 16e) * e, com e = 2^-53.
+#define PREDICATES_CROSS_ERROR_BOUND ((3.0 + 16.0 * 1.1102230246251565e-16) * 1.1102230246251565e-16)
+
+/**
+ * @brief Posição de um ponto em relação a um polígono.
+ */
+typedef enum {
+    POINT_OUTSIDE = 0,      ///< Fora do polígono.
+    POINT_INSIDE,           ///< Estritamente dentro.
+    POINT_ON_BOUNDARY       ///< Sobre uma aresta ou um vértice.
+} PointLocation;
+
+// --- SEÇÃO DE PROTÓTIPOS DE FUNÇÕES PÚBLICAS ---
+
+/**
+ * @brief Caminho exato de crossDiffSign(), chamado quando o filtro não decide o sinal.
+ */
+int crossDiffSignExact(Point a, Point b, Point c, Point d);
+
+/**
+ * @brief Localiza um ponto em relação a um polígono simples ou não (regra par-ímpar).
+ *
+ * Pontos sobre as arestas ou os vértices são reconhecidos exatamente; o
+ * teste não divide e não perde os vértices que ficam na mesma altura do ponto.
+ * @param p O ponto de teste.
+ * @param vertices Os vértices do polígono, em qualquer sentido.
+ * @param count A quantidade de vértices.
+ * @return PointLocation A posição do ponto.
+ */
+PointLocation pointInPolygon(Point p, const Point* vertices, int count);
+
+/**
+ * @brief Retorna quantas vezes os predicados precisaram do cálculo exato na thread que chama (para benchmarks).
+ */
+unsigned long long predicatesExactCount(void);
+
+// --- SEÇÃO DE FUNÇÕES EM LINHA ---
+
+/**
+ * @brief Indica se a diferença 'to - from', calculada em double, é exata e cabe em um float.
+ *
+ * Se não for exata, uma das duas contas de volta é exata (Sterbenz) e acusa a diferença.
+ */
+static inline int predicatesShortDifference(float to, float from, double difference) {
+    return difference + from == (double)to && (double)to - difference == (double)from &&
+           (double)(float)difference == difference;
+}
+
+/**
+ * @brief Sinal exato do produto vetorial (b - a) x (d - c).
+ *
+ * Generaliza orient2d() (que é crossDiffSign(a, b, a, c)) e compara, sem
+ * erro, a distância de dois pontos a uma reta: x está mais à direita de
+ * p->q do que y se crossDiffSign(p, q, y, x) < 0.
+ *
+ * A conta é feita em double (os produtos de coordenadas float são exatos)
+ * e só vai para crossDiffSignExact() se |det| não passar do limite de erro
+ * e as diferenças não forem curtas o bastante para os produtos serem exatos.
+ * @return int 1, -1 ou 0, conforme o sinal.
+ */
+static inline int crossDiffSign(Point a, Point b, Point c, Point d) {
+    double abx = (double)b.x - a.x, aby = (double)b.y - a.y;
+    double cdx = (double)d.x - c.x, cdy = (double)d.y - c.y;
+    double left = abx * cdy;
+    double right = aby * cdx;
+    double det = left - right;
+    // Com 'left' e 'right' de sinais opostos, |det| = |left| + |right| e o
+    // teste sempre passa; ambos nulos dão det == 0 exato.
+    double bound = PREDICATES_CROSS_ERROR_BOUND * (fabs(left) + fabs(right));
+    if (fabs(det) > bound || bound == 0.0) {
+        return (det > 0.0) - (det < 0.0);
+    }
+    // Diferenças exatas que cabem em float (pontos colineares em uma grade,
+    // por exemplo): os dois produtos têm no máximo 48 bits, são exatos, e o
+    // sinal sai da comparação entre eles.
+    if (predicatesShortDifference(b.x, a.x, abx) && predicatesShortDifference(b.y, a.y, aby) &&
+        predicatesShortDifference(d.x, c.x, cdx) && predicatesShortDifference(d.y, c.y, cdy)) {
+        return (left > right) - (left < right);
+    }
+    return crossDiffSignExact(a, b, c, d);
+}
+
+/**
+ * @brief Orientação exata do trio (a, b, c).
+ * @return int 1 se c está à esquerda de a->b (sentido anti-horário), -1 se
+ *         está à direita (horário) e 0 se os três pontos são colineares.
+ */
+static inline int orient2d(Point a, Point b, Point c) {
+    return crossDiffSign(a, b, a, c);
+}
+
+#endif // PREDICATES_H
@@ -0,0 +1,274 @@
+/**
+ * @file profiler.c
+ * @brief Implementação do medidor de tempo: buffers circulares por thread, resumo por quadro e trace.
+ *
+ * Cada thread registra o seu buffer na primeira medição e o devolve ao
+ * terminar (profilerThreadExit()); um buffer devolvido é reaproveitado pela
+ * próxima thread que precisar de um, então as PROFILER_MAX_THREADS vagas
+ * limitam as threads vivas ao mesmo tempo, e não as da sessão. Só a dona escreve
+ * no buffer; o contador de eventos é publicado depois do evento, então quem
+ * lê (o painel e a exportação, na thread principal) vê eventos completos.
+ * Um evento que a dona sobrescreve durante uma exportação pode sair
+ * misturado; por isso a exportação desliga as medições enquanto grava.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "profiler.h"
+#include "config.h"
+
+// --- SEÇÃO DE ESTRUTURAS PRIVADAS ---
+
+/**
+ * @brief Um trecho medido.
+ */
+typedef struct {
+    double start, end;      ///< Instantes de jobsWallTime(), em segundos.
+    int zone;
+} ProfileEvent;
+
+/**
+ * @brief O buffer circular de uma thread.
+ */
+typedef struct {
+    ProfileEvent* events;                           ///< PROFILER_RING_EVENTS eventos.
+    atomic_ullong count;                            ///< Eventos gravados desde o início (o buffer guarda os últimos).
+    atomic_ullong zoneNs[PROFILE_NUM_ZONES];        ///< Tempo total de cada zona, em nanossegundos.
+    atomic_int owned;                               ///< 1 enquanto uma thread viva usa o buffer.
+} ProfileRing;
+
+// --- SEÇÃO DE VARIÁVEIS GLOBAIS E PRIVADAS ---
+
+atomic_int g_profilerEnabled = 0;
+
+static _Atomic(ProfileRing*) s_rings[PROFILER_MAX_THREADS];
+static atomic_int s_numRings = 0;
+static _Thread_local ProfileRing* s_threadRing = NULL;
+static _Thread_local int s_threadRingFailed = 0;    ///< 1 se a thread não conseguiu um buffer (não mede).
+
+static double s_epoch = 0.0;                        ///< O instante zero do trace: a primeira vez que as medições foram ligadas.
+
+// O resumo do painel, mantido pela thread principal.
+static double s_frameMs[PROFILER_FRAME_HISTORY];
+static int s_numFrames = 0;
+static int s_frameCursor = 0;
+static unsigned long long s_lastZoneNs[PROFILE_NUM_ZONES];
+static double s_zoneMs[PROFILE_NUM_ZONES];
+
+static const char* s_zoneNames[PROFILE_NUM_ZONES] = {
+    "frame", "anim_step", "draw", "select", "transform", "flush", "hull", "scene_read", "scene_write"
+};
+
+// --- SEÇÃO DE FUNÇÕES AUXILIARES ---
+
+/**
+ * @brief Retorna o buffer de uma vaga, ou NULL se ela ainda não foi ocupada.
+ */
+static ProfileRing* ringAt(int slot) {
+    return atomic_load_explicit(&s_rings[slot], memory_order_acquire);
+}
+
+static int registeredRings(void) {
+    int count = atomic_load(&s_numRings);
+    return count < PROFILER_MAX_THREADS ? count : PROFILER_MAX_THREADS;
+}
+
+/**
+ * @brief Retorna o buffer da thread atual, registrando um na primeira chamada.
+ * @return ProfileRing* O buffer, ou NULL se acabaram as vagas ou a memória.
+ */
+static ProfileRing* threadRing(void) {
+    if (s_threadRing || s_threadRingFailed) return s_threadRing;
+
+    // Primeiro tenta um buffer devolvido por uma thread que já terminou.
+    int numRings = registeredRings();
+    for (int r = 0; r < numRings; r++) {
+        ProfileRing* ring = ringAt(r);
+        int expected = 0;
+        if (ring && atomic_compare_exchange_strong(&ring->owned, &expected, 1)) {
+            s_threadRing = ring;
+            return ring;
+        }
+    }
+
+    s_threadRingFailed = 1;
+    int slot = atomic_fetch_add(&s_numRings, 1);
+    if (slot >= PROFILER_MAX_THREADS) {
+        // Vagas esgotadas: há PROFILER_MAX_THREADS threads medindo ao mesmo tempo.
+        return NULL;
+    }
+    ProfileRing* ring = (ProfileRing*)calloc(1, sizeof(ProfileRing));
+    ProfileEvent* events = (ProfileEvent*)malloc(PROFILER_RING_EVENTS * sizeof(ProfileEvent));
+    if (!ring || !events) {
+        free(ring);
+        free(events);
+        fprintf(stderr, "[Profiler ERROR] Memória insuficiente para o buffer de uma thread; ela não será medida.\n");
+        return NULL;
+    }
+    ring->events = events;
+    atomic_init(&ring->owned, 1);
+    atomic_store_explicit(&s_rings[slot], ring, memory_order_release);
+    s_threadRing = ring;
+    s_threadRingFailed = 0;
+    return ring;
+}
+
+/**
+ * @brief Soma o tempo de cada zona entre todas as threads.
+ */
+static void sumZoneTimes(unsigned long long totals[PROFILE_NUM_ZONES]) {
+    memset(totals, 0, PROFILE_NUM_ZONES * sizeof(unsigned long long));
+    int numRings = registeredRings();
+    for (int r = 0; r < numRings; r++) {
+        ProfileRing* ring = ringAt(r);
+        if (!ring) continue;
+        for (int z = 0; z < PROFILE_NUM_ZONES; z++) {
+            totals[z] += atomic_load_explicit(&ring->zoneNs[z], memory_order_relaxed);
+        }
+    }
+}
+
+static int compareDoubles(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// --- SEÇÃO DE FUNÇÕES PÚBLICAS ---
+
+void profileRecord(ProfileZone zone, double start, double end) {
+    ProfileRing* ring = threadRing();
+    if (!ring) return;
+
+    unsigned long long n = atomic_load_explicit(&ring->count, memory_order_relaxed);
+    ProfileEvent* event = &ring->events[n & (PROFILER_RING_EVENTS - 1)];
+    event->start = start;
+    event->end = end;
+    event->zone = zone;
+    atomic_store_explicit(&ring->count, n + 1, memory_order_release);
+
+    // Só a dona escreve no total, então não é preciso uma soma atômica.
+    unsigned long long ns = (unsigned long long)((end - start) * 1e9);
+    atomic_store_explicit(&ring->zoneNs[zone],
+                          atomic_load_explicit(&ring->zoneNs[zone], memory_order_relaxed) + ns,
+                          memory_order_relaxed);
+}
+
+void profilerThreadExit(void) {
+    if (s_threadRing) {
+        atomic_store(&s_threadRing->owned, 0);
+        s_threadRing = NULL;
+    }
+    s_threadRingFailed = 0;
+}
+
+void profilerSetEnabled(int enabled) {
+    if (enabled && !atomic_load(&g_profilerEnabled)) {
+        threadRing(); // A thread que liga fica com a primeira vaga.
+        if (s_epoch == 0.0) s_epoch = jobsWallTime();
+        // O resumo recomeça do zero a cada vez que as medições são ligadas.
+        s_numFrames = s_frameCursor = 0;
+        sumZoneTimes(s_lastZoneNs);
+        memset(s_zoneMs, 0, sizeof(s_zoneMs));
+    }
+    atomic_store(&g_profilerEnabled, enabled ? 1 : 0);
+}
+
+void profilerFrameEnd(double start) {
+    if (start <= 0.0) return;
+    double end = jobsWallTime();
+    profileRecord(PROFILE_FRAME, start, end);
+
+    s_frameMs[s_frameCursor] = (end - start) * 1000.0;
+    s_frameCursor = (s_frameCursor + 1) % PROFILER_FRAME_HISTORY;
+    if (s_numFrames < PROFILER_FRAME_HISTORY) s_numFrames++;
+
+    // O tempo de cada zona desde o quadro anterior, suavizado ao longo dos quadros.
+    unsigned long long totals[PROFILE_NUM_ZONES];
+    sumZoneTimes(totals);
+    for (int z = 0; z < PROFILE_NUM_ZONES; z++) {
+        double ms = (double)(totals[z] - s_lastZoneNs[z]) * 1e-6;
+        s_zoneMs[z] = s_numFrames == 1 ? ms : 0.9 * s_zoneMs[z] + 0.1 * ms;
+        s_lastZoneNs[z] = totals[z];
+    }
+}
+
+void profilerGetStats(ProfileStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->numFrames = s_numFrames;
+    memcpy(stats->zoneMs, s_zoneMs, sizeof(s_zoneMs));
+    if (s_numFrames == 0) return;
+
+    int last = (s_frameCursor + PROFILER_FRAME_HISTORY - 1) % PROFILER_FRAME_HISTORY;
+    stats->frameMs = s_frameMs[last];
+    double sorted[PROFILER_FRAME_HISTORY];
+    memcpy(sorted, s_frameMs, s_numFrames * sizeof(double));
+    qsort(sorted, s_numFrames, sizeof(double), compareDoubles);
+    stats->frameP50Ms = sorted[(s_numFrames - 1) * 50 / 100];
+    stats->frameP99Ms = sorted[(s_numFrames - 1) * 99 / 100];
+}
+
+const char* profileZoneName(ProfileZone zone) {
+    return (zone >= 0 && zone < PROFILE_NUM_ZONES) ? s_zoneNames[zone] : "desconhecida";
+}
+
+int profilerExportTrace(const char* filename) {
+    FILE* file = fopen(filename, "w");
+    if (!file) {
+        fprintf(stderr, "[Profiler ERROR] Não foi possível abrir '%s' para escrita.\n", filename);
+        return 0;
+    }
+    int wasEnabled = atomic_exchange(&g_profilerEnabled, 0);
+
+    // Formato "JSON Object" do trace do Chrome: eventos completos ("X"), em microssegundos.
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Rabisquim\"}}");
+    unsigned long long numEvents = 0;
+    int numRings = registeredRings();
+    for (int r = 0; r < numRings; r++) {
+        ProfileRing* ring = ringAt(r);
+        if (!ring) continue;
+        if (r == 0) {
+            fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"principal\"}}");
+        } else {
+            fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}", r, r);
+        }
+        unsigned long long count = atomic_load_explicit(&ring->count, memory_order_acquire);
+        unsigned long long first = count > PROFILER_RING_EVENTS ? count - PROFILER_RING_EVENTS : 0;
+        for (unsigned long long i = first; i < count; i++) {
+            const ProfileEvent* event = &ring->events[i & (PROFILER_RING_EVENTS - 1)];
+            fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"rabisquim\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    profileZoneName((ProfileZone)event->zone), r,
+                    (event->start - s_epoch) * 1e6, (event->end - event->start) * 1e6);
+        }
+        numEvents += count - first;
+    }
+    fprintf(file, "\n]}\n");
+
+    atomic_store(&g_profilerEnabled, wasEnabled);
+    int ok = !ferror(file);
+    ok = fclose(file) == 0 && ok;
+    if (!ok) {
+        fprintf(stderr, "[Profiler ERROR] Falha ao gravar o trace '%s'.\n", filename);
+        return 0;
+    }
+    printf("[INFO] Trace com %llu eventos de %d threads gravado em '%s'.\n", numEvents, numRings, filename);
+    return 1;
+}
+
+void profilerShutdown(void) {
+    atomic_store(&g_profilerEnabled, 0);
+    int numRings = registeredRings();
+    for (int r = 0; r < numRings; r++) {
+        ProfileRing* ring = ringAt(r);
+        if (!ring) continue;
+        free(ring->events);
+        free(ring);
+        atomic_store(&s_rings[r], NULL);
+    }
+    atomic_store(&s_numRings, 0);
+    s_threadRing = NULL;
+    s_threadRingFailed = 0;
+}
@@ -0,0 +1,129 @@
+/**
+ * @file profiler.h
+ * @brief Define a interface do medidor de tempo dos trechos críticos (quadro, animação, desenho, E/S...).
+ *
+ * Cada trecho medido fica entre profileBegin() e profileEnd(), que gravam um
+ * evento (zona, início e fim) no buffer circular da thread que o executou;
+ * cada thread tem o seu buffer, então gravar não precisa de trava. Os
+ * buffers guardam os últimos PROFILER_RING_EVENTS eventos de cada thread e
+ * podem ser exportados no formato de trace do Chrome (chrome://tracing,
+ * Perfetto). O tempo por quadro de cada zona e os percentis do quadro
+ * alimentam o painel da janela (F3).
+ *
+ * Desligado (o padrão), cada medição custa a leitura de um inteiro.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdatomic.h>
+
+#include "jobs.h"
+
+// --- SEÇÃO DE ESTRUTURAS E TIPOS ---
+
+/**
+ * @brief Os trechos medidos.
+ */
+typedef enum {
+    PROFILE_FRAME,          ///< Um quadro inteiro da janela (displayCallback).
+    PROFILE_ANIM_STEP,      ///< Um passo fixo da animação (anim_step).
+    PROFILE_DRAW,           ///< O desenho da cena (renderAllObjects).
+    PROFILE_SELECT,         ///< A seleção por clique ou por área.
+    PROFILE_TRANSFORM,      ///< Uma transformação aplicada a um objeto ou à seleção.
+    PROFILE_FLUSH,          ///< A aplicação adiada das transformações aos vértices.
+    PROFILE_HULL,           ///< Um fecho convexo.
+    PROFILE_SCENE_READ,     ///< A leitura de um arquivo de cena.
+    PROFILE_SCENE_WRITE,    ///< A escrita de um arquivo de cena.
+    PROFILE_NUM_ZONES
+} ProfileZone;
+
+/**
+ * @brief O resumo das últimas medições, para o painel.
+ */
+typedef struct {
+    int numFrames;                      ///< Quadros considerados nos percentis (até PROFILER_FRAME_HISTORY).
+    double frameMs;                     ///< A duração do último quadro.
+    double frameP50Ms, frameP99Ms;      ///< Os percentis 50 e 99 da duração dos quadros.
+    double zoneMs[PROFILE_NUM_ZONES];   ///< O tempo médio de cada zona por quadro, somado entre as threads.
+} ProfileStats;
+
+extern atomic_int g_profilerEnabled;    ///< 1 enquanto as medições estão ligadas (use profilerSetEnabled()).
+
+// --- SEÇÃO DE PROTÓTIPOS DE FUNÇÕES PÚBLICAS ---
+
+/**
+ * @brief Grava um evento no buffer da thread que chama (use profileBegin()/profileEnd()).
+ */
+void profileRecord(ProfileZone zone, double start, double end);
+
+/**
+ * @brief Marca o início de um trecho medido.
+ * @return double O instante atual, ou 0 com as medições desligadas.
+ */
+static inline double profileBegin(void) {
+    return atomic_load_explicit(&g_profilerEnabled, memory_order_relaxed) ? jobsWallTime() : 0.0;
+}
+
+/**
+ * @brief Marca o fim de um trecho iniciado por profileBegin().
+ *
+ * Um trecho iniciado com as medições desligadas não é gravado.
+ */
+static inline void profileEnd(ProfileZone zone, double start) {
+    if (start > 0.0) {
+        profileRecord(zone, start, jobsWallTime());
+    }
+}
+
+/**
+ * @brief Devolve a vaga de buffer da thread que chama, para outra thread reaproveitar.
+ *
+ * Chamada por jobs.c no fim de cada thread trabalhadora e de cada tarefa em
+ * segundo plano. Os eventos e os tempos já gravados continuam no buffer; a
+ * próxima thread que ocupar a vaga continua a mesma linha do trace.
+ */
+void profilerThreadExit(void);
+
+/**
+ * @brief Liga ou desliga as medições.
+ *
+ * A thread que liga passa a ser a thread principal do trace. Desligar
+ * mantém os eventos já gravados.
+ */
+void profilerSetEnabled(int enabled);
+
+/**
+ * @brief Fecha um quadro: grava a zona PROFILE_FRAME e atualiza o resumo do painel.
+ *
+ * Chamada pela thread principal no fim de cada quadro.
+ * @param start O valor de profileBegin() no início do quadro.
+ */
+void profilerFrameEnd(double start);
+
+/**
+ * @brief Preenche o resumo das últimas medições.
+ */
+void profilerGetStats(ProfileStats* stats);
+
+/**
+ * @brief Retorna o nome de uma zona (o mesmo usado no trace).
+ */
+const char* profileZoneName(ProfileZone zone);
+
+/**
+ * @brief Grava os eventos de todas as threads em um arquivo JSON no formato de trace do Chrome.
+ *
+ * As medições ficam desligadas durante a gravação.
+ * @return int 1 em caso de sucesso, 0 se o arquivo não pôde ser gravado.
+ */
+int profilerExportTrace(const char* filename);
+
+/**
+ * @brief Libera os buffers de todas as threads.
+ *
+ * Deve ser chamada apenas no encerramento, quando nenhuma outra thread mede.
+ */
+void profilerShutdown(void);
+
+#endif // PROFILER_H
@@ -0,0 +1,672 @@
+/**
+ * @file rasterizer.c
+ * @brief Implementação do rasterizador em software.
+ *
+ * O desenho tem três fases:
+ * 1. Gravação: os lotes de renderSceneWithBackend() viram primitivas com
+ *    os vértices já em pixels. Um polígono é uma única primitiva por lote
+ *    (interior, contorno ou vértices), não uma por aresta.
+ * 2. Distribuição: cada primitiva entra na lista de todos os blocos que a
+ *    sua caixa toca, preservando a ordem de gravação (ordenação por
+ *    contagem em duas passadas).
+ * 3. Desenho: os blocos são independentes e rodam em paralelo; cada um
+ *    limpa a sua área e desenha as suas primitivas em ordem.
+ *
+ * A suavização das bordas é calculada por cobertura: linhas pela distância
+ * do centro do pixel ao segmento, pontos (quadrados, como GL_POINTS) pela
+ * área exata coberta e polígonos por RASTER_POLYGON_SAMPLES subdivisões
+ * de cada linha de pixels, com a cobertura horizontal exata.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "rasterizer.h"
+#include "config.h"
+#include "jobs.h"
+
+// --- SEÇÃO DE CONSTANTES PRIVADAS ---
+
+#define RASTER_POLYGON_SAMPLES 4        ///< Subdivisões verticais de cada linha de pixels no preenchimento.
+#define RASTER_VIEW_MARGIN 0.02f        ///< Margem em volta da cena em rasterFitView(), em fração do tamanho.
+#define RASTER_SOURCE_CACHE 4           ///< Arrays de vértices convertidos lembrados entre lotes.
+
+// --- SEÇÃO DE ESTRUTURAS PRIVADAS ---
+
+/**
+ * @brief Os tipos de primitiva gravados.
+ */
+typedef enum {
+    RASTER_FILL,        ///< Interior de um polígono (regra par-ímpar).
+    RASTER_POLYLINE,    ///< Linhas ligando vértices consecutivos (fechada ou não).
+    RASTER_POINTS       ///< Um quadrado em cada vértice.
+} RasterPrimitiveType;
+
+/**
+ * @brief Uma primitiva em pixels.
+ */
+typedef struct {
+    unsigned char type;         ///< RasterPrimitiveType.
+    unsigned char closed;       ///< Só linhas: 1 liga o último vértice ao primeiro.
+    unsigned char color[4];     ///< RGBA de 8 bits.
+    float halfSize;             ///< Meia espessura da linha ou meio lado do ponto, em pixels.
+    int first, count;           ///< Os vértices em 'RasterContext.vertices'.
+    int x0, y0, x1, y1;         ///< Pixels que a primitiva pode tocar (inclusive), já dentro da imagem.
+} RasterPrimitive;
+
+/**
+ * @brief O estado de um desenho.
+ */
+typedef struct {
+    RasterImage* image;
+    double scale;               ///< Pixels por unidade do mundo.
+    double originX, originY;    ///< Posição em pixels (Y para cima) do canto inferior esquerdo da região.
+    float sizeScale;            ///< Fator das espessuras e tamanhos de ponto.
+    unsigned char backgroundRow[RASTER_TILE_SIZE * 4]; ///< Uma linha de bloco com a cor de fundo.
+
+    Point* vertices;            ///< Vértices de todas as primitivas, em pixels (Y para baixo).
+    int numVertices, vertexCapacity;
+    RasterPrimitive* primitives;
+    int numPrimitives, primitiveCapacity;
+    int maxPolygonVertices;     ///< Maior polígono preenchido (tamanho da lista de cruzamentos).
+
+    // Últimos arrays convertidos, para que interior, contorno e vértices dos
+    // polígonos (o mesmo array de vértices) sejam convertidos uma vez só,
+    // mesmo com os lotes dos polígonos inteiros e dos simplificados alternados.
+    const void* lastSource[RASTER_SOURCE_CACHE];    ///< O array de vértices, ou a lista de polígonos.
+    int lastSourceCount[RASTER_SOURCE_CACHE];       ///< Vértices do array, ou polígonos da lista.
+    int lastFirst[RASTER_SOURCE_CACHE];
+    int nextSourceSlot;
+
+    int tilesX, tilesY;
+    int* binStart;              ///< Início da lista de cada bloco em 'binItems' (tilesX * tilesY + 1).
+    int* binItems;              ///< Índices das primitivas de cada bloco, em ordem.
+    int failed;                 ///< 1 se faltou memória na gravação.
+} RasterContext;
+
+// --- SEÇÃO DE FUNÇÕES AUXILIARES (IMPLEMENTAÇÃO PRIVADA) ---
+
+static unsigned char toByte(float value) {
+    if (!(value > 0.0f)) return 0;
+    if (value >= 1.0f) return 255;
+    return (unsigned char)(value * 255.0f + 0.5f);
+}
+
+static void colorToBytes(RenderColor color, unsigned char* bytes) {
+    bytes[0] = toByte(color.r);
+    bytes[1] = toByte(color.g);
+    bytes[2] = toByte(color.b);
+    bytes[3] = toByte(color.a);
+}
+
+static int clampInt(int value, int low, int high) {
+    return value < low ? low : (value > high ? high : value);
+}
+
+// Sem -ffast-math, fminf()/fmaxf() viram chamadas de função nos laços por pixel.
+static inline float minFloat(float a, float b) { return a < b ? a : b; }
+static inline float maxFloat(float a, float b) { return a > b ? a : b; }
+
+/**
+ * @brief Mistura uma cor sobre um pixel, com a opacidade da cor multiplicada pela cobertura.
+ */
+static inline void blendPixel(unsigned char* dst, const unsigned char* color, float coverage) {
+    int k = (int)(coverage * color[3] * (256.0f / 255.0f) + 0.5f); // De 0 a 256.
+    if (k <= 0) return;
+    if (k >= 256) {
+        dst[0] = color[0];
+        dst[1] = color[1];
+        dst[2] = color[2];
+        return;
+    }
+    for (int c = 0; c < 3; c++) {
+        dst[c] = (unsigned char)((dst[c] * (256 - k) + color[c] * k + 128) >> 8);
+    }
+}
+
+/**
+ * @brief Converte 'count' vértices do mundo para pixels, no fim de 'vertices'.
+ * @return int A posição do primeiro vértice convertido, ou -1 se faltou memória.
+ */
+static int appendVertices(RasterContext* rc, const Point* source, int count) {
+    if (rc->numVertices + count > rc->vertexCapacity) {
+        int newCapacity = rc->vertexCapacity > 0 ? rc->vertexCapacity : 1024;
+        while (newCapacity < rc->numVertices + count) newCapacity *= 2;
+        Point* vertices = (Point*)realloc(rc->vertices, (size_t)newCapacity * sizeof(Point));
+        if (!vertices) return -1;
+        rc->vertices = vertices;
+        rc->vertexCapacity = newCapacity;
+    }
+    int first = rc->numVertices;
+    float height = (float)rc->image->height;
+    for (int i = 0; i < count; i++) {
+        Point* v = &rc->vertices[first + i];
+        v->x = (float)(source[i].x * rc->scale + rc->originX);
+        v->y = height - (float)(source[i].y * rc->scale + rc->originY);
+    }
+    rc->numVertices += count;
+    return first;
+}
+
+/**
+ * @brief Grava uma primitiva, se a sua caixa (vértices + 'margin') tocar a imagem.
+ */
+static void appendPrimitive(RasterContext* rc, RasterPrimitiveType type, int closed, const unsigned char* color,
+                            float halfSize, float margin, int first, int count) {
+    const Point* v = &rc->vertices[first];
+    float minX = v[0].x, maxX = v[0].x, minY = v[0].y, maxY = v[0].y;
+    for (int i = 1; i < count; i++) {
+        if (v[i].x < minX) minX = v[i].x;
+        if (v[i].x > maxX) maxX = v[i].x;
+        if (v[i].y < minY) minY = v[i].y;
+        if (v[i].y > maxY) maxY = v[i].y;
+    }
+    minX -= margin; minY -= margin;
+    maxX += margin; maxY += margin;
+    // Também descarta caixas com NaN (as comparações abaixo falham).
+    if (!(maxX >= 0.0f && maxY >= 0.0f && minX < rc->image->width && minY < rc->image->height)) return;
+
+    if (rc->numPrimitives == rc->primitiveCapacity) {
+        int newCapacity = rc->primitiveCapacity > 0 ? rc->primitiveCapacity * 2 : INITIAL_OBJECT_CAPACITY;
+        RasterPrimitive* primitives = (RasterPrimitive*)realloc(rc->primitives, (size_t)newCapacity * sizeof(RasterPrimitive));
+        if (!primitives) {
+            rc->failed = 1;
+            return;
+        }
+        rc->primitives = primitives;
+        rc->primitiveCapacity = newCapacity;
+    }
+    RasterPrimitive* p = &rc->primitives[rc->numPrimitives++];
+    p->type = (unsigned char)type;
+    p->closed = (unsigned char)closed;
+    memcpy(p->color, color, 4);
+    p->halfSize = halfSize;
+    p->first = first;
+    p->count = count;
+    p->x0 = clampInt((int)floorf(minX), 0, rc->image->width - 1);
+    p->y0 = clampInt((int)floorf(minY), 0, rc->image->height - 1);
+    p->x1 = clampInt((int)floorf(maxX), 0, rc->image->width - 1);
+    p->y1 = clampInt((int)floorf(maxY), 0, rc->image->height - 1);
+}
+
+/**
+ * @brief Converte para pixels os vértices dos polígonos de um lote, um polígono após o outro.
+ * @return int A posição do primeiro vértice convertido, ou -1 se faltou memória.
+ */
+static int appendPolygonVertices(RasterContext* rc, const RenderBatch* batch) {
+    int base = rc->numVertices;
+    for (int k = 0; k < batch->numPolygons; k++) {
+        if (appendVertices(rc, &batch->vertices[batch->polygonFirst[k]], batch->polygonCount[k]) < 0) return -1;
+    }
+    return base;
+}
+
+/**
+ * @brief Converte para pixels os vértices que um lote usa, reaproveitando uma conversão anterior do mesmo array.
+ *
+ * Lotes de polígonos convertem só os polígonos listados, na ordem da lista
+ * (a região desenhada pode listar poucos polígonos de um array grande).
+ * @return int A posição do primeiro vértice convertido, ou -1 se faltou memória.
+ */
+static int convertBatchVertices(RasterContext* rc, const RenderBatch* batch) {
+    const void* source = batch->polygonFirst ? (const void*)batch->polygonFirst : (const void*)batch->vertices;
+    int sourceCount = batch->polygonFirst ? batch->numPolygons : batch->numVertices;
+    for (int slot = 0; slot < RASTER_SOURCE_CACHE; slot++) {
+        if (rc->lastSource[slot] == source && rc->lastSourceCount[slot] == sourceCount) {
+            return rc->lastFirst[slot];
+        }
+    }
+    int base = batch->polygonFirst ? appendPolygonVertices(rc, batch)
+                                   : appendVertices(rc, batch->vertices, batch->numVertices);
+    if (base < 0) return -1;
+    int slot = rc->nextSourceSlot;
+    rc->nextSourceSlot = (slot + 1) % RASTER_SOURCE_CACHE;
+    rc->lastSource[slot] = source;
+    rc->lastSourceCount[slot] = sourceCount;
+    rc->lastFirst[slot] = base;
+    return base;
+}
+
+/**
+ * @brief Backend de render.h: converte um lote em primitivas.
+ */
+static void rasterDrawBatch(void* ctx, const RenderBatch* batch) {
+    RasterContext* rc = (RasterContext*)ctx;
+    if (rc->failed || batch->numVertices == 0) return;
+
+    // Lotes com índices convertem só os vértices indicados, um a um, abaixo.
+    int base = batch->indices ? 0 : convertBatchVertices(rc, batch);
+    if (base < 0) {
+        rc->failed = 1;
+        return;
+    }
+
+    unsigned char color[4];
+    colorToBytes(batch->color, color);
+    float halfSize = 0.5f * batch->size * rc->sizeScale;
+    if (halfSize < 0.5f) halfSize = 0.5f;
+
+    // Os polígonos convertidos ficam em sequência a partir de 'base'.
+    int next = base;
+    switch (batch->type) {
+        case RENDER_BATCH_POLYGON_FILL:
+            for (int k = 0; k < batch->numPolygons; next += batch->polygonCount[k], k++) {
+                int n = batch->polygonCount[k];
+                if (n < 3) continue;
+                if (n > rc->maxPolygonVertices) rc->maxPolygonVertices = n;
+                appendPrimitive(rc, RASTER_FILL, 0, color, 0.0f, 0.0f, next, n);
+            }
+            break;
+        case RENDER_BATCH_POLYGON_OUTLINE:
+            // Como GL_LINE_LOOP: um vértice só não desenha nada, dois desenham um segmento.
+            for (int k = 0; k < batch->numPolygons; next += batch->polygonCount[k], k++) {
+                int n = batch->polygonCount[k];
+                if (n < 2) continue;
+                appendPrimitive(rc, RASTER_POLYLINE, n > 2, color, halfSize, halfSize + 0.5f, next, n);
+            }
+            break;
+        case RENDER_BATCH_LINES:
+            if (batch->indices) {
+                for (int i = 0; i + 1 < batch->numIndices; i += 2) {
+                    int first = appendVertices(rc, &batch->vertices[batch->indices[i]], 1);
+                    if (first < 0 || appendVertices(rc, &batch->vertices[batch->indices[i + 1]], 1) < 0) {
+                        rc->failed = 1;
+                        return;
+                    }
+                    appendPrimitive(rc, RASTER_POLYLINE, 0, color, halfSize, halfSize + 0.5f, first, 2);
+                }
+                break;
+            }
+            for (int i = 0; i + 1 < batch->numVertices; i += 2) {
+                appendPrimitive(rc, RASTER_POLYLINE, 0, color, halfSize, halfSize + 0.5f, base + i, 2);
+            }
+            break;
+        case RENDER_BATCH_POINTS:
+            if (batch->polygonFirst) {
+                // Vértices de polígonos: uma primitiva por polígono.
+                for (int k = 0; k < batch->numPolygons; next += batch->polygonCount[k], k++) {
+                    int n = batch->polygonCount[k];
+                    if (n == 0) continue;
+                    appendPrimitive(rc, RASTER_POINTS, 0, color, halfSize, halfSize, next, n);
+                }
+            } else if (batch->indices) {
+                for (int i = 0; i < batch->numIndices; i++) {
+                    int first = appendVertices(rc, &batch->vertices[batch->indices[i]], 1);
+                    if (first < 0) {
+                        rc->failed = 1;
+                        return;
+                    }
+                    appendPrimitive(rc, RASTER_POINTS, 0, color, halfSize, halfSize, first, 1);
+                }
+            } else {
+                for (int i = 0; i < batch->numVertices; i++) {
+                    appendPrimitive(rc, RASTER_POINTS, 0, color, halfSize, halfSize, base + i, 1);
+                }
+            }
+            break;
+    }
+}
+
+/**
+ * @brief Distribui as primitivas aos blocos que as suas caixas tocam, na ordem de gravação.
+ * @return int 1 em caso de sucesso, 0 se faltou memória.
+ */
+static int binPrimitives(RasterContext* rc) {
+    int numTiles = rc->tilesX * rc->tilesY;
+    rc->binStart = (int*)calloc((size_t)numTiles + 1, sizeof(int));
+    if (!rc->binStart) return 0;
+
+    // 1ª passada: conta as primitivas de cada bloco.
+    size_t total = 0;
+    for (int i = 0; i < rc->numPrimitives; i++) {
+        const RasterPrimitive* p = &rc->primitives[i];
+        for (int ty = p->y0 / RASTER_TILE_SIZE; ty <= p->y1 / RASTER_TILE_SIZE; ty++) {
+            for (int tx = p->x0 / RASTER_TILE_SIZE; tx <= p->x1 / RASTER_TILE_SIZE; tx++) {
+                rc->binStart[ty * rc->tilesX + tx + 1]++;
+            }
+        }
+        total += (size_t)(p->x1 / RASTER_TILE_SIZE - p->x0 / RASTER_TILE_SIZE + 1) *
+                 (size_t)(p->y1 / RASTER_TILE_SIZE - p->y0 / RASTER_TILE_SIZE + 1);
+    }
+    if (total > (size_t)0x7FFFFFFF) return 0;
+    for (int t = 0; t < numTiles; t++) {
+        rc->binStart[t + 1] += rc->binStart[t];
+    }
+
+    // 2ª passada: preenche as listas, usando 'next' como cursor de cada bloco.
+    rc->binItems = (int*)malloc((total > 0 ? total : 1) * sizeof(int));
+    int* next = (int*)malloc((size_t)numTiles * sizeof(int));
+    if (!rc->binItems || !next) {
+        free(next);
+        return 0;
+    }
+    memcpy(next, rc->binStart, (size_t)numTiles * sizeof(int));
+    for (int i = 0; i < rc->numPrimitives; i++) {
+        const RasterPrimitive* p = &rc->primitives[i];
+        for (int ty = p->y0 / RASTER_TILE_SIZE; ty <= p->y1 / RASTER_TILE_SIZE; ty++) {
+            for (int tx = p->x0 / RASTER_TILE_SIZE; tx <= p->x1 / RASTER_TILE_SIZE; tx++) {
+                rc->binItems[next[ty * rc->tilesX + tx]++] = i;
+            }
+        }
+    }
+    free(next);
+    return 1;
+}
+
+/**
+ * @brief Um retângulo de pixels [x0, x1) x [y0, y1).
+ */
+typedef struct {
+    int x0, y0, x1, y1;
+} TileRect;
+
+/**
+ * @brief Desenha uma linha de 'a' a 'b' com pontas arredondadas, limitada ao retângulo.
+ *
+ * Em cada linha de pixels só é percorrido o trecho que a faixa da linha
+ * cruza, então linhas diagonais longas não custam a área da sua caixa.
+ */
+static void drawLine(RasterImage* image, Point a, Point b, float halfWidth, const unsigned char* color,
+                     const TileRect* clip) {
+    float reach = halfWidth + 0.5f;
+    float reachSq = reach * reach;
+    float innerSq = reach > 1.0f ? (reach - 1.0f) * (reach - 1.0f) : -1.0f; // Cobertura total até aqui.
+    float minX = minFloat(a.x, b.x) - reach, maxX = maxFloat(a.x, b.x) + reach;
+    float minY = minFloat(a.y, b.y) - reach, maxY = maxFloat(a.y, b.y) + reach;
+    int y0 = (int)floorf(minY), y1 = (int)floorf(maxY);
+    if (y0 < clip->y0) y0 = clip->y0;
+    if (y1 > clip->y1 - 1) y1 = clip->y1 - 1;
+    if (y0 > y1 || maxX < clip->x0 || minX >= clip->x1) return;
+
+    float dx = b.x - a.x, dy = b.y - a.y;
+    float lengthSq = dx * dx + dy * dy;
+    float invLengthSq = lengthSq > 0.0f ? 1.0f / lengthSq : 0.0f;
+    float halfSpan = fabsf(dy) > 1e-3f ? reach * sqrtf(lengthSq) / fabsf(dy) : 0.0f;
+
+    for (int y = y0; y <= y1; y++) {
+        float cy = y + 0.5f;
+        float low = minX, high = maxX;
+        if (halfSpan > 0.0f) {
+            float middle = a.x + dx * (cy - a.y) / dy;
+            low = maxFloat(low, middle - halfSpan);
+            high = minFloat(high, middle + halfSpan);
+        }
+        int x0 = (int)floorf(low), x1 = (int)floorf(high);
+        if (x0 < clip->x0) x0 = clip->x0;
+        if (x1 > clip->x1 - 1) x1 = clip->x1 - 1;
+
+        unsigned char* row = image->pixels + ((size_t)y * image->width) * 4;
+        float py = cy - a.y;
+        for (int x = x0; x <= x1; x++) {
+            float px = x + 0.5f - a.x;
+            float t = (px * dx + py * dy) * invLengthSq;
+            t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+            float ex = px - t * dx, ey = py - t * dy;
+            float distanceSq = ex * ex + ey * ey;
+            if (distanceSq >= reachSq) continue;
+            float coverage = distanceSq <= innerSq ? 1.0f : minFloat(reach - sqrtf(distanceSq), 1.0f);
+            blendPixel(row + (size_t)x * 4, color, coverage);
+        }
+    }
+}
+
+/**
+ * @brief Desenha um quadrado centrado em 'c', com a área coberta de cada pixel como cobertura.
+ */
+static void drawSquare(RasterImage* image, Point c, float half, const unsigned char* color, const TileRect* clip) {
+    float left = c.x - half, right = c.x + half, top = c.y - half, bottom = c.y + half;
+    int x0 = (int)floorf(left), x1 = (int)floorf(right);
+    int y0 = (int)floorf(top), y1 = (int)floorf(bottom);
+    if (x0 < clip->x0) x0 = clip->x0;
+    if (x1 > clip->x1 - 1) x1 = clip->x1 - 1;
+    if (y0 < clip->y0) y0 = clip->y0;
+    if (y1 > clip->y1 - 1) y1 = clip->y1 - 1;
+
+    if (x0 > x1) return;
+
+    // Só a primeira e a última coluna são cobertas em parte.
+    float coverFirst = minFloat(x0 + 1.0f, right) - maxFloat((float)x0, left);
+    float coverLast = minFloat(x1 + 1.0f, right) - maxFloat((float)x1, left);
+    for (int y = y0; y <= y1; y++) {
+        float coverY = minFloat(y + 1.0f, bottom) - maxFloat((float)y, top);
+        if (coverY <= 0.0f) continue;
+        unsigned char* row = image->pixels + ((size_t)y * image->width) * 4;
+        blendPixel(row + (size_t)x0 * 4, color, coverFirst * coverY);
+        for (int x = x0 + 1; x < x1; x++) {
+            blendPixel(row + (size_t)x * 4, color, coverY);
+        }
+        if (x1 > x0) blendPixel(row + (size_t)x1 * 4, color, coverLast * coverY);
+    }
+}
+
+/**
+ * @brief Acrescenta a cobertura horizontal exata do intervalo [left, right) aos pixels de 'coverage'.
+ * @param coverage A cobertura das colunas [clipX0, clipX1), indexada a partir de clipX0.
+ */
+static void accumulateSpan(float* coverage, int clipX0, int clipX1, float left, float right, float weight) {
+    if (left < clipX0) left = (float)clipX0;
+    if (right > clipX1) right = (float)clipX1;
+    if (!(right > left)) return;
+    int il = (int)left, ir = (int)right;
+    if (il == ir) {
+        coverage[il - clipX0] += (right - left) * weight;
+        return;
+    }
+    coverage[il - clipX0] += (il + 1 - left) * weight;
+    for (int i = il + 1; i < ir; i++) {
+        coverage[i - clipX0] += weight;
+    }
+    if (ir < clipX1) coverage[ir - clipX0] += (right - ir) * weight;
+}
+
+/**
+ * @brief Preenche um polígono (regra par-ímpar), limitado ao retângulo.
+ * @param crossings Área para os cruzamentos de uma linha (capacidade 'count').
+ */
+static void drawFill(RasterImage* image, const RasterPrimitive* p, const Point* v, const TileRect* clip,
+                     float* crossings) {
+    int x0 = p->x0 > clip->x0 ? p->x0 : clip->x0;
+    int x1 = p->x1 < clip->x1 - 1 ? p->x1 : clip->x1 - 1;
+    int y0 = p->y0 > clip->y0 ? p->y0 : clip->y0;
+    int y1 = p->y1 < clip->y1 - 1 ? p->y1 : clip->y1 - 1;
+    if (x0 > x1 || y0 > y1) return;
+
+    float coverage[RASTER_TILE_SIZE];
+    int width = x1 - x0 + 1;
+    const float weight = 1.0f / RASTER_POLYGON_SAMPLES;
+    for (int y = y0; y <= y1; y++) {
+        memset(coverage, 0, (size_t)width * sizeof(float));
+        for (int s = 0; s < RASTER_POLYGON_SAMPLES; s++) {
+            float sy = y + (s + 0.5f) * weight;
+            int numCrossings = 0;
+            for (int i = 0, j = p->count - 1; i < p->count; j = i++) {
+                Point a = v[j], b = v[i];
+                if ((a.y > sy) == (b.y > sy)) continue;
+                float x = a.x + (sy - a.y) * (b.x - a.x) / (b.y - a.y);
+                // Inserção ordenada: os polígonos costumam cruzar cada linha poucas vezes.
+                int k = numCrossings++;
+                while (k > 0 && crossings[k - 1] > x) {
+                    crossings[k] = crossings[k - 1];
+                    k--;
+                }
+                crossings[k] = x;
+            }
+            for (int k = 0; k + 1 < numCrossings; k += 2) {
+                accumulateSpan(coverage, x0, x1 + 1, crossings[k], crossings[k + 1], weight);
+            }
+        }
+        unsigned char* row = image->pixels + ((size_t)y * image->width + x0) * 4;
+        for (int x = 0; x < width; x++) {
+            if (coverage[x] > 0.0f) {
+                blendPixel(row + (size_t)x * 4, p->color, coverage[x] < 1.0f ? coverage[x] : 1.0f);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Tarefa paralela: limpa e desenha os blocos [first, last).
+ */
+static void drawTiles(int first, int last, void* ctx) {
+    RasterContext* rc = (RasterContext*)ctx;
+    RasterImage* image = rc->image;
+    float* crossings = NULL;
+    if (rc->maxPolygonVertices > 0) {
+        crossings = (float*)malloc((size_t)rc->maxPolygonVertices * sizeof(float));
+    }
+
+    for (int t = first; t < last; t++) {
+        TileRect clip;
+        clip.x0 = (t % rc->tilesX) * RASTER_TILE_SIZE;
+        clip.y0 = (t / rc->tilesX) * RASTER_TILE_SIZE;
+        clip.x1 = clip.x0 + RASTER_TILE_SIZE < image->width ? clip.x0 + RASTER_TILE_SIZE : image->width;
+        clip.y1 = clip.y0 + RASTER_TILE_SIZE < image->height ? clip.y0 + RASTER_TILE_SIZE : image->height;
+
+        for (int y = clip.y0; y < clip.y1; y++) {
+            memcpy(image->pixels + ((size_t)y * image->width + clip.x0) * 4, rc->backgroundRow,
+                   (size_t)(clip.x1 - clip.x0) * 4);
+        }
+
+        for (int k = rc->binStart[t]; k < rc->binStart[t + 1]; k++) {
+            const RasterPrimitive* p = &rc->primitives[rc->binItems[k]];
+            const Point* v = &rc->vertices[p->first];
+            switch (p->type) {
+                case RASTER_FILL:
+                    // Sem a área dos cruzamentos (falta de memória), o interior é omitido.
+                    if (crossings) drawFill(image, p, v, &clip, crossings);
+                    break;
+                case RASTER_POLYLINE: {
+                    int numEdges = p->closed ? p->count : p->count - 1;
+                    for (int i = 0; i < numEdges; i++) {
+                        drawLine(image, v[i], v[(i + 1) % p->count], p->halfSize, p->color, &clip);
+                    }
+                    break;
+                }
+                case RASTER_POINTS:
+                    for (int i = 0; i < p->count; i++) {
+                        drawSquare(image, v[i], p->halfSize, p->color, &clip);
+                    }
+                    break;
+            }
+        }
+    }
+    free(crossings);
+}
+
+// --- SEÇÃO DE FUNÇÕES PÚBLICAS ---
+
+int rasterImageInit(RasterImage* image, int width, int height) {
+    image->width = 0;
+    image->height = 0;
+    image->pixels = NULL;
+    if (width <= 0 || height <= 0 || (size_t)width * height > ((size_t)1 << 31)) {
+        fprintf(stderr, "[Raster ERROR] Tamanho de imagem invalido: %dx%d.\n", width, height);
+        return 0;
+    }
+    image->pixels = (unsigned char*)malloc((size_t)width * height * 4);
+    if (!image->pixels) {
+        fprintf(stderr, "[Raster ERROR] Memoria insuficiente para uma imagem %dx%d.\n", width, height);
+        return 0;
+    }
+    image->width = width;
+    image->height = height;
+    return 1;
+}
+
+void rasterImageFree(RasterImage* image) {
+    free(image->pixels);
+    image->pixels = NULL;
+    image->width = 0;
+    image->height = 0;
+}
+
+RasterView rasterFitView(int width, int height) {
+    RasterView view;
+    memset(&view, 0, sizeof(view));
+    view.background = (RenderColor){0.95f, 0.95f, 0.95f, 1.0f}; // O mesmo fundo da janela.
+
+    objectsFlushTransforms();
+    if (g_numObjects == 0) {
+        view.maxX = (float)WINDOW_WIDTH;
+        view.maxY = (float)WINDOW_HEIGHT;
+        return view;
+    }
+    BoundingBox box = g_objects[0].bounds;
+    for (int i = 1; i < g_numObjects; i++) {
+        BoundingBox b = g_objects[i].bounds;
+        if (b.minX < box.minX) box.minX = b.minX;
+        if (b.minY < box.minY) box.minY = b.minY;
+        if (b.maxX > box.maxX) box.maxX = b.maxX;
+        if (b.maxY > box.maxY) box.maxY = b.maxY;
+    }
+    // Uma cena de um único ponto ainda precisa de uma região com área.
+    float sizeX = fmaxf(box.maxX - box.minX, 1.0f);
+    float sizeY = fmaxf(box.maxY - box.minY, 1.0f);
+    float margin = RASTER_VIEW_MARGIN * fmaxf(sizeX, sizeY) + CLICK_TOLERANCE;
+    sizeX += 2.0f * margin;
+    sizeY += 2.0f * margin;
+    // Amplia o eixo que sobra para a região ter a proporção da imagem.
+    float aspect = (float)width / (float)height;
+    if (sizeX < sizeY * aspect) sizeX = sizeY * aspect;
+    else sizeY = sizeX / aspect;
+    float centerX = 0.5f * (box.minX + box.maxX), centerY = 0.5f * (box.minY + box.maxY);
+    view.minX = centerX - 0.5f * sizeX;
+    view.maxX = centerX + 0.5f * sizeX;
+    view.minY = centerY - 0.5f * sizeY;
+    view.maxY = centerY + 0.5f * sizeY;
+    return view;
+}
+
+int rasterRenderScene(RasterImage* image, const RasterView* view) {
+    RasterContext rc;
+    memset(&rc, 0, sizeof(rc));
+    rc.image = image;
+
+    double viewWidth = (double)view->maxX - view->minX, viewHeight = (double)view->maxY - view->minY;
+    if (!(viewWidth > 0.0 && viewHeight > 0.0)) {
+        fprintf(stderr, "[Raster ERROR] Regiao do mundo vazia.\n");
+        return 0;
+    }
+    double scaleX = image->width / viewWidth, scaleY = image->height / viewHeight;
+    rc.scale = scaleX < scaleY ? scaleX : scaleY;
+    // Centraliza a região na imagem quando as proporções diferem.
+    rc.originX = 0.5 * (image->width - viewWidth * rc.scale) - view->minX * rc.scale;
+    rc.originY = 0.5 * (image->height - viewHeight * rc.scale) - view->minY * rc.scale;
+    rc.sizeScale = (float)rc.scale;
+    colorToBytes(view->background, rc.backgroundRow);
+    rc.backgroundRow[3] = 255;
+    for (int x = 1; x < RASTER_TILE_SIZE; x++) {
+        memcpy(rc.backgroundRow + x * 4, rc.backgroundRow, 4);
+    }
+
+    // A região que a imagem inteira cobre (maior que 'view' no eixo que sobra).
+    RenderView visible;
+    visible.minX = (float)(-rc.originX / rc.scale);
+    visible.maxX = (float)((image->width - rc.originX) / rc.scale);
+    visible.minY = (float)(-rc.originY / rc.scale);
+    visible.maxY = (float)((image->height - rc.originY) / rc.scale);
+    visible.pixelsPerUnit = (float)rc.scale;
+
+    static const RenderBackend backend = {rasterDrawBatch};
+    renderSceneWithBackend(&backend, &rc, view->fillPolygons, &visible);
+
+    int ok = !rc.failed;
+    if (ok) {
+        rc.tilesX = (image->width + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+        rc.tilesY = (image->height + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+        ok = binPrimitives(&rc);
+    }
+    if (ok) {
+        jobsParallelFor(rc.tilesX * rc.tilesY, 1, drawTiles, &rc);
+    } else {
+        fprintf(stderr, "[Raster ERROR] Memoria insuficiente para desenhar a cena.\n");
+    }
+
+    free(rc.vertices);
+    free(rc.primitives);
+    free(rc.binStart);
+    free(rc.binItems);
+    return ok;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file rasterizer.h
+ * @brief Define a interface do rasterizador em software, que desenha a cena sem janela nem OpenGL.
+ *
+ * O rasterizador é um backend de render.h: recebe os mesmos lotes que a
+ * janela desenha e os converte em primitivas em pixels (linhas e pontos com
+ * bordas suavizadas, polígonos preenchidos). A imagem é dividida em blocos
+ * (tiles) de RASTER_TILE_SIZE pixels; cada primitiva é distribuída aos
+ * blocos que a sua caixa toca e os blocos são desenhados em paralelo pelo
+ * sistema de tarefas (jobs.h). Cada bloco desenha as suas primitivas na
+ * ordem original, então o resultado não depende do número de threads.
+ */
+
+#ifndef RASTERIZER_H
+#define RASTERIZER_H
+
+#include "render.h"
+
+// --- SEÇÃO DE ESTRUTURAS E TIPOS ---
+
+/**
+ * @brief Uma imagem RGBA de 8 bits por componente, com a linha de cima primeiro.
+ */
+typedef struct {
+    int width, height;
+    unsigned char* pixels;      ///< width * height * 4 bytes.
+} RasterImage;
+
+/**
+ * @brief A região do mundo desenhada e as opções do desenho.
+ */
+typedef struct {
+    float minX, minY;           ///< Canto inferior esquerdo da região do mundo.
+    float maxX, maxY;           ///< Canto superior direito da região do mundo.
+    RenderColor background;     ///< A cor de fundo (opaca).
+    int fillPolygons;           ///< 1 para preencher o interior dos polígonos.
+} RasterView;
+
+// --- SEÇÃO DE PROTÓTIPOS DE FUNÇÕES PÚBLICAS ---
+
+/**
+ * @brief Aloca uma imagem.
+ * @return int 1 em caso de sucesso, 0 se o tamanho é inválido ou faltou memória.
+ */
+int rasterImageInit(RasterImage* image, int width, int height);
+
+/**
+ * @brief Libera os pixels de uma imagem.
+ */
+void rasterImageFree(RasterImage* image);
+
+/**
+ * @brief Calcula uma região do mundo que mostra a cena inteira na proporção da imagem.
+ *
+ * A região é a caixa de todos os objetos, com uma pequena margem, ampliada
+ * no eixo necessário para não distorcer a cena. Sem objetos, é a área da
+ * janela padrão.
+ */
+RasterView rasterFitView(int width, int height);
+
+/**
+ * @brief Desenha a cena atual em uma imagem.
+ *
+ * A escala da região para a imagem é a mesma nos dois eixos (a menor das
+ * duas), com a região centralizada. Espessuras e tamanhos de ponto crescem
+ * com a escala, como em uma captura da janela em resolução maior, mas nunca
+ * ficam abaixo de um pixel.
+ * @return int 1 em caso de sucesso, 0 se faltou memória.
+ */
+int rasterRenderScene(RasterImage* image, const RasterView* view);
+
+#endif // RASTERIZER_H
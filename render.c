@@ -1,20 +1,1121 @@
 /**
  * @file render.c
- * @brief Implementao da funo de renderizao principal do projeto.
+ * @brief Implementação do renderizador retido da cena.
  *
- * Este mdulo serve como uma camada de abstrao, delegando o
- * desenho de todos os objetos para o mdulo de gerenciamento de objetos.
+ * Pontos e segmentos já ficam em arrays contíguos ('g_points' e 'g_segments')
+ * e são enviados aos VBOs sem conversão. Os vértices dos polígonos estão
+ * espalhados pelo pool, então são copiados para um array empacotado, com o
+ * início e a quantidade de vértices de cada polígono, desenhado com
+ * glMultiDrawArrays.
+ *
+ * Objetos animados são enviados já deslocados para a posição interpolada
+ * entre os dois últimos passos da física (veja anim_render_offset()). No
+ * caminho sem VBOs, pontos e segmentos são desenhados na posição real.
+ *
+ * Se o OpenGL não oferecer vertex buffers (versão anterior à 1.5), os mesmos
+ * lotes são desenhados a partir da memória do programa com vertex arrays do
+ * OpenGL 1.1.
+ *
+ * Os lotes são descritos por emitBatches() sem OpenGL; o backend OpenGL
+ * (glDrawBatch()) é só um dos destinos possíveis.
+ *
+ * Antes de emitir, buildDrawLists() compara a região do destino com uma
+ * caixa de toda a cena. Se a cena cabe na região, pontos e segmentos saem
+ * inteiros e só os polígonos passam pelo nível de detalhe. Se não cabe, o
+ * índice espacial (spatial.h) dá os objetos da região e os lotes de pontos
+ * e segmentos levam apenas os índices deles; os VBOs continuam com a cena
+ * inteira, então mover a região não reenvia nada. Os polígonos simplificados
+ * e os reduzidos a um ponto vão em lotes à parte, montados a cada quadro a
+ * partir do array empacotado (que já tem o deslocamento da interpolação).
  */
 
 #include <stdio.h>
-#include <GL/glut.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <limits.h>
+#include <float.h>
+#include <GL/freeglut.h>
+
 #include "render.h"
 #include "objects.h"
+#include "config.h"
+#include "animation.h"
+#include "profiler.h"
+#include "spatial.h"
+
+// --- SEÇÃO DE DEFINIÇÕES DO OPENGL ---
+// Os cabeçalhos do OpenGL 1.1 (como o do Windows) não declaram as funções de
+// vertex buffer, que precisam ser obtidas em tempo de execução.
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#endif
+#ifndef GL_DYNAMIC_DRAW
+#define GL_DYNAMIC_DRAW 0x88E8
+#endif
+
+typedef void (APIENTRY *GenBuffersProc)(GLsizei n, GLuint* buffers);
+typedef void (APIENTRY *BindBufferProc)(GLenum target, GLuint buffer);
+typedef void (APIENTRY *BufferDataProc)(GLenum target, ptrdiff_t size, const void* data, GLenum usage);
+typedef void (APIENTRY *BufferSubDataProc)(GLenum target, ptrdiff_t offset, ptrdiff_t size, const void* data);
+typedef void (APIENTRY *MultiDrawArraysProc)(GLenum mode, const GLint* first, const GLsizei* count, GLsizei drawcount);
+
+// --- SEÇÃO DE CONSTANTES ---
+
+#define RENDER_MAX_DIRTY_RANGES 64          ///< Trechos modificados guardados antes de unir todos em um só.
+#define RENDER_MIN_BUFFER_BYTES 65536       ///< Tamanho inicial de cada VBO.
+#define RENDER_MIN_COMPACT_VERTICES 4096    ///< Sobras em 's_packed' abaixo disso nunca disparam a compactação.
+#define RENDER_POLYGON_FILL_ALPHA 0.2f      ///< Opacidade do interior dos polígonos, quando preenchidos.
+#define RENDER_LOD_COLLAPSE_PIXELS 1.0f     ///< Polígonos com a caixa menor que isso nos dois eixos viram um ponto.
+#define RENDER_LOD_MIN_VERTICES 32          ///< Polígonos com menos vértices nunca são simplificados.
+#define RENDER_LOD_TOLERANCE_PIXELS 0.5f    ///< Distância mínima entre vértices mantidos na simplificação.
+#define RENDER_CULL_MARGIN_PIXELS CLICK_TOLERANCE  ///< Folga da região para espessuras e tamanhos de ponto.
+
+// --- SEÇÃO DE ESTRUTURAS E VARIÁVEIS PRIVADAS ---
+
+/**
+ * @brief Um intervalo fechado de elementos modificados desde o último envio.
+ */
+typedef struct {
+    int first, last;
+} DirtyRange;
+
+/**
+ * @brief Um vertex buffer e os trechos que ainda precisam ser reenviados.
+ */
+typedef struct {
+    GLuint id;                                      ///< Nome do VBO (0 se ainda não foi criado).
+    size_t capacity;                                ///< Bytes alocados no VBO.
+    DirtyRange ranges[RENDER_MAX_DIRTY_RANGES];     ///< Trechos modificados, em elementos.
+    int numRanges;
+} RetainedBuffer;
+
+static int s_initialized = 0;
+static int s_useVbo = 0;                ///< 1 se os vertex buffers estão disponíveis.
+
+static GenBuffersProc s_glGenBuffers = NULL;
+static BindBufferProc s_glBindBuffer = NULL;
+static BufferDataProc s_glBufferData = NULL;
+static BufferSubDataProc s_glBufferSubData = NULL;
+static MultiDrawArraysProc s_glMultiDrawArrays = NULL;
+
+static RetainedBuffer s_pointBuffer;    ///< Espelho de 'g_points' (um elemento por ponto).
+static RetainedBuffer s_segmentBuffer;  ///< Espelho de 'g_segments' (um elemento por segmento).
+static RetainedBuffer s_polygonBuffer;  ///< Espelho de 's_packed' (um elemento por vértice).
+
+// Vértices de todos os polígonos, um trecho de 's_packed' por polígono. Os
+// trechos não seguem a ordem de 'g_polygons' e podem ter sobras entre eles
+// (trechos de polígonos removidos ou que cresceram e foram para o fim); as
+// sobras não são desenhadas e somem na próxima compactação.
+static Point* s_packed = NULL;
+static int s_packedCount = 0;           ///< Fim do último trecho em uso (sobras incluídas).
+static int s_packedCapacity = 0;
+static int s_packedLive = 0;            ///< Vértices de polígonos em 's_packed' (sem as sobras).
+static int* s_polyFirst = NULL;         ///< Posição do primeiro vértice de cada polígono em 's_packed'.
+static int* s_polyCount = NULL;         ///< Quantidade de vértices de cada polígono.
+static int* s_polyReserved = NULL;      ///< Tamanho do trecho de cada polígono (pelo menos 's_polyCount').
+static int s_numPackedPolygons = 0;
+static int s_polyCapacity = 0;
+static int s_layoutDirty = 1;           ///< 1 se 's_packed' precisa ser refeito por inteiro.
+
+// Cópia temporária de um trecho de pontos ou segmentos com o deslocamento da interpolação.
+static Point* s_staging = NULL;
+static int s_stagingCapacity = 0;
+
+// Cópias dos pontos e dos segmentos com o deslocamento da interpolação, para
+// os lotes desenhados da memória (sem VBO ou pelo rasterizador).
+static Point* s_animatedPoints = NULL;
+static int s_animatedPointCapacity = 0;
+static Point* s_animatedSegments = NULL;
+static int s_animatedSegmentCapacity = 0;
+
+static int s_framePending = 1;          ///< 1 se a cena mudou desde o último quadro desenhado.
+static void (*s_frameRequestHook)(void) = NULL;
+
+static RenderView s_windowView = {0.0f, 0.0f, (float)WINDOW_WIDTH, (float)WINDOW_HEIGHT, 1.0f};
+
+// Uma caixa que contém todos os objetos. Cada mudança apenas a amplia; ela
+// é recalculada (e pode diminuir) quando deixa de caber na região desenhada
+// e houve remoções, ou movimentos de tantos objetos quanto há na cena, desde
+// o último cálculo. Com animações, uma caixa maior que a cena só desvia o
+// quadro para o caminho com recorte, e o recálculo fica pago pelas marcações.
+static BoundingBox s_sceneBounds = {-FLT_MAX, -FLT_MAX, FLT_MAX, FLT_MAX};
+static int s_sceneBoundsLoose = 1;      ///< 1 se houve remoções desde o último cálculo.
+static int s_sceneBoundsMoves = 0;      ///< Objetos alterados desde o último cálculo.
+
+// Listas de desenho do quadro atual, montadas por buildDrawLists().
+static int s_useDrawLists = 0;          ///< 1 se os polígonos saem das listas abaixo; 0 emite todos, sem nível de detalhe.
+static int s_cullElements = 0;          ///< 1 se só os pontos e segmentos das listas de índices são emitidos.
+static unsigned int* s_pointIndices = NULL;     ///< Posições em 'g_points' dos pontos na região.
+static int s_numPointIndices = 0;
+static int s_pointIndexCapacity = 0;
+static unsigned int* s_segmentIndices = NULL;   ///< Extremos (2 * posição e 2 * posição + 1) dos segmentos na região.
+static int s_numSegmentIndices = 0;
+static int s_segmentIndexCapacity = 0;
+static int* s_drawFirst = NULL;         ///< Polígonos emitidos sem mudança: início em 's_packed'.
+static int* s_drawCount = NULL;         ///< Polígonos emitidos sem mudança: quantidade de vértices.
+static int s_numDrawPolygons = 0;
+static int* s_lodFirst = NULL;          ///< Polígonos simplificados: início em 's_lodVertices'.
+static int* s_lodCount = NULL;          ///< Polígonos simplificados: quantidade de vértices.
+static int s_numLodPolygons = 0;
+static Point* s_lodPoints = NULL;       ///< Um ponto por polígono menor que um pixel.
+static int s_numLodPoints = 0;
+static int s_polygonListCapacity = 0;   ///< Capacidade comum das cinco listas de polígonos acima.
+static Point* s_lodVertices = NULL;     ///< Vértices dos polígonos simplificados, empacotados.
+static int s_numLodVertices = 0;
+static int s_lodVertexCapacity = 0;
+
+static RenderStats s_stats;
+
+// --- SEÇÃO DE FUNÇÕES AUXILIARES (IMPLEMENTAÇÃO PRIVADA) ---
+
+/**
+ * @brief Obtém os ponteiros das funções de vertex buffer, se a versão do OpenGL permitir.
+ */
+static void initRenderer(void) {
+    s_initialized = 1;
+
+    int major = 1, minor = 0;
+    const char* version = (const char*)glGetString(GL_VERSION);
+    if (version) sscanf(version, "%d.%d", &major, &minor);
+
+    if (major > 1 || (major == 1 && minor >= 4)) {
+        s_glMultiDrawArrays = (MultiDrawArraysProc)glutGetProcAddress("glMultiDrawArrays");
+    }
+    if (major > 1 || (major == 1 && minor >= 5)) {
+        s_glGenBuffers = (GenBuffersProc)glutGetProcAddress("glGenBuffers");
+        s_glBindBuffer = (BindBufferProc)glutGetProcAddress("glBindBuffer");
+        s_glBufferData = (BufferDataProc)glutGetProcAddress("glBufferData");
+        s_glBufferSubData = (BufferSubDataProc)glutGetProcAddress("glBufferSubData");
+    }
+    s_useVbo = s_glGenBuffers && s_glBindBuffer && s_glBufferData && s_glBufferSubData;
+
+    if (s_useVbo) {
+        printf("[INFO] Renderizacao com vertex buffers (OpenGL %s).\n", version);
+    } else {
+        printf("[INFO] Vertex buffers indisponiveis (OpenGL %s): usando vertex arrays.\n",
+               version ? version : "?");
+    }
+}
+
+/**
+ * @brief Acrescenta um elemento aos trechos modificados de um buffer.
+ *
+ * Elementos vizinhos do último trecho o estendem. Se os trechos acabarem,
+ * todos são unidos em um único intervalo que cobre todos eles.
+ */
+static void markRange(RetainedBuffer* b, int first, int last) {
+    if (b->numRanges > 0) {
+        DirtyRange* r = &b->ranges[b->numRanges - 1];
+        if (first <= r->last + 1 && last >= r->first - 1) {
+            if (first < r->first) r->first = first;
+            if (last > r->last) r->last = last;
+            return;
+        }
+    }
+    if (b->numRanges == RENDER_MAX_DIRTY_RANGES) {
+        DirtyRange all = {first, last};
+        for (int i = 0; i < b->numRanges; i++) {
+            if (b->ranges[i].first < all.first) all.first = b->ranges[i].first;
+            if (b->ranges[i].last > all.last) all.last = b->ranges[i].last;
+        }
+        b->ranges[0] = all;
+        b->numRanges = 1;
+        return;
+    }
+    b->ranges[b->numRanges].first = first;
+    b->ranges[b->numRanges].last = last;
+    b->numRanges++;
+}
+
+static void markAll(RetainedBuffer* b) {
+    b->ranges[0].first = 0;
+    b->ranges[0].last = INT_MAX - 1;
+    b->numRanges = 1;
+}
+
+/**
+ * @brief Retorna os elementos [first, last] prontos para envio, com os objetos animados deslocados.
+ *
+ * Sem animações ativas, devolve o próprio array da cena.
+ * @param owners O array de donos do tipo (NULL se 'data' já está pronto para envio).
+ * @param verticesPerElement Quantos vértices (Point) formam um elemento.
+ */
+static const Point* renderPositions(const Point* data, const int* owners, int first, int last,
+                                    int verticesPerElement) {
+    const Point* src = data + (size_t)first * verticesPerElement;
+    if (owners == NULL || anim_active_count() == 0) return src;
+
+    int count = (last - first + 1) * verticesPerElement;
+    if (count > s_stagingCapacity) {
+        int newCapacity = s_stagingCapacity > 0 ? s_stagingCapacity : 1024;
+        while (newCapacity < count) newCapacity *= 2;
+        Point* staging = (Point*)realloc(s_staging, (size_t)newCapacity * sizeof(Point));
+        if (!staging) return src; // Sem interpolação, mas ainda na posição correta.
+        s_staging = staging;
+        s_stagingCapacity = newCapacity;
+    }
+    memcpy(s_staging, src, (size_t)count * sizeof(Point));
+    for (int k = first; k <= last; k++) {
+        float dx, dy;
+        anim_render_offset(owners[k], &dx, &dy);
+        if (dx == 0.0f && dy == 0.0f) continue;
+        Point* v = &s_staging[(k - first) * verticesPerElement];
+        for (int j = 0; j < verticesPerElement; j++) {
+            v[j].x += dx;
+            v[j].y += dy;
+        }
+    }
+    return s_staging;
+}
+
+/**
+ * @brief Envia ao VBO os trechos modificados de um array de 'count' elementos.
+ *
+ * Se o VBO for pequeno demais, ele é realocado (com folga) e recebe o array inteiro.
+ */
+static void syncBuffer(RetainedBuffer* b, const Point* data, const int* owners, int count,
+                       int verticesPerElement) {
+    if (!s_useVbo) {
+        b->numRanges = 0;
+        return;
+    }
+    if (b->id == 0) {
+        s_glGenBuffers(1, &b->id);
+    }
+    s_glBindBuffer(GL_ARRAY_BUFFER, b->id);
+
+    size_t elementSize = (size_t)verticesPerElement * sizeof(Point);
+    size_t needed = (size_t)count * elementSize;
+    if (needed > b->capacity) {
+        size_t capacity = b->capacity > 0 ? b->capacity : RENDER_MIN_BUFFER_BYTES;
+        while (capacity < needed) capacity *= 2;
+        s_glBufferData(GL_ARRAY_BUFFER, (ptrdiff_t)capacity, NULL, GL_DYNAMIC_DRAW);
+        b->capacity = capacity;
+        markAll(b);
+    }
+
+    for (int i = 0; i < b->numRanges; i++) {
+        int first = b->ranges[i].first;
+        int last = b->ranges[i].last < count ? b->ranges[i].last : count - 1;
+        if (first > last) continue;
+        s_glBufferSubData(GL_ARRAY_BUFFER, (ptrdiff_t)(first * elementSize),
+                          (ptrdiff_t)((size_t)(last - first + 1) * elementSize),
+                          renderPositions(data, owners, first, last, verticesPerElement));
+    }
+    b->numRanges = 0;
+}
+
+/**
+ * @brief Garante espaço em 's_packed' para 'count' vértices.
+ */
+static int reservePacked(int count) {
+    if (count <= s_packedCapacity) return 1;
+    int newCapacity = s_packedCapacity > 0 ? s_packedCapacity : 1024;
+    while (newCapacity < count) newCapacity *= 2;
+    Point* packed = (Point*)realloc(s_packed, (size_t)newCapacity * sizeof(Point));
+    if (!packed) return 0;
+    s_packed = packed;
+    s_packedCapacity = newCapacity;
+    return 1;
+}
+
+/**
+ * @brief Garante espaço nos arrays de trechos para 'count' polígonos.
+ */
+static int reservePolygonRanges(int count) {
+    if (count <= s_polyCapacity) return 1;
+    int newCapacity = s_polyCapacity > 0 ? s_polyCapacity : INITIAL_OBJECT_CAPACITY;
+    while (newCapacity < count) newCapacity *= 2;
+    int* first = (int*)realloc(s_polyFirst, newCapacity * sizeof(int));
+    if (first) s_polyFirst = first;
+    int* counts = (int*)realloc(s_polyCount, newCapacity * sizeof(int));
+    if (counts) s_polyCount = counts;
+    int* reserved = (int*)realloc(s_polyReserved, newCapacity * sizeof(int));
+    if (reserved) s_polyReserved = reserved;
+    if (!first || !counts || !reserved) return 0;
+    s_polyCapacity = newCapacity;
+    return 1;
+}
+
+/**
+ * @brief Copia os vértices de um polígono para o array empacotado, na posição de desenho.
+ */
+static void packPolygon(int slot) {
+    const GfxPolygon* poly = &g_polygons[slot];
+    Point* dst = &s_packed[s_polyFirst[slot]];
+    if (poly->numVertices == 0) return;
+    memcpy(dst, poly->vertices, (size_t)poly->numVertices * sizeof(Point));
+
+    float dx, dy;
+    anim_render_offset(g_polygonOwners[slot], &dx, &dy);
+    if (dx != 0.0f || dy != 0.0f) {
+        for (int i = 0; i < poly->numVertices; i++) {
+            dst[i].x += dx;
+            dst[i].y += dy;
+        }
+    }
+}
+
+/**
+ * @brief Refaz o array empacotado com os vértices de todos os polígonos.
+ */
+static void rebuildPolygonLayout(void) {
+    int total = 0;
+    for (int k = 0; k < g_numPolygons; k++) {
+        total += g_polygons[k].numVertices;
+    }
+    if (!reservePacked(total) || !reservePolygonRanges(g_numPolygons)) {
+        fprintf(stderr, "[Render ERROR] Memória insuficiente para os poligonos.\n");
+        s_numPackedPolygons = 0;
+        s_packedCount = 0;
+        s_packedLive = 0;
+        return;
+    }
+
+    int next = 0;
+    for (int k = 0; k < g_numPolygons; k++) {
+        int n = g_polygons[k].numVertices;
+        s_polyFirst[k] = next;
+        s_polyCount[k] = n;
+        s_polyReserved[k] = n;
+        packPolygon(k);
+        next += n;
+    }
+    s_numPackedPolygons = g_numPolygons;
+    s_packedCount = total;
+    s_packedLive = total;
+    s_layoutDirty = 0;
+    markAll(&s_polygonBuffer);
+}
+
+/**
+ * @brief Pede a compactação de 's_packed' quando as sobras passam dos vértices em uso.
+ *
+ * A compactação reenvia todos os polígonos, mas só depois de sobras do mesmo
+ * tamanho que a cena: o custo por remoção ou mudança continua constante, em média.
+ */
+static void compactPackedIfWasteful(void) {
+    int waste = s_packedCount - s_packedLive;
+    if (waste > RENDER_MIN_COMPACT_VERTICES && waste > s_packedLive) {
+        s_layoutDirty = 1;
+    }
+}
+
+/**
+ * @brief Reserva um trecho novo no fim de 's_packed' para o polígono 'slot', com folga para crescer.
+ * @return int 1 em caso de sucesso, 0 se faltou memória.
+ */
+static int relocatePackedPolygon(int slot, int n) {
+    int reserved = n + n / 2;
+    if (!reservePacked(s_packedCount + reserved)) return 0;
+    // A folga não é desenhada, mas vai para o VBO junto com o trecho.
+    memset(&s_packed[s_packedCount + n], 0, (size_t)(reserved - n) * sizeof(Point));
+    s_polyFirst[slot] = s_packedCount;
+    s_polyReserved[slot] = reserved;
+    s_packedCount += reserved;
+    return 1;
+}
+
+/**
+ * @brief Copia para o array empacotado os vértices de um polígono modificado ou recém-criado.
+ *
+ * Um polígono novo ganha um trecho no fim do array. Se a quantidade de
+ * vértices mudou, o polígono continua no seu trecho enquanto couber nele e
+ * senão vai para um trecho novo no fim; em todos os casos só o trecho do
+ * polígono é reenviado.
+ */
+static void updatePackedPolygon(int slot) {
+    if (s_layoutDirty) return;
+    int n = g_polygons[slot].numVertices;
+
+    if (slot == s_numPackedPolygons) {
+        // Polígono novo no fim do array: basta acrescentá-lo ao fim do empacotado.
+        if (!reservePacked(s_packedCount + n) || !reservePolygonRanges(slot + 1)) {
+            s_layoutDirty = 1;
+            return;
+        }
+        s_polyFirst[slot] = s_packedCount;
+        s_polyCount[slot] = n;
+        s_polyReserved[slot] = n;
+        s_numPackedPolygons++;
+        s_packedCount += n;
+        s_packedLive += n;
+    } else if (slot > s_numPackedPolygons) {
+        s_layoutDirty = 1;
+        return;
+    } else if (s_polyCount[slot] != n) {
+        if (n > s_polyReserved[slot] && !relocatePackedPolygon(slot, n)) {
+            s_layoutDirty = 1;
+            return;
+        }
+        s_packedLive += n - s_polyCount[slot];
+        s_polyCount[slot] = n;
+        compactPackedIfWasteful();
+        if (s_layoutDirty) return;
+    }
+
+    if (n > 0) {
+        packPolygon(slot);
+        markRange(&s_polygonBuffer, s_polyFirst[slot], s_polyFirst[slot] + n - 1);
+    }
+}
+
+/**
+ * @brief Libera o trecho de um polígono removido de 'g_polygons'.
+ *
+ * Acompanha a remoção em O(1) de objects.c: o último polígono já foi movido
+ * para 'slot', e aqui o seu trecho (que não muda de lugar) passa para 'slot'.
+ * Nada precisa ser reenviado.
+ */
+static void removePackedPolygon(int slot) {
+    if (s_layoutDirty) return;
+    int last = g_numPolygons; // A contagem já foi reduzida.
+    if (last != s_numPackedPolygons - 1 || slot > last) {
+        s_layoutDirty = 1;
+        return;
+    }
+
+    int freedFirst = s_polyFirst[slot];
+    int freedReserved = s_polyReserved[slot];
+    s_packedLive -= s_polyCount[slot];
+    if (slot != last) {
+        s_polyFirst[slot] = s_polyFirst[last];
+        s_polyCount[slot] = s_polyCount[last];
+        s_polyReserved[slot] = s_polyReserved[last];
+    }
+    s_numPackedPolygons--;
+    // O trecho liberado no fim do array volta a ser espaço livre.
+    if (freedFirst + freedReserved == s_packedCount) {
+        s_packedCount = freedFirst;
+    }
+    compactPackedIfWasteful();
+}
+
+/**
+ * @brief Aplica as transformações pendentes e refaz o array empacotado, se preciso.
+ */
+static void prepareScene(void) {
+    // Objetos com transformação pendente têm os vértices no mundo refeitos
+    // agora, uma única vez por quadro, e marcados para reenvio.
+    objectsFlushTransforms();
+    if (s_layoutDirty) {
+        rebuildPolygonLayout();
+    }
+}
+
+/**
+ * @brief Garante espaço em um array de 'elementSize' bytes para 'needed' elementos.
+ * @return void* O array (talvez realocado), ou NULL se faltou memória (o original continua válido).
+ */
+static void* growArray(void* array, int* capacity, int needed, size_t elementSize) {
+    if (needed <= *capacity) return array;
+    int newCapacity = *capacity > 0 ? *capacity : 256;
+    while (newCapacity < needed) newCapacity *= 2;
+    void* grown = realloc(array, (size_t)newCapacity * elementSize);
+    if (grown) *capacity = newCapacity;
+    return grown;
+}
+
+/**
+ * @brief Garante espaço nas listas de polígonos para 'count' polígonos.
+ */
+static int reservePolygonLists(int count) {
+    if (count <= s_polygonListCapacity) return 1;
+    int newCapacity = s_polygonListCapacity > 0 ? s_polygonListCapacity : INITIAL_OBJECT_CAPACITY;
+    while (newCapacity < count) newCapacity *= 2;
+    int* drawFirst = (int*)realloc(s_drawFirst, newCapacity * sizeof(int));
+    if (drawFirst) s_drawFirst = drawFirst;
+    int* drawCount = (int*)realloc(s_drawCount, newCapacity * sizeof(int));
+    if (drawCount) s_drawCount = drawCount;
+    int* lodFirst = (int*)realloc(s_lodFirst, newCapacity * sizeof(int));
+    if (lodFirst) s_lodFirst = lodFirst;
+    int* lodCount = (int*)realloc(s_lodCount, newCapacity * sizeof(int));
+    if (lodCount) s_lodCount = lodCount;
+    Point* lodPoints = (Point*)realloc(s_lodPoints, newCapacity * sizeof(Point));
+    if (lodPoints) s_lodPoints = lodPoints;
+    if (!drawFirst || !drawCount || !lodFirst || !lodCount || !lodPoints) return 0;
+    s_polygonListCapacity = newCapacity;
+    return 1;
+}
+
+static int boxInside(BoundingBox inner, BoundingBox outer) {
+    return inner.minX >= outer.minX && inner.maxX <= outer.maxX &&
+           inner.minY >= outer.minY && inner.maxY <= outer.maxY;
+}
+
+static int boxesOverlap(BoundingBox a, BoundingBox b) {
+    return a.minX <= b.maxX && a.maxX >= b.minX && a.minY <= b.maxY && a.maxY >= b.minY;
+}
+
+/**
+ * @brief Amplia a caixa da cena para conter o objeto dono de um elemento.
+ */
+static void growSceneBounds(ObjectType type, int slot) {
+    int owner = -1;
+    switch (type) {
+        case OBJECT_TYPE_POINT:   if (slot < g_numPoints) owner = g_pointOwners[slot]; break;
+        case OBJECT_TYPE_SEGMENT: if (slot < g_numSegments) owner = g_segmentOwners[slot]; break;
+        case OBJECT_TYPE_POLYGON: if (slot < g_numPolygons) owner = g_polygonOwners[slot]; break;
+    }
+    if (owner < 0 || owner >= g_numObjects) return;
+    BoundingBox b = g_objects[owner].bounds;
+    if (b.minX < s_sceneBounds.minX) s_sceneBounds.minX = b.minX;
+    if (b.minY < s_sceneBounds.minY) s_sceneBounds.minY = b.minY;
+    if (b.maxX > s_sceneBounds.maxX) s_sceneBounds.maxX = b.maxX;
+    if (b.maxY > s_sceneBounds.maxY) s_sceneBounds.maxY = b.maxY;
+}
 
-// --- SEO DE FUNES PBLICAS ---
+/**
+ * @brief Recalcula a caixa da cena a partir das caixas de todos os objetos.
+ */
+static void refreshSceneBounds(void) {
+    BoundingBox box = {FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX}; // Vazia: cabe em qualquer região.
+    for (int i = 0; i < g_numObjects; i++) {
+        BoundingBox b = g_objects[i].bounds;
+        if (b.minX < box.minX) box.minX = b.minX;
+        if (b.minY < box.minY) box.minY = b.minY;
+        if (b.maxX > box.maxX) box.maxX = b.maxX;
+        if (b.maxY > box.maxY) box.maxY = b.maxY;
+    }
+    s_sceneBounds = box;
+    s_sceneBoundsLoose = 0;
+    s_sceneBoundsMoves = 0;
+}
+
+/**
+ * @brief Copia um polígono do array empacotado para as listas de simplificados, sem vértices a menos de 'tolerance' do anterior mantido.
+ * @return int Os vértices mantidos (o polígono só entra nas listas se perdeu algum), ou 0 se faltou memória.
+ */
+static int simplifyPolygon(int first, int n, float tolerance) {
+    Point* vertices = (Point*)growArray(s_lodVertices, &s_lodVertexCapacity, s_numLodVertices + n, sizeof(Point));
+    if (!vertices) return 0;
+    s_lodVertices = vertices;
+
+    const Point* src = &s_packed[first];
+    Point* dst = &s_lodVertices[s_numLodVertices];
+    float toleranceSq = tolerance * tolerance;
+    int kept = 1;
+    dst[0] = src[0];
+    for (int i = 1; i < n; i++) {
+        float dx = src[i].x - dst[kept - 1].x;
+        float dy = src[i].y - dst[kept - 1].y;
+        if (dx * dx + dy * dy >= toleranceSq) {
+            dst[kept++] = src[i];
+        }
+    }
+    // O contorno é fechado: o último mantido também não pode estar colado no primeiro.
+    if (kept > 1) {
+        float dx = dst[kept - 1].x - dst[0].x;
+        float dy = dst[kept - 1].y - dst[0].y;
+        if (dx * dx + dy * dy < toleranceSq) kept--;
+    }
+    if (kept >= 2 && kept < n) {
+        s_lodFirst[s_numLodPolygons] = s_numLodVertices;
+        s_lodCount[s_numLodPolygons] = kept;
+        s_numLodPolygons++;
+        s_numLodVertices += kept;
+    }
+    return kept;
+}
+
+/**
+ * @brief Emite um polígono menor que um pixel como um ponto no centro, onde ele é desenhado.
+ */
+static void addCollapsedPolygon(int owner, BoundingBox b) {
+    float dx, dy;
+    anim_render_offset(owner, &dx, &dy);
+    Point center = {0.5f * (b.minX + b.maxX) + dx, 0.5f * (b.minY + b.maxY) + dy};
+    s_lodPoints[s_numLodPoints++] = center;
+    s_stats.collapsedPolygons++;
+}
+
+/**
+ * @brief Escolhe como um polígono visível é emitido: inteiro, simplificado ou como um ponto.
+ *
+ * As listas de polígonos devem ter espaço para mais um polígono.
+ */
+static void addVisiblePolygon(int slot, float pixelsPerUnit) {
+    int first = s_polyFirst[slot];
+    int n = s_polyCount[slot];
+    int owner = g_polygonOwners[slot];
+    BoundingBox b = g_objects[owner].bounds;
+    float width = (b.maxX - b.minX) * pixelsPerUnit;
+    float height = (b.maxY - b.minY) * pixelsPerUnit;
+
+    if (n > 0 && width < RENDER_LOD_COLLAPSE_PIXELS && height < RENDER_LOD_COLLAPSE_PIXELS) {
+        addCollapsedPolygon(owner, b);
+        return;
+    }
+    if (n >= RENDER_LOD_MIN_VERTICES && n > 2.0f * (width + height)) {
+        // Mais vértices do que pixels no contorno da caixa: muitos caem no mesmo pixel.
+        int kept = simplifyPolygon(first, n, RENDER_LOD_TOLERANCE_PIXELS / pixelsPerUnit);
+        if (kept == 1) {
+            addCollapsedPolygon(owner, b);
+            return;
+        }
+        if (kept >= 2 && kept < n) {
+            s_stats.simplifiedPolygons++;
+            return;
+        }
+    }
+    s_drawFirst[s_numDrawPolygons] = first;
+    s_drawCount[s_numDrawPolygons] = n;
+    s_numDrawPolygons++;
+}
+
+/**
+ * @brief Acrescenta um objeto na região às listas de desenho do quadro.
+ *
+ * As listas devem ter espaço para mais um objeto.
+ * @return int 1 se o objeto entrou nas listas, 0 se ele ainda não tem polígono empacotado.
+ */
+static int addVisibleObject(const Object* obj, float pixelsPerUnit) {
+    switch (obj->type) {
+        case OBJECT_TYPE_POINT:
+            s_pointIndices[s_numPointIndices++] = (unsigned int)obj->slot;
+            break;
+        case OBJECT_TYPE_SEGMENT:
+            s_segmentIndices[s_numSegmentIndices++] = 2u * (unsigned int)obj->slot;
+            s_segmentIndices[s_numSegmentIndices++] = 2u * (unsigned int)obj->slot + 1u;
+            break;
+        case OBJECT_TYPE_POLYGON:
+            if (obj->slot >= s_numPackedPolygons) return 0;
+            addVisiblePolygon(obj->slot, pixelsPerUnit);
+            break;
+    }
+    return 1;
+}
+
+/**
+ * @brief Monta as listas de desenho da região: os objetos dentro dela e o nível de detalhe dos polígonos.
+ *
+ * Sem região, ou se faltar memória, o quadro emite a cena inteira.
+ */
+static void buildDrawLists(const RenderView* view) {
+    s_useDrawLists = 0;
+    s_cullElements = 0;
+    s_numPointIndices = 0;
+    s_numSegmentIndices = 0;
+    s_numDrawPolygons = 0;
+    s_numLodPolygons = 0;
+    s_numLodVertices = 0;
+    s_numLodPoints = 0;
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_stats.drawnObjects = g_numObjects;
+    if (view == NULL || !(view->pixelsPerUnit > 0.0f)) return;
+
+    float pixelsPerUnit = view->pixelsPerUnit;
+    BoundingBox region = {view->minX, view->minY, view->maxX, view->maxY};
+    if ((s_sceneBoundsLoose || s_sceneBoundsMoves >= g_numObjects) && !boxInside(s_sceneBounds, region)) {
+        refreshSceneBounds();
+    }
+
+    if (boxInside(s_sceneBounds, region)) {
+        // A cena inteira está na região: só os polígonos passam pelas listas.
+        if (!reservePolygonLists(s_numPackedPolygons)) return;
+        for (int k = 0; k < s_numPackedPolygons; k++) {
+            addVisiblePolygon(k, pixelsPerUnit);
+        }
+        s_useDrawLists = 1;
+        return;
+    }
+
+    // A folga cobre pontos e linhas com o centro fora da região.
+    float margin = RENDER_CULL_MARGIN_PIXELS / (pixelsPerUnit < 1.0f ? pixelsPerUnit : 1.0f);
+    region.minX -= margin;
+    region.minY -= margin;
+    region.maxX += margin;
+    region.maxY += margin;
+
+    const int* candidates;
+    int numCandidates = spatialQuery(region, &candidates);
+    int numActive = anim_active_count();
+    int needed = numCandidates + numActive;
+    unsigned int* pointIndices = (unsigned int*)growArray(s_pointIndices, &s_pointIndexCapacity,
+                                                          needed, sizeof(unsigned int));
+    if (pointIndices) s_pointIndices = pointIndices;
+    unsigned int* segmentIndices = (unsigned int*)growArray(s_segmentIndices, &s_segmentIndexCapacity,
+                                                            2 * needed, sizeof(unsigned int));
+    if (segmentIndices) s_segmentIndices = segmentIndices;
+    if (!pointIndices || !segmentIndices || !reservePolygonLists(needed)) return;
+
+    // Os objetos animados são desenhados fora da caixa em cache, entre os dois
+    // últimos passos; eles são testados depois, na posição interpolada.
+    int drawn = 0;
+    for (int k = 0; k < numCandidates; k++) {
+        int index = candidates[k];
+        if (g_anim[index].active || !boxesOverlap(g_objects[index].bounds, region)) continue;
+        drawn += addVisibleObject(&g_objects[index], pixelsPerUnit);
+    }
+    const int* active = anim_active_indices();
+    for (int k = 0; k < numActive; k++) {
+        const Object* obj = &g_objects[active[k]];
+        float dx, dy;
+        anim_render_offset(active[k], &dx, &dy);
+        BoundingBox b = obj->bounds;
+        b.minX += dx;
+        b.maxX += dx;
+        b.minY += dy;
+        b.maxY += dy;
+        if (boxesOverlap(b, region)) drawn += addVisibleObject(obj, pixelsPerUnit);
+    }
+    s_stats.drawnObjects = drawn;
+    s_useDrawLists = 1;
+    s_cullElements = 1;
+}
+
+/**
+ * @brief Copia os pontos ou segmentos com os objetos animados na posição interpolada.
+ *
+ * Só os objetos da lista de ativos são deslocados. O VBO não precisa disso:
+ * ele já recebe as posições deslocadas em syncBuffer().
+ * @param data Os vértices do array da cena ('verticesPerElement' por elemento).
+ * @return const Point* A cópia, ou o próprio 'data' sem animações ativas ou se faltou memória.
+ */
+static const Point* animatedVertices(const Point* data, int numVertices, ObjectType type, int verticesPerElement,
+                                     Point** copy, int* capacity) {
+    if (anim_active_count() == 0 || numVertices == 0) return data;
+    Point* grown = (Point*)growArray(*copy, capacity, numVertices, sizeof(Point));
+    if (!grown) return data;
+    *copy = grown;
+    memcpy(grown, data, (size_t)numVertices * sizeof(Point));
+
+    const int* active = anim_active_indices();
+    for (int k = 0; k < anim_active_count(); k++) {
+        const Object* obj = &g_objects[active[k]];
+        if (obj->type != type) continue;
+        float dx, dy;
+        anim_render_offset(active[k], &dx, &dy);
+        Point* v = &grown[obj->slot * verticesPerElement];
+        for (int j = 0; j < verticesPerElement; j++) {
+            v[j].x += dx;
+            v[j].y += dy;
+        }
+    }
+    return grown;
+}
+
+/**
+ * @brief Emite os objetos das listas de desenho, um lote por tipo de primitiva.
+ *
+ * Polígonos vêm primeiro para que segmentos e pontos fiquem visíveis por
+ * cima deles. As cores e espessuras são as mesmas de drawPolygon(),
+ * drawSegment() e drawPoint() para objetos não selecionados. Cada etapa dos
+ * polígonos (interior, contorno e vértices) sai para os inteiros e depois
+ * para os simplificados; os reduzidos a um ponto saem com os vértices.
+ * @param fromMemory 1 se o backend lê 'vertices' dos lotes de pontos e segmentos
+ *        (0 se ele usa os VBOs, que já têm as posições interpoladas).
+ */
+static void emitBatches(const RenderBackend* backend, void* ctx, int fillPolygons, int fromMemory) {
+    RenderBatch batch;
+    memset(&batch, 0, sizeof(batch));
+
+    // Os polígonos inteiros (do array empacotado) e os simplificados.
+    const Point* polygonVertices[2] = {s_packed, s_lodVertices};
+    int polygonNumVertices[2] = {s_packedCount, s_numLodVertices};
+    const int* polygonFirst[2] = {s_polyFirst, s_lodFirst};
+    const int* polygonCount[2] = {s_polyCount, s_lodCount};
+    int numPolygons[2] = {s_numPackedPolygons, s_useDrawLists ? s_numLodPolygons : 0};
+    const void* polygonRetained[2] = {&s_polygonBuffer, NULL};
+    if (s_useDrawLists) {
+        polygonFirst[0] = s_drawFirst;
+        polygonCount[0] = s_drawCount;
+        numPolygons[0] = s_numDrawPolygons;
+    }
+
+    for (int stage = 0; stage < 3; stage++) {
+        if (stage == 0 && !fillPolygons) continue;
+        if (stage == 0) {
+            batch.type = RENDER_BATCH_POLYGON_FILL;
+            batch.color = (RenderColor){0.0f, 0.0f, 1.0f, RENDER_POLYGON_FILL_ALPHA};
+            batch.size = 0.0f;
+        } else if (stage == 1) {
+            batch.type = RENDER_BATCH_POLYGON_OUTLINE;
+            batch.color = (RenderColor){0.0f, 0.0f, 1.0f, 1.0f};
+            batch.size = 2.0f;
+        } else {
+            // Vértices de todos os polígonos como pontos de controle.
+            batch.type = RENDER_BATCH_POINTS;
+            batch.color = (RenderColor){0.5f, 0.5f, 0.5f, 1.0f};
+            batch.size = CLICK_TOLERANCE / 2.0f;
+        }
+        for (int list = 0; list < 2; list++) {
+            if (numPolygons[list] == 0) continue;
+            batch.vertices = polygonVertices[list];
+            batch.numVertices = polygonNumVertices[list];
+            batch.polygonFirst = polygonFirst[list];
+            batch.polygonCount = polygonCount[list];
+            batch.numPolygons = numPolygons[list];
+            batch.retained = polygonRetained[list];
+            backend->drawBatch(ctx, &batch);
+        }
+    }
+    batch.polygonFirst = NULL;
+    batch.polygonCount = NULL;
+    batch.numPolygons = 0;
+
+    if (s_numLodPoints > 0) {
+        // Polígonos menores que um pixel: o ponto de controle cobre o polígono inteiro.
+        batch.type = RENDER_BATCH_POINTS;
+        batch.vertices = s_lodPoints;
+        batch.numVertices = s_numLodPoints;
+        batch.retained = NULL;
+        batch.color = (RenderColor){0.5f, 0.5f, 0.5f, 1.0f};
+        batch.size = CLICK_TOLERANCE / 2.0f;
+        backend->drawBatch(ctx, &batch);
+    }
+
+    if (g_numSegments > 0 && (!s_cullElements || s_numSegmentIndices > 0)) {
+        batch.type = RENDER_BATCH_LINES;
+        batch.vertices = (const Point*)g_segments;
+        batch.numVertices = 2 * g_numSegments;
+        if (fromMemory) {
+            batch.vertices = animatedVertices(batch.vertices, batch.numVertices, OBJECT_TYPE_SEGMENT, 2,
+                                              &s_animatedSegments, &s_animatedSegmentCapacity);
+        }
+        batch.indices = s_cullElements ? s_segmentIndices : NULL;
+        batch.numIndices = s_cullElements ? s_numSegmentIndices : 0;
+        batch.retained = &s_segmentBuffer;
+        batch.color = (RenderColor){0.0f, 0.0f, 1.0f, 1.0f};
+        batch.size = 2.0f;
+        backend->drawBatch(ctx, &batch);
+    }
+
+    if (g_numPoints > 0 && (!s_cullElements || s_numPointIndices > 0)) {
+        batch.type = RENDER_BATCH_POINTS;
+        batch.vertices = g_points;
+        batch.numVertices = g_numPoints;
+        if (fromMemory) {
+            batch.vertices = animatedVertices(batch.vertices, batch.numVertices, OBJECT_TYPE_POINT, 1,
+                                              &s_animatedPoints, &s_animatedPointCapacity);
+        }
+        batch.indices = s_cullElements ? s_pointIndices : NULL;
+        batch.numIndices = s_cullElements ? s_numPointIndices : 0;
+        batch.retained = &s_pointBuffer;
+        batch.color = (RenderColor){0.0f, 0.0f, 1.0f, 1.0f};
+        batch.size = CLICK_TOLERANCE / 1.3f;
+        backend->drawBatch(ctx, &batch);
+    }
+}
+
+// --- SEÇÃO DO BACKEND OPENGL ---
+
+/**
+ * @brief Desenha os vértices de um lote: um trecho por polígono, os índices ou todos em sequência.
+ */
+static void glDrawBatchVertices(GLenum mode, const RenderBatch* batch) {
+    if (batch->polygonFirst) {
+        if (s_glMultiDrawArrays) {
+            s_glMultiDrawArrays(mode, batch->polygonFirst, batch->polygonCount, batch->numPolygons);
+        } else {
+            for (int k = 0; k < batch->numPolygons; k++) {
+                glDrawArrays(mode, batch->polygonFirst[k], batch->polygonCount[k]);
+            }
+        }
+    } else if (batch->indices) {
+        glDrawElements(mode, batch->numIndices, GL_UNSIGNED_INT, batch->indices);
+    } else {
+        glDrawArrays(mode, 0, batch->numVertices);
+    }
+}
+
+/**
+ * @brief Desenha um lote com vertex arrays, a partir do VBO retido ou da memória.
+ *
+ * O interior dos polígonos não é desenhado: o OpenGL de função fixa só
+ * preenche polígonos convexos, e a janela mostra apenas os contornos.
+ */
+static void glDrawBatch(void* ctx, const RenderBatch* batch) {
+    (void)ctx;
+    if (batch->type == RENDER_BATCH_POLYGON_FILL) return;
+
+    const RetainedBuffer* retained = (const RetainedBuffer*)batch->retained;
+    if (s_useVbo && retained) {
+        s_glBindBuffer(GL_ARRAY_BUFFER, retained->id);
+        glVertexPointer(2, GL_FLOAT, sizeof(Point), NULL);
+    } else {
+        if (s_useVbo) s_glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glVertexPointer(2, GL_FLOAT, sizeof(Point), batch->vertices);
+    }
+    glColor4f(batch->color.r, batch->color.g, batch->color.b, batch->color.a);
+
+    switch (batch->type) {
+        case RENDER_BATCH_POLYGON_OUTLINE:
+            glLineWidth(batch->size);
+            glDrawBatchVertices(GL_LINE_LOOP, batch);
+            glLineWidth(1.0f);
+            break;
+        case RENDER_BATCH_LINES:
+            glLineWidth(batch->size);
+            glDrawBatchVertices(GL_LINES, batch);
+            glLineWidth(1.0f);
+            break;
+        case RENDER_BATCH_POINTS:
+            glPointSize(batch->size);
+            glDrawBatchVertices(GL_POINTS, batch);
+            glPointSize(1.0f);
+            break;
+        default:
+            break;
+    }
+}
+
+static const RenderBackend s_glBackend = {glDrawBatch};
+
+// --- SEÇÃO DE FUNÇÕES PÚBLICAS ---
 
 void renderAllObjects() {
-    // Delega a responsabilidade de desenhar todos os objetos
-    // para a funo drawAllObjects() do mdulo 'objects'.
-    drawAllObjects();
+    double profileStart = profileBegin();
+    if (!s_initialized) {
+        initRenderer();
+    }
+    s_framePending = 0;
+    prepareScene();
+    buildDrawLists(&s_windowView);
+
+    // Envia apenas o que mudou desde o último quadro.
+    syncBuffer(&s_pointBuffer, g_points, g_pointOwners, g_numPoints, 1);
+    syncBuffer(&s_segmentBuffer, (const Point*)g_segments, g_segmentOwners, g_numSegments, 2);
+    syncBuffer(&s_polygonBuffer, s_packed, NULL, s_packedCount, 1);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    emitBatches(&s_glBackend, NULL, 0, !s_useVbo);
+    if (s_useVbo) {
+        s_glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    // O objeto selecionado é redesenhado por cima do lote, em destaque, junto
+    // com a pré-visualização dos objetos em criação.
+    drawObjectOverlays();
+    profileEnd(PROFILE_DRAW, profileStart);
+}
+
+void renderSceneWithBackend(const RenderBackend* backend, void* ctx, int fillPolygons, const RenderView* view) {
+    prepareScene();
+    buildDrawLists(view);
+    emitBatches(backend, ctx, fillPolygons, 1);
+}
+
+void renderSetView(const RenderView* view) {
+    s_windowView = *view;
+    renderRequestFrame();
+}
+
+void renderGetStats(RenderStats* stats) {
+    *stats = s_stats;
+}
+
+void renderMarkDirty(ObjectType type, int slot) {
+    renderRequestFrame();
+    // A caixa nova entra na da cena; a antiga pode ter deixado uma sobra.
+    growSceneBounds(type, slot);
+    if (s_sceneBoundsMoves < INT_MAX) s_sceneBoundsMoves++;
+    switch (type) {
+        case OBJECT_TYPE_POINT:
+            markRange(&s_pointBuffer, slot, slot);
+            break;
+        case OBJECT_TYPE_SEGMENT:
+            markRange(&s_segmentBuffer, slot, slot);
+            break;
+        case OBJECT_TYPE_POLYGON:
+            updatePackedPolygon(slot);
+            break;
+    }
+}
+
+void renderMarkRemoved(ObjectType type, int slot) {
+    renderRequestFrame();
+    s_sceneBoundsLoose = 1;
+    switch (type) {
+        case OBJECT_TYPE_POINT:
+            // O último ponto foi movido para 'slot'; a contagem já foi reduzida.
+            if (slot < g_numPoints) markRange(&s_pointBuffer, slot, slot);
+            break;
+        case OBJECT_TYPE_SEGMENT:
+            if (slot < g_numSegments) markRange(&s_segmentBuffer, slot, slot);
+            break;
+        case OBJECT_TYPE_POLYGON:
+            removePackedPolygon(slot);
+            break;
+    }
+}
+
+void renderInvalidateAll(void) {
+    renderRequestFrame();
+    markAll(&s_pointBuffer);
+    markAll(&s_segmentBuffer);
+    s_layoutDirty = 1;
+    // Uma caixa infinita não cabe em nenhuma região: força o recálculo.
+    s_sceneBounds = (BoundingBox){-FLT_MAX, -FLT_MAX, FLT_MAX, FLT_MAX};
+    s_sceneBoundsLoose = 1;
+}
+
+void renderRequestFrame(void) {
+    if (s_framePending) return;
+    s_framePending = 1;
+    if (s_frameRequestHook) {
+        s_frameRequestHook();
+    }
+}
+
+int renderFramePending(void) {
+    return s_framePending;
+}
+
+void renderSetFrameRequestHook(void (*hook)(void)) {
+    s_frameRequestHook = hook;
+}
+
+void renderShutdown(void) {
+    free(s_packed);
+    free(s_staging);
+    free(s_animatedPoints);
+    free(s_animatedSegments);
+    free(s_polyFirst);
+    free(s_polyCount);
+    free(s_polyReserved);
+    free(s_pointIndices);
+    free(s_segmentIndices);
+    free(s_drawFirst);
+    free(s_drawCount);
+    free(s_lodFirst);
+    free(s_lodCount);
+    free(s_lodPoints);
+    free(s_lodVertices);
+    s_packed = NULL;
+    s_staging = NULL;
+    s_stagingCapacity = 0;
+    s_animatedPoints = NULL;
+    s_animatedPointCapacity = 0;
+    s_animatedSegments = NULL;
+    s_animatedSegmentCapacity = 0;
+    s_polyFirst = NULL;
+    s_polyCount = NULL;
+    s_polyReserved = NULL;
+    s_packedCount = 0;
+    s_packedLive = 0;
+    s_packedCapacity = 0;
+    s_numPackedPolygons = 0;
+    s_polyCapacity = 0;
+    s_layoutDirty = 1;
+    s_pointIndices = NULL;
+    s_segmentIndices = NULL;
+    s_drawFirst = NULL;
+    s_drawCount = NULL;
+    s_lodFirst = NULL;
+    s_lodCount = NULL;
+    s_lodPoints = NULL;
+    s_lodVertices = NULL;
+    s_pointIndexCapacity = 0;
+    s_segmentIndexCapacity = 0;
+    s_polygonListCapacity = 0;
+    s_lodVertexCapacity = 0;
+    s_useDrawLists = 0;
+    s_cullElements = 0;
 }
@@ -1,23 +1,185 @@
 /**
  * @file render.h
- * @brief Define a interface pblica para o mdulo de renderizao.
+ * @brief Define a interface pública para o módulo de renderização.
  *
- * Este arquivo expe a funo principal de desenho que  chamada pela
+ * Este arquivo expõe a função principal de desenho que é chamada pela
  * biblioteca GLUT para renderizar a cena.
+ *
+ * A renderização é "retida": a geometria dos objetos fica em vertex buffers
+ * (VBOs) e só os trechos de objetos modificados são reenviados. Cada tipo de
+ * primitiva é desenhado com uma única chamada em lote. O módulo 'objects'
+ * avisa o renderizador de cada mudança pelas funções renderMark...().
+ *
+ * A descrição da cena em lotes (renderSceneWithBackend()) não depende do
+ * OpenGL: a janela usa um backend OpenGL e a exportação sem janela usa o
+ * rasterizador em software (rasterizer.h), com os mesmos lotes e cores.
+ *
+ * Cada destino informa a região do mundo que mostra (RenderView). Quando a
+ * cena não cabe nela, só os objetos que o índice espacial encontra na região
+ * são emitidos; polígonos menores que um pixel viram um ponto e polígonos
+ * com mais vértices do que pixels no contorno são simplificados. Assim, o
+ * custo do desenho acompanha o que aparece, não o tamanho da cena.
  */
 
 #ifndef RENDER_H
 #define RENDER_H
 
-// --- SEO DE PROTTIPOS DE FUNES PBLICAS ---
+#include "objects.h"
+
+// --- SEÇÃO DA INTERFACE DE BACKENDS ---
+
+/**
+ * @brief Uma cor RGBA, com componentes de 0 a 1.
+ */
+typedef struct {
+    float r, g, b, a;
+} RenderColor;
+
+/**
+ * @brief Os tipos de lote que a cena emite.
+ */
+typedef enum {
+    RENDER_BATCH_POLYGON_FILL,      ///< Interior dos polígonos (regra par-ímpar).
+    RENDER_BATCH_POLYGON_OUTLINE,   ///< Contorno fechado dos polígonos.
+    RENDER_BATCH_LINES,             ///< Segmentos independentes, um par de vértices por segmento.
+    RENDER_BATCH_POINTS             ///< Pontos quadrados, um vértice por ponto.
+} RenderBatchType;
+
+/**
+ * @brief Um lote de primitivas da mesma cor e espessura.
+ */
+typedef struct {
+    RenderBatchType type;
+    const Point* vertices;          ///< Vértices no mundo, na posição de desenho.
+    int numVertices;
+    const int* polygonFirst;        ///< Só polígonos: posição do primeiro vértice de cada um em 'vertices'.
+    const int* polygonCount;        ///< Só polígonos: quantidade de vértices de cada um.
+    int numPolygons;
+    const unsigned int* indices;    ///< Só pontos e linhas: os vértices a desenhar, como em glDrawElements (NULL para todos).
+    int numIndices;
+    RenderColor color;
+    float size;                     ///< Espessura das linhas ou lado dos pontos, em pixels na escala 1:1.
+    const void* retained;           ///< Cópia dos vértices já na placa de vídeo (uso do backend OpenGL), ou NULL.
+} RenderBatch;
+
+/**
+ * @brief Um destino de desenho: recebe os lotes da cena, em ordem de baixo para cima.
+ */
+typedef struct {
+    void (*drawBatch)(void* ctx, const RenderBatch* batch);
+} RenderBackend;
+
+/**
+ * @brief A região do mundo que um destino mostra e a sua escala.
+ */
+typedef struct {
+    float minX, minY;               ///< Canto inferior esquerdo da região visível.
+    float maxX, maxY;               ///< Canto superior direito da região visível.
+    float pixelsPerUnit;            ///< Pixels do destino por unidade do mundo.
+} RenderView;
+
+/**
+ * @brief O que o último desenho emitiu, para o painel de tempo.
+ */
+typedef struct {
+    int drawnObjects;               ///< Objetos emitidos (os demais estavam fora da região).
+    int simplifiedPolygons;         ///< Polígonos emitidos com menos vértices.
+    int collapsedPolygons;          ///< Polígonos menores que um pixel, emitidos como um ponto.
+} RenderStats;
+
+// --- SEÇÃO DE PROTÓTIPOS DE FUNÇÕES PÚBLICAS ---
 
 /**
- * @brief Ponto de entrada para o processo de renderizao da cena.
+ * @brief Ponto de entrada para o processo de renderização da cena.
  *
- * Esta funo  chamada pelo displayCallback do GLUT e  responsvel
- * por orquestrar o desenho de todos os objetos na tela, delegando
- * a tarefa para o mdulo 'objects'.
+ * Esta função é chamada pelo displayCallback do GLUT. Envia à placa de
+ * vídeo os trechos de geometria marcados como modificados, desenha todos os
+ * objetos em lote e, por fim, delega ao módulo 'objects' o destaque do
+ * objeto selecionado e a pré-visualização dos objetos em criação.
  */
 void renderAllObjects();
 
+/**
+ * @brief Emite os objetos da cena, em lotes, para um backend qualquer.
+ *
+ * Aplica as transformações pendentes e usa as mesmas cores e espessuras do
+ * desenho na janela. Não desenha o destaque da seleção nem as
+ * pré-visualizações, que só existem na janela. Não faz chamadas OpenGL.
+ * @param backend O destino dos lotes.
+ * @param ctx Um ponteiro repassado ao backend.
+ * @param fillPolygons 1 para emitir também o interior dos polígonos (a janela só desenha o contorno).
+ * @param view A região mostrada pelo destino, que limita e simplifica o que é
+ *        emitido, ou NULL para emitir a cena inteira, sem simplificação.
+ */
+void renderSceneWithBackend(const RenderBackend* backend, void* ctx, int fillPolygons, const RenderView* view);
+
+/**
+ * @brief Define a região do mundo mostrada pela janela.
+ *
+ * Chamada pelo programa principal quando a janela muda de tamanho. Antes da
+ * primeira chamada, a região é a janela padrão, um pixel por unidade.
+ */
+void renderSetView(const RenderView* view);
+
+/**
+ * @brief Preenche o resumo do último desenho (da janela ou de renderSceneWithBackend()).
+ */
+void renderGetStats(RenderStats* stats);
+
+/**
+ * @brief Marca como modificado um elemento do array de geometria de um tipo.
+ *
+ * Deve ser chamada quando os vértices do elemento mudam ou quando um novo
+ * elemento é acrescentado ao fim do array. Não faz chamadas OpenGL; o envio
+ * acontece no próximo renderAllObjects().
+ * @param type O tipo do objeto (indica o array de geometria).
+ * @param slot A posição do elemento no array do seu tipo.
+ */
+void renderMarkDirty(ObjectType type, int slot);
+
+/**
+ * @brief Avisa que um elemento foi removido do array de geometria de um tipo.
+ *
+ * Como os arrays de geometria removem por troca com o último, a posição
+ * 'slot' (se ainda existir) passa a conter outro elemento.
+ * @param type O tipo do objeto removido.
+ * @param slot A posição que o elemento ocupava.
+ */
+void renderMarkRemoved(ObjectType type, int slot);
+
+/**
+ * @brief Marca a cena como modificada, pedindo que um novo quadro seja desenhado.
+ *
+ * Pedidos repetidos antes do próximo renderAllObjects() são agrupados em um
+ * só. As funções renderMark...() já chamam esta função.
+ */
+void renderRequestFrame(void);
+
+/**
+ * @brief Indica se há mudanças na cena ainda não desenhadas.
+ * @return int 1 se algum quadro foi pedido desde o último renderAllObjects().
+ */
+int renderFramePending(void);
+
+/**
+ * @brief Define a função chamada quando a cena passa de "desenhada" para "modificada".
+ *
+ * O programa principal registra aqui o glutPostRedisplay(). Sem função
+ * registrada (ex: sem janela), os pedidos apenas marcam a cena.
+ * @param hook A função a ser chamada, ou NULL.
+ */
+void renderSetFrameRequestHook(void (*hook)(void));
+
+/**
+ * @brief Descarta o estado retido e força o reenvio de toda a cena no próximo quadro.
+ */
+void renderInvalidateAll(void);
+
+/**
+ * @brief Libera a memória auxiliar do renderizador.
+ *
+ * Os buffers OpenGL são liberados junto com o contexto da janela.
+ */
+void renderShutdown(void);
+
 #endif // RENDER_H
@@ -0,0 +1,316 @@
+/**
+ * @file scenebin.c
+ * @brief Implementação do formato binário de cenas.
+ *
+ * Todas as seções começam em um deslocamento múltiplo de 8 bytes, então os
+ * floats podem ser lidos diretamente do arquivo mapeado. Os deslocamentos
+ * do cabeçalho são conferidos contra o tamanho do arquivo antes de qualquer
+ * leitura.
+ *
+ * Usa mmap() nos sistemas POSIX e MapViewOfFile() no Windows.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "scenebin.h"
+#include "config.h"
+#include "snapshot.h"
+
+// --- SEÇÃO DE ESTRUTURAS DO ARQUIVO ---
+
+#define SCENE_BIN_MAGIC "RBQS"
+#define SCENE_BIN_VERSION 1u
+#define SCENE_BIN_BYTE_ORDER 0x01020304u    ///< Lido ao contrário em uma máquina big-endian.
+
+/**
+ * @brief Cabeçalho do arquivo. Versões futuras só podem acrescentar campos ao final.
+ */
+typedef struct {
+    char magic[4];                  ///< Sempre "RBQS".
+    uint32_t version;               ///< Versão do formato que gravou o arquivo.
+    uint32_t byteOrder;             ///< SCENE_BIN_BYTE_ORDER na ordem de bytes de quem gravou.
+    uint32_t headerSize;            ///< sizeof(SceneBinHeader) de quem gravou.
+    uint32_t numPoints;
+    uint32_t numSegments;
+    uint32_t numPolygons;
+    uint32_t numAnimated;
+    uint64_t numVertices;           ///< Total de vértices de todos os polígonos.
+    uint64_t pointsOffset;          ///< numPoints registros Point.
+    uint64_t segmentsOffset;        ///< numSegments registros Segment.
+    uint64_t polygonSizesOffset;    ///< numPolygons contagens uint32_t.
+    uint64_t verticesOffset;        ///< numVertices registros Point, polígono após polígono.
+    uint64_t animOffset;            ///< numAnimated registros SceneAnimRecord.
+} SceneBinHeader;
+
+_Static_assert(sizeof(Point) == 2 * sizeof(float), "Point precisa ser dois floats sem preenchimento");
+_Static_assert(sizeof(Segment) == 2 * sizeof(Point), "Segment precisa ser dois Points sem preenchimento");
+_Static_assert(sizeof(SceneBinHeader) == 80, "O cabeçalho binário mudou de tamanho");
+_Static_assert(sizeof(SceneAnimRecord) == 24, "O registro de animação mudou de tamanho");
+
+// --- SEÇÃO DE MAPEAMENTO DE ARQUIVOS ---
+
+/**
+ * @brief Um arquivo mapeado somente para leitura.
+ */
+typedef struct {
+    const unsigned char* data;
+    uint64_t size;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+} MappedFile;
+
+#ifdef _WIN32
+static int mapFile(const char* filename, MappedFile* map) {
+    map->file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                            FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (map->file == INVALID_HANDLE_VALUE) return 0;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(map->file, &size) || size.QuadPart == 0) {
+        CloseHandle(map->file);
+        return 0;
+    }
+    map->size = (uint64_t)size.QuadPart;
+    map->mapping = CreateFileMappingA(map->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    map->data = map->mapping ? (const unsigned char*)MapViewOfFile(map->mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (!map->data) {
+        if (map->mapping) CloseHandle(map->mapping);
+        CloseHandle(map->file);
+        return 0;
+    }
+    return 1;
+}
+
+static void unmapFile(MappedFile* map) {
+    UnmapViewOfFile(map->data);
+    CloseHandle(map->mapping);
+    CloseHandle(map->file);
+}
+#else
+static int mapFile(const char* filename, MappedFile* map) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+    map->size = (uint64_t)st.st_size;
+    void* data = mmap(NULL, (size_t)map->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // O mapeamento continua válido sem o descritor.
+    if (data == MAP_FAILED) return 0;
+    madvise(data, (size_t)map->size, MADV_SEQUENTIAL);
+    map->data = (const unsigned char*)data;
+    return 1;
+}
+
+static void unmapFile(MappedFile* map) {
+    munmap((void*)map->data, (size_t)map->size);
+}
+#endif
+
+// --- SEÇÃO DE FUNÇÕES AUXILIARES (IMPLEMENTAÇÃO PRIVADA) ---
+
+static uint64_t alignSection(uint64_t offset) {
+    return (offset + 7u) & ~(uint64_t)7u;
+}
+
+/**
+ * @brief Verifica se a seção [offset, offset + count * itemSize) cabe no arquivo e está alinhada.
+ */
+static int sectionFits(uint64_t offset, uint64_t count, uint64_t itemSize, uint64_t fileSize) {
+    if (offset % 8 != 0 || offset > fileSize) return 0;
+    return count <= (fileSize - offset) / itemSize;
+}
+
+/**
+ * @brief Escreve zeros até o arquivo chegar ao deslocamento 'offset'.
+ */
+static int padTo(FILE* f, uint64_t* written, uint64_t offset) {
+    static const char zeros[8] = {0};
+    size_t gap = (size_t)(offset - *written);
+    *written = offset;
+    return gap == 0 || fwrite(zeros, 1, gap, f) == gap;
+}
+
+/**
+ * @brief Confere o cabeçalho e a tabela de polígonos de um arquivo mapeado.
+ * @return const char* NULL se o arquivo é válido, ou a descrição do problema.
+ */
+static const char* validateScene(const MappedFile* map, const SceneBinHeader* h) {
+    if (memcmp(h->magic, SCENE_BIN_MAGIC, 4) != 0) return "não é uma cena binária";
+    if (h->byteOrder != SCENE_BIN_BYTE_ORDER) return "gravado com outra ordem de bytes";
+    if (h->version > SCENE_BIN_VERSION) return "versão do formato mais nova que este programa";
+    if (h->headerSize < sizeof(SceneBinHeader) || map->size < h->headerSize) return "cabeçalho truncado";
+
+    uint64_t size = map->size;
+    if (!sectionFits(h->pointsOffset, h->numPoints, sizeof(Point), size) ||
+        !sectionFits(h->segmentsOffset, h->numSegments, sizeof(Segment), size) ||
+        !sectionFits(h->polygonSizesOffset, h->numPolygons, sizeof(uint32_t), size) ||
+        !sectionFits(h->verticesOffset, h->numVertices, sizeof(Point), size) ||
+        !sectionFits(h->animOffset, h->numAnimated, sizeof(SceneAnimRecord), size)) {
+        return "seção fora dos limites do arquivo";
+    }
+
+    const uint32_t* sizes = (const uint32_t*)(map->data + h->polygonSizesOffset);
+    uint64_t total = 0;
+    for (uint32_t k = 0; k < h->numPolygons; k++) {
+        if (sizes[k] == 0 || sizes[k] > INT32_MAX) return "polígono com quantidade de vértices inválida";
+        total += sizes[k];
+    }
+    if (total != h->numVertices) return "a soma dos vértices dos polígonos não confere";
+    return NULL;
+}
+
+/**
+ * @brief Devolve o arquivo mapeado emprestado a um snapshot.
+ */
+static void releaseMappedFile(void* ctx) {
+    MappedFile* map = (MappedFile*)ctx;
+    unmapFile(map);
+    free(map);
+}
+
+/**
+ * @brief Escreve 'count' itens em blocos, atualizando o andamento e atendendo a um cancelamento.
+ * @return int 1 em caso de sucesso, 0 em caso de erro de escrita ou cancelamento.
+ */
+static int writeItems(FILE* f, const void* items, size_t count, size_t itemSize, SceneIoStatus* status) {
+    const size_t chunk = 65536;
+    const char* bytes = (const char*)items;
+    for (size_t first = 0; first < count; first += chunk) {
+        size_t n = count - first < chunk ? count - first : chunk;
+        if (fwrite(bytes + first * itemSize, itemSize, n, f) != n) return 0;
+        if (status) {
+            atomic_fetch_add(&status->done, (long long)n);
+            if (atomic_load(&status->cancel)) return 0;
+        }
+    }
+    return 1;
+}
+
+// --- SEÇÃO DE FUNÇÕES PÚBLICAS ---
+
+int sceneFileIsBinary(const char* filename) {
+    size_t length = strlen(filename);
+    size_t extLength = strlen(SCENE_BINARY_EXTENSION);
+    return length >= extLength && strcmp(filename + length - extLength, SCENE_BINARY_EXTENSION) == 0;
+}
+
+int writeSceneBinary(const SceneSnapshot* snap, const char* filename, SceneIoStatus* status) {
+    FILE* f = fopen(filename, "wb");
+    if (!f) {
+        fprintf(stderr, "[Scene ERROR] Nao foi possivel abrir '%s' para escrita.\n", filename);
+        return 0;
+    }
+
+    SceneBinHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, SCENE_BIN_MAGIC, 4);
+    h.version = SCENE_BIN_VERSION;
+    h.byteOrder = SCENE_BIN_BYTE_ORDER;
+    h.headerSize = sizeof(SceneBinHeader);
+    h.numPoints = (uint32_t)snap->numPoints;
+    h.numSegments = (uint32_t)snap->numSegments;
+    h.numPolygons = (uint32_t)snap->numPolygons;
+    h.numAnimated = (uint32_t)snap->numAnimated;
+    h.numVertices = (uint64_t)snap->numVertices;
+    h.pointsOffset = alignSection(sizeof(SceneBinHeader));
+    h.segmentsOffset = alignSection(h.pointsOffset + (uint64_t)h.numPoints * sizeof(Point));
+    h.polygonSizesOffset = alignSection(h.segmentsOffset + (uint64_t)h.numSegments * sizeof(Segment));
+    h.verticesOffset = alignSection(h.polygonSizesOffset + (uint64_t)h.numPolygons * sizeof(uint32_t));
+    h.animOffset = alignSection(h.verticesOffset + h.numVertices * sizeof(Point));
+    if (status) {
+        atomic_store(&status->total, (long long)(h.numPoints + h.numSegments + h.numPolygons + h.numVertices + h.numAnimated));
+    }
+
+    // Cada seção do snapshot já é um array contíguo.
+    uint64_t written = sizeof(SceneBinHeader);
+    int ok = fwrite(&h, sizeof(h), 1, f) == 1;
+    ok = ok && padTo(f, &written, h.pointsOffset);
+    ok = ok && writeItems(f, snap->points, h.numPoints, sizeof(Point), status);
+    written += (uint64_t)h.numPoints * sizeof(Point);
+    ok = ok && padTo(f, &written, h.segmentsOffset);
+    ok = ok && writeItems(f, snap->segments, h.numSegments, sizeof(Segment), status);
+    written += (uint64_t)h.numSegments * sizeof(Segment);
+    ok = ok && padTo(f, &written, h.polygonSizesOffset);
+    ok = ok && writeItems(f, snap->polygonSizes, h.numPolygons, sizeof(uint32_t), status);
+    written += (uint64_t)h.numPolygons * sizeof(uint32_t);
+    ok = ok && padTo(f, &written, h.verticesOffset);
+    ok = ok && writeItems(f, snap->vertices, (size_t)h.numVertices, sizeof(Point), status);
+    written += h.numVertices * sizeof(Point);
+    ok = ok && padTo(f, &written, h.animOffset);
+    ok = ok && writeItems(f, snap->anims, h.numAnimated, sizeof(SceneAnimRecord), status);
+
+    if (fclose(f) != 0) ok = 0;
+    if (!ok && !(status && atomic_load(&status->cancel))) {
+        fprintf(stderr, "[Scene ERROR] Falha ao escrever '%s'.\n", filename);
+    }
+    return ok;
+}
+
+int readSceneBinary(const char* filename, SceneSnapshot* snap, SceneIoStatus* status) {
+    MappedFile* map = (MappedFile*)malloc(sizeof(MappedFile));
+    if (!map || !mapFile(filename, map)) {
+        fprintf(stderr, "[Scene ERROR] Nao foi possivel abrir '%s' para leitura.\n", filename);
+        free(map);
+        return 0;
+    }
+
+    SceneBinHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(&h, map->data, map->size < sizeof(h) ? (size_t)map->size : sizeof(h));
+    const char* problem = validateScene(map, &h);
+    if (problem) {
+        fprintf(stderr, "[Scene ERROR] '%s': %s.\n", filename, problem);
+        releaseMappedFile(map);
+        return 0;
+    }
+
+    // Lê uma palavra de cada página para que o disco seja lido aqui, e não
+    // quando a cena for instalada (possivelmente na thread da interface).
+    const uint64_t stride = 4096;
+    volatile unsigned char sink = 0;
+    if (status) atomic_store(&status->total, (long long)map->size);
+    for (uint64_t offset = 0; offset < map->size; offset += stride) {
+        sink ^= map->data[offset];
+        if (status && (offset & ((1u << 20) - 1)) == 0) {
+            atomic_store(&status->done, (long long)offset);
+            if (atomic_load(&status->cancel)) {
+                releaseMappedFile(map);
+                return 0;
+            }
+        }
+    }
+    (void)sink;
+    if (status) atomic_store(&status->done, (long long)map->size);
+
+    // O snapshot aponta direto para as seções do arquivo mapeado (somente leitura).
+    snapshotInit(snap);
+    snap->points = (Point*)(map->data + h.pointsOffset);
+    snap->numPoints = (int)h.numPoints;
+    snap->segments = (Segment*)(map->data + h.segmentsOffset);
+    snap->numSegments = (int)h.numSegments;
+    snap->polygonSizes = (uint32_t*)(map->data + h.polygonSizesOffset);
+    snap->numPolygons = (int)h.numPolygons;
+    snap->vertices = (Point*)(map->data + h.verticesOffset);
+    snap->numVertices = (size_t)h.numVertices;
+    snap->anims = (SceneAnimRecord*)(map->data + h.animOffset);
+    snap->numAnimated = (int)h.numAnimated;
+    snap->releaseBorrowed = releaseMappedFile;
+    snap->borrowedCtx = map;
+    return 1;
+}
@@ -0,0 +1,52 @@
+/**
+ * @file scenebin.h
+ * @brief Define a interface do formato binário de cenas (".rbq").
+ *
+ * O arquivo começa com um cabeçalho versionado seguido de seções contíguas:
+ * os pontos, os segmentos, a quantidade de vértices de cada polígono, um
+ * bloco único com os vértices de todos os polígonos e, por fim, o estado
+ * dos objetos animados. Os números são gravados exatamente como estão na
+ * memória (float de 32 bits, little-endian), então salvar e carregar uma
+ * cena não perde precisão. A leitura mapeia o arquivo na memória e entrega
+ * um snapshot que aponta direto para as seções do arquivo, sem cópias.
+ */
+
+#ifndef SCENEBIN_H
+#define SCENEBIN_H
+
+#include "snapshot.h"
+
+// --- SEÇÃO DE PROTÓTIPOS DE FUNÇÕES PÚBLICAS ---
+
+/**
+ * @brief Verifica, pela extensão, se um nome de arquivo se refere a uma cena binária.
+ * @param filename O nome do arquivo.
+ * @return int 1 se o nome termina em SCENE_BINARY_EXTENSION, 0 caso contrário.
+ */
+int sceneFileIsBinary(const char* filename);
+
+/**
+ * @brief Escreve um snapshot no formato binário.
+ *
+ * Pode rodar em qualquer thread.
+ * @param snap O snapshot a ser escrito.
+ * @param filename O nome do arquivo a ser criado.
+ * @param status Recebe o andamento (em objetos e vértices) e pode cancelar a escrita (NULL para ignorar).
+ * @return int 1 em caso de sucesso, 0 em caso de erro ou cancelamento.
+ */
+int writeSceneBinary(const SceneSnapshot* snap, const char* filename, SceneIoStatus* status);
+
+/**
+ * @brief Lê um arquivo binário para um snapshot.
+ *
+ * O arquivo inteiro é validado e lido do disco aqui; o snapshot resultante
+ * aponta para o arquivo mapeado, que só é liberado por snapshotFree(). Pode
+ * rodar em qualquer thread.
+ * @param filename O nome do arquivo a ser lido.
+ * @param snap Recebe a cena lida.
+ * @param status Recebe o andamento (em bytes) e pode cancelar a leitura (NULL para ignorar).
+ * @return int 1 em caso de sucesso, 0 se o arquivo é inválido, não pôde ser lido ou a leitura foi cancelada.
+ */
+int readSceneBinary(const char* filename, SceneSnapshot* snap, SceneIoStatus* status);
+
+#endif // SCENEBIN_H
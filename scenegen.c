@@ -0,0 +1,165 @@
+/**
+ * @file scenegen.c
+ * @brief Implementação do gerador de cenas sintéticas.
+ *
+ * O gerador pseudoaleatório é o SplitMix64, que só usa aritmética inteira;
+ * os sorteios em float são montados a partir dos bits dele, então a
+ * sequência não depende do rand() da biblioteca C.
+ */
+
+#include <stdio.h>
+#include <math.h>
+
+#include "scenegen.h"
+#include "config.h"
+
+// --- SEÇÃO DE CONSTANTES PRIVADAS ---
+
+#define SCENEGEN_OBJECTS_PER_WINDOW 1000    ///< Objetos que ocupam a área da janela padrão, na densidade padrão.
+#define SCENEGEN_POWER_ALPHA 1.2f           ///< O expoente da distribuição de cauda longa.
+#define SCENEGEN_TWO_PI 6.28318530718f
+
+// --- SEÇÃO DE FUNÇÕES AUXILIARES ---
+
+/**
+ * @brief Sorteia um float uniforme em [0, 1), com 24 bits aleatórios.
+ */
+static float randomUnit(unsigned long long* state) {
+    return (float)(sceneGenRandom(state) >> 40) * (1.0f / 16777216.0f);
+}
+
+static float randomRange(unsigned long long* state, float low, float high) {
+    return low + (high - low) * randomUnit(state);
+}
+
+/**
+ * @brief Sorteia a quantidade de vértices de um polígono.
+ */
+static int randomVertexCount(const SceneGenParams* params, unsigned long long* state) {
+    int span = params->maxVertices - params->minVertices;
+    float u = randomUnit(state);
+    int extra;
+    if (params->distribution == SCENEGEN_VERTICES_POWER) {
+        // Pareto: min / (1 - u)^(1 / alfa), cortado no máximo.
+        float value = (float)params->minVertices / powf(1.0f - u, 1.0f / SCENEGEN_POWER_ALPHA);
+        extra = value - params->minVertices > span ? span : (int)(value - params->minVertices);
+    } else {
+        extra = (int)(u * (span + 1));
+        if (extra > span) extra = span;
+    }
+    return params->minVertices + extra;
+}
+
+/**
+ * @brief Sorteia um centro dentro da área, afastado das bordas pelo tamanho dos objetos.
+ */
+static Point randomCenter(const SceneGenParams* params, unsigned long long* state) {
+    float margin = 2.0f * params->objectSize;
+    Point c;
+    c.x = margin < params->width * 0.5f ? randomRange(state, margin, params->width - margin) : params->width * 0.5f;
+    c.y = margin < params->height * 0.5f ? randomRange(state, margin, params->height - margin) : params->height * 0.5f;
+    return c;
+}
+
+/**
+ * @brief Acrescenta um polígono simples ao snapshot.
+ *
+ * Os ângulos dos vértices são igualmente espaçados com um desvio menor do
+ * que meio espaço, então ficam sempre em ordem. Com raio único, os vértices
+ * estão em um círculo e o polígono é convexo; alternando raios, ele vira
+ * uma estrela, côncava a partir de 4 vértices.
+ */
+static int addPolygon(SceneSnapshot* snap, const SceneGenParams* params, unsigned long long* state) {
+    int n = randomVertexCount(params, state);
+    int concave = n >= 4 && randomUnit(state) < params->concaveFraction;
+    Point c = randomCenter(params, state);
+    float radius = params->objectSize * randomRange(state, 0.5f, 1.5f);
+    float innerRatio = randomRange(state, 0.35f, 0.7f);
+    float spacing = SCENEGEN_TWO_PI / n;
+    float offset = randomRange(state, 0.0f, spacing);
+
+    if (!snapshotBeginPolygon(snap, n)) return 0;
+    for (int v = 0; v < n; v++) {
+        float angle = offset + spacing * (v + randomRange(state, -0.4f, 0.4f));
+        float r = (concave && (v & 1)) ? radius * innerRatio : radius;
+        Point p = {c.x + r * cosf(angle), c.y + r * sinf(angle)};
+        if (!snapshotAddVertex(snap, p)) return 0;
+    }
+    snapshotEndPolygon(snap);
+    return 1;
+}
+
+// --- SEÇÃO DE FUNÇÕES PÚBLICAS ---
+
+unsigned long long sceneGenRandom(unsigned long long* state) {
+    unsigned long long z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void sceneGenDefaults(SceneGenParams* params, int numObjects) {
+    if (numObjects < 0) numObjects = 0;
+    params->numPoints = numObjects * 4 / 10;
+    params->numSegments = numObjects * 3 / 10;
+    params->numPolygons = numObjects - params->numPoints - params->numSegments;
+
+    float scale = sqrtf((float)numObjects / SCENEGEN_OBJECTS_PER_WINDOW);
+    if (scale < 1.0f) scale = 1.0f;
+    params->width = WINDOW_WIDTH * scale;
+    params->height = WINDOW_HEIGHT * scale;
+    params->objectSize = 6.0f;
+    params->minVertices = 3;
+    params->maxVertices = 64;
+    params->distribution = SCENEGEN_VERTICES_POWER;
+    params->concaveFraction = 0.5f;
+    params->animatedFraction = 0.0f;
+    params->seed = 20240501ULL;
+}
+
+int sceneGenerate(const SceneGenParams* params, SceneSnapshot* snap) {
+    if (params->numPoints < 0 || params->numSegments < 0 || params->numPolygons < 0 ||
+        params->minVertices < 3 || params->maxVertices < params->minVertices ||
+        params->width <= 0.0f || params->height <= 0.0f || params->objectSize <= 0.0f) {
+        fprintf(stderr, "[SceneGen ERROR] Parâmetros inválidos para a cena gerada.\n");
+        return 0;
+    }
+    if (!snapshotReserve(snap, params->numPoints, params->numSegments, params->numPolygons)) {
+        fprintf(stderr, "[SceneGen ERROR] Memória insuficiente para a cena gerada.\n");
+        return 0;
+    }
+
+    unsigned long long state = params->seed;
+    int ok = 1;
+    for (int k = 0; ok && k < params->numPoints; k++) {
+        ok = snapshotAddPoint(snap, randomCenter(params, &state));
+    }
+    for (int k = 0; ok && k < params->numSegments; k++) {
+        Point c = randomCenter(params, &state);
+        float angle = randomRange(&state, 0.0f, SCENEGEN_TWO_PI);
+        float half = params->objectSize * randomRange(&state, 0.5f, 2.0f);
+        Segment s;
+        s.p1.x = c.x - half * cosf(angle);
+        s.p1.y = c.y - half * sinf(angle);
+        s.p2.x = c.x + half * cosf(angle);
+        s.p2.y = c.y + half * sinf(angle);
+        ok = snapshotAddSegment(snap, s);
+    }
+    for (int k = 0; ok && k < params->numPolygons; k++) {
+        ok = addPolygon(snap, params, &state);
+    }
+
+    // A animação usa a ordem de carga: pontos, segmentos e então polígonos.
+    int numObjects = params->numPoints + params->numSegments + params->numPolygons;
+    for (int i = 0; ok && params->animatedFraction > 0.0f && i < numObjects; i++) {
+        if (randomUnit(&state) >= params->animatedFraction) continue;
+        float angle = randomRange(&state, 0.0f, SCENEGEN_TWO_PI);
+        float speed = randomRange(&state, 60.0f, 240.0f);
+        SceneAnimRecord anim = {(uint32_t)i, 0, speed * cosf(angle), speed * sinf(angle), 0.90f, 1200.0f};
+        ok = snapshotAddAnim(snap, &anim);
+    }
+    if (!ok) {
+        fprintf(stderr, "[SceneGen ERROR] Memória insuficiente para a cena gerada.\n");
+    }
+    return ok;
+}
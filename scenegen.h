@@ -0,0 +1,69 @@
+/**
+ * @file scenegen.h
+ * @brief Define a interface do gerador de cenas sintéticas, usado pelos benchmarks e pela linha de comando.
+ *
+ * O gerador espalha pontos, segmentos e polígonos convexos e côncavos
+ * (estrelados) em uma área retangular. A quantidade de vértices dos
+ * polígonos segue uma distribuição configurável. Tudo sai de um gerador
+ * pseudoaleatório com semente explícita, então os mesmos parâmetros geram
+ * sempre a mesma cena (entre plataformas diferentes, só o último bit das
+ * coordenadas pode mudar, conforme o cosf() e o sinf() da biblioteca C).
+ */
+
+#ifndef SCENEGEN_H
+#define SCENEGEN_H
+
+#include "snapshot.h"
+
+// --- SEÇÃO DE ESTRUTURAS E TIPOS ---
+
+/**
+ * @brief Como a quantidade de vértices de cada polígono é sorteada.
+ */
+typedef enum {
+    SCENEGEN_VERTICES_UNIFORM,  ///< Uniforme entre 'minVertices' e 'maxVertices'.
+    SCENEGEN_VERTICES_POWER     ///< Cauda longa (Pareto): a maioria perto de 'minVertices', alguns perto de 'maxVertices'.
+} SceneGenVertexDistribution;
+
+/**
+ * @brief Os parâmetros de uma cena gerada.
+ */
+typedef struct {
+    int numPoints, numSegments, numPolygons;
+    float width, height;                        ///< A área ocupada, a partir da origem.
+    float objectSize;                           ///< O raio típico de um polígono e o meio comprimento típico de um segmento.
+    int minVertices, maxVertices;               ///< A faixa de vértices por polígono (mínimo 3).
+    SceneGenVertexDistribution distribution;
+    float concaveFraction;                      ///< A fração (0 a 1) de polígonos côncavos.
+    float animatedFraction;                     ///< A fração (0 a 1) de objetos com animação ligada.
+    unsigned long long seed;                    ///< A semente; a mesma semente gera a mesma cena.
+} SceneGenParams;
+
+// --- SEÇÃO DE PROTÓTIPOS DE FUNÇÕES PÚBLICAS ---
+
+/**
+ * @brief Preenche os parâmetros padrão para uma cena com 'numObjects' objetos.
+ *
+ * 40% de pontos, 30% de segmentos e 30% de polígonos (de 3 a 64 vértices,
+ * cauda longa, metade côncavos), sem animação, em uma área que cresce com a
+ * cena para manter a densidade da janela padrão.
+ */
+void sceneGenDefaults(SceneGenParams* params, int numObjects);
+
+/**
+ * @brief Gera uma cena em um snapshot vazio.
+ *
+ * Não toca na cena atual; instale o resultado com snapshotInstall().
+ * @return int 1 em caso de sucesso, 0 se os parâmetros são inválidos ou faltou memória.
+ */
+int sceneGenerate(const SceneGenParams* params, SceneSnapshot* snap);
+
+/**
+ * @brief Avança o gerador pseudoaleatório da cena (SplitMix64) e retorna 64 bits novos.
+ *
+ * Para quem precisa de sorteios reprodutíveis junto com a cena (ex: os
+ * cliques de um benchmark).
+ */
+unsigned long long sceneGenRandom(unsigned long long* state);
+
+#endif // SCENEGEN_H
@@ -2,8 +2,8 @@
  * @file segment.h
  * @brief Define a estrutura de dados e a interface para o objeto Segmento de Reta.
  *
- * Um segmento  composto por dois pontos e serve como uma primitiva
- * fundamental para a construo de formas mais complexas, como polgonos.
+ * Um segmento é composto por dois pontos e serve como uma primitiva
+ * fundamental para a construção de formas mais complexas, como polígonos.
  */
 
 #ifndef SEGMENT_H
@@ -11,7 +11,7 @@
 
 #include "point.h"
 
-// --- SEO DE ESTRUTURAS E TIPOS ---
+// --- SEÇÃO DE ESTRUTURAS E TIPOS ---
 
 /**
  * @brief Estrutura para representar um segmento de reta 2D.
@@ -22,7 +22,7 @@ typedef struct {
 } Segment;
 
 
-// --- SEO DE PROTTIPOS DE FUNES PBLICAS ---
+// --- SEÇÃO DE PROTÓTIPOS DE FUNÇÕES PÚBLICAS ---
 
 /**
  * @brief Cria e inicializa uma estrutura Segment com os dois pontos fornecidos.
@@ -35,27 +35,27 @@ Segment createSegment(Point p1, Point p2);
 /**
  * @brief Desenha um segmento de reta na tela.
  *
- * A cor do segmento muda dependendo de seu estado de seleo.
+ * A cor do segmento muda dependendo de seu estado de seleção.
  * @param s Ponteiro para a estrutura Segment a ser desenhada.
- * @param is_selected Flag (1 ou 0) que indica se o segmento est selecionado.
+ * @param is_selected Flag (1 ou 0) que indica se o segmento está selecionado.
  */
 void drawSegment(Segment* s, int is_selected);
 
 /**
- * @brief Calcula a menor distncia entre um ponto e um segmento de reta.
+ * @brief Calcula a menor distância entre um ponto e um segmento de reta.
  *
- * Este algoritmo encontra o ponto mais prximo no segmento (no na reta infinita)
- * e retorna a distncia euclidiana at ele.  fundamental para a seleo por proximidade.
- * @param p O ponto de referncia (ex: o clique do mouse).
+ * Este algoritmo encontra o ponto mais próximo no segmento (não na reta infinita)
+ * e retorna a distância euclidiana até ele. É fundamental para a seleção por proximidade.
+ * @param p O ponto de referência (ex: o clique do mouse).
  * @param s O segmento de reta a ser testado.
- * @return float A menor distncia euclidiana entre o ponto e o segmento.
+ * @return float A menor distância euclidiana entre o ponto e o segmento.
  */
 float distPointSegment(Point p, Segment s);
 
 /**
- * @brief Libera a memria interna de um Segmento, se houver.
+ * @brief Libera a memória interna de um Segmento, se houver.
  *
- * Esta funo  mantida para consistncia com a API de gerenciamento de objetos.
+ * Esta função é mantida para consistência com a API de gerenciamento de objetos.
  * @param s Ponteiro para a estrutura Segment.
  */
 void freeSegment(Segment* s);
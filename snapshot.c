@@ -0,0 +1,233 @@
+/**
+ * @file snapshot.c
+ * @brief Implementação da cópia independente de uma cena.
+ *
+ * Os arrays crescem por dobra, como a lista de objetos. A captura e a
+ * instalação percorrem os arrays de cada tipo em ordem, então o índice de
+ * carga de um objeto é o seu índice em 'g_objects' logo após a instalação.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "snapshot.h"
+#include "config.h"
+#include "objects.h"
+#include "polygon.h"
+#include "vertexpool.h"
+#include "animation.h"
+#include "journal.h"
+
+// --- SEÇÃO DE FUNÇÕES AUXILIARES (IMPLEMENTAÇÃO PRIVADA) ---
+
+/**
+ * @brief Garante que '*array' comporte pelo menos 'needed' itens.
+ * @return int 1 em caso de sucesso, 0 se faltou memória (o array antigo continua válido).
+ */
+static int growTo(void** array, size_t* capacity, size_t needed, size_t itemSize) {
+    if (needed <= *capacity) return 1;
+    size_t newCapacity = *capacity > 0 ? *capacity : INITIAL_OBJECT_CAPACITY;
+    while (newCapacity < needed) newCapacity *= 2;
+    void* grown = realloc(*array, newCapacity * itemSize);
+    if (!grown) {
+        fprintf(stderr, "[Snapshot ERROR] Memória insuficiente para %zu itens.\n", needed);
+        return 0;
+    }
+    *array = grown;
+    *capacity = newCapacity;
+    return 1;
+}
+
+/**
+ * @brief Copia a cena para um snapshot vazio, com a geometria no mundo ou a geometria base.
+ * @return int 1 em caso de sucesso, 0 se faltou memória.
+ */
+static int captureScene(SceneSnapshot* snap, int useBase) {
+    size_t numVertices = 0;
+    for (int k = 0; k < g_numPolygons; k++) {
+        numVertices += (size_t)g_polygons[k].numVertices;
+    }
+    int numAnimated = 0;
+    for (int i = 0; i < g_numObjects; i++) {
+        if (g_anim[i].active) numAnimated++;
+    }
+    if (!snapshotReserve(snap, g_numPoints, g_numSegments, g_numPolygons) ||
+        !growTo((void**)&snap->vertices, &snap->vertexCapacity, numVertices, sizeof(Point)) ||
+        !growTo((void**)&snap->anims, &snap->animCapacity, (size_t)numAnimated, sizeof(SceneAnimRecord))) {
+        return 0;
+    }
+
+    if (useBase) {
+        int count;
+        for (int k = 0; k < g_numPoints; k++) {
+            snap->points[k] = *getObjectBaseVertices(g_pointOwners[k], &count);
+        }
+        for (int k = 0; k < g_numSegments; k++) {
+            memcpy(&snap->segments[k], getObjectBaseVertices(g_segmentOwners[k], &count), sizeof(Segment));
+        }
+    } else {
+        // Cada tipo já está agrupado no seu próprio array: pontos e segmentos são uma cópia só.
+        if (g_numPoints > 0) memcpy(snap->points, g_points, g_numPoints * sizeof(Point));
+        if (g_numSegments > 0) memcpy(snap->segments, g_segments, g_numSegments * sizeof(Segment));
+    }
+    snap->numPoints = g_numPoints;
+    snap->numSegments = g_numSegments;
+    for (int k = 0; k < g_numPolygons; k++) {
+        int count = g_polygons[k].numVertices;
+        const Point* vertices = useBase ? getObjectBaseVertices(g_polygonOwners[k], &count) : g_polygons[k].vertices;
+        memcpy(snap->vertices + snap->numVertices, vertices, count * sizeof(Point));
+        snap->numVertices += (size_t)count;
+        snap->polygonSizes[k] = (uint32_t)count;
+    }
+    snap->numPolygons = g_numPolygons;
+
+    // O número de cada objeto animado é a sua posição na ordem de carga.
+    for (int i = 0; i < g_numObjects; i++) {
+        if (!g_anim[i].active) continue;
+        SceneAnimRecord* a = &snap->anims[snap->numAnimated++];
+        a->objectIndex = (uint32_t)g_objects[i].slot;
+        if (g_objects[i].type != OBJECT_TYPE_POINT) a->objectIndex += (uint32_t)g_numPoints;
+        if (g_objects[i].type == OBJECT_TYPE_POLYGON) a->objectIndex += (uint32_t)g_numSegments;
+        a->gravity = g_anim[i].gravity;
+        a->vx = g_anim[i].vx;
+        a->vy = g_anim[i].vy;
+        a->e = g_anim[i].e;
+        a->vmax = g_anim[i].vmax;
+    }
+    return 1;
+}
+
+// --- SEÇÃO DE FUNÇÕES PÚBLICAS ---
+
+void snapshotInit(SceneSnapshot* snap) {
+    memset(snap, 0, sizeof(*snap));
+}
+
+void snapshotFree(SceneSnapshot* snap) {
+    if (snap->releaseBorrowed) {
+        snap->releaseBorrowed(snap->borrowedCtx);
+    } else {
+        free(snap->points);
+        free(snap->segments);
+        free(snap->polygonSizes);
+        free(snap->vertices);
+        free(snap->anims);
+    }
+    snapshotInit(snap);
+}
+
+int snapshotCapture(SceneSnapshot* snap) {
+    // Os vértices copiados são os do mundo, com todas as transformações aplicadas.
+    objectsFlushTransforms();
+    return captureScene(snap, 0);
+}
+
+int snapshotCaptureBase(SceneSnapshot* snap) {
+    return captureScene(snap, 1);
+}
+
+void snapshotInstall(SceneSnapshot* snap) {
+    clearAllObjects();
+    reserveObjects(snapshotObjectCount(snap));
+
+    // Um bloco de vértices próprio passa inteiro para o pool, e cada polígono
+    // fica com o seu trecho sem cópia; um bloco emprestado (arquivo mapeado)
+    // é copiado polígono a polígono.
+    int moved = !snap->releaseBorrowed && snap->numVertices > 0 &&
+                vertexPoolAdopt(snap->vertices, snap->numVertices, snap->vertexCapacity);
+
+    for (int k = 0; k < snap->numPoints; k++) {
+        addPointObject(snap->points[k]);
+    }
+    for (int k = 0; k < snap->numSegments; k++) {
+        addSegmentObject(snap->segments[k]);
+    }
+    Point* vertices = snap->vertices;
+    for (int k = 0; k < snap->numPolygons; k++) {
+        GfxPolygon poly;
+        if (moved) {
+            poly.vertices = vertices;
+            poly.numVertices = (int)snap->polygonSizes[k];
+            poly.capacity = poly.numVertices;
+        } else {
+            poly = createPolygonFromVertices(vertices, (int)snap->polygonSizes[k]);
+        }
+        vertices += snap->polygonSizes[k];
+        if (poly.numVertices == 0) {
+            fprintf(stderr, "[Snapshot ERROR] Memória insuficiente para os vértices do polígono %d.\n", k);
+            continue;
+        }
+        addPolygonObject(&poly);
+    }
+
+    for (int k = 0; k < snap->numAnimated; k++) {
+        const SceneAnimRecord* a = &snap->anims[k];
+        if (a->objectIndex < (uint32_t)g_numObjects) {
+            anim_enable((int)a->objectIndex, a->vx, a->vy, a->e, a->gravity);
+            g_anim[a->objectIndex].vmax = a->vmax;
+            journalRecordAnim((int)a->objectIndex);
+        }
+    }
+
+    if (moved) {
+        // Os vértices agora são dos polígonos da cena.
+        snap->vertices = NULL;
+        snap->numVertices = 0;
+        snap->vertexCapacity = 0;
+        snap->numPolygons = 0;
+    }
+}
+
+int snapshotReserve(SceneSnapshot* snap, int numPoints, int numSegments, int numPolygons) {
+    return growTo((void**)&snap->points, &snap->pointCapacity, (size_t)snap->numPoints + numPoints, sizeof(Point)) &&
+           growTo((void**)&snap->segments, &snap->segmentCapacity, (size_t)snap->numSegments + numSegments, sizeof(Segment)) &&
+           growTo((void**)&snap->polygonSizes, &snap->polygonCapacity, (size_t)snap->numPolygons + numPolygons, sizeof(uint32_t));
+}
+
+int snapshotAddPoint(SceneSnapshot* snap, Point p) {
+    if (!growTo((void**)&snap->points, &snap->pointCapacity, (size_t)snap->numPoints + 1, sizeof(Point))) return 0;
+    snap->points[snap->numPoints++] = p;
+    return 1;
+}
+
+int snapshotAddSegment(SceneSnapshot* snap, Segment s) {
+    if (!growTo((void**)&snap->segments, &snap->segmentCapacity, (size_t)snap->numSegments + 1, sizeof(Segment))) return 0;
+    snap->segments[snap->numSegments++] = s;
+    return 1;
+}
+
+int snapshotAddAnim(SceneSnapshot* snap, const SceneAnimRecord* anim) {
+    if (!growTo((void**)&snap->anims, &snap->animCapacity, (size_t)snap->numAnimated + 1, sizeof(SceneAnimRecord))) return 0;
+    snap->anims[snap->numAnimated++] = *anim;
+    return 1;
+}
+
+int snapshotBeginPolygon(SceneSnapshot* snap, int expectedVertices) {
+    snapshotEndPolygon(snap);
+    if (!growTo((void**)&snap->polygonSizes, &snap->polygonCapacity, (size_t)snap->numPolygons + 1, sizeof(uint32_t))) return 0;
+    if (expectedVertices > 0 &&
+        !growTo((void**)&snap->vertices, &snap->vertexCapacity, snap->numVertices + expectedVertices, sizeof(Point))) return 0;
+    snap->polygonSizes[snap->numPolygons++] = 0;
+    snap->polygonOpen = 1;
+    return 1;
+}
+
+int snapshotAddVertex(SceneSnapshot* snap, Point v) {
+    if (!snap->polygonOpen) return 0;
+    if (!growTo((void**)&snap->vertices, &snap->vertexCapacity, snap->numVertices + 1, sizeof(Point))) return 0;
+    snap->vertices[snap->numVertices++] = v;
+    snap->polygonSizes[snap->numPolygons - 1]++;
+    return 1;
+}
+
+void snapshotEndPolygon(SceneSnapshot* snap) {
+    if (snap->polygonOpen && snap->polygonSizes[snap->numPolygons - 1] == 0) {
+        snap->numPolygons--;
+    }
+    snap->polygonOpen = 0;
+}
+
+int snapshotObjectCount(const SceneSnapshot* snap) {
+    return snap->numPoints + snap->numSegments + snap->numPolygons;
+}
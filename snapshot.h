@@ -0,0 +1,150 @@
+/**
+ * @file snapshot.h
+ * @brief Define a cópia independente de uma cena usada para salvar e carregar arquivos.
+ *
+ * Um SceneSnapshot guarda a geometria no mundo de todos os objetos, agrupada
+ * por tipo na ordem de carga (pontos, depois segmentos, depois polígonos), e
+ * o estado dos objetos animados. Como não referencia a lista de objetos, ele
+ * pode ser escrito em disco ou preenchido a partir de um arquivo em outra
+ * thread; apenas snapshotCapture() e snapshotInstall() tocam a cena e
+ * precisam rodar na thread principal.
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "point.h"
+#include "segment.h"
+
+// --- SEÇÃO DE ESTRUTURAS E TIPOS ---
+
+/**
+ * @brief O estado de um objeto animado. 'objectIndex' segue a ordem de carga.
+ */
+typedef struct {
+    uint32_t objectIndex;
+    int32_t gravity;
+    float vx, vy;
+    float e;
+    float vmax;
+} SceneAnimRecord;
+
+/**
+ * @brief Uma cena completa fora da lista de objetos.
+ *
+ * Os vértices de todos os polígonos ficam em um único bloco, um polígono após
+ * o outro, com a quantidade de cada um em 'polygonSizes'. Se 'releaseBorrowed'
+ * não for NULL, os arrays apontam para a memória de outro dono (por exemplo,
+ * um arquivo mapeado), que é devolvida por snapshotFree().
+ */
+typedef struct {
+    Point* points;
+    int numPoints;
+    Segment* segments;
+    int numSegments;
+    uint32_t* polygonSizes;
+    int numPolygons;
+    Point* vertices;
+    size_t numVertices;
+    SceneAnimRecord* anims;
+    int numAnimated;
+    size_t pointCapacity, segmentCapacity, polygonCapacity, vertexCapacity, animCapacity;
+    int polygonOpen;                        ///< 1 entre snapshotBeginPolygon() e snapshotEndPolygon().
+
+    void (*releaseBorrowed)(void* ctx);     ///< Devolve a memória emprestada (NULL se os arrays são próprios).
+    void* borrowedCtx;
+} SceneSnapshot;
+
+/**
+ * @brief Andamento e cancelamento de uma leitura ou escrita, compartilhados entre threads.
+ *
+ * 'done' e 'total' usam a unidade que a operação achar conveniente (bytes
+ * ou objetos); apenas a razão entre eles é mostrada.
+ */
+typedef struct {
+    _Atomic long long done;
+    _Atomic long long total;
+    _Atomic int cancel;                     ///< Posto em 1 para pedir que a operação pare.
+} SceneIoStatus;
+
+// --- SEÇÃO DE PROTÓTIPOS DE FUNÇÕES PÚBLICAS ---
+
+/**
+ * @brief Inicializa um snapshot vazio.
+ */
+void snapshotInit(SceneSnapshot* snap);
+
+/**
+ * @brief Libera a memória de um snapshot e o deixa vazio.
+ */
+void snapshotFree(SceneSnapshot* snap);
+
+/**
+ * @brief Copia a cena atual (com as transformações aplicadas) para um snapshot vazio.
+ *
+ * Deve ser chamada na thread principal.
+ * @return int 1 em caso de sucesso, 0 se faltou memória.
+ */
+int snapshotCapture(SceneSnapshot* snap);
+
+/**
+ * @brief Versão de snapshotCapture() que copia a geometria base, sem as transformações acumuladas.
+ *
+ * Aplicar a cada objeto instalado a sua transformação ('Object.transform',
+ * na ordem de carga) reproduz exatamente a cena atual, inclusive as
+ * transformações ainda pendentes. Deve ser chamada na thread principal.
+ * @return int 1 em caso de sucesso, 0 se faltou memória.
+ */
+int snapshotCaptureBase(SceneSnapshot* snap);
+
+/**
+ * @brief Substitui a cena atual pelo conteúdo do snapshot.
+ *
+ * Deve ser chamada na thread principal. Se o snapshot é dono dos seus
+ * arrays, o bloco de vértices passa para os polígonos da cena sem cópia e o
+ * snapshot fica sem polígonos; em qualquer caso, ele ainda deve ser liberado
+ * com snapshotFree().
+ */
+void snapshotInstall(SceneSnapshot* snap);
+
+/**
+ * @brief Reserva espaço para mais objetos de um tipo antes de uma sequência de inserções.
+ * @param numPoints, numSegments, numPolygons A quantidade de objetos de cada tipo que ainda vão chegar.
+ * @return int 1 em caso de sucesso, 0 se faltou memória.
+ */
+int snapshotReserve(SceneSnapshot* snap, int numPoints, int numSegments, int numPolygons);
+
+/**
+ * @brief Acrescentam um objeto ao snapshot. Retornam 0 se faltou memória.
+ */
+int snapshotAddPoint(SceneSnapshot* snap, Point p);
+int snapshotAddSegment(SceneSnapshot* snap, Segment s);
+int snapshotAddAnim(SceneSnapshot* snap, const SceneAnimRecord* anim);
+
+/**
+ * @brief Começa um polígono; os vértices seguintes entram nele.
+ * @param expectedVertices Quantos vértices são esperados (apenas para reservar espaço).
+ * @return int 1 em caso de sucesso, 0 se faltou memória.
+ */
+int snapshotBeginPolygon(SceneSnapshot* snap, int expectedVertices);
+
+/**
+ * @brief Acrescenta um vértice ao polígono aberto.
+ * @return int 1 em caso de sucesso, 0 se faltou memória ou não há polígono aberto.
+ */
+int snapshotAddVertex(SceneSnapshot* snap, Point v);
+
+/**
+ * @brief Fecha o polígono aberto (um polígono sem vértices é descartado).
+ */
+void snapshotEndPolygon(SceneSnapshot* snap);
+
+/**
+ * @brief Retorna a quantidade de objetos do snapshot.
+ */
+int snapshotObjectCount(const SceneSnapshot* snap);
+
+#endif // SNAPSHOT_H
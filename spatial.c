@@ -0,0 +1,322 @@
+/**
+ * @file spatial.c
+ * @brief Implementação do índice espacial em grade uniforme.
+ *
+ * As células não são alocadas como uma matriz (a cena não tem limites
+ * fixos): cada par (célula, objeto) é guardado em uma tabela hash indexada
+ * pelas coordenadas da célula. Objetos muito grandes, que cobririam células
+ * demais, ficam em uma lista separada e entram em todas as consultas.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "spatial.h"
+#include "objects.h"
+#include "config.h"
+
+// --- SEÇÃO DE ESTRUTURAS E VARIÁVEIS PRIVADAS ---
+
+/**
+ * @brief Uma ocorrência de um objeto em uma célula da grade.
+ */
+typedef struct {
+    int cx, cy;     ///< Coordenadas da célula.
+    int id;         ///< Entrada do objeto na tabela de handles.
+} CellEntry;
+
+/**
+ * @brief Um balde da tabela hash, com as ocorrências de todas as células que caem nele.
+ */
+typedef struct {
+    CellEntry* items;
+    int count;
+    int capacity;
+} CellBucket;
+
+/**
+ * @brief Estado de um objeto na grade, indexado pela sua entrada na tabela de handles.
+ */
+typedef struct {
+    int cx0, cy0, cx1, cy1;     ///< Intervalo de células em que o objeto está registrado.
+    int largePos;               ///< Posição na lista de objetos grandes (-1 se não for grande).
+    int inserted;               ///< 1 se o objeto está registrado na grade.
+} SpatialRecord;
+
+static CellBucket* s_buckets = NULL;
+static int s_numBuckets = 0;        ///< Sempre uma potência de dois.
+static int s_numEntries = 0;
+
+static SpatialRecord* s_records = NULL;
+static unsigned int* s_queryStamps = NULL; ///< Marca de consulta por objeto, para evitar repetições.
+static int s_recordCapacity = 0;
+static unsigned int s_currentStamp = 0;
+
+static int* s_largeIds = NULL;
+static int s_numLarge = 0;
+static int s_largeCapacity = 0;
+
+static int* s_queryResult = NULL;
+static int s_queryCapacity = 0;
+
+// --- SEÇÃO DE FUNÇÕES AUXILIARES (IMPLEMENTAÇÃO PRIVADA) ---
+
+/**
+ * @brief Converte uma coordenada do mundo na coordenada da célula que a contém.
+ */
+static int cellCoord(float v) {
+    float c = floorf(v / SPATIAL_CELL_SIZE);
+    // Limita o valor para não estourar o int com coordenadas absurdas (ou NaN).
+    if (!(c > -1e6f)) return -1000000;
+    if (c > 1e6f) return 1000000;
+    return (int)c;
+}
+
+static unsigned int hashCell(int cx, int cy) {
+    return ((unsigned int)cx * 73856093u) ^ ((unsigned int)cy * 19349663u);
+}
+
+static int growIntArray(int** array, int* capacity, int needed) {
+    if (needed <= *capacity) return 1;
+    int newCapacity = *capacity > 0 ? *capacity : 64;
+    while (newCapacity < needed) newCapacity *= 2;
+    int* grown = (int*)realloc(*array, newCapacity * sizeof(int));
+    if (!grown) return 0;
+    *array = grown;
+    *capacity = newCapacity;
+    return 1;
+}
+
+static void bucketPush(CellBucket* b, CellEntry e) {
+    if (b->count == b->capacity) {
+        int newCapacity = b->capacity > 0 ? b->capacity * 2 : 4;
+        CellEntry* grown = (CellEntry*)realloc(b->items, newCapacity * sizeof(CellEntry));
+        if (!grown) {
+            fprintf(stderr, "[Spatial ERROR] Memória insuficiente para a grade.\n");
+            return;
+        }
+        b->items = grown;
+        b->capacity = newCapacity;
+    }
+    b->items[b->count++] = e;
+}
+
+/**
+ * @brief Dobra o número de baldes e redistribui todas as ocorrências.
+ */
+static void rehash(int newNumBuckets) {
+    CellBucket* buckets = (CellBucket*)calloc(newNumBuckets, sizeof(CellBucket));
+    if (!buckets) return; // Continua com a tabela atual, apenas mais lenta.
+
+    for (int b = 0; b < s_numBuckets; b++) {
+        for (int k = 0; k < s_buckets[b].count; k++) {
+            CellEntry e = s_buckets[b].items[k];
+            bucketPush(&buckets[hashCell(e.cx, e.cy) & (newNumBuckets - 1)], e);
+        }
+        free(s_buckets[b].items);
+    }
+    free(s_buckets);
+    s_buckets = buckets;
+    s_numBuckets = newNumBuckets;
+}
+
+static void addEntry(int cx, int cy, int id) {
+    if (s_numBuckets == 0) {
+        rehash(1024);
+        if (s_numBuckets == 0) return;
+    } else if (s_numEntries >= 2 * s_numBuckets) {
+        rehash(s_numBuckets * 2);
+    }
+    CellEntry e = {cx, cy, id};
+    bucketPush(&s_buckets[hashCell(cx, cy) & (s_numBuckets - 1)], e);
+    s_numEntries++;
+}
+
+static void removeEntry(int cx, int cy, int id) {
+    CellBucket* b = &s_buckets[hashCell(cx, cy) & (s_numBuckets - 1)];
+    for (int k = 0; k < b->count; k++) {
+        if (b->items[k].id == id && b->items[k].cx == cx && b->items[k].cy == cy) {
+            b->items[k] = b->items[--b->count];
+            s_numEntries--;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Garante que a tabela de registros comporte a entrada 'id'.
+ */
+static int ensureRecord(int id) {
+    if (id < s_recordCapacity) return 1;
+    int newCapacity = s_recordCapacity > 0 ? s_recordCapacity : INITIAL_OBJECT_CAPACITY;
+    while (newCapacity <= id) newCapacity *= 2;
+
+    SpatialRecord* records = (SpatialRecord*)realloc(s_records, newCapacity * sizeof(SpatialRecord));
+    if (!records) return 0;
+    s_records = records;
+    unsigned int* stamps = (unsigned int*)realloc(s_queryStamps, newCapacity * sizeof(unsigned int));
+    if (!stamps) return 0;
+    s_queryStamps = stamps;
+
+    for (int i = s_recordCapacity; i < newCapacity; i++) {
+        s_records[i].inserted = 0;
+        s_records[i].largePos = -1;
+        s_queryStamps[i] = 0;
+    }
+    s_recordCapacity = newCapacity;
+    return 1;
+}
+
+/**
+ * @brief Registra o objeto nas células do intervalo informado (ou na lista de grandes).
+ */
+static void registerCells(int id, int cx0, int cy0, int cx1, int cy1) {
+    SpatialRecord* r = &s_records[id];
+    r->cx0 = cx0; r->cy0 = cy0; r->cx1 = cx1; r->cy1 = cy1;
+
+    long long numCells = (long long)(cx1 - cx0 + 1) * (long long)(cy1 - cy0 + 1);
+    if (numCells > SPATIAL_MAX_CELLS_PER_OBJECT) {
+        if (!growIntArray(&s_largeIds, &s_largeCapacity, s_numLarge + 1)) return;
+        r->largePos = s_numLarge;
+        s_largeIds[s_numLarge++] = id;
+    } else {
+        r->largePos = -1;
+        for (int cy = cy0; cy <= cy1; cy++) {
+            for (int cx = cx0; cx <= cx1; cx++) {
+                addEntry(cx, cy, id);
+            }
+        }
+    }
+    r->inserted = 1;
+}
+
+/**
+ * @brief Retira o objeto das células em que está registrado.
+ */
+static void unregisterCells(int id) {
+    SpatialRecord* r = &s_records[id];
+    if (r->largePos != -1) {
+        int moved = s_largeIds[--s_numLarge];
+        s_largeIds[r->largePos] = moved;
+        s_records[moved].largePos = r->largePos;
+        r->largePos = -1;
+    } else {
+        for (int cy = r->cy0; cy <= r->cy1; cy++) {
+            for (int cx = r->cx0; cx <= r->cx1; cx++) {
+                removeEntry(cx, cy, id);
+            }
+        }
+    }
+    r->inserted = 0;
+}
+
+/**
+ * @brief Acrescenta o objeto ao resultado da consulta atual, se ainda não estiver nele.
+ */
+static void collect(int id, int* count) {
+    if (s_queryStamps[id] == s_currentStamp) return;
+    s_queryStamps[id] = s_currentStamp;
+    if (!growIntArray(&s_queryResult, &s_queryCapacity, *count + 1)) return;
+    s_queryResult[(*count)++] = resolveHandleId(id);
+}
+
+static int compareInts(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+// --- SEÇÃO DE FUNÇÕES PÚBLICAS ---
+
+void spatialInsert(int handleId, BoundingBox box) {
+    if (!ensureRecord(handleId)) {
+        fprintf(stderr, "[Spatial ERROR] Memória insuficiente para registrar o objeto.\n");
+        return;
+    }
+    if (s_records[handleId].inserted) {
+        unregisterCells(handleId);
+    }
+    registerCells(handleId, cellCoord(box.minX), cellCoord(box.minY),
+                  cellCoord(box.maxX), cellCoord(box.maxY));
+}
+
+void spatialUpdate(int handleId, BoundingBox box) {
+    if (handleId < 0 || handleId >= s_recordCapacity || !s_records[handleId].inserted) {
+        spatialInsert(handleId, box);
+        return;
+    }
+    int cx0 = cellCoord(box.minX), cy0 = cellCoord(box.minY);
+    int cx1 = cellCoord(box.maxX), cy1 = cellCoord(box.maxY);
+    SpatialRecord* r = &s_records[handleId];
+
+    // Movimentos pequenos normalmente não mudam as células ocupadas.
+    if (r->cx0 == cx0 && r->cy0 == cy0 && r->cx1 == cx1 && r->cy1 == cy1) {
+        return;
+    }
+    unregisterCells(handleId);
+    registerCells(handleId, cx0, cy0, cx1, cy1);
+}
+
+void spatialRemove(int handleId) {
+    if (handleId < 0 || handleId >= s_recordCapacity || !s_records[handleId].inserted) {
+        return;
+    }
+    unregisterCells(handleId);
+}
+
+void spatialClear(void) {
+    for (int b = 0; b < s_numBuckets; b++) {
+        s_buckets[b].count = 0;
+    }
+    for (int i = 0; i < s_recordCapacity; i++) {
+        s_records[i].inserted = 0;
+        s_records[i].largePos = -1;
+    }
+    s_numEntries = 0;
+    s_numLarge = 0;
+}
+
+int spatialQuery(BoundingBox box, const int** outIndices) {
+    int count = 0;
+    s_currentStamp++;
+    if (s_currentStamp == 0) {
+        // A marca deu a volta: zera as marcas antigas para não confundir consultas.
+        for (int i = 0; i < s_recordCapacity; i++) s_queryStamps[i] = 0;
+        s_currentStamp = 1;
+    }
+
+    int cx0 = cellCoord(box.minX), cy0 = cellCoord(box.minY);
+    int cx1 = cellCoord(box.maxX), cy1 = cellCoord(box.maxY);
+    long long numCells = (long long)(cx1 - cx0 + 1) * (long long)(cy1 - cy0 + 1);
+    if (s_numBuckets > 0 && numCells > s_numEntries) {
+        // Retângulo maior que a própria grade: é mais barato varrer todas as ocorrências.
+        for (int b = 0; b < s_numBuckets; b++) {
+            for (int k = 0; k < s_buckets[b].count; k++) {
+                CellEntry* e = &s_buckets[b].items[k];
+                if (e->cx >= cx0 && e->cx <= cx1 && e->cy >= cy0 && e->cy <= cy1) {
+                    collect(e->id, &count);
+                }
+            }
+        }
+    } else if (s_numBuckets > 0) {
+        for (int cy = cy0; cy <= cy1; cy++) {
+            for (int cx = cx0; cx <= cx1; cx++) {
+                CellBucket* b = &s_buckets[hashCell(cx, cy) & (s_numBuckets - 1)];
+                for (int k = 0; k < b->count; k++) {
+                    if (b->items[k].cx == cx && b->items[k].cy == cy) {
+                        collect(b->items[k].id, &count);
+                    }
+                }
+            }
+        }
+    }
+    for (int k = 0; k < s_numLarge; k++) {
+        collect(s_largeIds[k], &count);
+    }
+
+    // Ordena para que o desempate na seleção não dependa da ordem das células.
+    qsort(s_queryResult, count, sizeof(int), compareInts);
+    *outIndices = s_queryResult;
+    return count;
+}
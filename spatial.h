@@ -0,0 +1,56 @@
+/**
+ * @file spatial.h
+ * @brief Define a interface do índice espacial (grade uniforme) usado na seleção.
+ *
+ * Cada objeto é registrado nas células da grade cobertas pela sua caixa
+ * envolvente. Uma consulta por retângulo devolve apenas os objetos das
+ * células tocadas, evitando percorrer a cena inteira a cada clique.
+ */
+
+#ifndef SPATIAL_H
+#define SPATIAL_H
+
+#include "objects.h"
+
+// --- SEÇÃO DE PROTÓTIPOS DE FUNÇÕES PÚBLICAS ---
+
+/**
+ * @brief Registra um objeto na grade.
+ * @param handleId A entrada do objeto na tabela de handles (Object.handleId).
+ * @param box A caixa envolvente atual do objeto.
+ */
+void spatialInsert(int handleId, BoundingBox box);
+
+/**
+ * @brief Atualiza as células de um objeto já registrado após uma mudança de geometria.
+ *
+ * Se a caixa continua cobrindo as mesmas células, nada é feito.
+ * @param handleId A entrada do objeto na tabela de handles.
+ * @param box A nova caixa envolvente do objeto.
+ */
+void spatialUpdate(int handleId, BoundingBox box);
+
+/**
+ * @brief Remove um objeto da grade.
+ * @param handleId A entrada do objeto na tabela de handles.
+ */
+void spatialRemove(int handleId);
+
+/**
+ * @brief Remove todos os objetos da grade.
+ */
+void spatialClear(void);
+
+/**
+ * @brief Lista os objetos cujas células tocam o retângulo informado.
+ *
+ * O resultado é um superconjunto: o chamador ainda deve fazer o teste exato.
+ * Os índices são devolvidos em ordem crescente e sem repetições.
+ * @param box O retângulo de consulta.
+ * @param outIndices Recebe um ponteiro para um buffer interno com os índices
+ *        em 'g_objects'. O buffer é válido até a próxima consulta.
+ * @return int A quantidade de índices no buffer.
+ */
+int spatialQuery(BoundingBox box, const int** outIndices);
+
+#endif // SPATIAL_H
@@ -1,10 +1,10 @@
 /**
  * @file transformations.c
- * @brief Implementao das transformaes geomtricas e manipulao de matrizes.
+ * @brief Implementação das transformações geométricas e manipulação de matrizes.
  *
- * Contm a lgica matemtica para criar e aplicar matrizes de transformao
- * aos objetos da cena. As transformaes complexas so realizadas via
- * composio de matrizes.
+ * Contém a lógica matemática para criar e aplicar matrizes de transformação
+ * aos objetos da cena. As transformações complexas são realizadas via
+ * composição de matrizes.
  */
 
 #include <stdio.h>
@@ -15,9 +15,20 @@
 #include "segment.h"
 #include "polygon.h"
 #include "utils.h"
+#include "history.h"
+#include "profiler.h"
 
-// --- SEO DE FUNES AUXILIARES DE MATRIZES ---
-// Funes para criar e manipular as matrizes de transformao.
+// Os kernels vetoriais só existem em x86 com GCC/Clang; o AVX é escolhido em
+// tempo de execução, conforme o processador.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE__)
+#include <immintrin.h>
+#define TRANSFORM_HAVE_SIMD 1
+#else
+#define TRANSFORM_HAVE_SIMD 0
+#endif
+
+// --- SEÇÃO DE FUNÇÕES AUXILIARES DE MATRIZES ---
+// Funções para criar e manipular as matrizes de transformação.
 
 /**
  * @brief Cria e retorna uma matriz identidade 3x3.
@@ -33,7 +44,7 @@ Matrix3x3 createIdentityMatrix() {
 }
 
 /**
- * @brief Cria uma matriz de translao 2D.
+ * @brief Cria uma matriz de translação 2D.
  */
 Matrix3x3 createTranslationMatrix(float tx, float ty) {
     Matrix3x3 mat = createIdentityMatrix();
@@ -53,8 +64,8 @@ Matrix3x3 createScaleMatrix(float sx, float sy) {
 }
 
 /**
- * @brief Cria uma matriz de rotao 2D.
- * @param angleDegrees O ngulo de rotao em graus.
+ * @brief Cria uma matriz de rotação 2D.
+ * @param angleDegrees O ângulo de rotação em graus.
  */
 Matrix3x3 createRotationMatrix(float angleDegrees){
     Matrix3x3 result = createIdentityMatrix();
@@ -68,14 +79,14 @@ Matrix3x3 createRotationMatrix(float angleDegrees){
 }
 
 /**
- * @brief Cria uma matriz de reflexo (espelhamento) 2D.
- * @param axis O eixo de reflexo. Use 0 para refletir sobre o eixo X e 1 para o eixo Y.
+ * @brief Cria uma matriz de reflexão (espelhamento) 2D.
+ * @param axis O eixo de reflexão. Use 0 para refletir sobre o eixo X e 1 para o eixo Y.
  */
 Matrix3x3 createReflectionMatrix(int axis) {
     Matrix3x3 mat = createIdentityMatrix();
-    if (axis == 0) { // Reflexo sobre o eixo X (inverte Y)
+    if (axis == 0) { // Reflexão sobre o eixo X (inverte Y)
         mat.m[1][1] = -1.0f;
-    } else { // Reflexo sobre o eixo Y (inverte X)
+    } else { // Reflexão sobre o eixo Y (inverte X)
         mat.m[0][0] = -1.0f;
     }
     return mat;
@@ -83,8 +94,8 @@ Matrix3x3 createReflectionMatrix(int axis) {
 
 /**
  * @brief Cria uma matriz de cisalhamento (shear) 2D.
- * @param shx Fator de cisalhamento na direo X.
- * @param shy Fator de cisalhamento na direo Y.
+ * @param shx Fator de cisalhamento na direção X.
+ * @param shy Fator de cisalhamento na direção Y.
  */
 Matrix3x3 createShearMatrix(float shx, float shy) {
     Matrix3x3 mat = createIdentityMatrix();
@@ -119,45 +130,187 @@ Matrix3x3 multiplyMatrices(Matrix3x3 m1, Matrix3x3 m2) {
     return result;
 }
 
-// --- SEO DE FUNES DE LGICA E APLICAO DE MATRIZES ---
-// Funes internas que delegam as operaes de transformao.
+/**
+ * @brief Compõe T(c) * M * T(-c) diretamente, sem as duas multiplicações de matrizes.
+ */
+Matrix3x3 composeAboutPoint(Matrix3x3 linear, Point center) {
+    Matrix3x3 result = linear;
+    // Apenas a coluna de translação muda: M * (-c) + t + c.
+    result.m[0][2] = (linear.m[0][0] * -center.x + linear.m[0][1] * -center.y + linear.m[0][2]) + center.x;
+    result.m[1][2] = (linear.m[1][0] * -center.x + linear.m[1][1] * -center.y + linear.m[1][2]) + center.y;
+    return result;
+}
 
+// --- SEÇÃO DE KERNELS DE TRANSFORMAÇÃO EM LOTE ---
+// Todos calculam x' = a*x + b*y + tx e y' = c*x + d*y + ty na mesma ordem de
+// operações de multiplyMatrixByPoint(), então o resultado é idêntico em bits.
+
+static void transformPointsScalar(const Point* src, Point* dst, int count, const Matrix3x3* mat) {
+    const float a = mat->m[0][0], b = mat->m[0][1], tx = mat->m[0][2];
+    const float c = mat->m[1][0], d = mat->m[1][1], ty = mat->m[1][2];
+    for (int i = 0; i < count; i++) {
+        float x = src[i].x;
+        float y = src[i].y;
+        dst[i].x = a * x + b * y + tx;
+        dst[i].y = c * x + d * y + ty;
+    }
+}
+
+#if TRANSFORM_HAVE_SIMD
 /**
- * @brief Aplica uma matriz de transformao a um objeto.
+ * @brief Kernel SSE: dois pontos (x0, y0, x1, y1) por registrador.
  *
- * Esta funo age como um "dispatcher", identificando o tipo do objeto e
- * aplicando a matriz a todos os seus vrtices de forma adequada.
+ * Com v = (x, y) e s = (y, x), o resultado é v * (a, d) + s * (b, c) + (tx, ty).
  */
-void applyMatrixToObject(int objectIndex, Matrix3x3 matrix) {
-    if (objectIndex < 0 || objectIndex >= g_numObjects) {
+static void transformPointsSse(const Point* src, Point* dst, int count, const Matrix3x3* mat) {
+    const float a = mat->m[0][0], b = mat->m[0][1], tx = mat->m[0][2];
+    const float c = mat->m[1][0], d = mat->m[1][1], ty = mat->m[1][2];
+    const __m128 ad = _mm_setr_ps(a, d, a, d);
+    const __m128 bc = _mm_setr_ps(b, c, b, c);
+    const __m128 t = _mm_setr_ps(tx, ty, tx, ty);
+    const float* in = (const float*)src;
+    float* out = (float*)dst;
+    int i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128 v = _mm_loadu_ps(in + 2 * i);
+        __m128 swapped = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(v, ad), _mm_mul_ps(swapped, bc)), t);
+        _mm_storeu_ps(out + 2 * i, r);
+    }
+    transformPointsScalar(src + i, dst + i, count - i, mat);
+}
+
+/**
+ * @brief Kernel AVX: quatro pontos por registrador, com a mesma troca de x e y do SSE.
+ */
+__attribute__((target("avx")))
+static void transformPointsAvx(const Point* src, Point* dst, int count, const Matrix3x3* mat) {
+    const float a = mat->m[0][0], b = mat->m[0][1], tx = mat->m[0][2];
+    const float c = mat->m[1][0], d = mat->m[1][1], ty = mat->m[1][2];
+    const __m256 ad = _mm256_setr_ps(a, d, a, d, a, d, a, d);
+    const __m256 bc = _mm256_setr_ps(b, c, b, c, b, c, b, c);
+    const __m256 t = _mm256_setr_ps(tx, ty, tx, ty, tx, ty, tx, ty);
+    const float* in = (const float*)src;
+    float* out = (float*)dst;
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256 v = _mm256_loadu_ps(in + 2 * i);
+        __m256 swapped = _mm256_permute_ps(v, _MM_SHUFFLE(2, 3, 0, 1));
+        __m256 r = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(v, ad), _mm256_mul_ps(swapped, bc)), t);
+        _mm256_storeu_ps(out + 2 * i, r);
+    }
+    // Limpa a metade alta dos registradores antes de voltar ao código SSE;
+    // sem isso, cada instrução SSE seguinte paga uma penalidade de transição.
+    _mm256_zeroupper();
+    transformPointsSse(src + i, dst + i, count - i, mat);
+}
+#endif
+
+static int kernelSupported(TransformKernel kernel) {
+    switch (kernel) {
+        case TRANSFORM_KERNEL_SCALAR: return 1;
+#if TRANSFORM_HAVE_SIMD
+        case TRANSFORM_KERNEL_SSE: return 1;
+        case TRANSFORM_KERNEL_AVX: return __builtin_cpu_supports("avx");
+#endif
+        default: return 0;
+    }
+}
+
+TransformKernel transformBestKernel(void) {
+    static int s_best = -1;
+    if (s_best < 0) {
+        s_best = TRANSFORM_KERNEL_SCALAR;
+        for (int k = TRANSFORM_KERNEL_SCALAR; k < TRANSFORM_KERNEL_COUNT; k++) {
+            if (kernelSupported((TransformKernel)k)) s_best = k;
+        }
+    }
+    return (TransformKernel)s_best;
+}
+
+const char* transformKernelName(TransformKernel kernel) {
+    switch (kernel) {
+        case TRANSFORM_KERNEL_SCALAR: return "escalar";
+        case TRANSFORM_KERNEL_SSE: return "SSE";
+        case TRANSFORM_KERNEL_AVX: return "AVX";
+        default: return "?";
+    }
+}
+
+int transformPointsWithKernel(TransformKernel kernel, Point* points, int count, const Matrix3x3* mat) {
+    if (!kernelSupported(kernel)) return 0;
+    switch (kernel) {
+#if TRANSFORM_HAVE_SIMD
+        case TRANSFORM_KERNEL_SSE: transformPointsSse(points, points, count, mat); break;
+        case TRANSFORM_KERNEL_AVX: transformPointsAvx(points, points, count, mat); break;
+#endif
+        default: transformPointsScalar(points, points, count, mat); break;
+    }
+    return 1;
+}
+
+void transformPoints(Point* points, int count, const Matrix3x3* mat) {
+    transformPointsTo(points, points, count, mat);
+}
+
+void transformPointsTo(const Point* src, Point* dst, int count, const Matrix3x3* mat) {
+    // Listas curtas (pontos, segmentos, triângulos) não compensam o despacho.
+    if (count < 4) {
+        transformPointsScalar(src, dst, count, mat);
         return;
     }
-    Object* obj = &g_objects[objectIndex];
-    switch (obj->type) {
-        case OBJECT_TYPE_POINT: {
-            Point* p = (Point*)obj->data;
-            *p = multiplyMatrixByPoint(matrix, *p);
+    switch (transformBestKernel()) {
+#if TRANSFORM_HAVE_SIMD
+        case TRANSFORM_KERNEL_SSE: transformPointsSse(src, dst, count, mat); break;
+        case TRANSFORM_KERNEL_AVX: transformPointsAvx(src, dst, count, mat); break;
+#endif
+        default: transformPointsScalar(src, dst, count, mat); break;
+    }
+}
+
+// --- SEÇÃO DE FUNÇÕES DE LÓGICA E APLICAÇÃO DE MATRIZES ---
+// Funções internas que delegam as operações de transformação.
+
+/**
+ * @brief Aplica uma matriz a todos os vértices de um objeto, sem avisar a cena.
+ */
+static void applyMatrixToVertices(int objectIndex, const Matrix3x3* matrix) {
+    switch (g_objects[objectIndex].type) {
+        case OBJECT_TYPE_POINT:
+            transformPoints(getObjectPoint(objectIndex), 1, matrix);
             break;
-        }
-        case OBJECT_TYPE_SEGMENT: {
-            Segment* s = (Segment*)obj->data;
-            s->p1 = multiplyMatrixByPoint(matrix, s->p1);
-            s->p2 = multiplyMatrixByPoint(matrix, s->p2);
+        case OBJECT_TYPE_SEGMENT:
+            // Os dois extremos do segmento ficam lado a lado na memória.
+            transformPoints(&getObjectSegment(objectIndex)->p1, 2, matrix);
             break;
-        }
         case OBJECT_TYPE_POLYGON: {
-            GfxPolygon* poly = (GfxPolygon*)obj->data;
-            for (int i = 0; i < poly->numVertices; i++) {
-                poly->vertices[i] = multiplyMatrixByPoint(matrix, poly->vertices[i]);
-            }
+            GfxPolygon* poly = getObjectPolygon(objectIndex);
+            transformPoints(poly->vertices, poly->numVertices, matrix);
             break;
         }
     }
 }
 
+/**
+ * @brief Aplica uma matriz de transformação a um objeto.
+ *
+ * A matriz é apenas composta à transformação acumulada do objeto (O(1)); os
+ * vértices no mundo são refeitos a partir da geometria base quando alguém
+ * precisar deles (veja objectsFlushTransforms()). Assim, uma sequência de
+ * rotações não acumula erro de arredondamento nos vértices.
+ */
+void applyMatrixToObject(int objectIndex, Matrix3x3 matrix) {
+    if (objectIndex < 0 || objectIndex >= g_numObjects) {
+        return;
+    }
+    double profileStart = profileBegin();
+    objectApplyTransform(objectIndex, &matrix);
+    profileEnd(PROFILE_TRANSFORM, profileStart);
+}
 
-// --- SEO DE FUNES DE TRANSFORMAO (INTERFACE PBLICA) ---
-// Estas so as funes que devem ser chamadas por outros mdulos (e.g., input.c).
+
+// --- SEÇÃO DE FUNÇÕES DE TRANSFORMAÇÃO (INTERFACE PÚBLICA) ---
+// Estas são as funções que devem ser chamadas por outros módulos (e.g., input.c).
 
 void translateObject(int objectIndex, float dx, float dy) {
     if (objectIndex < 0 || objectIndex >= g_numObjects) {
@@ -167,26 +320,33 @@ void translateObject(int objectIndex, float dx, float dy) {
     applyMatrixToObject(objectIndex, translationMatrix);
 }
 
+void translateObjectGeometry(int objectIndex, float dx, float dy) {
+    Matrix3x3 translationMatrix = createTranslationMatrix(dx, dy);
+    applyMatrixToVertices(objectIndex, &translationMatrix);
+    objectShiftBounds(objectIndex, dx, dy);
+
+    // T(d) * M só altera a coluna de translação, e com a mesma soma feita nos vértices.
+    Matrix3x3* m = &g_objects[objectIndex].transform;
+    m->m[0][2] += dx;
+    m->m[1][2] += dy;
+}
+
+void applyTransformBatch(const ObjectTransform* items, int count) {
+    // Cada par só compõe matrizes; todos os vértices são refeitos de uma vez,
+    // pelo kernel em lote, no próximo flush.
+    for (int i = 0; i < count; i++) {
+        applyMatrixToObject(items[i].objectIndex, items[i].matrix);
+    }
+}
+
 void scaleObject(int objectIndex, float sx, float sy) {
     if (objectIndex < 0 || objectIndex >= g_numObjects) {
         return;
     }
-    // Para uma escala correta, a transformao  aplicada em relao ao centro do objeto.
+    // Para uma escala correta, a transformação é aplicada em relação ao centro
+    // do objeto: T(c) * S(sx,sy) * T(-c), composta de uma vez só.
     Point center = getObjectCenter(&g_objects[objectIndex]);
-
-    // A matriz final  uma composio de trs transformaes:
-    // 1. Translao do objeto para a origem (T(-c))
-    Matrix3x3 toOriginMatrix = createTranslationMatrix(-center.x, -center.y);
-    // 2. Aplicao da escala na origem (S(sx,sy))
-    Matrix3x3 scaleMatrix = createScaleMatrix(sx, sy);
-    // 3. Translao do objeto de volta para sua posio original (T(c))
-    Matrix3x3 fromOriginMatrix = createTranslationMatrix(center.x, center.y);
-
-    // A ordem de multiplicao  crucial: T(c) * S * T(-c)
-    Matrix3x3 tempMatrix = multiplyMatrices(scaleMatrix, toOriginMatrix);
-    Matrix3x3 finalMatrix = multiplyMatrices(fromOriginMatrix, tempMatrix);
-
-    applyMatrixToObject(objectIndex, finalMatrix);
+    applyMatrixToObject(objectIndex, composeAboutPoint(createScaleMatrix(sx, sy), center));
 }
 
 void rotateObject(int objectIndex, float angle) {
@@ -196,30 +356,18 @@ void rotateObject(int objectIndex, float angle) {
 
     Object* obj = &g_objects[objectIndex];
 
-    // Verifica se o objeto  um ponto para aplicar a regra especial.
+    // Verifica se o objeto é um ponto para aplicar a regra especial.
     if (obj->type == OBJECT_TYPE_POINT) {
-        // REGRA ESPECIAL PARA PONTOS: Rotao em torno da origem (0,0).
-        // A matriz de transformao  apenas a matriz de rotao pura.
+        // REGRA ESPECIAL PARA PONTOS: Rotação em torno da origem (0,0).
+        // A matriz de transformação é apenas a matriz de rotação pura.
         Matrix3x3 rotationMatrix = createRotationMatrix(angle);
         applyMatrixToObject(objectIndex, rotationMatrix);
 
     } else {
-        // REGRA GERAL (Segmentos, Polgonos): Rotao em torno do centro do objeto.
-        // Para isso, a transformao  composta: T(c) * R(angle) * T(-c)
+        // REGRA GERAL (Segmentos, Polígonos): Rotação em torno do centro do objeto,
+        // T(c) * R(angle) * T(-c).
         Point objectCenter = getObjectCenter(obj);
-
-        // 1. Translao do objeto para a origem (T(-c))
-        Matrix3x3 toOriginMatrix = createTranslationMatrix(-objectCenter.x, -objectCenter.y);
-        // 2. Aplicao da rotao na origem (R(angle))
-        Matrix3x3 rotationMatrix = createRotationMatrix(angle);
-        // 3. Translao do objeto de volta para sua posio original (T(c))
-        Matrix3x3 fromOriginMatrix = createTranslationMatrix(objectCenter.x, objectCenter.y);
-
-        // A ordem de multiplicao  crucial: T(c) * R * T(-c)
-        Matrix3x3 tempMatrix = multiplyMatrices(rotationMatrix, toOriginMatrix);
-        Matrix3x3 compositeMatrix = multiplyMatrices(fromOriginMatrix, tempMatrix);
-
-        applyMatrixToObject(objectIndex, compositeMatrix);
+        applyMatrixToObject(objectIndex, composeAboutPoint(createRotationMatrix(angle), objectCenter));
     }
 }
 
@@ -227,40 +375,72 @@ void reflectObject(int objectIndex, int axis) {
     if (objectIndex < 0 || objectIndex >= g_numObjects) {
         return;
     }
-    // Para uma reflexo em relao ao centro do objeto, a transformao  composta:
+    // Reflexão em relação ao centro do objeto: T(c) * R(axis) * T(-c).
     Point center = getObjectCenter(&g_objects[objectIndex]);
-
-    // 1. Translao do objeto para a origem (T(-c))
-    Matrix3x3 toOriginMatrix = createTranslationMatrix(-center.x, -center.y);
-    // 2. Aplicao da reflexo na origem (R(axis))
-    Matrix3x3 reflectionMatrix = createReflectionMatrix(axis);
-    // 3. Translao do objeto de volta para sua posio original (T(c))
-    Matrix3x3 fromOriginMatrix = createTranslationMatrix(center.x, center.y);
-
-    // A ordem de multiplicao  crucial: T(c) * R * T(-c)
-    Matrix3x3 tempMatrix = multiplyMatrices(reflectionMatrix, toOriginMatrix);
-    Matrix3x3 finalMatrix = multiplyMatrices(fromOriginMatrix, tempMatrix);
-
-    applyMatrixToObject(objectIndex, finalMatrix);
+    applyMatrixToObject(objectIndex, composeAboutPoint(createReflectionMatrix(axis), center));
 }
 
 void shearObject(int objectIndex, float shx, float shy) {
     if (objectIndex < 0 || objectIndex >= g_numObjects) {
         return;
     }
-    // Para um cisalhamento em relao ao centro do objeto, a transformao  composta:
+    // Cisalhamento em relação ao centro do objeto: T(c) * Shear * T(-c).
     Point center = getObjectCenter(&g_objects[objectIndex]);
+    applyMatrixToObject(objectIndex, composeAboutPoint(createShearMatrix(shx, shy), center));
+}
 
-    // 1. Translao do objeto para a origem (T(-c))
-    Matrix3x3 toOriginMatrix = createTranslationMatrix(-center.x, -center.y);
-    // 2. Aplicao do cisalhamento na origem (S(shx,shy))
-    Matrix3x3 shearMatrix = createShearMatrix(shx, shy);
-    // 3. Translao do objeto de volta para sua posio original (T(c))
-    Matrix3x3 fromOrigin = createTranslationMatrix(center.x, center.y);
+// --- SEÇÃO DE FUNÇÕES DE TRANSFORMAÇÃO DA SELEÇÃO ---
 
-    // A ordem de multiplicao  crucial: T(c) * Shear * T(-c)
-    Matrix3x3 tempMatrix = multiplyMatrices(shearMatrix, toOriginMatrix);
-    Matrix3x3 finalMatrix = multiplyMatrices(fromOrigin, tempMatrix);
+/**
+ * @brief Acumula a mesma matriz em todos os objetos selecionados e a registra no histórico.
+ */
+static void applyMatrixToSelection(Matrix3x3 matrix) {
+    double profileStart = profileBegin();
+    historyRecordTransform(g_selection, g_numSelected, &matrix);
+    for (int k = 0; k < g_numSelected; k++) {
+        objectApplyTransform(g_selection[k], &matrix);
+    }
+    profileEnd(PROFILE_TRANSFORM, profileStart);
+}
+
+Point getSelectionCenter(void) {
+    Point center = {0.0f, 0.0f};
+    if (g_numSelected == 0) {
+        return center;
+    }
+    // O centro de cada objeto sai da transformação acumulada em O(1).
+    for (int k = 0; k < g_numSelected; k++) {
+        Point c = getObjectCenter(&g_objects[g_selection[k]]);
+        center.x += c.x;
+        center.y += c.y;
+    }
+    center.x /= g_numSelected;
+    center.y /= g_numSelected;
+    return center;
+}
+
+void translateSelection(float dx, float dy) {
+    applyMatrixToSelection(createTranslationMatrix(dx, dy));
+}
+
+void rotateSelection(float angle) {
+    // Um único ponto mantém a regra de rotateObject() e gira em torno da origem;
+    // um único objeto de outro tipo gira em torno do próprio centro, que é o centro da seleção.
+    if (g_numSelected == 1 && g_objects[g_selection[0]].type == OBJECT_TYPE_POINT) {
+        applyMatrixToSelection(createRotationMatrix(angle));
+        return;
+    }
+    applyMatrixToSelection(composeAboutPoint(createRotationMatrix(angle), getSelectionCenter()));
+}
+
+void scaleSelection(float sx, float sy) {
+    applyMatrixToSelection(composeAboutPoint(createScaleMatrix(sx, sy), getSelectionCenter()));
+}
+
+void reflectSelection(int axis) {
+    applyMatrixToSelection(composeAboutPoint(createReflectionMatrix(axis), getSelectionCenter()));
+}
 
-    applyMatrixToObject(objectIndex, finalMatrix);
+void shearSelection(float shx, float shy) {
+    applyMatrixToSelection(composeAboutPoint(createShearMatrix(shx, shy), getSelectionCenter()));
 }
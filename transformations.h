@@ -1,9 +1,9 @@
 /**
  * @file transformations.h
- * @brief Define a interface pblica e as estruturas de dados para as transformaes geomtricas.
+ * @brief Define a interface pública e as estruturas de dados para as transformações geométricas.
  *
- * Este arquivo contm as estruturas e prottipos das funes que manipulam
- * matrizes de transformao e as aplicam aos objetos da cena.
+ * Este arquivo contém as estruturas e protótipos das funções que manipulam
+ * matrizes de transformação e as aplicam aos objetos da cena.
  */
 
 #ifndef TRANSFORMATIONS_H
@@ -12,20 +12,31 @@
 #include "objects.h"
 #include "point.h"
 
-// --- SEO DE ESTRUTURAS DE DADOS ---
+// --- SEÇÃO DE ESTRUTURAS DE DADOS ---
+
+// A estrutura Matrix3x3 é declarada em objects.h, pois cada objeto guarda a
+// sua transformação acumulada.
 
 /**
- * @brief Estrutura para uma Matriz 3x3.
- *
- * Usada para representar transformaes 2D em coordenadas homogneas,
- * permitindo a composio de mltiplas transformaes.
+ * @brief Um objeto e a matriz a ser aplicada a ele, para transformações em lote.
  */
 typedef struct {
-    float m[3][3];
-} Matrix3x3;
+    int objectIndex;        ///< O índice do objeto no array global.
+    Matrix3x3 matrix;       ///< A transformação já composta.
+} ObjectTransform;
+
+/**
+ * @brief Implementações disponíveis para a transformação de listas de vértices.
+ */
+typedef enum {
+    TRANSFORM_KERNEL_SCALAR,    ///< Um vértice por vez, em C puro.
+    TRANSFORM_KERNEL_SSE,       ///< Dois vértices por instrução (x86 com SSE).
+    TRANSFORM_KERNEL_AVX,       ///< Quatro vértices por instrução (x86 com AVX).
+    TRANSFORM_KERNEL_COUNT
+} TransformKernel;
 
-// --- SEO DE FUNES AUXILIARES DE MATRIZES ---
-// Funes internas para criar e manipular matrizes.
+// --- SEÇÃO DE FUNÇÕES AUXILIARES DE MATRIZES ---
+// Funções internas para criar e manipular matrizes.
 
 Matrix3x3 createIdentityMatrix();
 Matrix3x3 createTranslationMatrix(float tx, float ty);
@@ -36,45 +47,162 @@ Matrix3x3 createShearMatrix(float shx, float shy);
 Point multiplyMatrixByPoint(Matrix3x3 mat, Point p);
 Matrix3x3 multiplyMatrices(Matrix3x3 m1, Matrix3x3 m2);
 
-// --- SEO DE FUNES DE TRANSFORMAO DE OBJETOS (INTERFACE PBLICA) ---
-// Funes que outros mdulos devem chamar para transformar os objetos.
+/**
+ * @brief Compõe uma transformação em torno de um ponto: T(c) * M * T(-c).
+ * @param linear A transformação a ser aplicada com 'center' como origem.
+ * @param center O centro da transformação.
+ * @return Matrix3x3 A matriz composta, calculada sem multiplicações de matrizes.
+ */
+Matrix3x3 composeAboutPoint(Matrix3x3 linear, Point center);
+
+// --- SEÇÃO DE TRANSFORMAÇÃO EM LOTE ---
+
+/**
+ * @brief Aplica uma matriz afim a uma lista contígua de vértices.
+ *
+ * Usa o kernel mais rápido disponível no processador (AVX, SSE ou escalar).
+ * Todos os kernels dão o mesmo resultado, em bits, de multiplyMatrixByPoint().
+ * @param points Os vértices, modificados no lugar.
+ * @param count A quantidade de vértices.
+ * @param mat A transformação.
+ */
+void transformPoints(Point* points, int count, const Matrix3x3* mat);
+
+/**
+ * @brief Versão de transformPoints() que lê de 'src' e escreve em 'dst'.
+ *
+ * As listas podem ser a mesma, mas não podem se sobrepor parcialmente.
+ */
+void transformPointsTo(const Point* src, Point* dst, int count, const Matrix3x3* mat);
 
 /**
- * @brief Aplica uma translao (movimento) a um objeto da cena.
- * @param objectIndex O ndice do objeto no array global.
+ * @brief Versão de transformPoints() com um kernel específico (para testes e medições).
+ * @return int 1 se o kernel existe neste processador, 0 caso contrário (nada é feito).
+ */
+int transformPointsWithKernel(TransformKernel kernel, Point* points, int count, const Matrix3x3* mat);
+
+/**
+ * @brief Retorna o kernel usado por transformPoints() neste processador.
+ */
+TransformKernel transformBestKernel(void);
+
+/**
+ * @brief Retorna o nome de um kernel, para mensagens.
+ */
+const char* transformKernelName(TransformKernel kernel);
+
+// --- SEÇÃO DE FUNÇÕES DE TRANSFORMAÇÃO DE OBJETOS (INTERFACE PÚBLICA) ---
+// Funções que outros módulos devem chamar para transformar os objetos. Elas
+// apenas compõem a transformação acumulada do objeto; os vértices no mundo
+// são atualizados no próximo objectsFlushTransforms().
+
+/**
+ * @brief Aplica uma translação (movimento) a um objeto da cena.
+ * @param objectIndex O índice do objeto no array global.
  * @param dx O deslocamento no eixo X.
  * @param dy O deslocamento no eixo Y.
  */
 void translateObject(int objectIndex, float dx, float dy);
 
 /**
- * @brief Aplica uma rotao a um objeto em torno de seu prprio centro.
- * @param objectIndex O ndice do objeto no array global.
- * @param angle O ngulo de rotao em graus.
+ * @brief Versão imediata de translateObject() que não avisa a cena da mudança.
+ *
+ * Move os vértices no mundo, a caixa em cache e a transformação acumulada,
+ * escrevendo apenas nos dados do próprio objeto; por isso pode rodar em
+ * paralelo para objetos diferentes. O objeto não pode ter transformação
+ * pendente (chame objectsFlushTransforms() antes), e o chamador deve chamar
+ * objectCommitMove() para o objeto depois.
+ * @param objectIndex O índice do objeto no array global.
+ * @param dx O deslocamento no eixo X.
+ * @param dy O deslocamento no eixo Y.
+ */
+void translateObjectGeometry(int objectIndex, float dx, float dy);
+
+/**
+ * @brief Aplica uma lista de pares (objeto, matriz) de uma só vez.
+ *
+ * Cada par custa O(1): as matrizes são compostas às transformações
+ * acumuladas e os vértices de todos os objetos são refeitos juntos no
+ * próximo flush. Índices inválidos são ignorados.
+ * @param items Os pares a serem aplicados.
+ * @param count A quantidade de pares.
+ */
+void applyTransformBatch(const ObjectTransform* items, int count);
+
+/**
+ * @brief Aplica uma rotação a um objeto em torno de seu próprio centro.
+ * @param objectIndex O índice do objeto no array global.
+ * @param angle O ângulo de rotação em graus.
  */
 void rotateObject(int objectIndex, float angle);
 
 /**
- * @brief Aplica uma escala a um objeto a partir de seu prprio centro.
- * @param objectIndex O ndice do objeto no array global.
+ * @brief Aplica uma escala a um objeto a partir de seu próprio centro.
+ * @param objectIndex O índice do objeto no array global.
  * @param sx O fator de escala no eixo X.
  * @param sy O fator de escala no eixo Y.
  */
 void scaleObject(int objectIndex, float sx, float sy);
 
 /**
- * @brief Aplica uma reflexo (espelhamento) a um objeto em relao ao seu centro.
- * @param objectIndex O ndice do objeto no array global.
- * @param axis O eixo de reflexo (0 para eixo X, 1 para eixo Y).
+ * @brief Aplica uma reflexão (espelhamento) a um objeto em relação ao seu centro.
+ * @param objectIndex O índice do objeto no array global.
+ * @param axis O eixo de reflexão (0 para eixo X, 1 para eixo Y).
  */
 void reflectObject(int objectIndex, int axis);
 
 /**
- * @brief Aplica um cisalhamento a um objeto em relao ao seu prprio centro.
- * @param objectIndex O ndice do objeto no array global.
+ * @brief Aplica um cisalhamento a um objeto em relação ao seu próprio centro.
+ * @param objectIndex O índice do objeto no array global.
  * @param shx O fator de cisalhamento no eixo X.
  * @param shy O fator de cisalhamento no eixo Y.
  */
 void shearObject(int objectIndex, float shx, float shy);
 
+// --- SEÇÃO DE FUNÇÕES DE TRANSFORMAÇÃO DA SELEÇÃO (INTERFACE PÚBLICA) ---
+// Aplicam uma operação a todos os objetos de 'g_selection' em torno do
+// centroide do grupo. A matriz é composta uma única vez e então apenas
+// acumulada em cada objeto, então o custo total é O(objetos selecionados)
+// aqui mais O(vértices) no flush. Com um único objeto selecionado, elas se
+// comportam exatamente como as funções por objeto acima.
+
+/**
+ * @brief Calcula o centroide do grupo: a média dos centros dos objetos selecionados.
+ * @return Point O centroide (a origem se a seleção estiver vazia).
+ */
+Point getSelectionCenter(void);
+
+/**
+ * @brief Translada todos os objetos selecionados.
+ * @param dx O deslocamento no eixo X.
+ * @param dy O deslocamento no eixo Y.
+ */
+void translateSelection(float dx, float dy);
+
+/**
+ * @brief Rotaciona a seleção em torno do centroide do grupo.
+ * @param angle O ângulo de rotação em graus.
+ */
+void rotateSelection(float angle);
+
+/**
+ * @brief Aplica uma escala à seleção a partir do centroide do grupo.
+ * @param sx O fator de escala no eixo X.
+ * @param sy O fator de escala no eixo Y.
+ */
+void scaleSelection(float sx, float sy);
+
+/**
+ * @brief Reflete a seleção em relação ao centroide do grupo.
+ * @param axis O eixo de reflexão (0 para eixo X, 1 para eixo Y).
+ */
+void reflectSelection(int axis);
+
+/**
+ * @brief Aplica um cisalhamento à seleção em relação ao centroide do grupo.
+ * @param shx O fator de cisalhamento no eixo X.
+ * @param shy O fator de cisalhamento no eixo Y.
+ */
+void shearSelection(float shx, float shy);
+
 #endif // TRANSFORMATIONS_H
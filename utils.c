@@ -1,50 +1,56 @@
 /**
  * @file utils.c
- * @brief Implementao das funes utilitrias do projeto.
+ * @brief Implementação das funções utilitárias do projeto.
  *
- * Contm a lgica para o clculo do centro de objetos e outras operaes
- * genricas que no pertencem a um mdulo especfico.
+ * Contém a lógica para o cálculo do centro de objetos e outras operações
+ * genéricas que não pertencem a um módulo específico.
  */
 
 #include "utils.h"
 #include "objects.h"
 #include "segment.h"
 #include "polygon.h"
+#include "transformations.h"
 #include <stdio.h>
 
-// --- SEO DE FUNES PBLICAS ---
+// --- SEÇÃO DE FUNÇÕES PÚBLICAS ---
 
 /**
- * @brief Calcula o ponto central (centroide) de um objeto grfico.
- * @param obj Ponteiro para o objeto genrico.
+ * @brief Calcula o ponto central (centroide) de um objeto gráfico.
+ * @param obj Ponteiro para o objeto genérico.
  * @return Point As coordenadas (x, y) do centro do objeto.
  */
 Point getObjectCenter(Object* obj) {
-    Point center = {0.0f, 0.0f};
-
-    // Clusula de guarda para evitar operaes em ponteiros nulos.
-    if (obj == NULL || obj->data == NULL) {
+    // Cláusula de guarda para evitar operações em ponteiros nulos.
+    if (obj == NULL) {
         fprintf(stderr, "[Utils ERROR] Tentando calcular o centro de um objeto nulo.\n");
-        return center;
+        Point origin = {0.0f, 0.0f};
+        return origin;
     }
+    return multiplyMatrixByPoint(obj->transform, obj->baseCenter);
+}
+
+Point computeObjectCenter(int index) {
+    Point center = {0.0f, 0.0f};
+    Object* obj = &g_objects[index];
 
     switch (obj->type) {
         case OBJECT_TYPE_POINT: {
-            // O centro de um ponto  o prprio ponto.
-            Point* p = (Point*)obj->data;
+            // O centro de um ponto é o próprio ponto.
+            Point* p = &g_points[obj->slot];
             center = *p;
             break;
         }
         case OBJECT_TYPE_SEGMENT: {
-            // O centro de um segmento  o seu ponto mdio.
-            Segment* s = (Segment*)obj->data;
+            // O centro de um segmento é o seu ponto médio.
+            Segment* s = &g_segments[obj->slot];
             center.x = (s->p1.x + s->p2.x) / 2.0f;
             center.y = (s->p1.y + s->p2.y) / 2.0f;
             break;
         }
         case OBJECT_TYPE_POLYGON: {
-            // O centroide de um polgono  a mdia de todos os seus vrtices.
-            GfxPolygon* poly = (GfxPolygon*)obj->data;
+            // O centroide de um polígono é a média de todos os seus vértices.
+            GfxPolygon* poly = &g_polygons[obj->slot];
             if (poly->numVertices == 0) break;
 
             float sumX = 0.0f, sumY = 0.0f;
@@ -60,3 +66,31 @@ Point getObjectCenter(Object* obj) {
 
     return center;
 }
+
+BoundingBox computeObjectBounds(int index) {
+    BoundingBox box = {1e9f, 1e9f, -1e9f, -1e9f};
+    Object* o = &g_objects[index];
+
+    if (o->type == OBJECT_TYPE_POINT) {
+        Point* p = &g_points[o->slot];
+        box.minX = box.maxX = p->x;
+        box.minY = box.maxY = p->y;
+    } else if (o->type == OBJECT_TYPE_SEGMENT) {
+        Segment* s = &g_segments[o->slot];
+        box.minX = (s->p1.x < s->p2.x) ? s->p1.x : s->p2.x;
+        box.maxX = (s->p1.x > s->p2.x) ? s->p1.x : s->p2.x;
+        box.minY = (s->p1.y < s->p2.y) ? s->p1.y : s->p2.y;
+        box.maxY = (s->p1.y > s->p2.y) ? s->p1.y : s->p2.y;
+    } else if (o->type == OBJECT_TYPE_POLYGON) {
+        GfxPolygon* poly = &g_polygons[o->slot];
+        for (int v = 0; v < poly->numVertices; v++) {
+            float x = poly->vertices[v].x;
+            float y = poly->vertices[v].y;
+            if (x < box.minX) box.minX = x;
+            if (x > box.maxX) box.maxX = x;
+            if (y < box.minY) box.minY = y;
+            if (y > box.maxY) box.maxY = y;
+        }
+    }
+    return box;
+}
@@ -1,27 +1,48 @@
 /**
  * @file utils.h
- * @brief Define a interface para funes utilitrias genricas.
+ * @brief Define a interface para funções utilitárias genéricas.
  *
- * Este mdulo contm funes de apoio que podem ser usadas em mltiplos
- * arquivos do projeto, promovendo a reutilizao de cdigo.
+ * Este módulo contém funções de apoio que podem ser usadas em múltiplos
+ * arquivos do projeto, promovendo a reutilização de código.
  */
 
 #ifndef UTILS_H
 #define UTILS_H
 
-#include "objects.h" // Para a struct genrica Object
+#include "objects.h" // Para a struct genérica Object
 #include "point.h"   // Para a struct Point
 
-// --- SEO DE PROTTIPOS DE FUNES PBLICAS ---
+// --- SEÇÃO DE PROTÓTIPOS DE FUNÇÕES PÚBLICAS ---
 
 /**
- * @brief Calcula o ponto central (centroide) de um objeto grfico.
+ * @brief Calcula o ponto central (centroide) de um objeto gráfico.
  *
- * Essencial para realizar transformaes como rotaes e escalas a partir do
- * centro do prprio objeto, em vez de a partir da origem do sistema de coordenadas.
- * @param obj Ponteiro para o objeto genrico.
+ * Essencial para realizar transformações como rotações e escalas a partir do
+ * centro do próprio objeto, em vez de a partir da origem do sistema de coordenadas.
+ * Custa O(1): transformações afins preservam médias, então o centro é a
+ * transformação acumulada aplicada ao centro da geometria base, e o
+ * resultado vale mesmo com a transformação ainda pendente.
+ * @param obj Ponteiro para o objeto genérico.
  * @return Point As coordenadas (x, y) do centro do objeto.
  */
 Point getObjectCenter(Object* obj);
 
+/**
+ * @brief Calcula o centroide da geometria atual no mundo, percorrendo todos os vértices.
+ * @param index O índice do objeto em 'g_objects'.
+ * @return Point A média dos vértices do objeto.
+ */
+Point computeObjectCenter(int index);
+
+/**
+ * @brief Calcula a caixa envolvente alinhada aos eixos (AABB) de um objeto.
+ *
+ * É o menor retângulo, alinhado aos eixos, que contém completamente o objeto.
+ * Percorre todos os vértices; para consultas frequentes use getObjectBounds(),
+ * que devolve a caixa mantida em cache pela cena.
+ * @param index O índice do objeto em 'g_objects'.
+ * @return BoundingBox A caixa envolvente do objeto.
+ */
+BoundingBox computeObjectBounds(int index);
+
 #endif // UTILS_H
@@ -0,0 +1,230 @@
+/**
+ * @file vertexpool.c
+ * @brief Implementação do pool compartilhado de vértices dos polígonos.
+ *
+ * Blocos pequenos são recortados sequencialmente de chunks grandes e, quando
+ * liberados, vão para uma lista livre da sua classe de tamanho. Blocos tão
+ * grandes quanto um chunk são alocados diretamente com malloc.
+ *
+ * O pool também pode adotar um bloco contínuo já preenchido (os vértices de
+ * um snapshot carregado), de onde cada polígono recebe um bloco com a
+ * capacidade exata. Liberado, um bloco desses é recortado nas classes de
+ * tamanho como o resto de um chunk.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "vertexpool.h"
+#include "point.h"
+
+// --- SEÇÃO DE CONSTANTES ---
+
+#define POOL_MIN_BLOCK 4            ///< Menor bloco entregue pelo pool, em vértices.
+#define POOL_NUM_CLASSES 32         ///< Quantidade de classes de tamanho (4, 8, 16, ...).
+#define POOL_CHUNK_POINTS 16384     ///< Tamanho de cada chunk, em vértices (128 KB).
+
+// --- SEÇÃO DE ESTRUTURAS E VARIÁVEIS PRIVADAS ---
+
+/**
+ * @brief Cabeçalho gravado dentro de um bloco livre para encadeá-lo na lista da sua classe.
+ */
+typedef struct FreeBlock {
+    struct FreeBlock* next;
+} FreeBlock;
+
+static FreeBlock* s_freeLists[POOL_NUM_CLASSES]; ///< Blocos livres de cada classe de tamanho.
+static Point** s_chunks = NULL;                  ///< Todos os chunks já alocados.
+static int s_numChunks = 0;
+static int s_chunkCapacity = 0;
+static Point* s_bump = NULL;                     ///< Próxima posição livre do chunk atual.
+static int s_bumpLeft = 0;                       ///< Vértices ainda não recortados do chunk atual.
+static size_t s_pointsInUse = 0;
+
+/**
+ * @brief Uma região adotada com vertexPoolAdopt(); é liberada só no encerramento.
+ */
+typedef struct {
+    Point* start;
+    size_t count;
+} AdoptedRegion;
+
+static AdoptedRegion* s_regions = NULL;
+static int s_numRegions = 0;
+static int s_regionCapacity = 0;
+
+// --- SEÇÃO DE FUNÇÕES AUXILIARES (IMPLEMENTAÇÃO PRIVADA) ---
+
+/**
+ * @brief Calcula a classe de tamanho (e a capacidade) de um bloco para 'count' vértices.
+ */
+static int sizeClassFor(int count, int* capacity) {
+    int cls = 0;
+    int cap = POOL_MIN_BLOCK;
+    while (cap < count) {
+        cap <<= 1;
+        cls++;
+    }
+    *capacity = cap;
+    return cls;
+}
+
+/**
+ * @brief Coloca um bloco na lista livre da sua classe.
+ */
+static void pushFree(Point* block, int cls) {
+    FreeBlock* fb = (FreeBlock*)block;
+    fb->next = s_freeLists[cls];
+    s_freeLists[cls] = fb;
+}
+
+/**
+ * @brief Recorta um trecho livre em blocos das maiores classes que couberem.
+ *
+ * Os blocos ficam abaixo do tamanho de um chunk, que é o limite das listas
+ * livres; sobras menores que POOL_MIN_BLOCK são descartadas.
+ */
+static void recycleRange(Point* start, size_t count) {
+    while (count >= POOL_MIN_BLOCK) {
+        int cap = POOL_MIN_BLOCK;
+        int cls = 0;
+        while ((size_t)(cap << 1) <= count && (cap << 1) < POOL_CHUNK_POINTS) {
+            cap <<= 1;
+            cls++;
+        }
+        pushFree(start, cls);
+        start += cap;
+        count -= cap;
+    }
+}
+
+/**
+ * @brief Recorta o restante do chunk atual em blocos livres antes de abrir outro chunk.
+ */
+static void retireBumpRemainder(void) {
+    recycleRange(s_bump, (size_t)s_bumpLeft);
+    s_bumpLeft = 0;
+}
+
+/**
+ * @brief Retorna 1 se o bloco está dentro de uma região adotada.
+ */
+static int isAdoptedBlock(const Point* block) {
+    for (int i = 0; i < s_numRegions; i++) {
+        if (block >= s_regions[i].start && block < s_regions[i].start + s_regions[i].count) return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Aloca um novo chunk e o torna o chunk atual.
+ * @return int 1 em caso de sucesso, 0 se faltar memória.
+ */
+static int openChunk(void) {
+    if (s_numChunks == s_chunkCapacity) {
+        int newCapacity = s_chunkCapacity > 0 ? s_chunkCapacity * 2 : 16;
+        Point** chunks = (Point**)realloc(s_chunks, newCapacity * sizeof(Point*));
+        if (!chunks) return 0;
+        s_chunks = chunks;
+        s_chunkCapacity = newCapacity;
+    }
+    Point* chunk = (Point*)malloc(POOL_CHUNK_POINTS * sizeof(Point));
+    if (!chunk) return 0;
+
+    retireBumpRemainder();
+    s_chunks[s_numChunks++] = chunk;
+    s_bump = chunk;
+    s_bumpLeft = POOL_CHUNK_POINTS;
+    return 1;
+}
+
+// --- SEÇÃO DE FUNÇÕES PÚBLICAS ---
+
+Point* vertexPoolAlloc(int count, int* capacity) {
+    *capacity = 0;
+    if (count <= 0) return NULL;
+
+    int cap;
+    int cls = sizeClassFor(count, &cap);
+    Point* block = NULL;
+
+    if (cap >= POOL_CHUNK_POINTS) {
+        // Blocos enormes ganham uma alocação própria.
+        block = (Point*)malloc((size_t)cap * sizeof(Point));
+    } else if (s_freeLists[cls] != NULL) {
+        block = (Point*)s_freeLists[cls];
+        s_freeLists[cls] = s_freeLists[cls]->next;
+    } else {
+        if (s_bumpLeft < cap && !openChunk()) {
+            block = NULL;
+        } else {
+            block = s_bump;
+            s_bump += cap;
+            s_bumpLeft -= cap;
+        }
+    }
+
+    if (block == NULL) {
+        fprintf(stderr, "[VertexPool ERROR] Falha ao alocar bloco para %d vértices.\n", count);
+        return NULL;
+    }
+    *capacity = cap;
+    s_pointsInUse += cap;
+    return block;
+}
+
+void vertexPoolFree(Point* block, int capacity) {
+    if (block == NULL || capacity <= 0) return;
+    s_pointsInUse -= capacity;
+    if (capacity >= POOL_CHUNK_POINTS && !isAdoptedBlock(block)) {
+        free(block);
+        return;
+    }
+    // Um bloco de classe volta inteiro para a sua lista; um bloco de
+    // capacidade exata (de uma região adotada) é recortado.
+    recycleRange(block, (size_t)capacity);
+}
+
+int vertexPoolAdopt(Point* region, size_t used, size_t capacity) {
+    if (region == NULL) return 0;
+    if (s_numRegions == s_regionCapacity) {
+        int newCapacity = s_regionCapacity > 0 ? s_regionCapacity * 2 : 16;
+        AdoptedRegion* regions = (AdoptedRegion*)realloc(s_regions, newCapacity * sizeof(AdoptedRegion));
+        if (!regions) return 0;
+        s_regions = regions;
+        s_regionCapacity = newCapacity;
+    }
+    s_regions[s_numRegions].start = region;
+    s_regions[s_numRegions].count = capacity;
+    s_numRegions++;
+    s_pointsInUse += used;
+    recycleRange(region + used, capacity - used);
+    return 1;
+}
+
+size_t vertexPoolPointsInUse(void) {
+    return s_pointsInUse;
+}
+
+void vertexPoolShutdown(void) {
+    for (int i = 0; i < s_numChunks; i++) {
+        free(s_chunks[i]);
+    }
+    free(s_chunks);
+    s_chunks = NULL;
+    for (int i = 0; i < s_numRegions; i++) {
+        free(s_regions[i].start);
+    }
+    free(s_regions);
+    s_regions = NULL;
+    s_numRegions = 0;
+    s_regionCapacity = 0;
+    s_numChunks = 0;
+    s_chunkCapacity = 0;
+    s_bump = NULL;
+    s_bumpLeft = 0;
+    s_pointsInUse = 0;
+    for (int i = 0; i < POOL_NUM_CLASSES; i++) {
+        s_freeLists[i] = NULL;
+    }
+}
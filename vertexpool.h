@@ -0,0 +1,64 @@
+/**
+ * @file vertexpool.h
+ * @brief Define a interface do pool compartilhado de vértices dos polígonos.
+ *
+ * Os vértices de todos os polígonos são alocados em grandes blocos de memória
+ * ("chunks") divididos em classes de tamanho potência de dois. Assim, um
+ * triângulo ocupa apenas o espaço de 4 vértices, e não há limite fixo para a
+ * quantidade de vértices de um polígono.
+ */
+
+#ifndef VERTEXPOOL_H
+#define VERTEXPOOL_H
+
+#include <stddef.h>
+#include "point.h"
+
+// --- SEÇÃO DE PROTÓTIPOS DE FUNÇÕES PÚBLICAS ---
+
+/**
+ * @brief Aloca um bloco com espaço para pelo menos 'count' vértices.
+ * @param count A quantidade mínima de vértices do bloco.
+ * @param capacity Recebe a capacidade real do bloco (necessária para liberá-lo).
+ * @return Point* O bloco alocado, ou NULL se 'count' for zero ou faltar memória.
+ */
+Point* vertexPoolAlloc(int count, int* capacity);
+
+/**
+ * @brief Devolve um bloco ao pool para ser reutilizado.
+ * @param block O bloco obtido em vertexPoolAlloc() (NULL é ignorado).
+ * @param capacity A capacidade informada por vertexPoolAlloc().
+ */
+void vertexPoolFree(Point* block, int capacity);
+
+/**
+ * @brief Passa ao pool um bloco de vértices já preenchido, alocado com malloc.
+ *
+ * Os primeiros 'used' vértices continuam com o chamador, que os reparte entre
+ * polígonos com blocos de capacidade exata (liberados com vertexPoolFree(),
+ * como qualquer outro); o restante vira espaço livre. O bloco em si só é
+ * devolvido ao sistema em vertexPoolShutdown().
+ * @param region O bloco, que passa a pertencer ao pool.
+ * @param used A quantidade de vértices em uso no início do bloco.
+ * @param capacity O tamanho do bloco, em vértices.
+ * @return int 1 em caso de sucesso, 0 se faltou memória (o bloco continua com o chamador).
+ */
+int vertexPoolAdopt(Point* region, size_t used, size_t capacity);
+
+/**
+ * @brief Retorna a quantidade de vértices atualmente reservados no pool.
+ *
+ * Conta a capacidade dos blocos em uso (não os vértices efetivamente
+ * preenchidos), o que reflete a memória real ocupada pelos polígonos.
+ */
+size_t vertexPoolPointsInUse(void);
+
+/**
+ * @brief Libera toda a memória do pool.
+ *
+ * Deve ser chamada apenas no encerramento do programa, quando nenhum
+ * polígono ainda referencia os blocos.
+ */
+void vertexPoolShutdown(void);
+
+#endif // VERTEXPOOL_H